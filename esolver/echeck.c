@@ -0,0 +1,165 @@
+/* ========================================================================= */
+/* ESolver "Exact Mixed Integer Linear Solver" provides some basic structures
+ * and algorithms commons in solving MIP's
+ *
+ * Copyright (C) 2008 David Applegate, Bill Cook, Sanjeeb Dash, Daniel Espinoza.
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation; either version 2.1 of the License, or (at your
+ * option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ * */
+/* ========================================================================= */
+/* Check binary certificates written by esolver -C against their problem.  */
+/* ========================================================================= */
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "QSopt_ex.h"
+
+#include "logging-private.h"
+#include "qs_config.h"
+
+/* ========================================================================= */
+/** @name static parameters for the main program */
+/*@{*/
+static char *fname = 0;
+static int lpfile = 0;
+static int nthreads = 1;
+static int verbose = 0;
+/*@}*/
+
+/* ========================================================================= */
+/** @brief Display options to the screen */
+static void usage (char *s)
+{
+	fprintf (stderr, "Usage: %s [- below -] prob_file cert_file ...\n", s);
+	fprintf (stderr, "   -L    input file is in lp format (default: mps)\n");
+	fprintf (stderr, "   -t n  number of threads to use (default: 1)\n");
+	fprintf (stderr, "   -v    report the first violation found\n");
+	fprintf (stderr, "Exit status is zero only if every certificate is valid\n");
+}
+
+/* ========================================================================= */
+/** @brief parse the command line, leaves in *first the index of the first
+ * certificate */
+static int parseargs (int ac,
+											char **av,
+											int *first)
+{
+	int c;
+	int boptind = 1;
+	char *boptarg = 0;
+
+	while ((c = ILLutil_bix_getopt (ac, av, "Lt:v", &boptind, &boptarg)) != EOF)
+		switch (c)
+		{
+		case 'L':
+			lpfile = 1;
+			break;
+		case 't':
+			nthreads = atoi (boptarg);
+			break;
+		case 'v':
+			verbose = 1;
+			break;
+		case '?':
+		default:
+			usage (av[0]);
+			return 1;
+		}
+	if (ac - boptind < 2 || nthreads < 1)
+	{
+		usage (av[0]);
+		return 1;
+	}
+	fname = av[boptind++];
+	*first = boptind;
+	return 0;
+}
+
+/* ========================================================================= */
+/** @brief the main thing! */
+/* ========================================================================= */
+int main (int ac, char **av)
+{
+	int rval = 0,
+	  first = 0,
+	  ftype = 0,
+	  valid,
+	  i;
+	size_t len;
+	mpq_QSdata *p_mpq = 0;
+	QSexact_cert cert;
+	EGioFile_t *in_f;
+	double start;
+
+	memset (&cert, 0, sizeof (cert));
+	QSexactStart ();
+	QSexact_set_precision (128);
+	rval = parseargs (ac, av, &first);
+	if (rval)
+		goto CLEANUP;
+
+	/* get the file type, the same way esolver does */
+	len = strlen (fname);
+	if (len > 3 && !strcmp (fname + len - 3, ".gz"))
+		len -= 3;
+	else if (len > 4 && !strcmp (fname + len - 4, ".bz2"))
+		len -= 4;
+	if (lpfile || (len > 3 && !strncmp (fname + len - 3, ".lp", 3)) ||
+			(len > 3 && !strncmp (fname + len - 3, ".LP", 3)))
+		ftype = 1;
+
+	p_mpq = mpq_QSread_prob ((const char *) fname, ftype ? "LP" : "MPS");
+	if (p_mpq == 0)
+	{
+		fprintf (stderr, "Could not read %s file %s.\n", ftype ? "lp" : "mps",
+						 fname);
+		rval = 1;
+		goto CLEANUP;
+	}
+	p_mpq->simplex_display = verbose;
+
+	/* check every certificate in turn */
+	for (i = first; i < ac; i++)
+	{
+		in_f = EGioOpen (av[i], "r");
+		if (!in_f)
+		{
+			fprintf (stderr, "Could not open %s.\n", av[i]);
+			rval = 1;
+			continue;
+		}
+		valid = 0;
+		start = ILLutil_real_zeit ();
+		if (!QSexact_read_cert (in_f, &cert))
+			valid = QSexact_check_cert (p_mpq, &cert, nthreads);
+		EGioClose (in_f);
+		printf ("%s: %s %s in %.3lf seconds\n", av[i],
+						cert.status == QS_LP_OPTIMAL ? "OPTIMAL" :
+						cert.status == QS_LP_INFEASIBLE ? "INFEASIBLE" : "UNDEFINED",
+						valid ? "VALID" : "INVALID", ILLutil_real_zeit () - start);
+		QSexact_free_cert (&cert);
+		if (!valid)
+			rval = 1;
+	}
+
+CLEANUP:
+	mpq_QSfree_prob (p_mpq);
+	QSexactClear ();
+	return rval;
+}
@@ -36,6 +36,15 @@
 #include "qs_config.h"
 #include "timing_log.h"
 
+#if HAVE_EG_THREAD
+#include <errno.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#endif
+
 /* ========================================================================= */
 /** @name static parameters for the main program */
 /*@{*/
@@ -46,27 +55,57 @@ static int showversion = 0;
 static int simplexalgo = PRIMAL_SIMPLEX;
 static int pstrategy = QS_PRICE_PSTEEP;
 static int dstrategy = QS_PRICE_DSTEEP;
+static int basissolver = QS_EXACT_BASIS_SOLVER_LU;
+static int luupdate = QS_EXACT_LU_UPDATE_ETA;
+static int race = QS_EXACT_RACE_OFF;
+static int reconstruct = QS_EXACT_RECONSTRUCT_DEFAULT;
+static int schedule = QS_EXACT_SCHEDULE_FIXED;
+/** @brief threads used to factor the bases */
+static int factor_threads = 1;
+/** @brief explicit precision schedule given with -s, if nrungs is non-zero */
+static int nrungs = 0;
+static unsigned rung_bits[QS_EXACT_MAX_ITER * 2];
+static double rung_time[QS_EXACT_MAX_ITER * 2];
 static unsigned precision = 128;
 static int printsol = 0;
 static char *solname = 0;
+static char *certname = 0;
 static char *readbasis = 0;
 static char *writebasis = 0;
+/** @brief checkpoint file given with -K, and whether to resume from it */
+static char *checkpoint = 0;
+static int resume = 0;
 /** @brief maximum running time */
 static double max_rtime = INT_MAX;
 /** @brief maximum memory usage */
 static unsigned long memlimit = UINT_MAX;
+/** @brief number of worker threads in service mode, zero to solve prob_file */
+static int service_threads = 0;
+/** @brief Unix socket to read jobs from in service mode, stdin if zero */
+static char *service_socket = 0;
 /*@}*/
 /* ========================================================================= */
 /** @brief Display options to the screen */
 static void usage (char *s)
 {
 	fprintf (stderr, "Usage: %s [- below -] prob_file\n", s);
+	fprintf (stderr, "       %s -D n [-U socket] [- below -]\n", s);
 	fprintf (stderr, "   -b f  write basis to file f\n");
 	fprintf (stderr, "   -B f  read initial basis from file f\n");
+	fprintf (stderr, "   -C f  write a binary exact certificate to file f\n");
+	fprintf (stderr, "         append .gz/.bz2 to compress the file\n");
+	fprintf (stderr, "   -c n  snap approximate solutions to denominators up to n\n");
+	fprintf (stderr, "         before testing them (default: %d, 0 disables)\n",
+					 QS_EXACT_RECONSTRUCT_DEFAULT);
 #if 0
 	fprintf (stderr, "   -I    solve the MIP using BestBound\n");
 	fprintf (stderr, "   -E    edit problem after solving initial version\n");
 #endif
+	fprintf (stderr, "   -e #  solve rational basis systems with method #\n");
+	fprintf (stderr, "         (%d-LU (default), %d-Bareiss, %d-Modular, %d-Dixon)\n",
+					 QS_EXACT_BASIS_SOLVER_LU, QS_EXACT_BASIS_SOLVER_BAREISS,
+					 QS_EXACT_BASIS_SOLVER_MODULAR, QS_EXACT_BASIS_SOLVER_DIXON);
+	fprintf (stderr, "   -j n  factor large bases with n threads (default: 1)\n");
 	fprintf (stderr, "   -L    input file is in lp format (default: mps)\n");
 	fprintf (stderr, "   -O    write the final solution to the given file\n");
 	fprintf (stderr, "         append .gz/.bz2 to the .sol extension to compress the file\n");
@@ -77,11 +116,27 @@ static void usage (char *s)
 					 QS_PRICE_PMULTPARTIAL);
 	fprintf (stderr,
 					 "   -P #  number of bits to use for the float representation (default: 128)\n");
+	fprintf (stderr, "   -D n  service mode, solve the LP/MPS files named one per line on\n");
+	fprintf (stderr, "         stdin (or on connections to -U) with n worker threads\n");
 	fprintf (stderr, "   -d #  run dual simplex with pricing rule #\n");
 	fprintf (stderr, "         (%d-Dantzig, %d-Steep, %d-Partial, %d-Devex)\n",
 					 QS_PRICE_DDANTZIG, QS_PRICE_DSTEEP, QS_PRICE_DMULTPARTIAL,
 					 QS_PRICE_DDEVEX);
+	fprintf (stderr, "   -r #  run the first precisions concurrently with mode #\n");
+	fprintf (stderr, "         (%d-off (default), %d-double and mpf 128, %d-double, mpf 128 and 192)\n",
+					 QS_EXACT_RACE_OFF, QS_EXACT_RACE_MPF128, QS_EXACT_RACE_MPF192);
+	fprintf (stderr, "   -s l  try the mpf precisions in the comma separated list l,\n");
+	fprintf (stderr, "         each as bits[:seconds] (default: 128 growing by half)\n");
+	fprintf (stderr, "   -k    skip precisions too short for the element growth seen\n");
+	fprintf (stderr, "         in the previous one\n");
+	fprintf (stderr, "   -K f  save the state of the solve to file f after every precision\n");
+	fprintf (stderr, "         (not in service mode)\n");
+	fprintf (stderr, "   -x    resume from the file given with -K, if there is one\n");
 	fprintf (stderr, "   -S    do NOT scale the initial LP\n");
+	fprintf (stderr, "   -U f  in service mode, read jobs from the Unix socket f\n");
+	fprintf (stderr, "   -u #  keep the cached rational LU in sync with method #\n");
+	fprintf (stderr, "         (%d-eta updates (default), %d-Schur complement)\n",
+					 QS_EXACT_LU_UPDATE_ETA, QS_EXACT_LU_UPDATE_SCHUR);
 	fprintf (stderr, "   -v    print QSopt version number\n");
 	fprintf (stderr, "   -R n  maximum running time allowed, default %lf\n",
 						max_rtime);
@@ -89,6 +144,38 @@ static void usage (char *s)
 						memlimit);
 }
 
+/* ========================================================================= */
+/** @brief parse a precision schedule given as bits[:seconds],... into
+ * rung_bits, rung_time and nrungs */
+static int parse_schedule (char *s)
+{
+	char *end;
+	nrungs = 0;
+	while (*s)
+	{
+		if (nrungs == QS_EXACT_MAX_ITER * 2)
+			return 1;
+		rung_bits[nrungs] = (unsigned) strtoul (s, &end, 10);
+		rung_time[nrungs] = 0.0;
+		if (end == s)
+			return 1;
+		s = end;
+		if (*s == ':')
+		{
+			rung_time[nrungs] = strtod (s + 1, &end);
+			if (end == s + 1)
+				return 1;
+			s = end;
+		}
+		nrungs++;
+		if (*s == ',')
+			s++;
+		else if (*s)
+			return 1;
+	}
+	return nrungs ? 0 : 1;
+}
+
 /* ========================================================================= */
 /** @brief decide if a given file is mps or lp (only by extension) */
 // AP: ftype = 0 if MPS and 1 if LP
@@ -186,6 +273,438 @@ static int mem_limits(void)
 	signal(SIGXCPU,sighandler);
 	return rval;
 }
+#if HAVE_EG_THREAD
+/* ========================================================================= */
+/** @name service mode
+ * With -D the program does not solve a single file, but stays up and solves
+ * a stream of jobs on a pool of worker threads, so that the GMP memory pools
+ * and the library globals set up by #QSexactStart stay warm between jobs.
+ * A job is a line holding the name of an LP/MPS file (the format is taken
+ * from the extension, or LP for all jobs with -L); jobs are read from the
+ * standard input, or, with -U, from every connection to a Unix socket. The
+ * answer to each job is written back as one block:
+ *
+ * job <id> <file>
+ * <status and solution as written by #QSexact_print_sol, or, for
+ *  infeasible problems, the Farkas multipliers after CERTIFICATE:>
+ * end <id> <return code> <wall clock seconds>
+ *
+ * blocks of different jobs are never interleaved, but are written in the
+ * order the jobs finish. Solver messages go to the standard error. */
+/*@{*/
+/* ========================================================================= */
+/** @brief a pending job, a problem to solve or a connection to serve */
+typedef struct service_job_t
+{
+	char *fname;									/**< problem file, zero for a connection */
+	int fd;												/**< where answers go (and where jobs come
+																	 from, for a connection) */
+	struct service_job_t *next;
+}
+service_job_t;
+
+/* ========================================================================= */
+/** @brief set by SIGINT/SIGTERM to stop accepting connections */
+static volatile sig_atomic_t service_stop = 0;
+/** @brief queue of pending jobs, shared by all workers */
+static struct
+{
+	pthread_mutex_t mt;
+	pthread_cond_t cv;
+	service_job_t *head;
+	service_job_t *tail;
+	int closed;										/**< no more jobs will be added */
+	unsigned long njobs;					/**< jobs handed out so far */
+	int *conn;										/**< connection served by each worker, -1 if
+																	 none */
+}
+service_queue = {PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER, 0, 0, 0, 0, 0};
+/** @brief serializes the answers written to a shared descriptor */
+static pthread_mutex_t service_out = PTHREAD_MUTEX_INITIALIZER;
+
+/* ========================================================================= */
+/** @brief add a job to the queue, the queue takes ownership of fname */
+static int service_push (char *fname,
+												 int fd)
+{
+	service_job_t *job = EGsMalloc (service_job_t, 1);
+	job->fname = fname;
+	job->fd = fd;
+	job->next = 0;
+	pthread_mutex_lock (&service_queue.mt);
+	if (service_queue.tail)
+		service_queue.tail->next = job;
+	else
+		service_queue.head = job;
+	service_queue.tail = job;
+	pthread_cond_signal (&service_queue.cv);
+	pthread_mutex_unlock (&service_queue.mt);
+	return 0;
+}
+
+/* ========================================================================= */
+/** @brief tell the workers that no more jobs will come, the connections being
+ * served are shut down so that the workers reading them see their end */
+static void service_close (void)
+{
+	int w;
+	pthread_mutex_lock (&service_queue.mt);
+	service_queue.closed = 1;
+	for (w = 0; w < service_threads; w++)
+		if (service_queue.conn[w] >= 0)
+			shutdown (service_queue.conn[w], SHUT_RDWR);
+	pthread_cond_broadcast (&service_queue.cv);
+	pthread_mutex_unlock (&service_queue.mt);
+}
+
+/* ========================================================================= */
+/** @brief wait for the next job of worker w, zero once the queue is closed
+ * and empty. A connection is recorded as served by w; once the queue is
+ * closed, the connections not served yet are dropped. */
+static service_job_t *service_pop (const int w)
+{
+	service_job_t *job;
+	pthread_mutex_lock (&service_queue.mt);
+	for (;;)
+	{
+		while (!service_queue.head && !service_queue.closed)
+			pthread_cond_wait (&service_queue.cv, &service_queue.mt);
+		job = service_queue.head;
+		if (!job)
+			break;
+		service_queue.head = job->next;
+		if (!service_queue.head)
+			service_queue.tail = 0;
+		if (job->fname)
+			break;
+		if (!service_queue.closed)
+		{
+			service_queue.conn[w] = job->fd;
+			break;
+		}
+		close (job->fd);
+		EGfree (job);
+	}
+	pthread_mutex_unlock (&service_queue.mt);
+	return job;
+}
+
+/* ========================================================================= */
+/** @brief worker w is done with its connection */
+static void service_done (const int w)
+{
+	pthread_mutex_lock (&service_queue.mt);
+	service_queue.conn[w] = -1;
+	pthread_mutex_unlock (&service_queue.mt);
+}
+
+/* ========================================================================= */
+/** @brief identifier for a new job */
+static unsigned long service_next_id (void)
+{
+	unsigned long id;
+	pthread_mutex_lock (&service_queue.mt);
+	id = ++service_queue.njobs;
+	pthread_mutex_unlock (&service_queue.mt);
+	return id;
+}
+
+/* ========================================================================= */
+/** @brief write len bytes of buf to fd, in one piece with respect to the
+ * other workers */
+static int service_write (int fd,
+													const char *buf,
+													size_t len)
+{
+	int rval = 0;
+	ssize_t sz;
+	pthread_mutex_lock (&service_out);
+	while (len)
+	{
+		sz = write (fd, buf, len);
+		if (sz < 0 && errno == EINTR)
+			continue;
+		if (sz <= 0)
+		{
+			rval = 1;
+			break;
+		}
+		buf += sz;
+		len -= (size_t) sz;
+	}
+	pthread_mutex_unlock (&service_out);
+	return rval;
+}
+
+/* ========================================================================= */
+/** @brief solve the problem in fname with the options given on the command
+ * line and write the answer to fd. The whole answer is built in memory first,
+ * so that it reaches fd as one block. */
+static int service_solve (const char *fname,
+													int fd)
+{
+	int rval = 0,
+	  status = QS_LP_UNSOLVED,
+	  ftype = lpfile,
+	  i;
+	unsigned long const id = service_next_id ();
+	double const start = ILLutil_real_zeit ();
+	mpq_QSdata *p_mpq = 0;
+	mpq_t *y_mpq = 0;
+	char *buf = 0,
+	 *str = 0;
+	size_t len = 0;
+	FILE *mem = open_memstream (&buf, &len);
+	EGioFile_t *out = 0;
+
+	if (!mem)
+		return 1;
+	out = EGioOpenFILE (mem);
+	EGioPrintf (out, "job %lu %s\n", id, fname);
+	if (!ftype)
+		get_ftype (fname, &ftype);
+	p_mpq = mpq_QSread_prob (fname, ftype ? "LP" : "MPS");
+	if (!p_mpq)
+	{
+		EGioPrintf (out, "status = UNDEFINED\n");
+		rval = 1;
+		goto CLEANUP;
+	}
+	rval = mpq_QSset_param (p_mpq, QS_PARAM_PRIMAL_PRICING, pstrategy)
+		|| mpq_QSset_param (p_mpq, QS_PARAM_DUAL_PRICING, dstrategy)
+		|| mpq_QSset_param (p_mpq, QS_PARAM_SIMPLEX_SCALING, usescaling)
+		|| mpq_QSset_param (p_mpq, QS_PARAM_EXACT_BASIS_SOLVER, basissolver)
+		|| mpq_QSset_param (p_mpq, QS_PARAM_EXACT_LU_UPDATE, luupdate)
+		|| mpq_QSset_param (p_mpq, QS_PARAM_EXACT_RACE, race)
+		|| mpq_QSset_param (p_mpq, QS_PARAM_EXACT_RECONSTRUCT, reconstruct)
+		|| mpq_QSset_param (p_mpq, QS_PARAM_EXACT_PRECISION_SCHEDULE, schedule)
+		|| mpq_QSset_param (p_mpq, QS_PARAM_FACTOR_THREADS, factor_threads)
+		|| QSexact_set_precision_schedule (p_mpq, nrungs, rung_bits, rung_time);
+	if (rval)
+		goto CLEANUP;
+	y_mpq = mpq_EGlpNumAllocArray (p_mpq->qslp->nrows);
+	rval = QSexact_solver (p_mpq, 0, y_mpq, 0, simplexalgo, &status);
+	if (rval)
+	{
+		EGioPrintf (out, "status = UNDEFINED\n");
+		goto CLEANUP;
+	}
+	switch (status)
+	{
+	case QS_LP_INFEASIBLE:
+		EGioPrintf (out, "status INFEASIBLE\nCERTIFICATE:\n");
+		for (i = 0; i < p_mpq->qslp->nrows; i++)
+			if (mpq_sgn (y_mpq[i]))
+			{
+				str = mpq_EGlpNumGetStr (y_mpq[i]);
+				EGioPrintf (out, "%s = %s\n", p_mpq->qslp->rownames[i], str);
+				free (str);
+			}
+		break;
+	default:
+		rval = QSexact_print_sol (p_mpq, out);
+		break;
+	}
+CLEANUP:
+	EGioPrintf (out, "end %lu %d %.3lf\n", id, rval,
+							ILLutil_real_zeit () - start);
+	EGioClose (out);
+	if (service_write (fd, buf, len))
+		rval = 1;
+	free (buf);
+	mpq_EGlpNumFreeArray (y_mpq);
+	mpq_QSfree_prob (p_mpq);
+	return rval;
+}
+
+/* ========================================================================= */
+/** @brief read one job name per line from in and queue it (or, with
+ * queue_jobs unset, solve it right away), answers go to fd */
+static void service_read (FILE * in,
+													int fd,
+													int queue_jobs)
+{
+	char line[4096],
+	 *s,
+	 *e;
+	while (!service_stop && fgets (line, sizeof (line), in))
+	{
+		for (s = line; *s == ' ' || *s == '\t'; s++) ;
+		for (e = s + strlen (s); e > s && (e[-1] == '\n' || e[-1] == '\r' ||
+																			 e[-1] == ' ' || e[-1] == '\t'); e--) ;
+		*e = '\0';
+		if (!*s || *s == '#')
+			continue;
+		if (queue_jobs)
+			service_push (strdup (s), fd);
+		else
+			service_solve (s, fd);
+	}
+}
+
+/* ========================================================================= */
+/** @brief body of the worker threads, arg is the number of the worker */
+static void *service_worker (void *arg)
+{
+	int const w = (int) (long) arg;
+	service_job_t *job;
+	FILE *in;
+	QSexactThreadStart (precision);
+	while ((job = service_pop (w)))
+	{
+		if (job->fname)
+		{
+			service_solve (job->fname, job->fd);
+			free (job->fname);
+		}
+		else if ((in = fdopen (job->fd, "r")))
+		{
+			/* a connection is served by one worker, job after job */
+			service_read (in, job->fd, 0);
+			service_done (w);
+			fclose (in);
+		}
+		else
+		{
+			service_done (w);
+			close (job->fd);
+		}
+		EGfree (job);
+	}
+	QSexactThreadClear ();
+	return 0;
+}
+
+/* ========================================================================= */
+/** @brief signal handler to leave service mode */
+static void service_sighandler (int s)
+{
+	(void) s;
+	service_stop = 1;
+}
+
+/* ========================================================================= */
+/** @brief run in service mode until the input ends (or, when listening on a
+ * socket, until SIGINT or SIGTERM) */
+static int service (void)
+{
+	int rval = 0,
+	  fd = -1,
+	  out_fd = -1,
+	  i;
+	pthread_t *workers = EGsMalloc (pthread_t, service_threads);
+	struct sockaddr_un addr;
+	struct sigaction sa;
+	struct stat st;
+	sigset_t sigs,
+	  oldsigs;
+
+	service_queue.conn = EGsMalloc (int, service_threads);
+	for (i = 0; i < service_threads; i++)
+		service_queue.conn[i] = -1;
+	memset (&sa, 0, sizeof (sa));
+	sa.sa_handler = service_sighandler;
+	sigaction (SIGINT, &sa, 0);
+	sigaction (SIGTERM, &sa, 0);
+	signal (SIGPIPE, SIG_IGN);
+	if (service_socket)
+	{
+		memset (&addr, 0, sizeof (addr));
+		addr.sun_family = AF_UNIX;
+		if (strlen (service_socket) >= sizeof (addr.sun_path))
+		{
+			fprintf (stderr, "Socket path %s too long\n", service_socket);
+			rval = 1;
+			goto CLEANUP;
+		}
+		strcpy (addr.sun_path, service_socket);
+		/* only a stale socket is replaced, never any other file */
+		if (!lstat (service_socket, &st))
+		{
+			if (!S_ISSOCK (st.st_mode))
+			{
+				fprintf (stderr, "%s exists and is not a socket\n", service_socket);
+				rval = 1;
+				goto CLEANUP;
+			}
+			unlink (service_socket);
+		}
+		if ((fd = socket (AF_UNIX, SOCK_STREAM, 0)) < 0 ||
+				bind (fd, (struct sockaddr *) &addr, sizeof (addr)) ||
+				listen (fd, SOMAXCONN))
+		{
+			perror (service_socket);
+			rval = 1;
+			goto CLEANUP;
+		}
+	}
+	else
+	{
+		/* answers go to the real standard output, anything the solver prints
+		 * goes to the standard error */
+		fflush (stdout);
+		if ((out_fd = dup (STDOUT_FILENO)) < 0 ||
+				dup2 (STDERR_FILENO, STDOUT_FILENO) < 0)
+		{
+			perror ("dup");
+			rval = 1;
+			goto CLEANUP;
+		}
+	}
+	fprintf (stderr, "Serving jobs from %s with %d workers\n",
+					 service_socket ? service_socket : "standard input",
+					 service_threads);
+	/* SIGINT and SIGTERM must reach this thread, which waits in accept */
+	sigemptyset (&sigs);
+	sigaddset (&sigs, SIGINT);
+	sigaddset (&sigs, SIGTERM);
+	pthread_sigmask (SIG_BLOCK, &sigs, &oldsigs);
+	for (i = 0; i < service_threads; i++)
+		if (pthread_create (workers + i, 0, service_worker, (void *) (long) i))
+			break;
+	pthread_sigmask (SIG_SETMASK, &oldsigs, 0);
+	if (!i)
+	{
+		fprintf (stderr, "Could not start any worker\n");
+		rval = 1;
+		goto CLEANUP;
+	}
+	service_threads = i;
+	if (service_socket)
+	{
+		int cfd;
+		while (!service_stop)
+		{
+			cfd = accept (fd, 0, 0);
+			if (cfd < 0)
+			{
+				if (errno == EINTR)
+					continue;
+				perror ("accept");
+				break;
+			}
+			service_push (0, cfd);
+		}
+	}
+	else
+		service_read (stdin, out_fd, 1);
+	service_close ();
+	for (i = 0; i < service_threads; i++)
+		pthread_join (workers[i], 0);
+CLEANUP:
+	if (fd >= 0)
+	{
+		close (fd);
+		unlink (service_socket);
+	}
+	if (out_fd >= 0)
+		close (out_fd);
+	EGfree (workers);
+	EGfree (service_queue.conn);
+	return rval;
+}
+/*@}*/
+#endif
 /* ========================================================================= */
 /** @brief parssing options for the program */
 static int parseargs (int ac, char **av)
@@ -194,7 +713,7 @@ static int parseargs (int ac, char **av)
 	int boptind = 1;
 	char *boptarg = 0;
 
-	while ((c = ILLutil_bix_getopt (ac, av, "b:B:d:EILm:O:p:P:R:Sv", &boptind, &boptarg)) != EOF)
+	while ((c = ILLutil_bix_getopt (ac, av, "b:B:c:C:d:D:e:EIj:kK:Lm:O:p:P:r:R:s:Su:U:vx", &boptind, &boptarg)) != EOF)
 		switch (c)
 		{
 		case 'm':
@@ -209,6 +728,9 @@ static int parseargs (int ac, char **av)
 		case 'B':
 			readbasis = boptarg;
 			break;
+		case 'C':
+			certname = boptarg;
+			break;
 		case 'P':
 			precision = atoi (boptarg);
 			break;
@@ -216,6 +738,45 @@ static int parseargs (int ac, char **av)
 			simplexalgo = DUAL_SIMPLEX;
 			dstrategy = atoi (boptarg);
 			break;
+		case 'D':
+			service_threads = atoi (boptarg);
+			break;
+		case 'e':
+			basissolver = atoi (boptarg);
+			break;
+		case 'u':
+			luupdate = atoi (boptarg);
+			break;
+		case 'U':
+			service_socket = boptarg;
+			if (!service_threads)
+				service_threads = 1;
+			break;
+		case 'r':
+			race = atoi (boptarg);
+			break;
+		case 'c':
+			reconstruct = atoi (boptarg);
+			break;
+		case 's':
+			if (parse_schedule (boptarg))
+			{
+				usage (av[0]);
+				return 1;
+			}
+			break;
+		case 'j':
+			factor_threads = atoi (boptarg);
+			break;
+		case 'k':
+			schedule = QS_EXACT_SCHEDULE_SKIP;
+			break;
+		case 'K':
+			checkpoint = boptarg;
+			break;
+		case 'x':
+			resume = 1;
+			break;
 		case 'L':
 			lpfile = 1;
 			break;
@@ -248,6 +809,17 @@ static int parseargs (int ac, char **av)
 		exit(0);
 	}
 
+	if (service_threads > 0)
+	{
+		if (boptind != ac)
+		{
+			usage (av[0]);
+			return 1;
+		}
+		mem_limits();
+		return 0;
+	}
+
 	if (boptind != (ac - 1))
 	{
 		usage (av[0]);
@@ -285,6 +857,17 @@ int main (int ac, char **av)
 	QSexact_set_precision (precision);
 	if (rval)
 		goto CLEANUP;
+	if (service_threads > 0)
+	{
+#if HAVE_EG_THREAD
+		rval = service ();
+#else
+		fprintf (stderr, "Service mode needs thread support\n");
+		rval = 1;
+#endif
+		QSexactClear ();
+		return rval;
+	}
 	if (writebasis)
 	{
 		// basis is pointer to space allocated for final basis, set to all 0s
@@ -361,13 +944,23 @@ int main (int ac, char **av)
 	rval = mpq_QSset_param (p_mpq, QS_PARAM_SIMPLEX_DISPLAY, 1)
 		|| mpq_QSset_param (p_mpq, QS_PARAM_PRIMAL_PRICING, pstrategy)
 		|| mpq_QSset_param (p_mpq, QS_PARAM_DUAL_PRICING, dstrategy)
-		|| mpq_QSset_param (p_mpq, QS_PARAM_SIMPLEX_SCALING, usescaling);
+		|| mpq_QSset_param (p_mpq, QS_PARAM_SIMPLEX_SCALING, usescaling)
+		|| mpq_QSset_param (p_mpq, QS_PARAM_EXACT_BASIS_SOLVER, basissolver)
+		|| mpq_QSset_param (p_mpq, QS_PARAM_EXACT_LU_UPDATE, luupdate)
+		|| mpq_QSset_param (p_mpq, QS_PARAM_EXACT_RACE, race)
+		|| mpq_QSset_param (p_mpq, QS_PARAM_EXACT_RECONSTRUCT, reconstruct)
+		|| mpq_QSset_param (p_mpq, QS_PARAM_EXACT_PRECISION_SCHEDULE, schedule)
+		|| mpq_QSset_param (p_mpq, QS_PARAM_FACTOR_THREADS, factor_threads)
+		|| QSexact_set_precision_schedule (p_mpq, nrungs, rung_bits, rung_time)
+		|| QSexact_set_checkpoint (p_mpq, checkpoint, resume);
 	ILL_CLEANUP_IF (rval);
 	if (printsol)
 	{
 		x_mpq = mpq_EGlpNumAllocArray (p_mpq->qslp->ncols);
 		y_mpq = mpq_EGlpNumAllocArray (p_mpq->qslp->nrows);
 	}
+	else if (certname)
+		y_mpq = mpq_EGlpNumAllocArray (p_mpq->qslp->nrows);
 	ILLutil_init_timer (&timer_solve, "SOLVER");
 	ILLutil_start_timer (&timer_solve);
 	rval = QSexact_solver (p_mpq, x_mpq, y_mpq, basis, simplexalgo, &status);
@@ -398,6 +991,19 @@ int main (int ac, char **av)
 		}
 		EGioClose (out_f);
 	}
+	if (certname)
+	{
+		EGioFile_t *out_f = EGioOpen (certname, "w");
+		if (!out_f)
+		{
+			QSlog ("Unable to open %s for writing", certname);
+			rval = 1;
+			goto CLEANUP;
+		}
+		rval = QSexact_write_cert (p_mpq, status, y_mpq, out_f);
+		EGioClose (out_f);
+		CHECKRVALG(rval,CLEANUP);
+	}
 	/* ending */
 CLEANUP:
 	if (printsol) EGfree(solname);
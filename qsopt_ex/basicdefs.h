@@ -157,6 +157,37 @@ typedef struct itcnt_t
 	int tot_iter;
 } itcnt_t;
 
+/** @brief Statistics on how the cached rational LU was brought in sync with
+ * the basis being verified. Costs are predicted in nonzeros touched, actual
+ * costs are in seconds, and both refer to the path that was chosen. */
+typedef struct QSexact_lu_stats
+{
+	int nupdate;									/**< times the eta update path was chosen */
+	int nrefactor;								/**< times a refactorization was chosen */
+	int nfallback;								/**< update path abandoned for a refactorization */
+	int last_mismatch;						/**< basis positions that differed last time */
+	int last_refactor;						/**< one if the last decision was to refactor */
+	double last_predicted_update;	/**< predicted cost of the update path */
+	double last_predicted_refactor;	/**< predicted cost of refactoring */
+	double last_actual;						/**< seconds spent in the chosen path */
+	double total_predicted;				/**< sum of predicted costs of chosen paths */
+	double total_actual;					/**< sum of seconds spent in chosen paths */
+}
+QSexact_lu_stats;
+
+/** @brief The path the last exact solve of a problem took to its answer. */
+typedef struct QSexact_solve_info
+{
+	int race_winner;							/**< bits of the racer that was certified, zero
+																 * for double, -1 if no race settled it */
+	int rung;											/**< last rung of the precision schedule run
+																 * after the double solve, -1 if none */
+	int resumed;									/**< rung resumed from a checkpoint, -1 if
+																 * the solve started from scratch */
+	int nsaved;										/**< checkpoints written */
+}
+QSexact_solve_info;
+
 #ifndef QS_DEFINITIONS
 #define QS_DEFINITIONS
 #define QS_MIN       (1)
@@ -177,6 +208,12 @@ typedef struct itcnt_t
 #define QS_PARAM_SIMPLEX_SCALING   7
 #define QS_PARAM_OBJULIM           8
 #define QS_PARAM_OBJLLIM           9
+#define QS_PARAM_EXACT_BASIS_SOLVER 10
+#define QS_PARAM_EXACT_LU_UPDATE   11
+#define QS_PARAM_EXACT_RACE        12
+#define QS_PARAM_EXACT_RECONSTRUCT 13
+#define QS_PARAM_EXACT_PRECISION_SCHEDULE 14
+#define QS_PARAM_FACTOR_THREADS    15
 
 
 /****************************************************************************/
@@ -196,6 +233,61 @@ typedef struct itcnt_t
 #define QS_PRICE_DDEVEX 9
 
 
+/****************************************************************************/
+/*                                                                          */
+/*               VALUES FOR THE EXACT BASIS SOLVER PARAMETER                */
+/*                                                                          */
+/****************************************************************************/
+
+#define QS_EXACT_BASIS_SOLVER_LU 0
+#define QS_EXACT_BASIS_SOLVER_BAREISS 1
+#define QS_EXACT_BASIS_SOLVER_MODULAR 2
+#define QS_EXACT_BASIS_SOLVER_DIXON 3
+
+
+/****************************************************************************/
+/*                                                                          */
+/*                VALUES FOR THE EXACT LU UPDATE PARAMETER                  */
+/*                                                                          */
+/****************************************************************************/
+
+#define QS_EXACT_LU_UPDATE_ETA 0			/* Forrest-Tomlin updates of the cache */
+#define QS_EXACT_LU_UPDATE_SCHUR 1		/* frozen cache plus Schur complement */
+
+
+/****************************************************************************/
+/*                                                                          */
+/*             VALUES FOR THE EXACT PRECISION RACE PARAMETER                */
+/*                                                                          */
+/****************************************************************************/
+
+#define QS_EXACT_RACE_OFF 0				/* one precision at a time */
+#define QS_EXACT_RACE_MPF128 1		/* double and mpf 128 side by side */
+#define QS_EXACT_RACE_MPF192 2		/* double, mpf 128 and mpf 192 side by side */
+
+
+/****************************************************************************/
+/*                                                                          */
+/*          VALUES FOR THE EXACT RATIONAL RECONSTRUCTION PARAMETER          */
+/*                                                                          */
+/****************************************************************************/
+
+/* the parameter is the largest denominator to snap solution values to */
+#define QS_EXACT_RECONSTRUCT_OFF 0				/* test the solution as computed */
+#define QS_EXACT_RECONSTRUCT_DEFAULT 65536	/* default denominator bound */
+
+
+/****************************************************************************/
+/*                                                                          */
+/*          VALUES FOR THE EXACT PRECISION SCHEDULE PARAMETER               */
+/*                                                                          */
+/****************************************************************************/
+
+#define QS_EXACT_SCHEDULE_FIXED 0		/* run every rung of the schedule */
+#define QS_EXACT_SCHEDULE_SKIP 1		/* skip rungs too short for the element
+																		 * growth seen in the previous one */
+
+
 /****************************************************************************/
 /*                                                                          */
 /*                         VALUES FOR BASIS STATUS                          */
@@ -289,6 +381,7 @@ typedef struct itcnt_t
 #define QS_FACTOR_UPDMAXMULT   15
 #define QS_FACTOR_DENSE_FRACT  16
 #define QS_FACTOR_DENSE_MIN    17
+#define QS_FACTOR_NTHREADS     18
 #define E_CHECK_FAILED 6
 #define E_NO_PIVOT 7
 #define E_FACTOR_BLOWUP 8
@@ -298,6 +391,9 @@ typedef struct itcnt_t
 #define E_SING_NO_DATA 12
 #define E_SINGULAR_INTERNAL 13
 #define SPARSE_FACTOR 0.05
+#define HYPER_FACTOR 0.01			/* solves this sparse go by the reach */
+#define HYPER_DECAY 0.9			/* weight of the old density in the average */
+#define SPIKE_BLOCK_ENTRIES (1 << 18)	/* dense block of ILLfactor_spike_block */
 #define CNT_YNZ           1			/* nz in entering columns */
 #define CNT_ZNZ           2			/* nz in ith row of B^{-1}, ie z_i */
 #define CNT_ZANZ          3			/* nz in ith row of B^{-1}, ie z_i */
@@ -1415,6 +1415,9 @@ int EGLPNUM_TYPENAME_ILLbasis_factor (
 		}
 		rval = EGLPNUM_TYPENAME_ILLfactor_create_factor_work (lp->f, lp->O->nrows);
 		CHECKRVALG (rval, CLEANUP);
+		rval = EGLPNUM_TYPENAME_ILLfactor_set_factor_iparam (lp->f, QS_FACTOR_NTHREADS,
+																				lp->factor_threads);
+		CHECKRVALG (rval, CLEANUP);
 
 		rval = EGLPNUM_TYPENAME_ILLfactor (lp->f, lp->baz, lp->matbeg, lp->matcnt,
 											lp->matind, lp->matval, &nsing, &singr, &singc);
@@ -1498,6 +1501,163 @@ void EGLPNUM_TYPENAME_ILLbasis_row_solve (
 	EGLPNUM_TYPENAME_ILLfactor_btran (lp->f, rhs, soln);
 }
 
+void EGLPNUM_TYPENAME_ILLbasis_column_solve_multi (
+	EGLPNUM_TYPENAME_lpinfo * lp,
+	int k,
+	EGLPNUM_TYPENAME_svector * rhs,
+	EGLPNUM_TYPENAME_svector * soln)
+{
+	EGLPNUM_TYPENAME_ILLfactor_ftran_multi (lp->f, k, rhs, soln);
+}
+
+void EGLPNUM_TYPENAME_ILLbasis_row_solve_multi (
+	EGLPNUM_TYPENAME_lpinfo * lp,
+	int k,
+	EGLPNUM_TYPENAME_svector * rhs,
+	EGLPNUM_TYPENAME_svector * soln)
+{
+	EGLPNUM_TYPENAME_ILLfactor_btran_multi (lp->f, k, rhs, soln);
+}
+
+/* ========================================================================= */
+/** @brief estimate the 1-norm condition number of the current basis.
+ * @param lp the lp whose basis we look at, it is factored if needed.
+ * @param cond where we return the estimate of
+ * \f$\|B\|_1\|B^{-1}\|_1\f$, a lower bound on the true value.
+ * @return zero on success, non-zero otherwise.
+ * @note \f$\|B^{-1}\|_1\f$ is estimated with Hager's method as refined by
+ * Higham (ACM TOMS 14, 1988), it costs at most #BASIS_COND_ITER FTRAN/BTRAN
+ * pairs plus one more FTRAN, and all norms are accumulated in double. */
+#define BASIS_COND_ITER 5
+int EGLPNUM_TYPENAME_ILLbasis_condition (
+	EGLPNUM_TYPENAME_lpinfo * lp,
+	double *cond)
+{
+	int rval = 0;
+	int i, k, it;
+	int j = -1, jold;
+	int singular = 0;
+	int const n = lp->nrows;
+	double d, colsum, ztx, zmax;
+	double bnorm = 0.0, est = 0.0, ynorm;
+	EGLPNUM_TYPENAME_svector x, y;
+
+	EGLPNUM_TYPENAME_ILLsvector_init (&x);
+	EGLPNUM_TYPENAME_ILLsvector_init (&y);
+	*cond = 1.0;
+
+	if (lp->basisid == -1)
+	{
+		QSlog("EGLPNUM_TYPENAME_ILLbasis_condition: no basis");
+		rval = E_GENERAL_ERROR;
+		ILL_CLEANUP;
+	}
+	if (n == 0)
+		ILL_CLEANUP;
+	if (lp->fbasisid != lp->basisid)
+	{
+		rval = EGLPNUM_TYPENAME_ILLbasis_factor (lp, &singular);
+		CHECKRVALG (rval, CLEANUP);
+		if (singular)
+		{
+			MESSAGE (__QS_SB_VERB, "Singular Basis found!");
+			rval = E_BASIS_SINGULAR;
+			ILL_CLEANUP;
+		}
+	}
+
+	/* ||B||_1 is the largest column sum among the basic columns */
+	for (i = 0; i < n; i++)
+	{
+		colsum = 0.0;
+		for (k = lp->matbeg[lp->baz[i]];
+				 k < lp->matbeg[lp->baz[i]] + lp->matcnt[lp->baz[i]]; k++)
+			colsum += fabs (EGLPNUM_TYPENAME_EGlpNumToLf (lp->matval[k]));
+		if (colsum > bnorm)
+			bnorm = colsum;
+	}
+
+	rval = EGLPNUM_TYPENAME_ILLsvector_alloc (&x, n);
+	CHECKRVALG (rval, CLEANUP);
+	rval = EGLPNUM_TYPENAME_ILLsvector_alloc (&y, n);
+	CHECKRVALG (rval, CLEANUP);
+
+	/* Hager's iteration, starting from x = e/n */
+	x.nzcnt = n;
+	for (i = 0; i < n; i++)
+	{
+		x.indx[i] = i;
+		EGLPNUM_TYPENAME_EGlpNumSet (x.coef[i], 1.0 / n);
+	}
+	for (it = 0; it < BASIS_COND_ITER; it++)
+	{
+		jold = j;
+		EGLPNUM_TYPENAME_ILLfactor_ftran (lp->f, &x, &y);
+		ynorm = 0.0;
+		for (i = 0; i < y.nzcnt; i++)
+			ynorm += fabs (EGLPNUM_TYPENAME_EGlpNumToLf (y.coef[i]));
+		if (it && ynorm <= est)
+			break;
+		est = ynorm;
+		/* x = sign(y), zero entries counting as positive */
+		x.nzcnt = n;
+		for (i = 0; i < n; i++)
+		{
+			x.indx[i] = i;
+			EGLPNUM_TYPENAME_EGlpNumOne (x.coef[i]);
+		}
+		for (i = 0; i < y.nzcnt; i++)
+			if (EGLPNUM_TYPENAME_EGlpNumToLf (y.coef[i]) < 0)
+				EGLPNUM_TYPENAME_EGlpNumSet (x.coef[y.indx[i]], -1.0);
+		EGLPNUM_TYPENAME_ILLfactor_btran (lp->f, &x, &y);
+		/* z = y now, look for its largest entry and for z'x_old */
+		zmax = -1.0;
+		ztx = 0.0;
+		for (i = 0; i < y.nzcnt; i++)
+		{
+			d = EGLPNUM_TYPENAME_EGlpNumToLf (y.coef[i]);
+			if (fabs (d) > zmax)
+			{
+				zmax = fabs (d);
+				j = y.indx[i];
+			}
+			if (jold == -1)
+				ztx += d / n;
+			else if (y.indx[i] == jold)
+				ztx = d;
+		}
+		if (zmax < 0 || j == jold || zmax <= ztx)
+			break;
+		x.nzcnt = 1;
+		x.indx[0] = j;
+		EGLPNUM_TYPENAME_EGlpNumOne (x.coef[0]);
+	}
+
+	/* Higham's safeguard, b_i = (-1)^i (1 + i/(n-1)) */
+	x.nzcnt = n;
+	for (i = 0; i < n; i++)
+	{
+		x.indx[i] = i;
+		d = 1.0 + (n > 1 ? (double) i / (n - 1) : 0.0);
+		EGLPNUM_TYPENAME_EGlpNumSet (x.coef[i], (i & 1) ? -d : d);
+	}
+	EGLPNUM_TYPENAME_ILLfactor_ftran (lp->f, &x, &y);
+	ynorm = 0.0;
+	for (i = 0; i < y.nzcnt; i++)
+		ynorm += fabs (EGLPNUM_TYPENAME_EGlpNumToLf (y.coef[i]));
+	ynorm = 2.0 * ynorm / (3.0 * n);
+	if (ynorm > est)
+		est = ynorm;
+
+	*cond = bnorm * est;
+
+CLEANUP:
+
+	EGLPNUM_TYPENAME_ILLsvector_free (&x);
+	EGLPNUM_TYPENAME_ILLsvector_free (&y);
+	EG_RETURN (rval);
+}
+
 int EGLPNUM_TYPENAME_ILLbasis_update (
 	EGLPNUM_TYPENAME_lpinfo * lp,
 	EGLPNUM_TYPENAME_svector * y,
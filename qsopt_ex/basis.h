@@ -75,7 +75,10 @@ int EGLPNUM_TYPENAME_ILLbasis_build_basisinfo (
 	EGLPNUM_TYPENAME_svector * y,
 	int lindex,
 	int *refactor,
-	int *singular);
+	int *singular),
+  EGLPNUM_TYPENAME_ILLbasis_condition (
+	EGLPNUM_TYPENAME_lpinfo * lp,
+	double *cond);
 
 void EGLPNUM_TYPENAME_ILLbasis_column_solve (
 	EGLPNUM_TYPENAME_lpinfo * lp,
@@ -90,6 +93,16 @@ void EGLPNUM_TYPENAME_ILLbasis_column_solve (
 	EGLPNUM_TYPENAME_lpinfo * lp,
 	EGLPNUM_TYPENAME_svector * rhs,
 	EGLPNUM_TYPENAME_svector * soln),
+  EGLPNUM_TYPENAME_ILLbasis_column_solve_multi (
+	EGLPNUM_TYPENAME_lpinfo * lp,
+	int k,
+	EGLPNUM_TYPENAME_svector * rhs,
+	EGLPNUM_TYPENAME_svector * soln),
+  EGLPNUM_TYPENAME_ILLbasis_row_solve_multi (
+	EGLPNUM_TYPENAME_lpinfo * lp,
+	int k,
+	EGLPNUM_TYPENAME_svector * rhs,
+	EGLPNUM_TYPENAME_svector * soln),
   EGLPNUM_TYPENAME_ILLbasis_free_basisinfo (
 	EGLPNUM_TYPENAME_lpinfo * lp),
   EGLPNUM_TYPENAME_ILLbasis_free_fbasisinfo (
@@ -31,6 +31,8 @@
 #include <stdarg.h>
 #include <string.h>
 #include <errno.h>
+#include <stdint.h>
+#include <sys/stat.h>
 
 #ifdef HAVE_LIBBZ2
 # include <bzlib.h>
@@ -636,6 +638,108 @@ char* EGioGets(char*buf, int len, EGioFile_t*file)
 	}
 }
 /* ========================================================================= */
+/** @brief largest chunk handed to the compression libraries in one call, they
+ * take int/unsigned lengths */
+#define EGIO_CHUNK ((size_t)1<<30)
+/* ========================================================================= */
+size_t EGioFwrite(const void*buf, size_t len, EGioFile_t*file)
+{
+	const char*b = (const char*)buf;
+	size_t done = 0, sz;
+	int rval;
+	switch(file->type)
+	{
+		case EGIO_PLAIN:
+			return fwrite(buf,(size_t)1,len,(FILE*)(file->file));
+		case EGIO_ZLIB:
+#ifdef HAVE_LIBZ
+			while(done < len)
+			{
+				sz = len - done > EGIO_CHUNK ? EGIO_CHUNK : len - done;
+				rval = gzwrite((gzFile)(file->file),b+done,(unsigned)sz);
+				if(rval <= 0) break;
+				done += (size_t)rval;
+			}
+			return done;
+#else
+			QSlog("no zlib support");
+			return 0;
+#endif
+		case EGIO_BZLIB:
+#ifdef HAVE_LIBBZ2
+			while(done < len)
+			{
+				sz = len - done > EGIO_CHUNK ? EGIO_CHUNK : len - done;
+				rval = BZ2_bzwrite((BZFILE*)(file->file),(void*)(b+done),(int)sz);
+				if(rval <= 0) break;
+				done += (size_t)rval;
+			}
+			return done;
+#else
+			QSlog("no bzip2 support");
+			return 0;
+#endif
+		default:
+			QSlog("UNKNOWN FILE TYPE %d", file->type);
+			return 0;
+	}
+}
+/* ========================================================================= */
+size_t EGioFread(void*buf, size_t len, EGioFile_t*file)
+{
+	char*b = (char*)buf;
+	size_t done = 0, sz;
+	int rval;
+	switch(file->type)
+	{
+		case EGIO_PLAIN:
+			return fread(buf,(size_t)1,len,(FILE*)(file->file));
+		case EGIO_ZLIB:
+#ifdef HAVE_LIBZ
+			while(done < len)
+			{
+				sz = len - done > EGIO_CHUNK ? EGIO_CHUNK : len - done;
+				rval = gzread((gzFile)(file->file),b+done,(unsigned)sz);
+				if(rval <= 0) break;
+				done += (size_t)rval;
+			}
+			return done;
+#else
+			QSlog("no zlib support");
+			return 0;
+#endif
+		case EGIO_BZLIB:
+#ifdef HAVE_LIBBZ2
+			while(done < len)
+			{
+				sz = len - done > EGIO_CHUNK ? EGIO_CHUNK : len - done;
+				rval = BZ2_bzread((BZFILE*)(file->file),b+done,(int)sz);
+				if(rval <= 0) break;
+				done += (size_t)rval;
+			}
+			return done;
+#else
+			QSlog("no bzip2 support");
+			return 0;
+#endif
+		default:
+			QSlog("UNKNOWN FILE TYPE %d", file->type);
+			return 0;
+	}
+}
+/* ========================================================================= */
+size_t EGioLeft(const EGioFile_t*const file)
+{
+	struct stat st;
+	long pos;
+	if(file->type != EGIO_PLAIN) return SIZE_MAX;
+	pos = ftell((FILE*)(file->file));
+	if(pos < 0 || fstat(fileno((FILE*)(file->file)),&st) || !S_ISREG(st.st_mode) ||
+		 st.st_size < (off_t)pos)
+		return SIZE_MAX;
+	return (size_t)(st.st_size - (off_t)pos);
+}
+/* ========================================================================= */
 int EGioEof(const EGioFile_t*const file)
 {
 	int err;
@@ -293,6 +293,22 @@ int EGioFlush(EGioFile_t*file);
  * */
 char* EGioGets(char*buf, int len, EGioFile_t*file);
 /* ========================================================================= */
+/** @brief write len raw bytes from buf into the file, as fwrite (and unlike
+ * #EGioWrite, that only handles short null terminated strings).
+ * @return the number of bytes actually written. */
+size_t EGioFwrite(const void*buf, size_t len, EGioFile_t*file);
+/* ========================================================================= */
+/** @brief read up to len raw bytes from the file into buf, as fread.
+ * @return the number of bytes actually read, less than len only at the end of
+ * the file or on error. */
+size_t EGioFread(void*buf, size_t len, EGioFile_t*file);
+/* ========================================================================= */
+/** @brief bound the number of bytes that can still be read from the file.
+ * @return the bytes between the current position and the end of a plain
+ * regular file, or SIZE_MAX when that is not known (compressed files, pipes).
+ * */
+size_t EGioLeft(const EGioFile_t*const file);
+/* ========================================================================= */
 /** @brief Test if the given file stream pointer point to the end of file.
  * @return non-zero if stream pointer points to end of file, 0 otherwise.
  * */
@@ -71,17 +71,23 @@ mpq_t __zeroLpNum_mpq__;
 mpq_t __oneLpNum_mpq__;
 mpq_t __MaxLpNum_mpq__;
 mpq_t __MinLpNum_mpq__;
-mpf_t __zeroLpNum_mpf__;
-mpf_t __MaxLpNum_mpf__;
-mpf_t __MinLpNum_mpf__;
-mpf_t __oneLpNum_mpf__;
-mpf_t mpf_eps;
-unsigned long int EGLPNUM_PRECISION = 128;
+/* thread local, as EGLPNUM_TLS in eg_lpnum.h (not included here), so that
+ * they carry the precision of the thread using them */
+__thread mpf_t __zeroLpNum_mpf__;
+__thread mpf_t __MaxLpNum_mpf__;
+__thread mpf_t __MinLpNum_mpf__;
+__thread mpf_t __oneLpNum_mpf__;
+__thread mpf_t mpf_eps;
+__thread unsigned long int EGLPNUM_PRECISION = 128;
 
 /** @} */
 
 /* ========================================================================= */
+/* from eg_lpnum.dbl.h, see #dbl_EGlpNumDenseAxpy */
+void dbl_EGlpNumDenseStart (void);
 static int __EGlpNum_setup=0;
+/** @brief set once the calling thread has its own mpf_eps */
+static __thread int __EGlpNum_thread_setup=0;
 /* ========================================================================= */
 /** @name data to handle memory allocations within gmp */
 /** @{*/
@@ -255,6 +261,37 @@ static void __EGgmp_free(void*ptr,size_t sz)
 	}
 }
 
+/* ========================================================================= */
+/** @brief initialize the mpf constants and mpf_eps of the calling thread at
+ * #EGLPNUM_PRECISION bits */
+static void __EGlpNumInitThreadConstants(void)
+{
+	mpf_init2 (__MaxLpNum_mpf__, EGLPNUM_PRECISION);
+	mpf_init2 (__MinLpNum_mpf__, EGLPNUM_PRECISION);
+	mpf_init2 (__zeroLpNum_mpf__, EGLPNUM_PRECISION);
+	mpf_init2 (__oneLpNum_mpf__, EGLPNUM_PRECISION);
+	mpf_init2 (mpf_eps, EGLPNUM_PRECISION);
+	mpf_set_ui(__MaxLpNum_mpf__,1UL);
+	mpf_set_si(__MinLpNum_mpf__,-1L);
+	mpf_mul_2exp(__MaxLpNum_mpf__,__MaxLpNum_mpf__,4096);
+	mpf_mul_2exp(__MinLpNum_mpf__,__MinLpNum_mpf__,4096);
+	mpf_set_ui (__oneLpNum_mpf__, (unsigned long int)1);
+	mpf_set_ui (__zeroLpNum_mpf__, (unsigned long int)0);
+	mpf_set_ui (mpf_eps, (unsigned long int)1);
+	mpf_div_2exp (mpf_eps, mpf_eps,  (unsigned long int)(EGLPNUM_PRECISION - 1));
+}
+
+/* ========================================================================= */
+/** @brief release what #__EGlpNumInitThreadConstants set up */
+static void __EGlpNumClearThreadConstants(void)
+{
+	mpf_clear (__MaxLpNum_mpf__);
+	mpf_clear (__MinLpNum_mpf__);
+	mpf_clear (__zeroLpNum_mpf__);
+	mpf_clear (__oneLpNum_mpf__);
+	mpf_clear (mpf_eps);
+}
+
 /* ========================================================================= */
 /*void EGlpNumStart(void) __attribute__ ((constructor));*/
 void EGlpNumStart(void)
@@ -273,6 +310,7 @@ void EGlpNumStart(void)
 		mp_set_memory_functions(__EGgmp_malloc, __EGgmp_realloc, __EGgmp_free);
 	}
 
+	dbl_EGlpNumDenseStart ();
 	mpf_set_default_prec (EGLPNUM_PRECISION); // AP: set to 128 at the beginning
 	mpz_init (__zeroLpNum_mpz__);
 	mpz_init (__oneLpNum_mpz__);
@@ -282,24 +320,12 @@ void EGlpNumStart(void)
 	mpz_set_ui (__oneLpNum_mpz__, (unsigned long int)1);
 	mpq_init (__MaxLpNum_mpq__);
 	mpq_init (__MinLpNum_mpq__);
-	mpf_init (__MaxLpNum_mpf__);
-	mpf_init (__MinLpNum_mpf__);
-	mpf_init (__zeroLpNum_mpf__);
-	mpf_init (__oneLpNum_mpf__);
-	mpf_set_ui(__MaxLpNum_mpf__,1UL);
-	mpf_set_si(__MinLpNum_mpf__,-1L);
-	mpf_mul_2exp(__MaxLpNum_mpf__,__MaxLpNum_mpf__,4096);
-	/*mpf_mul_2exp(__MaxLpNum_mpf__,__MaxLpNum_mpf__,ULONG_MAX);*/
-	mpf_mul_2exp(__MinLpNum_mpf__,__MinLpNum_mpf__,4096);
-	/*mpf_mul_2exp(__MinLpNum_mpf__,__MinLpNum_mpf__,ULONG_MAX);*/
+	__EGlpNumInitThreadConstants ();
+	__EGlpNum_thread_setup=1;
 	mpq_set_f(__MaxLpNum_mpq__,__MaxLpNum_mpf__);
 	mpq_set_f(__MinLpNum_mpq__,__MinLpNum_mpf__);
 	mpz_set_f(__MaxLpNum_mpz__,__MaxLpNum_mpf__);
 	mpz_set_f(__MinLpNum_mpz__,__MinLpNum_mpf__);
-	mpf_set_ui (__oneLpNum_mpf__, (unsigned long int)1);
-	mpf_set_ui (__zeroLpNum_mpf__, (unsigned long int)0);
-	mpf_init_set_ui (mpf_eps, (unsigned long int)1);
-	mpf_div_2exp (mpf_eps, mpf_eps,  (unsigned long int)(EGLPNUM_PRECISION - 1));
 	mpq_init (__zeroLpNum_mpq__);
 	mpq_init (__oneLpNum_mpq__);
 	mpq_set_ui (__oneLpNum_mpq__, (unsigned long int)1, (unsigned long int)1);
@@ -307,14 +333,42 @@ void EGlpNumStart(void)
 	__EGlpNum_setup=1;
 }
 
+/* ========================================================================= */
+/* declared in eg_lpnum.h, which can't be included here */
+void EGlpNumThreadStart (const unsigned prec);
+
 /* ========================================================================= */
 void EGlpNumSetPrecision (const unsigned prec)
 {
+	if(!__EGlpNum_thread_setup)
+	{
+		EGlpNumThreadStart (prec);
+		return;
+	}
 	EGLPNUM_PRECISION = prec;
-	mpf_set_default_prec (EGLPNUM_PRECISION);
-	mpf_clear (mpf_eps);
-	mpf_init_set_ui (mpf_eps, (unsigned long int)1);
-	mpf_div_2exp (mpf_eps, mpf_eps,  (unsigned long int)(EGLPNUM_PRECISION - 1));
+	__EGlpNumClearThreadConstants ();
+	__EGlpNumInitThreadConstants ();
+}
+
+/* ========================================================================= */
+void EGlpNumThreadStart (const unsigned prec)
+{
+	if(__EGlpNum_thread_setup)
+	{
+		EGlpNumSetPrecision (prec);
+		return;
+	}
+	EGLPNUM_PRECISION = prec;
+	__EGlpNumInitThreadConstants ();
+	__EGlpNum_thread_setup=1;
+}
+
+/* ========================================================================= */
+void EGlpNumThreadClear (void)
+{
+	if(!__EGlpNum_thread_setup) return;
+	__EGlpNumClearThreadConstants ();
+	__EGlpNum_thread_setup=0;
 }
 
 /* ========================================================================= */
@@ -326,11 +380,7 @@ void EGlpNumClear(void)
 	#endif
 	int i;
 	if(!__EGlpNum_setup) return;
-	mpf_clear (__zeroLpNum_mpf__);
-	mpf_clear (__oneLpNum_mpf__);
-	mpf_clear (__MaxLpNum_mpf__);
-	mpf_clear (__MinLpNum_mpf__);
-	mpf_clear (mpf_eps);
+	EGlpNumThreadClear ();
 	mpq_clear (__zeroLpNum_mpq__);
 	mpq_clear (__oneLpNum_mpq__);
 	mpq_clear (__MinLpNum_mpq__);
@@ -392,7 +442,7 @@ void mpq_EGlpNumSet_mpf (mpq_t var,
 	int i;
 	unsigned long int uexp;
 	mpf_t __cvl,__lpnum__;
-	mpf_init(__lpnum__);
+	mpf_init2(__lpnum__, EGLPNUM_PRECISION);
 	/* check if the given number is zero, if so, set to zero var and return */
 	if (mpf_cmp_ui (flt, (unsigned long int)0) == 0)
 	{
@@ -401,7 +451,7 @@ void mpq_EGlpNumSet_mpf (mpq_t var,
 	}
 	/* if not, then we have some work to do */
 	/* now we initialize the internal numbers */
-	mpf_init (__cvl);
+	mpf_init2 (__cvl, EGLPNUM_PRECISION);
 	mpf_abs (__cvl, flt);
 	mpz_init_set_ui (__utmp, (unsigned long int)0);
 	for (i = 7; i--;)
@@ -38,6 +38,10 @@
 #define dbl_epsLpNum  DBL_EPSILON
 #define dbl_MaxLpNum	DBL_MAX
 #define dbl_MinLpNum	DBL_MIN
+/** storage class of the dbl tolerances, they are shared by all threads */
+#define dbl_EGlpNumTLS
+/** set if the precision of the numbers depends on #EGLPNUM_PRECISION */
+#define dbl_EGlpNumHasPrecision 0
 
 /* ========================================================================= */
 /** @brief Read from a string a number and store it in the given double, 
@@ -483,6 +487,45 @@
 /** @brief free the internal memory of a given variable */
 #define dbl_EGlpNumClearVar(a)
 
+/* ========================================================================= */
+/** @name Exact dot products
+ * Same interface as #mpq_EGlpNumDot_t, for doubles it is a plain sum. */
+/** @{ */
+typedef double dbl_EGlpNumDot_t;
+#define dbl_EGlpNumDotInit(acc) ((acc) = 0.0)
+#define dbl_EGlpNumDotClear(acc)
+#define dbl_EGlpNumDotZero(acc) ((acc) = 0.0)
+#define dbl_EGlpNumDotAdd(acc,a) ((acc) += (a))
+#define dbl_EGlpNumDotAddProd(acc,a,b) ((acc) += (a)*(b))
+#define dbl_EGlpNumDotSubProd(acc,a,b) ((acc) -= (a)*(b))
+#define dbl_EGlpNumDotAddDot(acc,b) ((acc) += (b))
+#define dbl_EGlpNumDotSubDot(acc,b) ((acc) -= (b))
+#define dbl_EGlpNumDotGet(res,acc) ((res) = (acc))
+#define dbl_EGlpNumDotAllocArray(size) dbl_EGlpNumAllocArray(size)
+#define dbl_EGlpNumDotFreeArray(ea) dbl_EGlpNumFreeArray(ea)
+/** @} */
+
+/* ========================================================================= */
+/** @name Dense kernels
+ * Vectorized loops used by the dense tail of the LU factorization, they give
+ * bit for bit the same results as the plain loops. Only defined for doubles,
+ * the template code tests EGLPNUM_TYPENAME_EGLPNUM_DENSE_KERNEL to use them. */
+/** @{ */
+#define dbl_EGLPNUM_DENSE_KERNEL 1
+/* ========================================================================= */
+/** @brief set \f$w_j \leftarrow w_j - v p_j\f$ for \f$0\leq j<n\f$.
+ * @return \f$\max_j |w_j|\f$ after the update (zero if n is zero).
+ * @note uses AVX-512 or AVX2 when the running processor has them. */
+double dbl_EGlpNumDenseAxpy (double *const w,
+														 const double *const p,
+														 const double v,
+														 const int n);
+/* ========================================================================= */
+/** @brief choose the version of #dbl_EGlpNumDenseAxpy for the running
+ * processor, called once from #EGlpNumStart before any thread can use it. */
+void dbl_EGlpNumDenseStart (void);
+/** @} */
+
 /* ========================================================================= */
 /** @} */
 #endif
@@ -198,6 +198,13 @@ extern const mpz_t __MinLpNum_mpz__;
 #define mpz_MaxLpNum  __MaxLpNum_mpz__
 #define mpz_MinLpNum  __MinLpNum_mpz__
 
+/* ========================================================================= */
+/** @brief storage class of the precision dependent state (the current mpf
+ * precision, mpf_eps and the mpf tolerances), each thread keeps its own copy
+ * so that several mpf precisions can run side by side, see
+ * #EGlpNumThreadStart. */
+#define EGLPNUM_TLS __thread
+
 #include "eg_lpnum.dbl.h"
 #include "eg_lpnum.mpq.h"
 #include "eg_lpnum.mpf.h"
@@ -214,12 +221,27 @@ extern const mpz_t __MinLpNum_mpz__;
 /** @brief Set the default number of __BITS__ used in the precision of the
  * float point numbers (mpf_t), a normal double use up to 56-64 bits., the 
  * default precision is set to 128 */
-extern unsigned long int EGLPNUM_PRECISION;
+extern EGLPNUM_TLS unsigned long int EGLPNUM_PRECISION;
 
 /* ========================================================================= */
-/** @brief Change the default precision for mpf_t numbers. */
+/** @brief Change the precision used for mpf_t numbers initialized afterwards
+ * by the calling thread (and its mpf_eps). Other threads, and the default GMP
+ * precision, are not affected; a thread that never called
+ * #EGlpNumThreadStart is set up on the fly. */
 void EGlpNumSetPrecision (const unsigned prec);
 
+/* ========================================================================= */
+/** @brief Set up the precision dependent state of a thread other than the one
+ * that called #EGlpNumStart, all mpf_t numbers initialized afterwards by this
+ * thread use prec bits. The default GMP precision is not touched.
+ * @param prec number of bits for this thread. */
+void EGlpNumThreadStart (const unsigned prec);
+
+/* ========================================================================= */
+/** @brief Release the state set up by #EGlpNumThreadStart, must be called by
+ * the same thread before it exits. */
+void EGlpNumThreadClear (void);
+
 /* ========================================================================= */
 /** @brief Allocate an array of a given type and store (sizeof(size_t) bytes 
  * before the actual array) the size of the allocated array. 
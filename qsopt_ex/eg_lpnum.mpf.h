@@ -35,19 +35,24 @@
 /** @brief This is the smallest difference (with the current precision) that can
  * be distinguished betwen 1.0 and it's clossest representable number, in some
  * sense it is the absolute minimum epsilon for comparisons */
-extern mpf_t mpf_eps;
+extern EGLPNUM_TLS mpf_t mpf_eps;
 
 /* ========================================================================= */
 /** extern definitions of constaants for different set-ups */
-extern const mpf_t __zeroLpNum_mpf__;
-extern const mpf_t __oneLpNum_mpf__;
-extern const mpf_t __MaxLpNum_mpf__;
-extern const mpf_t __MinLpNum_mpf__;
+extern EGLPNUM_TLS const mpf_t __zeroLpNum_mpf__;
+extern EGLPNUM_TLS const mpf_t __oneLpNum_mpf__;
+extern EGLPNUM_TLS const mpf_t __MaxLpNum_mpf__;
+extern EGLPNUM_TLS const mpf_t __MinLpNum_mpf__;
 #define mpf_zeroLpNum __zeroLpNum_mpf__
 #define mpf_oneLpNum  __oneLpNum_mpf__
 #define mpf_epsLpNum  mpf_eps
 #define mpf_MaxLpNum  __MaxLpNum_mpf__
 #define mpf_MinLpNum  __MinLpNum_mpf__
+/** storage class of the mpf tolerances, they depend on the precision and so
+ * each thread keeps its own copy */
+#define mpf_EGlpNumTLS EGLPNUM_TLS
+/** set if the precision of the numbers depends on #EGLPNUM_PRECISION */
+#define mpf_EGlpNumHasPrecision 1
 
 /* ========================================================================= */
 /** @brief Given a double exp, compute \f$ e^{exp} \f$ and store it in the given
@@ -59,11 +64,14 @@ extern const mpf_t __MinLpNum_mpf__;
 	unsigned int __i = 0;\
 	int __lsgn = (exp)<0 ? 1:0;\
 	mpf_t __ntmp,__res,__lexp,__err;\
-	mpf_init_set_d(__lexp,exp);\
+	mpf_EGlpNumInitVar(__lexp);\
+	mpf_set_d(__lexp,exp);\
 	if(__lsgn) mpf_neg(__lexp,__lexp);\
-	mpf_init_set_ui(__ntmp,(unsigned long int)1);\
-	mpf_init_set_ui(__res,(unsigned long int)1);\
-	mpf_init(__err);\
+	mpf_EGlpNumInitVar(__ntmp);\
+	mpf_set_ui(__ntmp,(unsigned long int)1);\
+	mpf_EGlpNumInitVar(__res);\
+	mpf_set_ui(__res,(unsigned long int)1);\
+	mpf_EGlpNumInitVar(__err);\
 	mpf_div(__err,__ntmp,__res);\
 	while(mpf_cmp(__err,mpf_eps)>0)\
 	{\
@@ -147,7 +155,7 @@ extern const mpf_t __MinLpNum_mpf__;
 			__ntmp__[0] = __sz__; \
 			__ntmp__++; \
 			*__ptr__ = (mpf_t *) __ntmp__; \
-			for (; __psz__ < __sz__; __psz__++) mpf_init ((*__ptr__)[__psz__]); \
+			for (; __psz__ < __sz__; __psz__++) mpf_EGlpNumInitVar((*__ptr__)[__psz__]); \
 		} \
 	} \
 })
@@ -158,7 +166,7 @@ extern const mpf_t __MinLpNum_mpf__;
 #define mpf_EGlpNumAllocArray(size) ({\
 	size_t __i__ = (size);\
 	mpf_t *__res = __EGlpNumAllocArray(mpf_t,__i__);\
-	while(__i__--) mpf_init(__res[__i__]);\
+	while(__i__--) mpf_EGlpNumInitVar(__res[__i__]);\
 	__res;})
 
 /* ========================================================================= */
@@ -213,7 +221,7 @@ extern const mpf_t __MinLpNum_mpf__;
  * return 1 if |a-b|<= __error, otherwise it return 0.
  * */
 #define mpf_EGlpNumIsEqual(a,b,__error) ({\
-	mpf_t __lpnum__;int __res__=0;mpf_init(__lpnum__);\
+	mpf_t __lpnum__;int __res__=0;mpf_EGlpNumInitVar(__lpnum__);\
 	mpf_sub (__lpnum__, a, b);\
 	mpf_abs (__lpnum__, __lpnum__);\
 	__res__=(mpf_cmp (__lpnum__, __error) <= 0);\
@@ -222,7 +230,7 @@ extern const mpf_t __MinLpNum_mpf__;
 })
 
 #define mpf_EGlpNumIsNeq(a,b,__error) ({\
-	mpf_t __lpnum__;int __res__=0;mpf_init(__lpnum__);\
+	mpf_t __lpnum__;int __res__=0;mpf_EGlpNumInitVar(__lpnum__);\
 	mpf_sub (__lpnum__, a, b);\
 	mpf_abs (__lpnum__, __lpnum__);\
 	__res__=(mpf_cmp (__lpnum__, __error) > 0);\
@@ -231,7 +239,7 @@ extern const mpf_t __MinLpNum_mpf__;
 })
 
 #define mpf_EGlpNumIsNeqZero(a,__error) ({\
-	mpf_t __lpnum__;int __res__=0;mpf_init(__lpnum__);\
+	mpf_t __lpnum__;int __res__=0;mpf_EGlpNumInitVar(__lpnum__);\
 	mpf_abs (__lpnum__, a);\
 	__res__=(mpf_cmp (__lpnum__, __error) > 0);\
 	mpf_clear(__lpnum__);\
@@ -277,7 +285,7 @@ extern const mpf_t __MinLpNum_mpf__;
  * Given a,b, and c, return nonzero if (a + b < c), zero toherwise.
  * */
 #define mpf_EGlpNumIsSumLess(a, b, c) ({\
-	mpf_t __lpnum__;int __res__=0;mpf_init(__lpnum__);\
+	mpf_t __lpnum__;int __res__=0;mpf_EGlpNumInitVar(__lpnum__);\
 	mpf_add (__lpnum__, a, b);\
 	__res__=(mpf_cmp (__lpnum__, c) < 0);\
 	mpf_clear(__lpnum__);\
@@ -295,7 +303,7 @@ extern const mpf_t __MinLpNum_mpf__;
  * Given a,b, and c, return nonzero if (a - b < c), zero toherwise.
  * */
 #define mpf_EGlpNumIsDiffLess(a, b, c) ({\
-	mpf_t __lpnum__;int __res__=0;mpf_init(__lpnum__);\
+	mpf_t __lpnum__;int __res__=0;mpf_EGlpNumInitVar(__lpnum__);\
 	mpf_sub (__lpnum__, a, b);\
 	__res__=(mpf_cmp (__lpnum__, c) < 0);\
 	mpf_clear(__lpnum__);\
@@ -384,13 +392,13 @@ extern const mpf_t __MinLpNum_mpf__;
  * implement dest = max(dest,abs(orig))
  * */
 #define mpf_EGlpNumSetToMaxAbs(dest, orig) ({\
-	mpf_t __lpnum__;mpf_init(__lpnum__);\
+	mpf_t __lpnum__;mpf_EGlpNumInitVar(__lpnum__);\
 	mpf_abs (__lpnum__, orig);\
 	if (mpf_cmp (dest, __lpnum__) < 0) mpf_set (dest, __lpnum__);\
 	mpf_clear(__lpnum__);})
 
 #define mpf_EGlpNumSetToMinAbs(dest, orig) ({\
-	mpf_t __lpnum__;mpf_init(__lpnum__);\
+	mpf_t __lpnum__;mpf_EGlpNumInitVar(__lpnum__);\
 	mpf_abs (__lpnum__, orig);\
 	if (mpf_cmp (dest, __lpnum__) > 0) mpf_set (dest, __lpnum__);\
 	mpf_clear(__lpnum__);})
@@ -475,7 +483,7 @@ extern const mpf_t __MinLpNum_mpf__;
  * stored in 'b' nor in 'c'.
  * */
 #define mpf_EGlpNumSubInnProdTo(a, b, c) ({\
-	mpf_t __lpnum__;mpf_init(__lpnum__);\
+	mpf_t __lpnum__;mpf_EGlpNumInitVar(__lpnum__);\
 	mpf_mul (__lpnum__, b, c);\
 	mpf_sub (a, a, __lpnum__);\
 	mpf_clear(__lpnum__);\
@@ -491,7 +499,7 @@ extern const mpf_t __MinLpNum_mpf__;
  * stored in 'b' nor in 'c'.
  * */
 #define mpf_EGlpNumAddInnProdTo(a, b, c) ({\
-	mpf_t __lpnum__;mpf_init(__lpnum__);\
+	mpf_t __lpnum__;mpf_EGlpNumInitVar(__lpnum__);\
 	mpf_mul (__lpnum__, b, c);\
 	mpf_add (a, a, __lpnum__);\
 	mpf_clear(__lpnum__);\
@@ -616,13 +624,32 @@ extern const mpf_t __MinLpNum_mpf__;
 #define mpf_EGlpNumToLf(a) mpf_get_d(a)
 
 /* ========================================================================= */
-/** @brief initialize the internal memory of a given variable */
-#define mpf_EGlpNumInitVar(a) mpf_init(a)
+/** @brief initialize the internal memory of a given variable, with the
+ * precision of the calling thread */
+#define mpf_EGlpNumInitVar(a) mpf_init2(a,EGLPNUM_PRECISION)
 
 /* ========================================================================= */
 /** @brief free the internal memory of a given variable */
 #define mpf_EGlpNumClearVar(a) mpf_clear(a)
 
+/* ========================================================================= */
+/** @name Exact dot products
+ * Same interface as #mpq_EGlpNumDot_t, for mpf it is a plain sum. */
+/** @{ */
+typedef mpf_t mpf_EGlpNumDot_t;
+#define mpf_EGlpNumDotInit(acc) mpf_EGlpNumInitVar(acc)
+#define mpf_EGlpNumDotClear(acc) mpf_clear(acc)
+#define mpf_EGlpNumDotZero(acc) mpf_set_ui(acc,0UL)
+#define mpf_EGlpNumDotAdd(acc,a) mpf_add(acc,acc,a)
+#define mpf_EGlpNumDotAddProd(acc,a,b) mpf_EGlpNumAddInnProdTo(acc,a,b)
+#define mpf_EGlpNumDotSubProd(acc,a,b) mpf_EGlpNumSubInnProdTo(acc,a,b)
+#define mpf_EGlpNumDotAddDot(acc,b) mpf_add(acc,acc,b)
+#define mpf_EGlpNumDotSubDot(acc,b) mpf_sub(acc,acc,b)
+#define mpf_EGlpNumDotGet(res,acc) mpf_set(res,acc)
+#define mpf_EGlpNumDotAllocArray(size) mpf_EGlpNumAllocArray(size)
+#define mpf_EGlpNumDotFreeArray(ea) mpf_EGlpNumFreeArray(ea)
+/** @} */
+
 /* ========================================================================= */
 /** @} */
 #endif
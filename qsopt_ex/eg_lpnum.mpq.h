@@ -46,6 +46,10 @@ extern const mpq_t __MinLpNum_mpq__;
 #define mpq_epsLpNum  __zeroLpNum_mpq__
 #define mpq_MaxLpNum  __MaxLpNum_mpq__
 #define mpq_MinLpNum  __MinLpNum_mpq__
+/** storage class of the mpq tolerances, they are shared by all threads */
+#define mpq_EGlpNumTLS
+/** set if the precision of the numbers depends on #EGLPNUM_PRECISION */
+#define mpq_EGlpNumHasPrecision 0
 
 /* ========================================================================= */
 /** @brief This function read a number in float form and store it in an mpq_t
@@ -591,6 +595,108 @@ void mpq_EGlpNumSet (mpq_t var,
 /** @brief free the internal memory of a given variable */
 #define mpq_EGlpNumClearVar(a) mpq_clear(a)
 
+/* ========================================================================= */
+/** @name Exact dot products
+ * Accumulating a sum of products with mpq_mul and mpq_add pays a gcd at
+ * every step to keep the partial sum canonical. An accumulator instead keeps
+ * the sum as an integer numerator over a common denominator, which is only
+ * grown (to the lcm of the denominators seen so far) when a term does not fit
+ * it, and canonicalizes once, when the value is read back with
+ * #mpq_EGlpNumDotGet. While all denominators are powers of two, as is the case
+ * for values converted from doubles, the denominator is kept as an exponent
+ * and terms are aligned with shifts only; the accumulator is then a dyadic
+ * number (a mantissa and an exponent) and is promoted to a general rational
+ * only when a term that is not dyadic is added.
+ *
+ * The same interface exists for dbl and mpf (where it reduces to plain
+ * arithmetic), so that it can be used from template code. */
+/** @{ */
+/* ========================================================================= */
+/** @brief accumulator for sums of products of rationals */
+typedef struct
+{
+	mpz_t num;				/**< numerator of the sum */
+	mpz_t den;				/**< common denominator, meaningful only if exp < 0 */
+	long exp;					/**< if non negative, the denominator is 2^exp */
+	mpz_t tnum,				/**< numerator of the current term */
+	  tden,						/**< denominator of the current term */
+	  q,							/**< scratch space */
+	  r;							/**< scratch space */
+}
+__mpq_EGlpNumDot_struct;
+typedef __mpq_EGlpNumDot_struct mpq_EGlpNumDot_t[1];
+typedef __mpq_EGlpNumDot_struct *mpq_EGlpNumDot_ptr;
+
+/* ========================================================================= */
+/** @brief initialize an accumulator to zero */
+void mpq_EGlpNumDotInit (mpq_EGlpNumDot_ptr acc);
+
+/* ========================================================================= */
+/** @brief free the internal memory of an accumulator */
+void mpq_EGlpNumDotClear (mpq_EGlpNumDot_ptr acc);
+
+/* ========================================================================= */
+/** @brief reset an accumulator to zero */
+#define mpq_EGlpNumDotZero(acc) ({\
+	mpz_set_ui((acc)->num,0UL);\
+	(acc)->exp = 0;})
+
+/* ========================================================================= */
+/** @brief acc = acc + a */
+void mpq_EGlpNumDotAdd (mpq_EGlpNumDot_ptr acc,
+												mpq_t a);
+
+/* ========================================================================= */
+/** @brief acc = acc + a*b */
+void mpq_EGlpNumDotAddProd (mpq_EGlpNumDot_ptr acc,
+														mpq_t a,
+														mpq_t b);
+
+/* ========================================================================= */
+/** @brief acc = acc - a*b */
+void mpq_EGlpNumDotSubProd (mpq_EGlpNumDot_ptr acc,
+														mpq_t a,
+														mpq_t b);
+
+/* ========================================================================= */
+/** @brief acc = acc + b, where b is another accumulator */
+void mpq_EGlpNumDotAddDot (mpq_EGlpNumDot_ptr acc,
+													 mpq_EGlpNumDot_ptr b);
+
+/* ========================================================================= */
+/** @brief acc = acc - b, where b is another accumulator */
+void mpq_EGlpNumDotSubDot (mpq_EGlpNumDot_ptr acc,
+													 mpq_EGlpNumDot_ptr b);
+
+/* ========================================================================= */
+/** @brief store in res the (canonical) value of the accumulator */
+void mpq_EGlpNumDotGet (mpq_t res,
+												mpq_EGlpNumDot_ptr acc);
+
+/* ========================================================================= */
+/** @brief return the same value as mpq_get_d, but if the denominator of a is
+ * a power of two (as for every value that came from a double) get it with a
+ * shift instead of a division. */
+double mpq_EGlpNumGetD (mpq_t a);
+
+/* ========================================================================= */
+/** @brief Allocate and initialize 'size' accumulators */
+#define mpq_EGlpNumDotAllocArray(size) ({\
+	size_t __i__ = (size);\
+	mpq_EGlpNumDot_t *__res = __EGlpNumAllocArray(mpq_EGlpNumDot_t,__i__);\
+	while(__i__--) mpq_EGlpNumDotInit(__res[__i__]);\
+	__res;})
+
+/* ========================================================================= */
+/** @brief free an array of accumulators, if the pointer is NULL nothing
+ * happen. */
+#define mpq_EGlpNumDotFreeArray(ea) ({\
+	size_t __sz = __EGlpNumArraySize(ea);\
+	mpq_EGlpNumDot_t* __ptr__ = (ea);\
+	while(__sz--) mpq_EGlpNumDotClear(__ptr__[__sz]);\
+	__EGlpNumFreeArray(ea);})
+/** @} */
+
 /* ========================================================================= */
 /** @} */
 #endif
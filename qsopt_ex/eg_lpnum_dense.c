@@ -0,0 +1,196 @@
+/* EGlib "Efficient General Library" provides some basic structures and
+ * algorithms commons in many optimization algorithms.
+ *
+ * Copyright (C) 2005 Daniel Espinoza and Marcos Goycoolea.
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation; either version 2.1 of the License, or (at your
+ * option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ * */
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <math.h>
+
+#include "eg_lpnum.h"
+
+/** @file
+ * @ingroup EGlpNum
+ * Vectorized dense kernels for doubles, see #dbl_EGlpNumDenseAxpy */
+/** @addtogroup EGlpNum */
+/** @{ */
+
+/* ========================================================================= */
+/** @brief if zero, never use the vector units, this also disables the
+ * run-time detection of the processor. */
+#ifndef EGLPNUM_DENSE_SIMD
+#if defined(__GNUC__) && defined(__x86_64__)
+#define EGLPNUM_DENSE_SIMD 1
+#else
+#define EGLPNUM_DENSE_SIMD 0
+#endif
+#endif
+
+#if EGLPNUM_DENSE_SIMD
+#include <immintrin.h>
+/* products and differences must be rounded one at a time, as in the plain
+ * loop, so that all versions agree to the last bit */
+#pragma GCC optimize ("fp-contract=off")
+#endif
+
+/* ========================================================================= */
+/** @brief plain version of #dbl_EGlpNumDenseAxpy */
+static double dense_axpy_scalar (double *const w,
+																 const double *const p,
+																 const double v,
+																 const int n)
+{
+	double max = 0.0;
+	int j;
+	for (j = 0; j < n; j++)
+	{
+		w[j] -= v * p[j];
+		dbl_EGlpNumSetToMaxAbs (max, w[j]);
+	}
+	return max;
+}
+
+#if EGLPNUM_DENSE_SIMD
+/* ========================================================================= */
+/** @brief largest of max and the n entries of m */
+static inline double dense_hmax (double max,
+																 const double *const m,
+																 const int n)
+{
+	int j;
+	for (j = 0; j < n; j++)
+		if (max < m[j])
+			max = m[j];
+	return max;
+}
+
+/* ========================================================================= */
+/** @brief AVX2 version of #dbl_EGlpNumDenseAxpy. MAXPD returns its second
+ * operand when the first is a NaN, which is what the plain loop does. */
+__attribute__ ((target ("avx2")))
+static double dense_axpy_avx2 (double *const w,
+															 const double *const p,
+															 const double v,
+															 const int n)
+{
+	__m256d const vv = _mm256_set1_pd (v);
+	__m256d const sign = _mm256_set1_pd (-0.0);
+	__m256d m0 = _mm256_setzero_pd (),
+	  m1 = _mm256_setzero_pd (),
+	  w0,
+	  w1;
+	double m[4],
+	  max;
+	int j;
+	for (j = 0; j + 8 <= n; j += 8)
+	{
+		w0 = _mm256_sub_pd (_mm256_loadu_pd (w + j),
+												_mm256_mul_pd (vv, _mm256_loadu_pd (p + j)));
+		w1 = _mm256_sub_pd (_mm256_loadu_pd (w + j + 4),
+												_mm256_mul_pd (vv, _mm256_loadu_pd (p + j + 4)));
+		_mm256_storeu_pd (w + j, w0);
+		_mm256_storeu_pd (w + j + 4, w1);
+		m0 = _mm256_max_pd (_mm256_andnot_pd (sign, w0), m0);
+		m1 = _mm256_max_pd (_mm256_andnot_pd (sign, w1), m1);
+	}
+	_mm256_storeu_pd (m, _mm256_max_pd (m0, m1));
+	max = dense_hmax (0.0, m, 4);
+	if (j < n)
+	{
+		m[0] = dense_axpy_scalar (w + j, p + j, v, n - j);
+		max = dense_hmax (max, m, 1);
+	}
+	return max;
+}
+
+/* ========================================================================= */
+/** @brief AVX-512 version of #dbl_EGlpNumDenseAxpy, the tail is done with a
+ * mask instead of a scalar loop. */
+__attribute__ ((target ("avx512f")))
+static double dense_axpy_avx512 (double *const w,
+																 const double *const p,
+																 const double v,
+																 const int n)
+{
+	__m512d const vv = _mm512_set1_pd (v);
+	__m512d m0 = _mm512_setzero_pd (),
+	  w0;
+	__mmask8 k;
+	double m[8];
+	int j;
+	for (j = 0; j + 8 <= n; j += 8)
+	{
+		w0 = _mm512_sub_pd (_mm512_loadu_pd (w + j),
+												_mm512_mul_pd (vv, _mm512_loadu_pd (p + j)));
+		_mm512_storeu_pd (w + j, w0);
+		m0 = _mm512_max_pd (_mm512_abs_pd (w0), m0);
+	}
+	if (j < n)
+	{
+		k = (__mmask8) ((1u << (n - j)) - 1);
+		w0 = _mm512_sub_pd (_mm512_maskz_loadu_pd (k, w + j),
+												_mm512_mul_pd (vv, _mm512_maskz_loadu_pd (k, p + j)));
+		_mm512_mask_storeu_pd (w + j, k, w0);
+		m0 = _mm512_mask_max_pd (m0, k, _mm512_abs_pd (w0), m0);
+	}
+	_mm512_storeu_pd (m, m0);
+	return dense_hmax (0.0, m, 8);
+}
+
+/* ========================================================================= */
+/** @brief the version of #dbl_EGlpNumDenseAxpy to use, set by
+ * #dbl_EGlpNumDenseStart and only read afterwards */
+static double (*dense_axpy) (double *const,
+														 const double *const,
+														 const double,
+														 const int) = 0;
+#endif
+
+/* ========================================================================= */
+void dbl_EGlpNumDenseStart (void)
+{
+#if EGLPNUM_DENSE_SIMD
+	__builtin_cpu_init ();
+	if (__builtin_cpu_supports ("avx512f"))
+		dense_axpy = dense_axpy_avx512;
+	else if (__builtin_cpu_supports ("avx2"))
+		dense_axpy = dense_axpy_avx2;
+	else
+		dense_axpy = dense_axpy_scalar;
+#endif
+}
+
+/* ========================================================================= */
+double dbl_EGlpNumDenseAxpy (double *const w,
+														 const double *const p,
+														 const double v,
+														 const int n)
+{
+#if EGLPNUM_DENSE_SIMD
+	/* all versions agree to the last bit, so before EGlpNumStart the plain
+	 * loop does */
+	if (dense_axpy)
+		return dense_axpy (w, p, v, n);
+#endif
+	return dense_axpy_scalar (w, p, v, n);
+}
+
+/* ========================================================================= */
+/** @} */
@@ -0,0 +1,227 @@
+/* EGlib "Efficient General Library" provides some basic structures and
+ * algorithms commons in many optimization algorithms.
+ *
+ * Copyright (C) 2005 Daniel Espinoza and Marcos Goycoolea.
+ * 
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation; either version 2.1 of the License, or (at your
+ * option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but 
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY 
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public 
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA 
+ * */
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <math.h>
+
+#include <gmp.h>
+
+#include "eg_lpnum.h"
+
+/** @file
+ * @ingroup EGlpNum
+ * Exact dot product accumulators and dyadic helpers, see #mpq_EGlpNumDot_t */
+/** @addtogroup EGlpNum */
+/** @{ */
+/* ========================================================================= */
+void mpq_EGlpNumDotInit (mpq_EGlpNumDot_ptr acc)
+{
+	mpz_init (acc->num);
+	mpz_init (acc->den);
+	mpz_init (acc->tnum);
+	mpz_init (acc->tden);
+	mpz_init (acc->q);
+	mpz_init (acc->r);
+	acc->exp = 0;
+}
+
+/* ========================================================================= */
+void mpq_EGlpNumDotClear (mpq_EGlpNumDot_ptr acc)
+{
+	mpz_clear (acc->num);
+	mpz_clear (acc->den);
+	mpz_clear (acc->tnum);
+	mpz_clear (acc->tden);
+	mpz_clear (acc->q);
+	mpz_clear (acc->r);
+}
+
+/* ========================================================================= */
+/** @brief return k if d is 2^k, -1 otherwise */
+static inline long __mpq_EGlpNumDotExp (mpz_t d)
+{
+	return mpz_popcount (d) == 1 ? (long) mpz_scan1 (d, 0UL) : -1L;
+}
+
+/* ========================================================================= */
+/** @brief add the term tnum/2^k (if k >= 0) or tnum/tden (if k < 0) to the
+ * accumulator */
+static void __mpq_EGlpNumDotAddTerm (mpq_EGlpNumDot_ptr acc,
+																		 long k)
+{
+	/* all denominators so far are powers of two, align with shifts */
+	if (acc->exp >= 0 && k >= 0)
+	{
+		if (k <= acc->exp)
+			mpz_mul_2exp (acc->tnum, acc->tnum, (mp_bitcnt_t) (acc->exp - k));
+		else
+		{
+			mpz_mul_2exp (acc->num, acc->num, (mp_bitcnt_t) (k - acc->exp));
+			acc->exp = k;
+		}
+		mpz_add (acc->num, acc->num, acc->tnum);
+		return;
+	}
+	if (acc->exp >= 0)
+	{
+		mpz_set_ui (acc->den, 1UL);
+		mpz_mul_2exp (acc->den, acc->den, (mp_bitcnt_t) acc->exp);
+		acc->exp = -1;
+	}
+	if (k >= 0)
+	{
+		mpz_set_ui (acc->tden, 1UL);
+		mpz_mul_2exp (acc->tden, acc->tden, (mp_bitcnt_t) k);
+	}
+	/* the usual case, the common denominator is a multiple of tden */
+	mpz_tdiv_qr (acc->q, acc->r, acc->den, acc->tden);
+	if (!mpz_sgn (acc->r))
+	{
+		mpz_addmul (acc->num, acc->tnum, acc->q);
+		return;
+	}
+	/* grow the common denominator to lcm(den,tden) */
+	mpz_gcd (acc->r, acc->den, acc->tden);
+	mpz_divexact (acc->q, acc->den, acc->r);
+	mpz_divexact (acc->tden, acc->tden, acc->r);
+	mpz_mul (acc->num, acc->num, acc->tden);
+	mpz_addmul (acc->num, acc->tnum, acc->q);
+	mpz_mul (acc->den, acc->den, acc->tden);
+}
+
+/* ========================================================================= */
+void mpq_EGlpNumDotAdd (mpq_EGlpNumDot_ptr acc,
+												mpq_t a)
+{
+	long k;
+	if (!mpq_sgn (a))
+		return;
+	mpz_set (acc->tnum, mpq_numref (a));
+	k = __mpq_EGlpNumDotExp (mpq_denref (a));
+	if (k < 0)
+		mpz_set (acc->tden, mpq_denref (a));
+	__mpq_EGlpNumDotAddTerm (acc, k);
+}
+
+/* ========================================================================= */
+/** @brief acc = acc + sgn*a*b */
+static void __mpq_EGlpNumDotProd (mpq_EGlpNumDot_ptr acc,
+																	mpq_t a,
+																	mpq_t b,
+																	const int sgn)
+{
+	long ka,
+	  kb;
+	if (!mpq_sgn (a) || !mpq_sgn (b))
+		return;
+	mpz_mul (acc->tnum, mpq_numref (a), mpq_numref (b));
+	if (sgn < 0)
+		mpz_neg (acc->tnum, acc->tnum);
+	ka = __mpq_EGlpNumDotExp (mpq_denref (a));
+	kb = ka < 0 ? -1L : __mpq_EGlpNumDotExp (mpq_denref (b));
+	if (kb < 0)
+		mpz_mul (acc->tden, mpq_denref (a), mpq_denref (b));
+	__mpq_EGlpNumDotAddTerm (acc, kb < 0 ? -1L : ka + kb);
+}
+
+/* ========================================================================= */
+void mpq_EGlpNumDotAddProd (mpq_EGlpNumDot_ptr acc,
+														mpq_t a,
+														mpq_t b)
+{
+	__mpq_EGlpNumDotProd (acc, a, b, 1);
+}
+
+/* ========================================================================= */
+void mpq_EGlpNumDotSubProd (mpq_EGlpNumDot_ptr acc,
+														mpq_t a,
+														mpq_t b)
+{
+	__mpq_EGlpNumDotProd (acc, a, b, -1);
+}
+
+/* ========================================================================= */
+/** @brief acc = acc + sgn*b */
+static void __mpq_EGlpNumDotMerge (mpq_EGlpNumDot_ptr acc,
+																	 mpq_EGlpNumDot_ptr b,
+																	 const int sgn)
+{
+	if (!mpz_sgn (b->num))
+		return;
+	if (sgn < 0)
+		mpz_neg (acc->tnum, b->num);
+	else
+		mpz_set (acc->tnum, b->num);
+	if (b->exp < 0)
+		mpz_set (acc->tden, b->den);
+	__mpq_EGlpNumDotAddTerm (acc, b->exp);
+}
+
+/* ========================================================================= */
+void mpq_EGlpNumDotAddDot (mpq_EGlpNumDot_ptr acc,
+													 mpq_EGlpNumDot_ptr b)
+{
+	__mpq_EGlpNumDotMerge (acc, b, 1);
+}
+
+/* ========================================================================= */
+void mpq_EGlpNumDotSubDot (mpq_EGlpNumDot_ptr acc,
+													 mpq_EGlpNumDot_ptr b)
+{
+	__mpq_EGlpNumDotMerge (acc, b, -1);
+}
+
+/* ========================================================================= */
+void mpq_EGlpNumDotGet (mpq_t res,
+												mpq_EGlpNumDot_ptr acc)
+{
+	mp_bitcnt_t z;
+	if (acc->exp < 0)
+	{
+		mpz_set (mpq_numref (res), acc->num);
+		mpz_set (mpq_denref (res), acc->den);
+		mpq_canonicalize (res);
+		return;
+	}
+	/* only powers of two can be common factors */
+	z = mpz_sgn (acc->num) ? mpz_scan1 (acc->num, 0UL) : (mp_bitcnt_t) acc->exp;
+	if (z > (mp_bitcnt_t) acc->exp)
+		z = (mp_bitcnt_t) acc->exp;
+	mpz_tdiv_q_2exp (mpq_numref (res), acc->num, z);
+	mpz_set_ui (mpq_denref (res), 1UL);
+	mpz_mul_2exp (mpq_denref (res), mpq_denref (res),
+								(mp_bitcnt_t) acc->exp - z);
+}
+
+/* ========================================================================= */
+double mpq_EGlpNumGetD (mpq_t a)
+{
+	long const k = __mpq_EGlpNumDotExp (mpq_denref (a));
+	/* both mpz_get_d and mpq_get_d truncate, and ldexp is exact as long as the
+	 * result is a normal double */
+	if (k >= 0 && k < 1000 && mpz_sizeinbase (mpq_numref (a), 2) < 1000)
+		return ldexp (mpz_get_d (mpq_numref (a)), (int) -k);
+	return mpq_get_d (a);
+}
+
+/** @} */
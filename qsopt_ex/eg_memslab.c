@@ -32,6 +32,7 @@
 #include <stdint.h>
 #include <inttypes.h> /* For printf format support */
 
+#include "qs_config.h"
 #include "eg_memslab.h"
 
 #include "logging-private.h"
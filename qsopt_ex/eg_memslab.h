@@ -67,6 +67,9 @@
 #include <stdio.h>
 #include <stdint.h>
 #include <unistd.h>
+#if HAVE_EG_THREAD
+#include <pthread.h>
+#endif
 
 #include "eg_mem.h"
 #include "eg_elist.h"
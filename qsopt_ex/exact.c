@@ -26,12 +26,19 @@
 #ifdef HAVE_CONFIG_H
 # include "config.h"
 #endif
+#include "qs_config.h"
 
 #include "exact.h"
+#include "exact_basis.h"
 
+#include <float.h>
+#include <math.h>
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
+#if HAVE_EG_THREAD
+#include <pthread.h>
+#endif
 
 #include "logging-private.h"
 
@@ -55,6 +62,9 @@
 #include "fct_dbl.h"
 #include "simplex_dbl.h"
 #include "simplex_mpf.h"
+#include "basis_mpf.h"
+#include "lpdata_mpf.h"
+#include "price_mpf.h"
 
 /* ========================================================================= */
 int QSexact_print_sol (mpq_QSdata * p,
@@ -234,6 +244,8 @@ dbl_QSdata *QScopy_prob_mpq_dbl (mpq_QSdata * p, const char *newname)
 	EGcallD(dbl_QSset_param(p2, QS_PARAM_SIMPLEX_MAX_ITERATIONS, objsense));
 	EGcallD(mpq_QSget_param(p, QS_PARAM_SIMPLEX_SCALING, &objsense));
 	EGcallD(dbl_QSset_param(p2, QS_PARAM_SIMPLEX_SCALING, objsense));
+	EGcallD(mpq_QSget_param(p, QS_PARAM_FACTOR_THREADS, &objsense));
+	EGcallD(dbl_QSset_param(p2, QS_PARAM_FACTOR_THREADS, objsense));
 	EGcallD(mpq_QSget_param_EGlpNum(p, QS_PARAM_SIMPLEX_MAX_TIME, &mpq_val));
 	dbl_val = mpq_get_d(mpq_val);
 	EGcallD(dbl_QSset_param_EGlpNum(p2, QS_PARAM_SIMPLEX_MAX_TIME, dbl_val));
@@ -309,7 +321,7 @@ mpf_QSdata *QScopy_prob_mpq_mpf (mpq_QSdata * p, const char *newname)
 	mpf_t mpf_val;
 	register int i;
 	mpq_init(mpq_val);
-	mpf_init(mpf_val);
+	mpf_EGlpNumInitVar(mpf_val);
 	/* get all information */
 	EGcallD(mpq_QSget_objsense(p,&objsense));
 	mpq_lb = mpq_EGlpNumAllocArray(ncol);
@@ -352,6 +364,8 @@ mpf_QSdata *QScopy_prob_mpq_mpf (mpq_QSdata * p, const char *newname)
 	EGcallD(mpf_QSset_param(p2, QS_PARAM_SIMPLEX_MAX_ITERATIONS, objsense));
 	EGcallD(mpq_QSget_param(p, QS_PARAM_SIMPLEX_SCALING, &objsense));
 	EGcallD(mpf_QSset_param(p2, QS_PARAM_SIMPLEX_SCALING, objsense));
+	EGcallD(mpq_QSget_param(p, QS_PARAM_FACTOR_THREADS, &objsense));
+	EGcallD(mpf_QSset_param(p2, QS_PARAM_FACTOR_THREADS, objsense));
 	EGcallD(mpq_QSget_param_EGlpNum(p, QS_PARAM_SIMPLEX_MAX_TIME, &mpq_val));
 	mpf_set_q(mpf_val,mpq_val);
 	EGcallD(mpf_QSset_param_EGlpNum(p2, QS_PARAM_SIMPLEX_MAX_TIME, mpf_val));
@@ -395,6 +409,245 @@ mpf_QSdata *QScopy_prob_mpq_mpf (mpq_QSdata * p, const char *newname)
 	return p2;
 }
 
+#if QSEXACT_REUSE_SKELETON || QSEXACT_ITERATIVE_REFINEMENT
+/* ========================================================================= */
+/** @brief check that the internal layout of a floating point copy still
+ * matches the rational problem it was built from, i.e. same dimensions, same
+ * column mapping and same column sparsity pattern. Only if this holds we can
+ * address both problems with the same internal indices. The copy is given by
+ * its index arrays, which do not depend on its number type, see
+ * #QSexact_skeleton_matches.
+ * @return one if the layouts match, zero otherwise. */
+static int QSexact_skeleton_matches_arrays (mpq_ILLlpdata const *const qq,
+																						const int nrows,
+																						const int ncols,
+																						const int nstruct,
+																						const int nzcount,
+																						const int objsense,
+																						const int presolved,
+																						int const *const structmap,
+																						int const *const rowmap,
+																						char const *const sense,
+																						int const *const matcnt)
+{
+	int i;
+	if (qq->nrows != nrows || qq->ncols != ncols || qq->nstruct != nstruct ||
+			qq->nzcount != nzcount || qq->objsense != objsense || presolved)
+		return 0;
+	for (i = 0; i < qq->nstruct; i++)
+		if (qq->structmap[i] != structmap[i])
+			return 0;
+	for (i = 0; i < qq->nrows; i++)
+		if (qq->rowmap[i] != rowmap[i] || qq->sense[i] != sense[i])
+			return 0;
+	for (i = 0; i < qq->ncols; i++)
+		if (qq->A.matcnt[i] != matcnt[i])
+			return 0;
+	return 1;
+}
+
+/* ========================================================================= */
+/** @brief #QSexact_skeleton_matches_arrays for qo, a dbl_ILLlpdata or
+ * mpf_ILLlpdata copy of the rational problem qq. */
+#define QSexact_skeleton_matches(qq,qo) \
+	QSexact_skeleton_matches_arrays (qq, (qo)->nrows, (qo)->ncols, \
+																	 (qo)->nstruct, (qo)->nzcount, \
+																	 (qo)->objsense, (qo)->presolve != 0, \
+																	 (qo)->structmap, (qo)->rowmap, (qo)->sense, \
+																	 (qo)->A.matcnt)
+#endif
+
+#if QSEXACT_REUSE_SKELETON
+/* ========================================================================= */
+/** @brief re-materialize the numeric data of an mpf problem at the current
+ * mpf precision, reading the values from the rational problem it was built
+ * from. Index arrays, the row copy and symbol tables are kept, everything
+ * derived from the old numeric values (scaling, cache, pricing norms, basis
+ * information and factorization) is dropped.
+ * @param p_mpq original rational problem.
+ * @param p_mpf mpf copy of p_mpq previously created by #QScopy_prob_mpq_mpf.
+ * @param precision number of bits to use for the new values.
+ * @return zero on success, non-zero if the skeleton can not be reused, in
+ * which case the caller should discard p_mpf and build a fresh copy. */
+static int mpf_QSrematerialize_prob (mpq_QSdata * p_mpq,
+																		 mpf_QSdata * p_mpf,
+																		 const unsigned precision)
+{
+	mpq_ILLlpdata *qq = p_mpq->qslp;
+	mpf_ILLlpdata *qf = p_mpf->qslp;
+	mpf_ILLlp_rows *rA = qf->rA;
+	mpq_t *colval = 0;
+	int *rowpos = 0;
+	int rval = 0;
+	register int i, j, k;
+	if (!QSexact_skeleton_matches (qq, qf))
+	{
+		rval = 1;
+		goto CLEANUP;
+	}
+	/* drop everything that depends on the old values */
+	if (p_mpf->cache)
+	{
+		mpf_ILLlp_cache_free (p_mpf->cache);
+		mpf_clear (p_mpf->cache->val);
+		ILL_IFFREE(p_mpf->cache);
+	}
+	if (qf->sinfo)
+	{
+		mpf_ILLlp_sinfo_free (qf->sinfo);
+		ILL_IFFREE(qf->sinfo);
+	}
+	if (p_mpf->basis)
+	{
+		mpf_ILLlp_basis_free (p_mpf->basis);
+		ILL_IFFREE(p_mpf->basis);
+	}
+	mpf_ILLprice_free_pricing_info (p_mpf->pricing);
+	mpf_ILLbasis_free_basisinfo (p_mpf->lp);
+	mpf_ILLbasis_init_basisinfo (p_mpf->lp);
+	p_mpf->lp->basisid = -1;
+	p_mpf->factorok = 0;
+	p_mpf->qstatus = QS_LP_MODIFIED;
+	p_mpf->precision = precision;
+	/* the scalars set up by mpf_QScreate_prob, mpf_set never changes the
+	 * precision of its destination */
+	mpf_set_prec (p_mpf->uobjlim, precision);
+	mpf_set_prec (p_mpf->lobjlim, precision);
+	mpf_set_prec (p_mpf->lp->objval, precision);
+	mpf_set_prec (p_mpf->lp->pobjval, precision);
+	mpf_set_prec (p_mpf->lp->dobjval, precision);
+	mpf_set_prec (p_mpf->lp->pinfeas, precision);
+	mpf_set_prec (p_mpf->lp->dinfeas, precision);
+	mpf_set_prec (p_mpf->lp->objbound, precision);
+	mpf_set_prec (p_mpf->lp->upd.piv, precision);
+	mpf_set_prec (p_mpf->lp->upd.dty, precision);
+	mpf_set_prec (p_mpf->lp->upd.c_obj, precision);
+	mpf_set_prec (p_mpf->lp->upd.tz, precision);
+	mpf_set_prec (p_mpf->pricing->htrigger, precision);
+	/* column data, structural and logical variables share the same mapping */
+	for (j = 0; j < qq->ncols; j++)
+	{
+		mpf_set_prec (qf->obj[j], precision);
+		mpf_set_prec (qf->lower[j], precision);
+		mpf_set_prec (qf->upper[j], precision);
+		mpf_set_q (qf->obj[j], qq->obj[j]);
+		mpf_set_q (qf->lower[j], qq->lower[j]);
+		mpf_set_q (qf->upper[j], qq->upper[j]);
+	}
+	for (i = 0; i < qq->nrows; i++)
+	{
+		mpf_set_prec (qf->rhs[i], precision);
+		mpf_set_q (qf->rhs[i], qq->rhs[i]);
+		if (qf->rangeval)
+		{
+			mpf_set_prec (qf->rangeval[i], precision);
+			if (qq->rangeval)
+				mpf_set_q (qf->rangeval[i], qq->rangeval[i]);
+			else
+				mpf_set_ui (qf->rangeval[i], 0UL);
+		}
+	}
+	/* the row order inside a column may differ, so scatter each rational
+	 * column and gather it back in the mpf order */
+	colval = mpq_EGlpNumAllocArray (qq->nrows);
+	if (rA)
+	{
+		ILL_SAFE_MALLOC (rowpos, qq->nrows, int);
+		for (i = 0; i < qq->nrows; i++)
+			rowpos[i] = rA->rowbeg[i];
+	}
+	for (j = 0; j < qq->ncols; j++)
+	{
+		for (k = qq->A.matbeg[j]; k < qq->A.matbeg[j] + qq->A.matcnt[j]; k++)
+			mpq_set (colval[qq->A.matind[k]], qq->A.matval[k]);
+		for (k = qf->A.matbeg[j]; k < qf->A.matbeg[j] + qf->A.matcnt[j]; k++)
+		{
+			i = qf->A.matind[k];
+			mpf_set_prec (qf->A.matval[k], precision);
+			mpf_set_q (qf->A.matval[k], colval[i]);
+			/* the row copy is ordered by column, keep it if that holds */
+			if (rA)
+			{
+				if (rowpos[i] < rA->rowbeg[i] + rA->rowcnt[i] &&
+						rA->rowind[rowpos[i]] == j)
+				{
+					mpf_set_prec (rA->rowval[rowpos[i]], precision);
+					mpf_set_q (rA->rowval[rowpos[i]], colval[i]);
+					rowpos[i]++;
+				}
+				else
+				{
+					mpf_ILLlp_rows_clear (rA);
+					ILL_IFFREE(qf->rA);
+					rA = 0;
+				}
+			}
+		}
+		for (k = qq->A.matbeg[j]; k < qq->A.matbeg[j] + qq->A.matcnt[j]; k++)
+			mpq_set_ui (colval[qq->A.matind[k]], 0UL, 1UL);
+	}
+CLEANUP:
+	mpq_EGlpNumFreeArray (colval);
+	ILL_IFFREE(rowpos);
+	return rval;
+}
+
+/* ========================================================================= */
+/** @brief if the rational problem holds a factorization of its current basis,
+ * and that basis is the one just loaded into p_mpf, convert it to the current
+ * mpf precision and install it as the starting LU of p_mpf, so that the
+ * simplex does not need to refactor. If anything does not match, p_mpf is left untouched and the
+ * simplex will factor the basis as usual.
+ * @return zero on success (whether or not the LU was seeded). */
+static int mpf_QSseed_factor (mpq_QSdata * p_mpq,
+															mpf_QSdata * p_mpf)
+{
+	mpf_lpinfo *lp = p_mpf->lp;
+	mpf_factor_work *f = 0;
+	int rval = 0;
+	register int i;
+	if (!p_mpf->basis || !p_mpq->lp->f || !p_mpq->lp->baz ||
+			p_mpq->lp->fbasisid != p_mpq->lp->basisid ||
+			p_mpq->lp->f->dim != lp->O->nrows ||
+			!QSexact_skeleton_matches (p_mpq->qslp, p_mpf->qslp))
+		goto CLEANUP;
+	EGcallD(mpf_ILLbasis_load (lp, p_mpf->basis, p_mpq->lp->baz));
+	for (i = 0; i < lp->O->nrows; i++)
+		if (lp->baz[i] != p_mpq->lp->baz[i])
+			goto CLEANUP;
+	ILL_SAFE_MALLOC (f, 1, mpf_factor_work);
+	rval = mpq_factor_work_to_mpf_factor_work (f, p_mpq->lp->f);
+	if (rval)
+	{
+		/* the conversion already released the arrays */
+		rval = 0;
+		goto CLEANUP;
+	}
+	/* singularity reporting pointers belong to the rational factorization */
+	f->p_nsing = 0;
+	f->p_singr = 0;
+	f->p_singc = 0;
+	lp->f = f;
+	f = 0;
+	lp->fbasisid = lp->basisid;
+	p_mpf->factorok = 1;
+	MESSAGE (__QS_SB_VERB, "Seeded mpf LU from rational factorization");
+CLEANUP:
+	if (f)
+	{
+		mpf_EGlpNumClearVar (f->fzero_tol);
+		mpf_EGlpNumClearVar (f->szero_tol);
+		mpf_EGlpNumClearVar (f->partial_tol);
+		mpf_EGlpNumClearVar (f->maxelem_orig);
+		mpf_EGlpNumClearVar (f->maxelem_factor);
+		mpf_EGlpNumClearVar (f->maxelem_cur);
+		mpf_EGlpNumClearVar (f->partial_cur);
+		ILL_IFFREE(f);
+	}
+	return rval;
+}
+#endif
+
 #if QSEXACT_SAVE_OPTIMAL
 /* ========================================================================= */
 /** @brief used to enumerate the generated optimal tests */
@@ -424,6 +677,8 @@ int QSexact_optimal_test (mpq_QSdata * p,
 	 *arr4 = 0,
 	 *rhs_copy = 0;
 	mpq_t *dz = 0;
+	mpq_EGlpNumDot_t *ax = 0,
+	  acc;
 	int objsense = (qslp->objsense == QS_MIN) ? 1 : -1;
 	int const msg_lvl = __QS_SB_VERB <= DEBUG ? 0 : 100000 * (1 - p->simplex_display);
 	int rval = 1;									/* store whether or not the solution is optimal, we start 
@@ -438,6 +693,7 @@ int QSexact_optimal_test (mpq_QSdata * p,
 	mpq_init (num3);
 	mpq_init (p_obj);
 	mpq_init (d_obj);
+	mpq_EGlpNumDotInit (acc);
 	mpq_set_ui (p_obj, 0UL, 1UL);
 	mpq_set_ui (d_obj, 0UL, 1UL);
 
@@ -527,8 +783,9 @@ int QSexact_optimal_test (mpq_QSdata * p,
 		}
 	}
 
-	/* compute the actual RHS */
+	/* compute the actual RHS, canonicalizing each row only once */
 	rhs_copy = mpq_EGlpNumAllocArray (qslp->nrows);
+	ax = mpq_EGlpNumDotAllocArray (qslp->nrows);
 	for (i = qslp->nstruct; i--;)
 	{
 		if (!mpq_equal (p_sol[i], mpq_zeroLpNum))
@@ -536,12 +793,11 @@ int QSexact_optimal_test (mpq_QSdata * p,
 			arr1 = qslp->A.matval + qslp->A.matbeg[structmap[i]];
 			iarr1 = qslp->A.matind + qslp->A.matbeg[structmap[i]];
 			for (j = qslp->A.matcnt[structmap[i]]; j--;)
-			{
-				mpq_mul (num1, arr1[j], p_sol[i]);
-				mpq_add (rhs_copy[iarr1[j]], rhs_copy[iarr1[j]], num1);
-			}
+				mpq_EGlpNumDotAddProd (ax[iarr1[j]], arr1[j], p_sol[i]);
 		}
 	}
+	for (i = qslp->nrows; i--;)
+		mpq_EGlpNumDotGet (rhs_copy[i], ax[i]);
 
 	/* now check if both rhs and copy_rhs are equal */
 	arr4 = qslp->upper;
@@ -616,13 +872,11 @@ int QSexact_optimal_test (mpq_QSdata * p,
 		mpq_add (p_obj, p_obj, num1);
 		arr1 = qslp->A.matval + qslp->A.matbeg[col];
 		iarr1 = qslp->A.matind + qslp->A.matbeg[col];
-		mpq_set (num1, arr2[col]);
+		mpq_EGlpNumDotZero (acc);
+		mpq_EGlpNumDotAdd (acc, arr2[col]);
 		for (j = qslp->A.matcnt[col]; j--;)
-		{
-			mpq_mul (num2, arr1[j], d_sol[iarr1[j]]);
-			mpq_sub (num1, num1, num2);
-		}
-		mpq_set (dz[col], num1);
+			mpq_EGlpNumDotSubProd (acc, arr1[j], d_sol[iarr1[j]]);
+		mpq_EGlpNumDotGet (dz[col], acc);
 		/* objective update */
 		if (objsense * mpq_cmp_ui (dz[col], 0UL, 1UL) > 0)
 		{
@@ -686,13 +940,11 @@ int QSexact_optimal_test (mpq_QSdata * p,
 		mpq_add (p_obj, p_obj, num1);
 		arr1 = qslp->A.matval + qslp->A.matbeg[col];
 		iarr1 = qslp->A.matind + qslp->A.matbeg[col];
-		mpq_set (num1, arr2[col]);
+		mpq_EGlpNumDotZero (acc);
+		mpq_EGlpNumDotAdd (acc, arr2[col]);
 		for (j = qslp->A.matcnt[col]; j--;)
-		{
-			mpq_mul (num2, arr1[j], d_sol[iarr1[j]]);
-			mpq_sub (num1, num1, num2);
-		}
-		mpq_set (dz[col], num1);
+			mpq_EGlpNumDotSubProd (acc, arr1[j], d_sol[iarr1[j]]);
+		mpq_EGlpNumDotGet (dz[col], acc);
 		/* objective update */
 		if (objsense * mpq_cmp_ui (dz[col], 0UL, 1UL) > 0)
 		{
@@ -832,6 +1084,8 @@ CLEANUP:
 
 	mpq_EGlpNumFreeArray (dz);
 	mpq_EGlpNumFreeArray (rhs_copy);
+	mpq_EGlpNumDotFreeArray (ax);
+	mpq_EGlpNumDotClear (acc);
 	mpq_clear (num1);
 	mpq_clear (num2);
 	mpq_clear (num3);
@@ -857,6 +1111,7 @@ int QSexact_infeasible_test (mpq_QSdata * p, mpq_t * d_sol)
 	 *arr4;
 	mpq_t *dl = 0,
 	 *du = 0;
+	mpq_EGlpNumDot_t acc;
 	int const msg_lvl = __QS_SB_VERB <= DEBUG ? 0 : 100000 * (1 - p->simplex_display);
 	int rval = 1;									/* store whether or not the solution is optimal, we start 
 																 * assuming it is. */
@@ -868,6 +1123,7 @@ int QSexact_infeasible_test (mpq_QSdata * p, mpq_t * d_sol)
 	mpq_init (num2);
 	mpq_init (num3);
 	mpq_init (d_obj);
+	mpq_EGlpNumDotInit (acc);
 	mpq_set_ui (d_obj, 0UL, 1UL);
 
 	/* compute the dual objective value */
@@ -890,14 +1146,12 @@ int QSexact_infeasible_test (mpq_QSdata * p, mpq_t * d_sol)
 	{
 		arr1 = qslp->A.matval + qslp->A.matbeg[i];
 		iarr1 = qslp->A.matind + qslp->A.matbeg[i];
-		mpq_set_ui (num1, 0UL, 1UL);
+		mpq_EGlpNumDotZero (acc);
 		mpq_set_ui (du[i], 0UL, 1UL);
 		mpq_set_ui (dl[i], 0UL, 1UL);
 		for (j = qslp->A.matcnt[i]; j--;)
-		{
-			mpq_mul (num2, arr1[j], d_sol[iarr1[j]]);
-			mpq_sub (num1, num1, num2);
-		}
+			mpq_EGlpNumDotSubProd (acc, arr1[j], d_sol[iarr1[j]]);
+		mpq_EGlpNumDotGet (num1, acc);
 		if (mpq_cmp_ui (num1, 0UL, 1UL) < 0)
 			mpq_set (du[i], num1);
 		else
@@ -951,6 +1205,7 @@ CLEANUP:
 
 	mpq_EGlpNumFreeArray (dl);
 	mpq_EGlpNumFreeArray (du);
+	mpq_EGlpNumDotClear (acc);
 	mpq_clear (num1);
 	mpq_clear (num2);
 	mpq_clear (num3);
@@ -990,6 +1245,168 @@ static void infeasible_output (mpq_QSdata * p_mpq,
 	}
 }
 
+/* ========================================================================= */
+int QSexact_reconstruct (mpq_t * array,
+												 int n,
+												 unsigned long maxden,
+												 unsigned precision)
+{
+	int i,
+	  nsnap = 0;
+	unsigned long const k = precision / 2;
+	mpz_t num,
+	  den,
+	  t,
+	  r,
+	  p[2],
+	  q[2],
+	  err,
+	  lim;
+
+	mpz_init (num);
+	mpz_init (den);
+	mpz_init (t);
+	mpz_init (r);
+	mpz_init (p[0]);
+	mpz_init (p[1]);
+	mpz_init (q[0]);
+	mpz_init (q[1]);
+	mpz_init (err);
+	mpz_init (lim);
+	/* two fractions with denominators up to maxden differ by at least
+	 * 1/maxden^2, keep that above twice the tolerance so that the snapped value
+	 * is the only candidate */
+	if (k < 2)
+		maxden = 1UL;
+	else if ((k >> 1) - 1 < sizeof (unsigned long) * 8 - 1 &&
+					 maxden > (1UL << ((k >> 1) - 1)))
+		maxden = 1UL << ((k >> 1) - 1);
+	for (i = 0; i < n; i++)
+	{
+		mpz_srcptr const a = mpq_numref (array[i]);
+		mpz_srcptr const b = mpq_denref (array[i]);
+		if (mpz_cmp_ui (b, maxden) <= 0)
+			continue;
+		/* expand |a|/b, the convergents are p[1]/q[1] (the last one) and
+		 * p[0]/q[0] (the one before), starting with 1/0 and 0/1 */
+		mpz_abs (num, a);
+		mpz_set (den, b);
+		mpz_set_ui (p[0], 0UL);
+		mpz_set_ui (q[0], 1UL);
+		mpz_set_ui (p[1], 1UL);
+		mpz_set_ui (q[1], 0UL);
+		while (mpz_sgn (den))
+		{
+			mpz_fdiv_qr (t, r, num, den);
+			mpz_addmul (p[0], t, p[1]);
+			mpz_addmul (q[0], t, q[1]);
+			mpz_swap (p[0], p[1]);
+			mpz_swap (q[0], q[1]);
+			if (mpz_cmp_ui (q[1], maxden) > 0)
+				break;
+			/* accept if ||a| q - p b| 2^k <= q max(|a|,b) */
+			mpz_mul (err, q[1], a);
+			mpz_abs (err, err);
+			mpz_submul (err, p[1], b);
+			mpz_abs (err, err);
+			mpz_mul_2exp (err, err, k);
+			mpz_mul (lim, q[1], mpz_cmpabs (a, b) > 0 ? a : b);
+			mpz_abs (lim, lim);
+			if (mpz_cmp (err, lim) <= 0)
+			{
+				if (mpz_sgn (a) < 0)
+					mpz_neg (p[1], p[1]);
+				mpz_set (mpq_numref (array[i]), p[1]);
+				mpz_set (mpq_denref (array[i]), q[1]);
+				nsnap++;
+				break;
+			}
+			mpz_swap (num, den);
+			mpz_swap (den, r);
+		}
+	}
+	mpz_clear (num);
+	mpz_clear (den);
+	mpz_clear (t);
+	mpz_clear (r);
+	mpz_clear (p[0]);
+	mpz_clear (p[1]);
+	mpz_clear (q[0]);
+	mpz_clear (q[1]);
+	mpz_clear (err);
+	mpz_clear (lim);
+	return nsnap;
+}
+
+/* ========================================================================= */
+/** @brief test an approximate optimal solution, first snapped to small
+ * denominators with #QSexact_reconstruct (unless the QS_PARAM_EXACT_RECONSTRUCT
+ * parameter of p_mpq is zero) and then, if that fails, as it was given.
+ * When both x and y were snapped, each of them is also tried along with the
+ * other one as given, as it is common that only the primal (or only the dual)
+ * solution has small denominators.
+ * @param x_mpq primal solution candidate, on success it holds the solution
+ * that passed the test.
+ * @param y_mpq dual solution candidate, as x_mpq.
+ * @param precision bits of the arithmetic that computed x_mpq and y_mpq.
+ * @return one if the solution is optimal, zero otherwise. */
+static int QSexact_reconstructed_test (mpq_QSdata * p_mpq,
+																			 mpq_t * x_mpq,
+																			 mpq_t * y_mpq,
+																			 QSbasis * basis,
+																			 const unsigned precision,
+																			 const int msg_lvl)
+{
+	int const nx = __EGlpNumArraySize (x_mpq),
+	  ny = __EGlpNumArraySize (y_mpq);
+	mpq_t *xr,
+	 *yr,
+	 *xt,
+	 *yt;
+	int i,
+	  k,
+	  nsx,
+	  nsy,
+	  rval = 0;
+
+	if (p_mpq->exact_reconstruct <= 0)
+		return QSexact_optimal_test (p_mpq, x_mpq, y_mpq, basis);
+	xr = mpq_EGlpNumAllocArray (nx);
+	yr = mpq_EGlpNumAllocArray (ny);
+	for (i = nx; i--;)
+		mpq_set (xr[i], x_mpq[i]);
+	for (i = ny; i--;)
+		mpq_set (yr[i], y_mpq[i]);
+	nsx = QSexact_reconstruct (xr, nx, (unsigned long) p_mpq->exact_reconstruct,
+														 precision);
+	nsy = QSexact_reconstruct (yr, ny, (unsigned long) p_mpq->exact_reconstruct,
+														 precision);
+	/* k = 0: both snapped, k = 1: only x, k = 2: only y */
+	for (k = 0; k < 3 && !rval; k++)
+	{
+		if (k ? !(nsx && nsy) : !(nsx || nsy))
+			continue;
+		xt = k == 2 ? x_mpq : xr;
+		yt = k == 1 ? y_mpq : yr;
+		if (!QSexact_optimal_test (p_mpq, xt, yt, basis))
+			continue;
+		MESSAGE (msg_lvl, "Reconstructed solution is optimal (%d primal and %d "
+						 "dual values snapped)", xt == xr ? nsx : 0, yt == yr ? nsy : 0);
+		if (xt != x_mpq)
+			for (i = nx; i--;)
+				mpq_set (x_mpq[i], xt[i]);
+		if (yt != y_mpq)
+			for (i = ny; i--;)
+				mpq_set (y_mpq[i], yt[i]);
+		rval = 1;
+	}
+	mpq_EGlpNumFreeArray (xr);
+	mpq_EGlpNumFreeArray (yr);
+	if (!rval)
+		rval = QSexact_optimal_test (p_mpq, x_mpq, y_mpq, basis);
+	return rval;
+}
+
 /* ========================================================================= */
 /** @brief print into screen (if enable) a message indicating that we have
  * successfully solved the problem at optimality, and save (if x and y are non
@@ -1109,6 +1526,504 @@ mpq_basis_matrix_nzcnt (const mpq_lpinfo *lp)
 	return nnz;
 }
 
+#ifndef QS_EXACT_REFACTOR_WEIGHT
+/* ========================================================================= */
+/** @brief relative cost of one elimination step of a rational refactorization
+ * against one nonzero touched by an FTRAN through the cached LU */
+#define QS_EXACT_REFACTOR_WEIGHT 2.0
+#endif
+
+#ifndef QS_EXACT_UPDATE_OVERHEAD
+/* ========================================================================= */
+/** @brief fixed cost per row of each column of a cached LU block update
+ * (dense block and work vectors), in the same units as
+ * #QS_EXACT_REFACTOR_WEIGHT */
+#define QS_EXACT_UPDATE_OVERHEAD 2.0
+#endif
+
+/* ========================================================================= */
+void QSexact_get_lu_stats (mpq_QSdata * p,
+													 QSexact_lu_stats * stats)
+{
+	if (p && stats)
+		*stats = p->exact_lu_stats;
+}
+
+/* ========================================================================= */
+void QSexact_reset_lu_stats (mpq_QSdata * p)
+{
+	if (p)
+		memset (&(p->exact_lu_stats), 0, sizeof (QSexact_lu_stats));
+}
+
+/* ========================================================================= */
+void QSexact_get_solve_info (mpq_QSdata * p,
+														 QSexact_solve_info * info)
+{
+	if (p && info)
+		*info = p->exact_info;
+}
+
+/* ========================================================================= */
+/** @brief decide whether the cached LU should be brought in sync with the
+ * current basis by a block update (#QSexact_lu_block_update) or replaced by
+ * a fresh factorization.
+ *
+ * Both paths are priced in nonzeros touched. The block update pays a fixed
+ * per-row overhead for every column, one floating point FTRAN per column, a
+ * single rational pass over L and the eta file, and the Forrest-Tomlin
+ * updates themselves; each update makes U and the eta file grow by about the
+ * fill-in of the entering column, which the later spikes of the block and
+ * the piz/xbz solves that follow have to go through. A refactorization is
+ * priced by the fill of the cached LU scaled to the new basis, times the
+ * average elimination row length. In Schur complement mode the cached LU is
+ * never updated, and the update path is priced by one FTRAN per replaced
+ * column plus the dense elimination of the Schur block.
+ * @param lp current internal lp, with baz set to the new basis.
+ * @param f cached LU, factoring the columns in cached_baz.
+ * @param cached_baz basis factored by f.
+ * @param mismatch number of positions where baz and cached_baz differ.
+ * @param mode QS_EXACT_LU_UPDATE_xxx, which update path to price.
+ * @param upd_cost where to store the predicted cost of the update path.
+ * @param fac_cost where to store the predicted cost of refactoring.
+ * @return one if refactoring is cheaper, or if the updates would not fit in
+ * the eta file. */
+static int QSexact_lu_prefer_refactor (const mpq_lpinfo * lp,
+																			 const mpq_factor_work * f,
+																			 const int *cached_baz,
+																			 const int mismatch,
+																			 const int mode,
+																			 double *upd_cost,
+																			 double *fac_cost)
+{
+	mpq_factor_work_lu_nz_breakdown b;
+	const int n = lp->nrows;
+	const double m = mismatch;
+	long long cached_nz = 0,
+	  entering_nz = 0;
+	double solve_nz, growth, fill, new_lu_nz;
+	int i;
+
+	*upd_cost = *fac_cost = 0.0;
+	if (mismatch == 0 || n == 0)
+		return 0;
+	mpq_factor_work_lu_nz_breakdown_fill (f, &b);
+	for (i = 0; i < n; i++)
+	{
+		cached_nz += lp->matcnt[cached_baz[i]];
+		if (cached_baz[i] != lp->baz[i])
+			entering_nz += lp->matcnt[lp->baz[i]];
+	}
+	solve_nz = (double) b.u_nz + b.l_nz + b.eta_nz;
+	fill = cached_nz > 0 ? ((double) b.u_nz + b.l_nz) / cached_nz : 1.0;
+	if (fill < 1.0)
+		fill = 1.0;
+	new_lu_nz = fill * mpq_basis_matrix_nzcnt (lp);
+	/* each update adds the spike to U and one eta row */
+	growth = 2.0 * fill * entering_nz / m;
+
+	*fac_cost = QS_EXACT_REFACTOR_WEIGHT * new_lu_nz * (1.0 + new_lu_nz / n)
+		+ 3.0 * new_lu_nz;
+	if (mode == QS_EXACT_LU_UPDATE_SCHUR)
+	{
+		/* one sparse rational FTRAN per column, the elimination of the Schur
+		 * block, whose density is taken to be that of the spikes, and the three
+		 * solves with the frozen factorization */
+		const double density = growth < n ? growth / n : 1.0;
+		*upd_cost = m * growth
+			+ density * m * m * m / 3.0
+			+ 3.0 * solve_nz;
+		return *fac_cost < *upd_cost;
+	}
+	/* overhead and floating point FTRANs per column, one rational pass, the
+	 * updates, the etas of the block applied to the later spikes, and piz, xbz
+	 * and the copy into lp->f on the final factorization */
+	*upd_cost = QS_EXACT_UPDATE_OVERHEAD * m * n
+		+ 0.25 * m * solve_nz
+		+ solve_nz
+		+ 2.0 * m * growth * (1.0 + solve_nz / n)
+		+ growth * m * (m - 1.0) / 2.0
+		+ 3.0 * (solve_nz + m * growth);
+	if (b.eta_vecs + mismatch >= f->etamax)
+		return 1;
+	return *fac_cost < *upd_cost;
+}
+
+#ifndef QS_EXACT_BLOCK_PIVOT_TOL
+/* ========================================================================= */
+/** @brief relative size, against the first pivot, below which a pivot of the
+ * block update ordering is considered zero */
+#define QS_EXACT_BLOCK_PIVOT_TOL 1e-12
+#endif
+
+#ifndef QS_EXACT_BLOCK_SOLVES
+/* ========================================================================= */
+/** @brief number of entering columns solved together through the 128-bit
+ * copy of the cached LU when forming W */
+#define QS_EXACT_BLOCK_SOLVES 32
+#endif
+
+/* ========================================================================= */
+void QSexact_free_lu_shadow (mpf_factor_work * shadow)
+{
+	if (!shadow)
+		return;
+	mpf_ILLfactor_free_factor_work (shadow);
+	mpf_EGlpNumClearVar (shadow->fzero_tol);
+	mpf_EGlpNumClearVar (shadow->szero_tol);
+	mpf_EGlpNumClearVar (shadow->partial_tol);
+	mpf_EGlpNumClearVar (shadow->maxelem_orig);
+	mpf_EGlpNumClearVar (shadow->maxelem_factor);
+	mpf_EGlpNumClearVar (shadow->maxelem_cur);
+	mpf_EGlpNumClearVar (shadow->partial_cur);
+	ILL_IFFREE (shadow);
+}
+
+/* ========================================================================= */
+/** @brief release the 128-bit copy of the cached LU of p, once the cached LU
+ * has been replaced by a fresh factorization. */
+static void QSexact_drop_lu_shadow (mpq_QSdata * p)
+{
+	QSexact_free_lu_shadow (p->cached_lu_mpf);
+	p->cached_lu_mpf = 0;
+}
+
+/* ========================================================================= */
+int QSexact_lu_update (mpq_factor_work * f,
+											 mpf_factor_work ** shadow,
+											 mpq_svector * spike,
+											 const int row,
+											 int *refactor)
+{
+	mpf_svector a;
+	int rval = 0,
+	  i,
+	  shadow_refactor = 0;
+
+	mpf_ILLsvector_init (&a);
+	if (*shadow)
+	{
+		/* the rational update may use the spike as work space */
+		EGcallD (mpf_ILLsvector_alloc (&a, spike->nzcnt));
+		for (i = 0; i < spike->nzcnt; i++)
+		{
+			a.indx[i] = spike->indx[i];
+			mpf_set_q (a.coef[i], spike->coef[i]);
+		}
+	}
+	rval = mpq_ILLfactor_update (f, spike, row, refactor);
+	if (rval || *refactor || !*shadow)
+		goto CLEANUP;
+	if (mpf_ILLfactor_update (*shadow, &a, row, &shadow_refactor) ||
+			shadow_refactor)
+	{
+		/* rebuilt from the rational LU the next time it is needed */
+		QSexact_free_lu_shadow (*shadow);
+		*shadow = 0;
+	}
+CLEANUP:
+	mpf_ILLsvector_free (&a);
+	EG_RETURN (rval);
+}
+
+/* ========================================================================= */
+/** @brief bring the cached LU in sync with the current basis by replacing all
+ * mismatched positions as one block.
+ *
+ * Entering columns that are already basic in the cached LU at another
+ * mismatched position only move. For the rest, the order in which they
+ * replace the leaving positions is fixed up front: the square matrix
+ * W = (B^{-1} A_E) restricted to the leaving positions is formed with
+ * multiple right hand side FTRANs (mpf_ILLfactor_ftran_multi) through a
+ * 128-bit copy of the cached LU and eliminated with complete
+ * pivoting, and the pivots give a sequence of nonsingular column
+ * replacements. The spikes of all entering columns are then computed with a
+ * single pass over L and the eta file (mpq_ILLfactor_spike_block), and each
+ * one only picks up the etas of the earlier updates of the block before it
+ * is applied, to f and to its 128-bit copy alike (#QSexact_lu_update).
+ * @param lp current internal lp; on success baz and vindex are permuted over
+ * the mismatched positions to agree with cached_baz.
+ * @param f cached LU, updated in place.
+ * @param shadow 128-bit copy of f, built from f if null and kept in step
+ * with it; left null if it could not follow the updates.
+ * @param cached_baz basis factored by f, kept in sync with every update.
+ * @param pos mismatched positions.
+ * @param k number of mismatched positions.
+ * @param refactor set to one if the block could not be applied and the basis
+ * has to be refactored.
+ * @return zero on success, non-zero on failure. */
+static int QSexact_lu_block_update (mpq_lpinfo * lp,
+																		mpq_factor_work * f,
+																		mpf_factor_work ** shadow,
+																		int *cached_baz,
+																		const int *pos,
+																		const int k,
+																		int *refactor)
+{
+	const int n = lp->nrows;
+	const unsigned original_precision = EGLPNUM_PRECISION;
+	int rval = 0,
+	  i, j, t, r, c, p, b, nb,
+	  kw = 0,
+	  nspike = 0,
+	  start_eta,
+	  set_precision = 0;
+	int *row = 0,
+	 *col = 0,
+	 *rowof = 0,
+	 *pivrow = 0,
+	 *pivcol = 0;
+	char *mark = 0,
+	 *rdone = 0,
+	 *cdone = 0;
+	double *W = 0,
+	  wmax,
+	  w0max = 0.0,
+	  m;
+	mpq_svector *a = 0,
+	 *spike = 0,
+	  upd;
+	mpf_svector mpf_a[QS_EXACT_BLOCK_SOLVES],
+	  mpf_d[QS_EXACT_BLOCK_SOLVES];
+
+	*refactor = 0;
+	mpq_ILLsvector_init (&upd);
+	for (j = 0; j < QS_EXACT_BLOCK_SOLVES; j++)
+	{
+		mpf_ILLsvector_init (mpf_a + j);
+		mpf_ILLsvector_init (mpf_d + j);
+	}
+	if (k == 0)
+		return 0;
+	ILL_SAFE_MALLOC (row, k, int);
+	ILL_SAFE_MALLOC (col, k, int);
+	ILL_SAFE_MALLOC (rowof, n, int);
+	ILL_SAFE_MALLOC (mark, lp->ncols, char);
+	memset (mark, 0, sizeof (char) * lp->ncols);
+	for (i = 0; i < n; i++)
+		rowof[i] = -1;
+	/* 1: entering, 2: leaving, 3: basic in both, at another position */
+	for (i = 0; i < k; i++)
+	{
+		mark[lp->baz[pos[i]]] |= 1;
+		mark[cached_baz[pos[i]]] |= 2;
+	}
+	for (i = 0; i < k; i++)
+	{
+		if (mark[cached_baz[pos[i]]] == 2)
+		{
+			rowof[pos[i]] = kw;
+			row[kw++] = pos[i];
+		}
+	}
+	for (i = 0, j = 0; i < k; i++)
+	{
+		if (mark[lp->baz[pos[i]]] == 1)
+			col[j++] = lp->baz[pos[i]];
+	}
+	TESTG ((rval = (j != kw)), CLEANUP, "entering and leaving columns differ, "
+				 "%d != %d", j, kw);
+
+	if (kw)
+	{
+		/* pivot order from the floating point block */
+		ILL_SAFE_MALLOC (W, kw * kw, double);
+		ILL_SAFE_MALLOC (pivrow, kw, int);
+		ILL_SAFE_MALLOC (pivcol, kw, int);
+		ILL_SAFE_MALLOC (rdone, kw, char);
+		ILL_SAFE_MALLOC (cdone, kw, char);
+		memset (W, 0, sizeof (double) * kw * kw);
+		memset (rdone, 0, sizeof (char) * kw);
+		memset (cdone, 0, sizeof (char) * kw);
+		/* the 128-bit copy and its updates all run at 128 bits */
+		QSexact_set_precision (128);
+		set_precision = 1;
+		if (!*shadow)
+		{
+			ILL_SAFE_MALLOC (*shadow, 1, mpf_factor_work);
+			rval = mpq_factor_work_to_mpf_factor_work (*shadow, f);
+			if (rval)
+			{
+				QSlog ("Failed to convert mpq_factor_work to mpf_factor_work");
+				ILL_IFFREE (*shadow);
+				rval = 0;
+				*refactor = 1;
+				goto CLEANUP;
+			}
+			/* singularity reporting pointers belong to the rational factorization */
+			(*shadow)->p_nsing = 0;
+			(*shadow)->p_singr = 0;
+			(*shadow)->p_singc = 0;
+		}
+		for (j = 0; j < QS_EXACT_BLOCK_SOLVES && j < kw; j++)
+		{
+			EGcallD (mpf_ILLsvector_alloc (mpf_a + j, n));
+			EGcallD (mpf_ILLsvector_alloc (mpf_d + j, n));
+		}
+		for (b = 0; b < kw; b += nb)
+		{
+			nb = (kw - b < QS_EXACT_BLOCK_SOLVES) ? kw - b : QS_EXACT_BLOCK_SOLVES;
+			for (j = 0; j < nb; j++)
+			{
+				c = col[b + j];
+				mpf_a[j].nzcnt = lp->matcnt[c];
+				for (i = 0; i < mpf_a[j].nzcnt; i++)
+				{
+					mpf_a[j].indx[i] = lp->matind[lp->matbeg[c] + i];
+					mpf_set_q (mpf_a[j].coef[i], lp->matval[lp->matbeg[c] + i]);
+				}
+			}
+			mpf_ILLfactor_ftran_multi (*shadow, nb, mpf_a, mpf_d);
+			for (j = 0; j < nb; j++)
+			{
+				for (i = 0; i < mpf_d[j].nzcnt; i++)
+				{
+					r = rowof[mpf_d[j].indx[i]];
+					if (r >= 0)
+						W[r * kw + b + j] = mpf_get_d (mpf_d[j].coef[i]);
+				}
+			}
+		}
+
+		for (t = 0; t < kw; t++)
+		{
+			wmax = 0.0;
+			r = c = -1;
+			for (i = 0; i < kw; i++)
+			{
+				if (rdone[i])
+					continue;
+				for (j = 0; j < kw; j++)
+				{
+					if (!cdone[j] && fabs (W[i * kw + j]) > wmax)
+					{
+						wmax = fabs (W[i * kw + j]);
+						r = i;
+						c = j;
+					}
+				}
+			}
+			if (t == 0)
+				w0max = wmax;
+			if (r < 0 || wmax <= QS_EXACT_BLOCK_PIVOT_TOL * w0max)
+			{
+				QSlog ("Block update: no pivot at step %d of %d", t, kw);
+				*refactor = 1;
+				goto CLEANUP;
+			}
+			pivrow[t] = r;
+			pivcol[t] = c;
+			rdone[r] = 1;
+			cdone[c] = 1;
+			for (i = 0; i < kw; i++)
+			{
+				if (rdone[i] || W[i * kw + c] == 0.0)
+					continue;
+				m = W[i * kw + c] / W[r * kw + c];
+				for (j = 0; j < kw; j++)
+				{
+					if (!cdone[j])
+						W[i * kw + j] -= m * W[r * kw + j];
+				}
+			}
+		}
+
+		/* all rational spikes at once, then the updates in pivot order */
+		ILL_SAFE_MALLOC (a, kw, mpq_svector);
+		ILL_SAFE_MALLOC (spike, kw, mpq_svector);
+		for (j = 0; j < kw; j++)
+		{
+			c = col[j];
+			a[j].nzcnt = lp->matcnt[c];
+			a[j].indx = lp->matind + lp->matbeg[c];
+			a[j].coef = lp->matval + lp->matbeg[c];
+		}
+		start_eta = f->etacnt;
+		nspike = kw;
+		EGcallD (mpq_ILLfactor_spike_block (f, kw, a, spike));
+		EGcallD (mpq_ILLsvector_alloc (&upd, n));
+		for (t = 0; t < kw; t++)
+		{
+			j = pivcol[t];
+			p = row[pivrow[t]];
+			upd.nzcnt = spike[j].nzcnt;
+			for (i = 0; i < upd.nzcnt; i++)
+			{
+				upd.indx[i] = spike[j].indx[i];
+				mpq_set (upd.coef[i], spike[j].coef[i]);
+			}
+			mpq_ILLsvector_free (spike + j);
+			mpq_ILLsvector_init (spike + j);
+			mpq_ILLfactor_spike_refresh (f, start_eta, &upd);
+			rval = QSexact_lu_update (f, shadow, &upd, p, refactor);
+			if (rval || *refactor)
+			{
+				QSlog ("Block update at position %d, step %d of %d, triggered "
+							 "refactorization (refactor=%d, rval=%d)", p, t, kw, *refactor,
+							 rval);
+				rval = 0;
+				*refactor = 1;
+				goto CLEANUP;
+			}
+			cached_baz[p] = col[j];
+		}
+	}
+
+	/* the basis is now the cached one, up to the order of the positions */
+	for (i = 0; i < k; i++)
+	{
+		lp->baz[pos[i]] = cached_baz[pos[i]];
+		lp->vindex[cached_baz[pos[i]]] = pos[i];
+	}
+	log_message ("Block update: %d positions, %d moved, %d updated, %d etas",
+							 k, k - kw, kw, f->etacnt);
+
+CLEANUP:
+	if (set_precision)
+		QSexact_set_precision (original_precision);
+	for (j = 0; j < nspike; j++)
+		mpq_ILLsvector_free (spike + j);
+	mpq_ILLsvector_free (&upd);
+	for (j = 0; j < QS_EXACT_BLOCK_SOLVES; j++)
+	{
+		mpf_ILLsvector_free (mpf_a + j);
+		mpf_ILLsvector_free (mpf_d + j);
+	}
+	ILL_IFFREE (a);
+	ILL_IFFREE (spike);
+	ILL_IFFREE (W);
+	ILL_IFFREE (pivrow);
+	ILL_IFFREE (pivcol);
+	ILL_IFFREE (rdone);
+	ILL_IFFREE (cdone);
+	ILL_IFFREE (mark);
+	ILL_IFFREE (rowof);
+	ILL_IFFREE (col);
+	ILL_IFFREE (row);
+	EG_RETURN (rval);
+}
+
+/* ========================================================================= */
+/** @brief release the factorization held by lp once its basis has been
+ * solved without it, so that nothing (e.g. #mpf_QSseed_factor) takes it for
+ * a factorization of the current basis. */
+static void QSexact_drop_factor (mpq_lpinfo * lp)
+{
+	if (lp->f)
+	{
+		mpq_ILLfactor_free_factor_work (lp->f);
+		mpq_EGlpNumClearVar (lp->f->fzero_tol);
+		mpq_EGlpNumClearVar (lp->f->szero_tol);
+		mpq_EGlpNumClearVar (lp->f->partial_tol);
+		mpq_EGlpNumClearVar (lp->f->maxelem_orig);
+		mpq_EGlpNumClearVar (lp->f->maxelem_factor);
+		mpq_EGlpNumClearVar (lp->f->maxelem_cur);
+		mpq_EGlpNumClearVar (lp->f->partial_cur);
+		ILL_IFFREE(lp->f);
+	}
+	lp->fbasisid = -1;
+}
+
 /* ========================================================================= */
 /** @brief get the status for a given basis in rational arithmetic, it should
  * also leave everything set to get primal/dual solutions when needed.
@@ -1123,7 +2038,8 @@ static int QSexact_basis_status (mpq_QSdata * p_mpq,
         clock_t start = clock();
 
 	int rval = 0,
-	singular;
+	singular,
+	solved_alt = 0;
 	mpq_feas_info fi;
 	EGtimer_t local_timer;
 	mpq_EGlpNumInitVar (fi.totinfeas);
@@ -1161,7 +2077,24 @@ static int QSexact_basis_status (mpq_QSdata * p_mpq,
 		log_message("Basis matrix: %dx%d (%lld dense entries), nonzeros: %lld",
 								n, n, dense_sz, mpq_basis_matrix_nzcnt (p_mpq->lp));
 	}
-	if (p_mpq->cached_lu == 0) 
+	if (p_mpq->exact_basis_solver != QS_EXACT_BASIS_SOLVER_LU)
+	{
+		clock_t alt_start = clock();
+		EGcallD(QSexact_basis_solve (p_mpq->lp, p_mpq->exact_basis_solver,
+																 QS_EXACT_BASIS_PRIMAL | QS_EXACT_BASIS_DUAL,
+																 &singular));
+		log_timing ("Alternative basis solve took ",
+								(double) (clock () - alt_start) / CLOCKS_PER_SEC);
+		/* a singular basis is repaired by the LU path below */
+		solved_alt = !singular;
+	}
+	if (solved_alt)
+	{
+		/* xbz and piz are already exact, no LU needed, and the one in lp->f
+		 * belongs to an earlier basis */
+		QSexact_drop_factor (p_mpq->lp);
+	}
+	else if (p_mpq->cached_lu == 0) 
 	{
 		EGcallD(mpq_ILLbasis_factor (p_mpq->lp, &singular));
 		ILL_SAFE_MALLOC (p_mpq->cached_lu, 1, mpq_factor_work);
@@ -1194,165 +2127,56 @@ static int QSexact_basis_status (mpq_QSdata * p_mpq,
 				mismatch_indices[mismatch_count++] = i;
 			}
 		}
-		if (mismatch_count > 100) {
+		double upd_cost, fac_cost;
+		clock_t sync_start = clock();
+		const int prefer_refactor =
+			QSexact_lu_prefer_refactor (p_mpq->lp, p_mpq->cached_lu,
+																	p_mpq->cached_baz, mismatch_count,
+																	p_mpq->exact_lu_update, &upd_cost,
+																	&fac_cost);
+		p_mpq->exact_lu_stats.last_mismatch = mismatch_count;
+		p_mpq->exact_lu_stats.last_refactor = prefer_refactor;
+		p_mpq->exact_lu_stats.last_predicted_update = upd_cost;
+		p_mpq->exact_lu_stats.last_predicted_refactor = fac_cost;
+		p_mpq->exact_lu_stats.total_predicted +=
+			prefer_refactor ? fac_cost : upd_cost;
+		if (prefer_refactor) {
+			p_mpq->exact_lu_stats.nrefactor++;
 			QSlog("Using refactorization");
 			refactor = 1;
-			free(mismatch_indices);
-		}
-		log_message("Mismatch's: %d/%d", mismatch_count, p_mpq->lp->O->nrows);
-		int update_count = 0;
-		while (!refactor) {
-			int changed = 0;
-			int update_pos = -1;
-			int leaving_col = -1;
-			update_count++;
-			// Find the next column that has changed
-			for (int i = 0; i < mismatch_count; ++i) {
-				if (p_mpq->cached_baz[mismatch_indices[i]] != p_mpq->lp->baz[mismatch_indices[i]]) {
-					update_pos = mismatch_indices[i];
-					leaving_col = p_mpq->cached_baz[update_pos];
-					changed = 1;
-					break;
-				}
-			}
-
-			if (!changed) {
-				break; // Bases are now in sync
+		}
+		else
+			p_mpq->exact_lu_stats.nupdate++;
+		log_message("Mismatch's: %d/%d, predicted update %.4g refactor %.4g",
+								mismatch_count, p_mpq->lp->O->nrows, upd_cost, fac_cost);
+		if (refactor)
+			;
+		else if (p_mpq->exact_lu_update == QS_EXACT_LU_UPDATE_SCHUR)
+		{
+			/* cached_lu stays frozen, xbz and piz come from its Schur complement */
+			EGcallD(QSexact_schur_solve (p_mpq->lp, p_mpq->cached_lu,
+																	 p_mpq->cached_baz,
+																	 QS_EXACT_BASIS_PRIMAL | QS_EXACT_BASIS_DUAL,
+																	 &singular));
+			if (singular)
+				refactor = 1;
+			else
+			{
+				/* lp->f still factors cached_baz, not the basis just solved */
+				solved_alt = 1;
+				QSexact_drop_factor (p_mpq->lp);
 			}
-			else {
-				mpq_factor_work_lu_nz_breakdown lu_nz;
-				mpq_factor_work_lu_nz_breakdown_fill (p_mpq->cached_lu, &lu_nz);
-				log_message(
-						"Update count: %d, U nz: %d, L nz: %d, eta: %d vectors, %d nz",
-						update_count, lu_nz.u_nz, lu_nz.l_nz, lu_nz.eta_vecs,
-						lu_nz.eta_nz);
-				int entering_col = p_mpq->lp->baz[update_pos];
-
-				// Create a_s for the entering column
-				mpq_svector a_s;
-				a_s.nzcnt = p_mpq->lp->matcnt[entering_col];
-				a_s.indx = &(p_mpq->lp->matind[p_mpq->lp->matbeg[entering_col]]);
-				a_s.coef = &(p_mpq->lp->matval[p_mpq->lp->matbeg[entering_col]]);
-		
-				// Allocate and compute the spike vector
-				mpq_svector spike, direction;
-				mpq_ILLsvector_alloc(&spike, p_mpq->lp->nrows);
-				mpq_ILLsvector_alloc(&direction, p_mpq->lp->nrows);
-				
-				// Use cached MPF 128-bit LU for faster and more accurate direction computation
-				unsigned original_precision = EGLPNUM_PRECISION;
-				QSexact_set_precision(128);  
-				
-				mpf_factor_work *mpf_cached_lu = NULL;
-				mpf_svector mpf_a_s, mpf_spike, mpf_direction;
-				
-				ILL_SAFE_MALLOC(mpf_cached_lu, 1, mpf_factor_work);
-				rval = mpq_factor_work_to_mpf_factor_work(mpf_cached_lu, p_mpq->cached_lu);
-				if (rval) {
-					QSlog("Failed to convert mpq_factor_work to mpf_factor_work");
-					QSexact_set_precision(original_precision);
-					refactor = 1;
-					break;
-				}	
-				
-				// Convert a_s to mpf precision
-				mpf_ILLsvector_alloc(&mpf_a_s, p_mpq->lp->nrows);
-				mpf_ILLsvector_alloc(&mpf_spike, p_mpq->lp->nrows);
-				mpf_ILLsvector_alloc(&mpf_direction, p_mpq->lp->nrows);
-				
-				mpf_a_s.nzcnt = a_s.nzcnt;
-				memcpy(mpf_a_s.indx, a_s.indx, a_s.nzcnt * sizeof(int));
-				for (int j = 0; j < a_s.nzcnt; j++) {
-					mpf_set_q(mpf_a_s.coef[j], a_s.coef[j]);
-				}
-				
-				mpf_ILLfactor_ftran_update(mpf_cached_lu, &mpf_a_s, &mpf_spike, &mpf_direction);
-				direction.nzcnt = mpf_direction.nzcnt;
-				memcpy(direction.indx, mpf_direction.indx, mpf_direction.nzcnt * sizeof(int));
-				for (int j = 0; j < mpf_direction.nzcnt; j++) {
-					mpq_set_f(direction.coef[j], mpf_direction.coef[j]);
-				}
-				mpq_compute_spike(p_mpq->cached_lu, &a_s, &spike);
-				
-				// Clean up mpf precision structures
-				mpf_ILLsvector_free(&mpf_a_s);
-				mpf_ILLsvector_free(&mpf_spike);
-				mpf_ILLsvector_free(&mpf_direction);
-				mpf_ILLfactor_free_factor_work(mpf_cached_lu);
-				ILL_IFFREE(mpf_cached_lu);
-				
-				// Restore original precision
-				QSexact_set_precision(original_precision);
-
-				// Look through mismatches for direction vector entry != 0
-				int swap_pos = -1;
-				char* is_mismatch = calloc(p_mpq->lp->O->nrows, sizeof(char));
-				for (int j = 0; j < mismatch_count; ++j) {
-					int pos = mismatch_indices[j];
-					if (p_mpq->cached_baz[pos] != p_mpq->lp->baz[pos]) {
-						is_mismatch[pos] = 1;
-					}
-				}
-				
-				// Find the mismatch position with maximum absolute value in direction vector
-				double max_abs_val = 0.0;
-				for (int k = 0; k < direction.nzcnt; ++k) {
-					int pos = direction.indx[k];
-					if (is_mismatch[pos]) {
-						double abs_val = fabs(mpq_get_d(direction.coef[k]));
-						if (abs_val > max_abs_val) {
-							max_abs_val = abs_val;
-								swap_pos = pos;
-						}
-					}
-				}
-				// If we found a position with direction > 0 within cached basis, we need to update that position in the current basis
-				if (swap_pos != -1 && swap_pos != update_pos) {
-				
-					int temp_col = p_mpq->lp->baz[update_pos];
-					p_mpq->lp->baz[update_pos] = p_mpq->lp->baz[swap_pos];
-					p_mpq->lp->baz[swap_pos] = temp_col;
-					update_pos = swap_pos;
-
-				}
-				if (swap_pos == -1) {
-					QSlog("No swap found, increase copy precision");
-					refactor = 1;
-					break;
-				}
-				rval = mpq_ILLfactor_update(p_mpq->cached_lu, &spike, update_pos, &refactor);
-
-				if (refactor || rval) {
-					QSlog("LU update at position %d triggered refactorization (refactor=%d, rval=%d)\n", update_pos, refactor, rval);
-				refactor = 1; 
-				break; 
-				}
-				
-				// Update was successful, update the cached basis for this position
-				p_mpq->cached_baz[update_pos] = entering_col;
-
-				mpq_ILLsvector_free(&spike);
-				mpq_ILLsvector_free(&direction);
-				free(is_mismatch);
-				
-				// Remove the mismatch from the list
-				for (int idx = 0; idx < mismatch_count; ++idx) {
-					if (mismatch_indices[idx] == update_pos) {
-						/* swap current entry with the last one and shrink */
-						mismatch_indices[idx] = mismatch_indices[mismatch_count - 1];
-						mismatch_count--;
-						break;
-					}
-				}
-
-				// If no mismatches are left, we can stop looping
-				if (mismatch_count == 0) {
-					break;
-				}
-				
-			}		
 		}
-		if (!refactor) {
+		else
+		{
+			p_mpq->free_cached_lu_mpf = QSexact_free_lu_shadow;
+			EGcallD(QSexact_lu_block_update (p_mpq->lp, p_mpq->cached_lu,
+																			 &p_mpq->cached_lu_mpf,
+																			 p_mpq->cached_baz, mismatch_indices,
+																			 mismatch_count, &refactor));
+		}
+		ILL_IFFREE(mismatch_indices);
+		if (!refactor && !solved_alt) {
 			mpq_factor_work *temp_lu;
 			ILL_SAFE_MALLOC (temp_lu, 1, mpq_factor_work);	
 			mpq_EGlpNumInitVar (temp_lu->fzero_tol);
@@ -1367,17 +2191,15 @@ static int QSexact_basis_status (mpq_QSdata * p_mpq,
 				QSlog("Failed to deep copy factor work after refactorization");
 				goto CLEANUP;
 			}
-			if (p_mpq->lp->f) {
-				mpq_ILLfactor_free_factor_work(p_mpq->lp->f);
-				ILL_IFFREE(p_mpq->lp->f);
-			}
+			QSexact_drop_factor (p_mpq->lp);
 			p_mpq->lp->f = temp_lu;
+			p_mpq->lp->fbasisid = p_mpq->lp->basisid;
 			QSlog("Updated cached lu");
-			free(mismatch_indices);	
 		}
 		if (refactor) {
 		    int singular;
    			// Perform full refactorization
+    		QSexact_drop_lu_shadow (p_mpq);
     		EGcallD(mpq_ILLbasis_factor(p_mpq->lp, &singular));
     		// Deep copy the new LU factorization into the cache
     		rval = mpq_ILLfactor_deep_copy(p_mpq->cached_lu, p_mpq->lp->f);
@@ -1385,14 +2207,23 @@ static int QSexact_basis_status (mpq_QSdata * p_mpq,
     		for (int i = 0; i < p_mpq->lp->O->nrows; ++i) {
         		p_mpq->cached_baz[i] = p_mpq->lp->baz[i];
     		}
-
+			if (!prefer_refactor)
+				p_mpq->exact_lu_stats.nfallback++;
 		}
+		p_mpq->exact_lu_stats.last_actual =
+			(double) (clock () - sync_start) / CLOCKS_PER_SEC;
+		p_mpq->exact_lu_stats.total_actual += p_mpq->exact_lu_stats.last_actual;
+		log_timing (prefer_refactor ? "Cached LU refactor took " :
+								"Cached LU update took ", p_mpq->exact_lu_stats.last_actual);
 	}
 	memset (&(p_mpq->lp->basisstat), 0, sizeof (mpq_lp_status_info));
 	// feasibility check
-	mpq_ILLfct_compute_piz (p_mpq->lp);
+	if (!solved_alt)
+	{
+		mpq_ILLfct_compute_piz (p_mpq->lp);
+		mpq_ILLfct_compute_xbz (p_mpq->lp);
+	}
 	mpq_ILLfct_compute_dz (p_mpq->lp);
-	mpq_ILLfct_compute_xbz (p_mpq->lp);
 	// primal and dual solution check
 	mpq_ILLfct_check_pfeasible (p_mpq->lp, &fi, mpq_zeroLpNum);
 	mpq_ILLfct_check_dfeasible (p_mpq->lp, &fi, mpq_zeroLpNum);
@@ -1411,6 +2242,9 @@ static int QSexact_basis_status (mpq_QSdata * p_mpq,
 		*status = QS_LP_INFEASIBLE;
 		p_mpq->lp->final_phase = PRIMAL_PHASEI;
 		p_mpq->lp->pIpiz = mpq_EGlpNumAllocArray (p_mpq->lp->nrows);
+		/* the phase I multipliers need the factorization */
+		if (solved_alt)
+			EGcallD(mpq_ILLbasis_factor (p_mpq->lp, &singular));
 		mpq_ILLfct_compute_phaseI_piz (p_mpq->lp);
 	}
 	else if (p_mpq->lp->basisstat.primal_unbounded)
@@ -1500,12 +2334,20 @@ int QSexact_basis_optimalstatus(
    mpq_ILLfct_set_variable_type (p_mpq->lp);
 
    EGcallD(mpq_ILLbasis_load (p_mpq->lp, p_mpq->basis, p_mpq->cached_baz));
-   EGcallD(mpq_ILLbasis_factor (p_mpq->lp, &singular));
+   singular = 1;
+   if (p_mpq->exact_basis_solver != QS_EXACT_BASIS_SOLVER_LU)
+      EGcallD(QSexact_basis_solve (p_mpq->lp, p_mpq->exact_basis_solver,
+                                   QS_EXACT_BASIS_PRIMAL | QS_EXACT_BASIS_DUAL,
+                                   &singular));
+   if (singular)
+   {
+      EGcallD(mpq_ILLbasis_factor (p_mpq->lp, &singular));
+      mpq_ILLfct_compute_piz (p_mpq->lp); 
+      mpq_ILLfct_compute_xbz (p_mpq->lp);
+   }
 
    memset (&(p_mpq->lp->basisstat), 0, sizeof (mpq_lp_status_info));
-   mpq_ILLfct_compute_piz (p_mpq->lp); 
    mpq_ILLfct_compute_dz (p_mpq->lp);
-   mpq_ILLfct_compute_xbz (p_mpq->lp);
    mpq_ILLfct_check_pfeasible (p_mpq->lp, &fi, mpq_zeroLpNum);
    mpq_ILLfct_check_dfeasible (p_mpq->lp, &fi, mpq_zeroLpNum);
    mpq_ILLfct_set_status_values (p_mpq->lp, fi.pstatus, fi.dstatus, PHASEII, PHASEII);
@@ -1583,10 +2425,17 @@ int QSexact_basis_dualstatus(
 	EGcallD(mpq_build_internal_lpinfo (p_mpq->lp));
 	mpq_ILLfct_set_variable_type (p_mpq->lp);
 	EGcallD(mpq_ILLbasis_load (p_mpq->lp, p_mpq->basis, p_mpq->cached_baz));
-	EGcallD(mpq_ILLbasis_factor (p_mpq->lp, &singular));
+	singular = 1;
+	if (p_mpq->exact_basis_solver != QS_EXACT_BASIS_SOLVER_LU)
+		EGcallD(QSexact_basis_solve (p_mpq->lp, p_mpq->exact_basis_solver,
+																 QS_EXACT_BASIS_DUAL, &singular));
+	if (singular)
+	{
+		EGcallD(mpq_ILLbasis_factor (p_mpq->lp, &singular));
+		mpq_ILLfct_compute_piz (p_mpq->lp); 
+	}
 
 	memset (&(p_mpq->lp->basisstat), 0, sizeof (mpq_lp_status_info));
-	mpq_ILLfct_compute_piz (p_mpq->lp); 
 	mpq_ILLfct_compute_dz (p_mpq->lp);
 	mpq_ILLfct_compute_dobj(p_mpq->lp); 
 	mpq_ILLfct_check_dfeasible (p_mpq->lp, &fi, mpq_zeroLpNum);
@@ -1629,6 +2478,89 @@ CLEANUP:
 	return rval;
 }
 
+/* ========================================================================= */
+int QSexact_lift_solution (mpq_QSdata * p_mpq,
+													 QSbasis * basis,
+													 mpq_t * x,
+													 mpq_t * y)
+{
+	int rval = 0,
+	singular = 0,
+	what = 0;
+	mpq_lpinfo *lp = p_mpq->lp;
+	register int i;
+	clock_t start = clock ();
+	if (x)
+		what |= QS_EXACT_BASIS_PRIMAL;
+	if (y)
+		what |= QS_EXACT_BASIS_DUAL;
+	if (!what)
+		goto CLEANUP;
+	EGcallD(mpq_QSload_basis (p_mpq, basis));
+	if (p_mpq->cache) 
+	{
+		mpq_ILLlp_cache_free (p_mpq->cache);
+		mpq_clear (p_mpq->cache->val);
+		ILL_IFFREE(p_mpq->cache);
+	}
+	p_mpq->qstatus = QS_LP_MODIFIED;
+	if(p_mpq->qslp->sinfo) 
+	{
+		mpq_ILLlp_sinfo_free(p_mpq->qslp->sinfo);
+		ILL_IFFREE(p_mpq->qslp->sinfo);
+	}
+	if(p_mpq->qslp->rA)
+	{
+		mpq_ILLlp_rows_clear (p_mpq->qslp->rA);
+		ILL_IFFREE(p_mpq->qslp->rA);
+	}
+	mpq_free_internal_lpinfo (lp);
+	mpq_init_internal_lpinfo (lp);
+	EGcallD(mpq_build_internal_lpinfo (lp));
+	mpq_ILLfct_set_variable_type (lp);
+	EGcallD(mpq_ILLbasis_load (lp, p_mpq->basis, p_mpq->cached_baz));
+	EGcallD(QSexact_basis_solve (lp, QS_EXACT_BASIS_SOLVER_DIXON, what,
+															 &singular));
+	if (singular)
+	{
+		QSlog ("QSexact_lift_solution: basis is singular");
+		rval = 1;
+		goto CLEANUP;
+	}
+	if (x)
+		for (i = 0; i < lp->O->nstruct; i++)
+		{
+			const int col = lp->O->structmap[i];
+			switch (lp->vstat[col])
+			{
+			case STAT_BASIC:
+				mpq_set (x[i], lp->xbz[lp->vindex[col]]);
+				break;
+			case STAT_UPPER:
+				mpq_set (x[i], lp->uz[col]);
+				break;
+			case STAT_LOWER:
+				mpq_set (x[i], lp->lz[col]);
+				break;
+			default:
+				mpq_set_ui (x[i], 0UL, 1UL);
+				break;
+			}
+		}
+	if (y)
+		for (i = 0; i < lp->nrows; i++)
+		{
+			if (lp->O->objsense == mpq_ILL_MAX)
+				mpq_neg (y[i], lp->piz[i]);
+			else
+				mpq_set (y[i], lp->piz[i]);
+		}
+CLEANUP:
+	log_timing ("QSexact_lift_solution took ",
+							(double) (clock () - start) / CLOCKS_PER_SEC);
+	return rval;
+}
+
 /* ========================================================================= */
 /** @brief test whether given basis is dual feasible in rational arithmetic. 
  * if wanted it will first directly test the corresponding approximate dual and primal solution 
@@ -1795,6 +2727,998 @@ int QSexact_verify (
    return rval;
 }
 
+#if QSEXACT_ITERATIVE_REFINEMENT
+/* ========================================================================= */
+/** @brief approximate base two logarithm of a non-zero rational number, it is
+ * off by at most one, which is enough to pick power of two scaling factors. */
+#define mpq_ilog2(v) ((long) mpz_sizeinbase (mpq_numref (v), 2) - \
+											(long) mpz_sizeinbase (mpq_denref (v), 2))
+
+/* ========================================================================= */
+/** @brief run rational iterative refinement starting from the optimal
+ * solution of the double copy of the problem.
+ *
+ * In every round the exact primal residual \f$r = b - Ax\f$, the exact bound
+ * violations and the exact reduced costs \f$d = c - A^ty\f$ of the current
+ * rational solution \f$(x,y)\f$ are computed. The correction LP
+ * \f[ \min 2^{k_d} d^t\hat{x} \quad A\hat{x} = 2^{k_p}r \quad
+ * 2^{k_p}(l-x) \le \hat{x} \le 2^{k_p}(u-x) \f]
+ * is loaded in place of the numeric data of the double problem (the
+ * constraint matrix does not change, so its basis and factorization are
+ * kept) and re-solved warm-started from the previous basis. Its primal and
+ * dual solutions, scaled back, are added to \f$(x,y)\f$ in rational
+ * arithmetic. The scaling exponents grow by at most #QS_EXACT_IR_SCALE_STEP
+ * bits per round.
+ *
+ * Refinement stops when the rational solution passes
+ * #QSexact_optimal_test, when a correction LP is solved without pivots (the
+ * basis is then considered final), when the violations stop decreasing, when
+ * a correction LP can not be solved to optimality, or after
+ * #QS_EXACT_IR_MAX_ROUNDS rounds.
+ * @param p_mpq the exact problem.
+ * @param p_dbl double copy of p_mpq, solved to optimality. Its original
+ * numeric data is restored on return, its basis and factorization are those
+ * of the last correction LP.
+ * @param x_mpq where to store the optimal primal solution (structural and
+ * logical values) if found.
+ * @param y_mpq where to store the optimal dual solution if found.
+ * @param basis on input, the basis of the double solution. On output, the
+ * last basis found by refinement, to be used by any further exact check.
+ * @param msg_lvl message level.
+ * @param optimal set to one if an exact optimal solution was found, zero
+ * otherwise.
+ * @return zero on success, non-zero on error. Failing to refine is not an
+ * error. */
+static int QSexact_refine (mpq_QSdata * p_mpq,
+													 dbl_QSdata * p_dbl,
+													 mpq_t * x_mpq,
+													 mpq_t * y_mpq,
+													 QSbasis ** basis,
+													 const int msg_lvl,
+													 int *optimal)
+{
+	clock_t start = clock();
+	mpq_ILLlpdata *qq = p_mpq->qslp;
+	dbl_ILLlpdata *qd = p_dbl->qslp;
+	const int nstruct = qq->nstruct,
+	  nrows = qq->nrows,
+	  ncols = qq->nstruct + qq->nrows;
+	int const objsense = (qq->objsense == QS_MIN) ? 1 : -1;
+	int rval = 0,
+	  round,
+	  status,
+	  sgn,
+	  it_before,
+	  it_after,
+	  stable = 0,
+	  kp = 0,
+	  kd = 0,
+	  nkp,
+	  nkd,
+	 *colmap = 0;
+	register int i,
+	  j,
+	  k;
+	double *obj_save = 0,
+	 *lower_save = 0,
+	 *upper_save = 0,
+	 *rhs_save = 0,
+	 *xc = 0,
+	 *yc = 0;
+	mpq_t *x = 0,
+	 *y = 0,
+	 *r = 0,
+	 *d = 0;
+	mpq_t viol_p,
+	  viol_d,
+	  num1;
+	QSbasis *B = 0;
+	mpq_init (viol_p);
+	mpq_init (viol_d);
+	mpq_init (num1);
+	*optimal = 0;
+	if (!QSexact_skeleton_matches (qq, qd) || qq->ncols != ncols)
+		goto CLEANUP;
+	/* API position (structural, then logical) to internal column */
+	ILL_SAFE_MALLOC (colmap, ncols, int);
+	for (k = 0; k < nstruct; k++)
+		colmap[k] = qq->structmap[k];
+	for (i = 0; i < nrows; i++)
+		colmap[nstruct + i] = qq->rowmap[i];
+	/* save the double data that the correction LPs overwrite */
+	obj_save = dbl_EGlpNumAllocArray (ncols);
+	lower_save = dbl_EGlpNumAllocArray (ncols);
+	upper_save = dbl_EGlpNumAllocArray (ncols);
+	rhs_save = dbl_EGlpNumAllocArray (nrows);
+	memcpy (obj_save, qd->obj, sizeof (double) * ncols);
+	memcpy (lower_save, qd->lower, sizeof (double) * ncols);
+	memcpy (upper_save, qd->upper, sizeof (double) * ncols);
+	memcpy (rhs_save, qd->rhs, sizeof (double) * nrows);
+	/* starting point, doubles are converted exactly */
+	xc = dbl_EGlpNumAllocArray (ncols);
+	yc = dbl_EGlpNumAllocArray (nrows);
+	x = mpq_EGlpNumAllocArray (ncols);
+	y = mpq_EGlpNumAllocArray (nrows);
+	r = mpq_EGlpNumAllocArray (nrows);
+	d = mpq_EGlpNumAllocArray (ncols);
+	EGcallD(dbl_QSget_x_array (p_dbl, xc));
+	EGcallD(dbl_QSget_slack_array (p_dbl, xc + nstruct));
+	EGcallD(dbl_QSget_pi_array (p_dbl, yc));
+	for (k = 0; k < ncols; k++)
+		mpq_set_d (x[k], xc[k]);
+	for (i = 0; i < nrows; i++)
+		mpq_set_d (y[i], yc[i]);
+
+	for (round = 0; round < QS_EXACT_IR_MAX_ROUNDS; round++)
+	{
+		/* exact primal residual and bound violation */
+		mpq_set_ui (viol_p, 0UL, 1UL);
+		for (i = 0; i < nrows; i++)
+			mpq_set (r[i], qq->rhs[i]);
+		for (k = 0; k < ncols; k++)
+		{
+			j = colmap[k];
+			if (mpq_sgn (x[k]))
+				for (i = qq->A.matbeg[j]; i < qq->A.matbeg[j] + qq->A.matcnt[j]; i++)
+				{
+					mpq_mul (num1, qq->A.matval[i], x[k]);
+					mpq_sub (r[qq->A.matind[i]], r[qq->A.matind[i]], num1);
+				}
+			if (!mpq_equal (qq->lower[j], mpq_ILL_MINDOUBLE))
+			{
+				mpq_sub (num1, qq->lower[j], x[k]);
+				if (mpq_cmp (num1, viol_p) > 0)
+					mpq_set (viol_p, num1);
+			}
+			if (!mpq_equal (qq->upper[j], mpq_ILL_MAXDOUBLE))
+			{
+				mpq_sub (num1, x[k], qq->upper[j]);
+				if (mpq_cmp (num1, viol_p) > 0)
+					mpq_set (viol_p, num1);
+			}
+		}
+		for (i = 0; i < nrows; i++)
+		{
+			mpq_abs (num1, r[i]);
+			if (mpq_cmp (num1, viol_p) > 0)
+				mpq_set (viol_p, num1);
+		}
+		/* exact reduced costs and complementary slackness violation */
+		mpq_set_ui (viol_d, 0UL, 1UL);
+		for (k = 0; k < ncols; k++)
+		{
+			j = colmap[k];
+			mpq_set (d[k], qq->obj[j]);
+			for (i = qq->A.matbeg[j]; i < qq->A.matbeg[j] + qq->A.matcnt[j]; i++)
+			{
+				mpq_mul (num1, qq->A.matval[i], y[qq->A.matind[i]]);
+				mpq_sub (d[k], d[k], num1);
+			}
+			sgn = objsense * mpq_sgn (d[k]);
+			if ((sgn > 0 && mpq_cmp (x[k], qq->lower[j]) > 0) ||
+					(sgn < 0 && mpq_cmp (x[k], qq->upper[j]) < 0))
+			{
+				mpq_abs (num1, d[k]);
+				if (mpq_cmp (num1, viol_d) > 0)
+					mpq_set (viol_d, num1);
+			}
+		}
+		MESSAGE (msg_lvl, "refinement round %d, primal violation %lg, dual "
+						 "violation %lg", round, mpq_get_d (viol_p), mpq_get_d (viol_d));
+		if (!mpq_sgn (viol_p) && !mpq_sgn (viol_d))
+		{
+			for (k = 0; k < ncols; k++)
+				mpq_set (x_mpq[k], x[k]);
+			for (i = 0; i < nrows; i++)
+				mpq_set (y_mpq[i], y[i]);
+			B = dbl_QSget_basis (p_dbl);
+			if (B && QSexact_optimal_test (p_mpq, x_mpq, y_mpq, B))
+				*optimal = 1;
+			break;
+		}
+		if (stable)
+			break;
+		/* new scaling exponents, zero violations keep the old ones */
+		nkp = kp;
+		if (mpq_sgn (viol_p))
+		{
+			nkp = (int) -mpq_ilog2 (viol_p);
+			if (nkp > kp + QS_EXACT_IR_SCALE_STEP)
+				nkp = kp + QS_EXACT_IR_SCALE_STEP;
+			if (nkp < 0)
+				nkp = 0;
+		}
+		nkd = kd;
+		if (mpq_sgn (viol_d))
+		{
+			nkd = (int) -mpq_ilog2 (viol_d);
+			if (nkd > kd + QS_EXACT_IR_SCALE_STEP)
+				nkd = kd + QS_EXACT_IR_SCALE_STEP;
+			if (nkd < 0)
+				nkd = 0;
+		}
+		if (round && nkp <= kp && nkd <= kd)
+		{
+			MESSAGE (msg_lvl, "refinement stalled");
+			break;
+		}
+		kp = nkp;
+		kd = nkd;
+		/* load the correction LP into the double problem */
+		for (k = 0; k < ncols; k++)
+		{
+			j = colmap[k];
+			mpq_mul_2exp (num1, d[k], (unsigned long) kd);
+			qd->obj[j] = mpq_get_d (num1);
+			if (mpq_equal (qq->lower[j], mpq_ILL_MINDOUBLE))
+				qd->lower[j] = dbl_ILL_MINDOUBLE;
+			else
+			{
+				mpq_sub (num1, qq->lower[j], x[k]);
+				mpq_mul_2exp (num1, num1, (unsigned long) kp);
+				qd->lower[j] = mpq_get_d (num1);
+			}
+			if (mpq_equal (qq->upper[j], mpq_ILL_MAXDOUBLE))
+				qd->upper[j] = dbl_ILL_MAXDOUBLE;
+			else
+			{
+				mpq_sub (num1, qq->upper[j], x[k]);
+				mpq_mul_2exp (num1, num1, (unsigned long) kp);
+				qd->upper[j] = mpq_get_d (num1);
+			}
+		}
+		for (i = 0; i < nrows; i++)
+		{
+			mpq_mul_2exp (num1, r[i], (unsigned long) kp);
+			qd->rhs[i] = mpq_get_d (num1);
+		}
+		if (p_dbl->cache)
+		{
+			dbl_ILLlp_cache_free (p_dbl->cache);
+			dbl_EGlpNumClearVar (p_dbl->cache->val);
+			ILL_IFFREE(p_dbl->cache);
+		}
+		p_dbl->qstatus = QS_LP_MODIFIED;
+		/* re-solve warm started from the current basis and factorization */
+		EGcallD(dbl_QSget_itcnt (p_dbl, 0, 0, 0, 0, &it_before));
+		status = QS_LP_UNSOLVED;
+		if (dbl_QSopt_dual (p_dbl, &status) || status != QS_LP_OPTIMAL)
+		{
+			if (dbl_QSopt_primal (p_dbl, &status) || status != QS_LP_OPTIMAL)
+			{
+				MESSAGE (msg_lvl, "correction LP not solved, status %d", status);
+				break;
+			}
+		}
+		EGcallD(dbl_QSget_itcnt (p_dbl, 0, 0, 0, 0, &it_after));
+		log_message ("Refinement round %d: primal scale 2^%d, dual scale 2^%d, "
+								 "%d pivots", round, kp, kd, it_after - it_before);
+		stable = (it_after == it_before);
+		/* accumulate the corrections */
+		EGcallD(dbl_QSget_x_array (p_dbl, xc));
+		EGcallD(dbl_QSget_slack_array (p_dbl, xc + nstruct));
+		EGcallD(dbl_QSget_pi_array (p_dbl, yc));
+		for (k = 0; k < ncols; k++)
+		{
+			mpq_set_d (num1, xc[k]);
+			mpq_div_2exp (num1, num1, (unsigned long) kp);
+			mpq_add (x[k], x[k], num1);
+		}
+		for (i = 0; i < nrows; i++)
+		{
+			mpq_set_d (num1, yc[i]);
+			mpq_div_2exp (num1, num1, (unsigned long) kd);
+			mpq_add (y[i], y[i], num1);
+		}
+	}
+	/* hand back the last basis we saw */
+	if (!B)
+		B = dbl_QSget_basis (p_dbl);
+	if (B)
+	{
+		mpq_QSfree_basis (*basis);
+		*basis = B;
+		B = 0;
+	}
+CLEANUP:
+	if (obj_save)
+	{
+		memcpy (qd->obj, obj_save, sizeof (double) * ncols);
+		memcpy (qd->lower, lower_save, sizeof (double) * ncols);
+		memcpy (qd->upper, upper_save, sizeof (double) * ncols);
+		memcpy (qd->rhs, rhs_save, sizeof (double) * nrows);
+		if (p_dbl->cache)
+		{
+			dbl_ILLlp_cache_free (p_dbl->cache);
+			dbl_EGlpNumClearVar (p_dbl->cache->val);
+			ILL_IFFREE(p_dbl->cache);
+		}
+		p_dbl->qstatus = QS_LP_MODIFIED;
+	}
+	if (B)
+		mpq_QSfree_basis (B);
+	ILL_IFFREE(colmap);
+	dbl_EGlpNumFreeArray (obj_save);
+	dbl_EGlpNumFreeArray (lower_save);
+	dbl_EGlpNumFreeArray (upper_save);
+	dbl_EGlpNumFreeArray (rhs_save);
+	dbl_EGlpNumFreeArray (xc);
+	dbl_EGlpNumFreeArray (yc);
+	mpq_EGlpNumFreeArray (x);
+	mpq_EGlpNumFreeArray (y);
+	mpq_EGlpNumFreeArray (r);
+	mpq_EGlpNumFreeArray (d);
+	mpq_clear (viol_p);
+	mpq_clear (viol_d);
+	mpq_clear (num1);
+	log_timing ("Iterative refinement took ",
+							(double) (clock () - start) / CLOCKS_PER_SEC);
+	return rval;
+}
+#endif
+
+/* ========================================================================= */
+int QSexact_set_precision_schedule (mpq_QSdata * p,
+																		int nrungs,
+																		const unsigned *bits,
+																		const double *seconds)
+{
+	unsigned *rungs = 0;
+	double *rung_time = 0;
+	int i,
+	  rval = 0;
+
+	if (nrungs < 0 || (nrungs && !bits))
+	{
+		QSlog ("illegal precision schedule");
+		rval = 1;
+		goto CLEANUP;
+	}
+	for (i = 0; i < nrungs; i++)
+	{
+		if (bits[i] < 32)
+		{
+			QSlog ("illegal precision %u in rung %d of the schedule", bits[i], i);
+			rval = 1;
+			goto CLEANUP;
+		}
+	}
+	if (nrungs)
+	{
+		ILL_SAFE_MALLOC (rungs, nrungs, unsigned);
+		ILL_SAFE_MALLOC (rung_time, nrungs, double);
+		for (i = 0; i < nrungs; i++)
+		{
+			rungs[i] = bits[i];
+			rung_time[i] = seconds ? seconds[i] : 0.0;
+		}
+	}
+	ILL_IFFREE (p->exact_rungs);
+	ILL_IFFREE (p->exact_rung_time);
+	p->exact_nrungs = nrungs;
+	p->exact_rungs = rungs;
+	p->exact_rung_time = rung_time;
+	rungs = 0;
+	rung_time = 0;
+CLEANUP:
+	ILL_IFFREE (rungs);
+	ILL_IFFREE (rung_time);
+	EG_RETURN (rval);
+}
+
+/* ========================================================================= */
+int QSexact_set_checkpoint (mpq_QSdata * p,
+														const char *fname,
+														int resume)
+{
+	char *name = 0;
+	int rval = 0;
+
+	if (fname)
+	{
+		ILL_SAFE_MALLOC (name, strlen (fname) + 1, char);
+		strcpy (name, fname);
+	}
+	ILL_IFFREE (p->exact_checkpoint);
+	p->exact_checkpoint = name;
+	p->exact_resume = fname ? resume : 0;
+CLEANUP:
+	EG_RETURN (rval);
+}
+
+/* ========================================================================= */
+/** @brief save the state of #QSexact_solver to the checkpoint file of p_mpq,
+ * if any, to resume at rung k; a failure to write it is reported but not
+ * fatal. */
+static void QSexact_save_checkpoint (mpq_QSdata * p_mpq,
+																		 int k,
+																		 unsigned precision,
+																		 double lost,
+																		 int status,
+																		 int iter,
+																		 QSbasis * basis,
+																		 const int msg_lvl)
+{
+	QSexact_checkpoint ck;
+	if (!p_mpq->exact_checkpoint)
+		return;
+	ck.ncols = p_mpq->qslp->nstruct;
+	ck.nrows = p_mpq->qslp->nrows;
+	ck.rung = k;
+	ck.precision = precision;
+	ck.lost = (int) ceil (lost);
+	ck.status = status;
+	ck.iter = iter;
+	ck.basis = (basis && basis->nstruct == ck.ncols &&
+							basis->nrows == ck.nrows) ? basis : 0;
+	if (QSexact_write_checkpoint (p_mpq->exact_checkpoint, &ck))
+		return;
+	p_mpq->exact_info.nsaved++;
+	MESSAGE (msg_lvl, "checkpoint saved to %s, resuming at rung %d",
+					 p_mpq->exact_checkpoint, k);
+}
+
+/* ========================================================================= */
+/** @brief bits of rung k of the precision schedule of p_mpq, zero past the
+ * last rung */
+static unsigned QSexact_rung_bits (const mpq_QSdata * p_mpq,
+																	 int k)
+{
+	unsigned bits = 128;
+	if (p_mpq->exact_nrungs)
+		return k < p_mpq->exact_nrungs ? p_mpq->exact_rungs[k] : 0;
+	if (k >= QS_EXACT_MAX_ITER)
+		return 0;
+	while (k--)
+		bits = (unsigned) (bits * 1.5);
+	return bits;
+}
+
+/* ========================================================================= */
+/** @brief set the time limit of the simplex of an mpf problem to the budget
+ * of rung k, or to the one of p_mpq if the rung has none */
+static void QSexact_rung_limit (const mpq_QSdata * p_mpq,
+																mpf_QSdata * p_mpf,
+																int k)
+{
+	if (k < p_mpq->exact_nrungs && p_mpq->exact_rung_time[k] > 0)
+		p_mpf->lp->maxtime = p_mpq->exact_rung_time[k];
+	else
+		p_mpf->lp->maxtime = p_mpq->lp->maxtime;
+}
+
+/* ========================================================================= */
+/** @brief bits lost to element growth in the last factorization of p, i.e.
+ * \f$\log_2(\f$maxelem_factor / maxelem_orig\f$)\f$, zero if unknown */
+static double QSexact_lost_bits_dbl (dbl_QSdata * p)
+{
+	dbl_factor_work const *const f = p && p->lp ? p->lp->f : 0;
+	if (!f || f->maxelem_orig <= 0 || f->maxelem_factor <= f->maxelem_orig)
+		return 0;
+	return log2 (f->maxelem_factor / f->maxelem_orig);
+}
+
+/* ========================================================================= */
+/** @brief as #QSexact_lost_bits_dbl, for an mpf problem */
+static double QSexact_lost_bits_mpf (mpf_QSdata * p)
+{
+	mpf_factor_work *const f = p && p->lp ? p->lp->f : 0;
+	long eo,
+	  ef;
+	double d_o,
+	  d_f;
+	if (!f || mpf_sgn (f->maxelem_orig) <= 0 ||
+			mpf_cmp (f->maxelem_factor, f->maxelem_orig) <= 0)
+		return 0;
+	d_o = mpf_get_d_2exp (&eo, f->maxelem_orig);
+	d_f = mpf_get_d_2exp (&ef, f->maxelem_factor);
+	return (double) (ef - eo) + log2 (d_f / d_o);
+}
+
+/* ========================================================================= */
+/** @brief first rung to run, starting at rung k, after a solve with the given
+ * precision failed having lost the given number of bits to element growth
+ * (or, for the double solve, to the condition of its final basis).
+ * Unless the QS_PARAM_EXACT_PRECISION_SCHEDULE parameter of p_mpq is
+ * QS_EXACT_SCHEDULE_SKIP this is k; otherwise rungs shorter than precision
+ * plus the lost bits are skipped, but never the last one. */
+static int QSexact_next_rung (const mpq_QSdata * p_mpq,
+															int k,
+															unsigned precision,
+															double lost,
+															const int msg_lvl)
+{
+	double const need = precision + lost;
+	unsigned bits;
+	if (p_mpq->exact_schedule != QS_EXACT_SCHEDULE_SKIP || lost < 1)
+		return k;
+	while ((bits = QSexact_rung_bits (p_mpq, k)) && bits < need &&
+				 QSexact_rung_bits (p_mpq, k + 1))
+	{
+		MESSAGE (msg_lvl, "Skipping mpf with %u bits, %.0lf bits lost to element "
+						 "growth at %u bits", bits, lost, precision);
+		k++;
+	}
+	return k;
+}
+
+#if HAVE_EG_THREAD
+/* ========================================================================= */
+/** @name Speculative precision racing
+ * With QS_PARAM_EXACT_RACE set, #QSexact_solver runs the double solve and the
+ * first mpf rungs of the precision ladder on separate threads. The main
+ * thread verifies the racers in the order they finish and cancels the rest
+ * as soon as one result is certified. Every racer owns its copy of the
+ * problem, built by the main thread before the race starts; the mpf racers
+ * run at their own precision (see #QSexactThreadStart), and the rational
+ * problem is only ever touched by the main thread. */
+/** @{ */
+/* ========================================================================= */
+/** @brief maximum number of racers (double plus two mpf rungs) */
+#define QS_EXACT_RACE_MAX 3
+
+typedef struct QSexact_race_t QSexact_race_t;
+
+/* ========================================================================= */
+/** @brief one approximate solve taking part in the race */
+typedef struct
+{
+	QSexact_race_t *race;				/**< race this racer belongs to */
+	unsigned precision;					/**< mpf bits, zero for the double racer */
+	int simplexalgo;						/**< algorithm to start with */
+	dbl_QSdata *p_dbl;					/**< problem of the double racer */
+	mpf_QSdata *p_mpf;					/**< problem of an mpf racer */
+	qsstring_reporter reporter;	/**< reporter of the problem before the race */
+	int started;								/**< set if the thread was created */
+	int rval;										/**< return code of the solve */
+	int cancelled;							/**< set if the solve was stopped by the race */
+	int status;									/**< final status of the solve */
+	int iter;										/**< simplex iterations used */
+	double time;								/**< wall clock time of the solve */
+	QSbasis *basis;							/**< final basis, if any */
+	mpq_t *x;										/**< primal solution if optimal */
+	mpq_t *y;										/**< dual solution if optimal, infeasibility
+																	 proof if infeasible */
+	pthread_t thread;
+}
+QSexact_racer_t;
+
+/* ========================================================================= */
+/** @brief shared state of a race, protected by mt */
+struct QSexact_race_t
+{
+	pthread_mutex_t mt;
+	pthread_cond_t cv;					/**< signaled whenever a racer finishes */
+	int cancel;									/**< set to stop all running racers */
+	int nracer;									/**< number of racers */
+	int nfinished;							/**< number of racers in order */
+	QSexact_racer_t *order[QS_EXACT_RACE_MAX];	/**< racers by finishing time */
+	QSexact_racer_t racer[QS_EXACT_RACE_MAX];
+};
+
+/* ========================================================================= */
+/** @brief tell whether the race has been cancelled */
+static int QSexact_race_cancelled (QSexact_race_t * race)
+{
+	int cancel;
+	pthread_mutex_lock (&race->mt);
+	cancel = race->cancel;
+	pthread_mutex_unlock (&race->mt);
+	return cancel;
+}
+
+/* ========================================================================= */
+/** @brief reporter installed on the racing problems, it is called by the
+ * simplex every few iterations, forwards the progress output to the original
+ * reporter and aborts the solve once the race is cancelled. */
+static int QSexact_race_report (void *dest,
+																const char *s)
+{
+	QSexact_racer_t *const racer = (QSexact_racer_t *) dest;
+	if (QSexact_race_cancelled (racer->race))
+		return -1;
+	if (s && racer->reporter.report_fct)
+		return racer->reporter.report_fct (racer->reporter.dest, s) < 0 ? -1 : 0;
+	return 0;
+}
+
+/* ========================================================================= */
+/** @brief record that a racer is done and wake up the main thread */
+static void QSexact_race_finish (QSexact_racer_t * racer)
+{
+	QSexact_race_t *const race = racer->race;
+	pthread_mutex_lock (&race->mt);
+	race->order[race->nfinished++] = racer;
+	pthread_cond_signal (&race->cv);
+	pthread_mutex_unlock (&race->mt);
+}
+
+/* ========================================================================= */
+/** @brief thread body of the double racer, solve and hand back the basis and
+ * the rational images of the approximate solution (or infeasibility proof) */
+static void *QSexact_race_dbl (void *arg)
+{
+	QSexact_racer_t *const racer = (QSexact_racer_t *) arg;
+	dbl_QSdata *const p = racer->p_dbl;
+	double const start = ILLutil_real_zeit ();
+	double *x_dbl = 0,
+	 *y_dbl = 0;
+	int rval = 0;
+
+	racer->status = QS_LP_UNSOLVED;
+	rval = dbl_ILLeditor_solve (p, racer->simplexalgo);
+	/* a losing racer is stopped through its reporter, that is not an error */
+	if (rval && QSexact_race_cancelled (racer->race))
+	{
+		racer->cancelled = 1;
+		rval = 0;
+		goto CLEANUP;
+	}
+	CHECKRVALG (rval, CLEANUP);
+	EGcallD(dbl_QSget_status (p, &racer->status));
+	if ((racer->status == QS_LP_INFEASIBLE) &&
+			(p->lp->final_phase != PRIMAL_PHASEI) &&
+			(p->lp->final_phase != DUAL_PHASEII))
+		dbl_QSopt_primal (p, &racer->status);
+	EGcallD(dbl_QSget_status (p, &racer->status));
+	EGcallD(dbl_QSget_itcnt (p, 0, 0, 0, 0, &racer->iter));
+	racer->basis = dbl_QSget_basis (p);
+	switch (racer->status)
+	{
+	case QS_LP_OPTIMAL:
+		x_dbl = dbl_EGlpNumAllocArray (p->qslp->ncols);
+		y_dbl = dbl_EGlpNumAllocArray (p->qslp->nrows);
+		EGcallD(dbl_QSget_x_array (p, x_dbl));
+		EGcallD(dbl_QSget_pi_array (p, y_dbl));
+		racer->x = QScopy_array_dbl_mpq (x_dbl);
+		racer->y = QScopy_array_dbl_mpq (y_dbl);
+		break;
+	case QS_LP_INFEASIBLE:
+		y_dbl = dbl_EGlpNumAllocArray (p->qslp->nrows);
+		if (!dbl_QSget_infeas_array (p, y_dbl))
+			racer->y = QScopy_array_dbl_mpq (y_dbl);
+		break;
+	default:
+		break;
+	}
+CLEANUP:
+	dbl_EGlpNumFreeArray (x_dbl);
+	dbl_EGlpNumFreeArray (y_dbl);
+	racer->rval = rval;
+	racer->time = ILLutil_real_zeit () - start;
+	QSexact_race_finish (racer);
+	return 0;
+}
+
+/* ========================================================================= */
+/** @brief thread body of an mpf racer, as #QSexact_race_dbl but running at
+ * the precision of the racer */
+static void *QSexact_race_mpf (void *arg)
+{
+	QSexact_racer_t *const racer = (QSexact_racer_t *) arg;
+	mpf_QSdata *const p = racer->p_mpf;
+	double const start = ILLutil_real_zeit ();
+	mpf_t *x_mpf = 0,
+	 *y_mpf = 0;
+	int rval = 0;
+
+	QSexactThreadStart (racer->precision);
+	racer->status = QS_LP_UNSOLVED;
+	rval = mpf_ILLeditor_solve (p, racer->simplexalgo);
+	/* a losing racer is stopped through its reporter, that is not an error */
+	if (rval && QSexact_race_cancelled (racer->race))
+	{
+		racer->cancelled = 1;
+		rval = 0;
+		goto CLEANUP;
+	}
+	CHECKRVALG (rval, CLEANUP);
+	EGcallD(mpf_QSget_status (p, &racer->status));
+	if ((racer->status == QS_LP_INFEASIBLE) &&
+			(p->lp->final_phase != PRIMAL_PHASEI) &&
+			(p->lp->final_phase != DUAL_PHASEII))
+		mpf_QSopt_primal (p, &racer->status);
+	EGcallD(mpf_QSget_status (p, &racer->status));
+	EGcallD(mpf_QSget_itcnt (p, 0, 0, 0, 0, &racer->iter));
+	racer->basis = mpf_QSget_basis (p);
+	switch (racer->status)
+	{
+	case QS_LP_OPTIMAL:
+		x_mpf = mpf_EGlpNumAllocArray (p->qslp->ncols);
+		y_mpf = mpf_EGlpNumAllocArray (p->qslp->nrows);
+		EGcallD(mpf_QSget_x_array (p, x_mpf));
+		EGcallD(mpf_QSget_pi_array (p, y_mpf));
+		racer->x = QScopy_array_mpf_mpq (x_mpf);
+		racer->y = QScopy_array_mpf_mpq (y_mpf);
+		break;
+	case QS_LP_INFEASIBLE:
+		y_mpf = mpf_EGlpNumAllocArray (p->qslp->nrows);
+		EGcallD(mpf_QSget_infeas_array (p, y_mpf));
+		racer->y = QScopy_array_mpf_mpq (y_mpf);
+		break;
+	default:
+		break;
+	}
+CLEANUP:
+	mpf_EGlpNumFreeArray (x_mpf);
+	mpf_EGlpNumFreeArray (y_mpf);
+	QSexactThreadClear ();
+	racer->rval = rval;
+	racer->time = ILLutil_real_zeit () - start;
+	QSexact_race_finish (racer);
+	return 0;
+}
+
+/* ========================================================================= */
+/** @brief certify the result of a finished racer in rational arithmetic, in
+ * the same way the sequential ladder does: test the approximate solution
+ * first, then the exact basic solution of the racer's basis.
+ * @param certified set to one if the problem was solved (x, y and status are
+ * then set), zero otherwise. */
+static int QSexact_race_verify (mpq_QSdata * p_mpq,
+																QSexact_racer_t * racer,
+																mpq_t * const x,
+																mpq_t * const y,
+																const int msg_lvl,
+																int *status,
+																int *certified)
+{
+	int rval = 0;
+	int simplexalgo = DUAL_SIMPLEX;
+	*certified = 0;
+	if (racer->rval)
+		goto CLEANUP;
+	switch (racer->status)
+	{
+	case QS_LP_OPTIMAL:
+		if (QSexact_reconstructed_test (p_mpq, racer->x, racer->y, racer->basis,
+																		racer->precision ? racer->precision :
+																		DBL_MANT_DIG, msg_lvl))
+		{
+			optimal_output (p_mpq, x, y, racer->x, racer->y);
+			*status = QS_LP_OPTIMAL;
+			*certified = 1;
+			break;
+		}
+		EGcallD(QSexact_basis_status (p_mpq, status, racer->basis, msg_lvl,
+																	&simplexalgo));
+		if (*status != QS_LP_OPTIMAL)
+			break;
+		MESSAGE (msg_lvl, "Retesting solution");
+		EGcallD(mpq_QSget_x_array (p_mpq, racer->x));
+		EGcallD(mpq_QSget_pi_array (p_mpq, racer->y));
+		if (QSexact_optimal_test (p_mpq, racer->x, racer->y, racer->basis))
+		{
+			optimal_output (p_mpq, x, y, racer->x, racer->y);
+			*certified = 1;
+		}
+		break;
+	case QS_LP_INFEASIBLE:
+		if (racer->y && QSexact_infeasible_test (p_mpq, racer->y))
+		{
+			infeasible_output (p_mpq, y, racer->y);
+			*status = QS_LP_INFEASIBLE;
+			*certified = 1;
+			break;
+		}
+		if (!racer->basis)
+			break;
+		MESSAGE (msg_lvl, "Retesting solution in exact arithmetic");
+		EGcallD(QSexact_basis_status (p_mpq, status, racer->basis, msg_lvl,
+																	&simplexalgo));
+		if (*status != QS_LP_INFEASIBLE)
+			break;
+		mpq_EGlpNumFreeArray (racer->y);
+		racer->y = mpq_EGlpNumAllocArray (p_mpq->qslp->nrows);
+		EGcallD(mpq_QSget_infeas_array (p_mpq, racer->y));
+		if (QSexact_infeasible_test (p_mpq, racer->y))
+		{
+			infeasible_output (p_mpq, y, racer->y);
+			*certified = 1;
+		}
+		break;
+	default:
+		break;
+	}
+CLEANUP:
+	EG_RETURN (rval);
+}
+
+/* ========================================================================= */
+/** @brief run the double solve and the first mpf rungs concurrently, and
+ * certify whichever finishes first. If no racer can be certified, the caller
+ * continues with the sequential precision ladder.
+ * @param p_mpq problem to solve.
+ * @param x,y,ebasis,simplexalgo as in #QSexact_solver.
+ * @param msg_lvl message level.
+ * @param status where to store the status of the problem.
+ * @param basis where to store a basis to warm start the next precision (the
+ * one of the highest precision racer that produced one), if not certified.
+ * @param precision where to store the bits of the last raced rung.
+ * @param lost where to store the bits that rung lost to element growth.
+ * @param last_status,last_iter status and iteration count of that racer.
+ * @param rung where to store the first rung of the precision schedule that
+ * was not raced.
+ * @param done set to one if the race settled the problem (certified, or an
+ * objective limit was reached, in which case status is #QS_LP_OBJ_LIMIT),
+ * zero if the ladder has to go on.
+ * @return zero on success, non-zero otherwise. */
+static int QSexact_race (mpq_QSdata * p_mpq,
+												 mpq_t * const x,
+												 mpq_t * const y,
+												 QSbasis * const ebasis,
+												 int simplexalgo,
+												 const int msg_lvl,
+												 int *status,
+												 QSbasis ** basis,
+												 unsigned *precision,
+												 double *lost,
+												 int *last_status,
+												 int *last_iter,
+												 int *rung,
+												 int *done)
+{
+	QSexact_race_t race;
+	QSexact_racer_t *racer,
+	 *best = 0;
+	unsigned const old_precision = EGLPNUM_PRECISION;
+	int const nmpf = p_mpq->exact_race == QS_EXACT_RACE_MPF192 &&
+		QSexact_rung_bits (p_mpq, 1) ? 2 : 1;
+	int const warm = ebasis && ebasis->nstruct;
+	double const start = ILLutil_real_zeit ();
+	int rval = 0,
+	  certified = 0,
+	  nverified = 0,
+	  i;
+	char label[128];
+
+	*done = 0;
+	memset (&race, 0, sizeof (race));
+	pthread_mutex_init (&race.mt, 0);
+	pthread_cond_init (&race.cv, 0);
+	race.nracer = 1 + nmpf;
+	/* build all copies up front, so the racers never touch p_mpq */
+	for (i = 0; i < race.nracer; i++)
+	{
+		racer = race.racer + i;
+		racer->race = &race;
+		racer->precision = i ? QSexact_rung_bits (p_mpq, i - 1) : 0;
+		if (!i)
+		{
+			racer->simplexalgo = warm ? DUAL_SIMPLEX : simplexalgo;
+			racer->p_dbl = QScopy_prob_mpq_dbl (p_mpq, "dbl_problem");
+			if (!racer->p_dbl)
+			{
+				rval = 1;
+				goto CLEANUP;
+			}
+			if (__QS_SB_VERB <= DEBUG)
+				racer->p_dbl->simplex_display = 1;
+			if (warm)
+				EGcallD(dbl_QSload_basis (racer->p_dbl, ebasis));
+			ILLstring_reporter_copy (&racer->reporter,
+															 &racer->p_dbl->qslp->reporter);
+			dbl_QSset_reporter (racer->p_dbl, racer->p_dbl->lp->iterskip,
+													(void *) QSexact_race_report, racer);
+		}
+		else
+		{
+			racer->simplexalgo = warm ? DUAL_SIMPLEX : PRIMAL_SIMPLEX;
+			QSexact_set_precision (racer->precision);
+			racer->p_mpf = QScopy_prob_mpq_mpf (p_mpq, "mpf_problem");
+			if (!racer->p_mpf)
+			{
+				rval = 1;
+				goto CLEANUP;
+			}
+			if (__QS_SB_VERB <= DEBUG)
+				racer->p_mpf->simplex_display = 1;
+			QSexact_rung_limit (p_mpq, racer->p_mpf, i - 1);
+			if (warm)
+				EGcallD(mpf_QSload_basis (racer->p_mpf, ebasis));
+			ILLstring_reporter_copy (&racer->reporter,
+															 &racer->p_mpf->qslp->reporter);
+			mpf_QSset_reporter (racer->p_mpf, racer->p_mpf->lp->iterskip,
+													(void *) QSexact_race_report, racer);
+		}
+	}
+	QSexact_set_precision (old_precision);
+	if (p_mpq->simplex_display || DEBUG >= __QS_SB_VERB)
+		QSlog("Racing double precision against mpf with %u bits", 
+					race.racer[race.nracer - 1].precision);
+	/* start the race, a racer that can not be started is reported as failed */
+	for (i = 0; i < race.nracer; i++)
+	{
+		racer = race.racer + i;
+		if (pthread_create (&racer->thread, 0, i ? QSexact_race_mpf :
+												QSexact_race_dbl, racer))
+		{
+			racer->rval = 1;
+			QSexact_race_finish (racer);
+		}
+		else
+			racer->started = 1;
+	}
+	/* verify in finishing order until something is certified */
+	while (!certified && nverified < race.nracer)
+	{
+		pthread_mutex_lock (&race.mt);
+		while (race.nfinished == nverified)
+			pthread_cond_wait (&race.cv, &race.mt);
+		racer = race.order[nverified++];
+		pthread_mutex_unlock (&race.mt);
+		MESSAGE (msg_lvl, "racer with %u bits finished %d of %d, status %d",
+						 racer->precision, nverified, race.nracer, racer->status);
+		if (!racer->rval && racer->status == QS_LP_OBJ_LIMIT)
+		{
+			IFMESSAGE (p_mpq->simplex_display, "Objective limit reached (in "
+								 "floating point) ending now");
+			*status = QS_LP_OBJ_LIMIT;
+			*done = 1;
+			break;
+		}
+		EGcallD(QSexact_race_verify (p_mpq, racer, x, y, msg_lvl, status,
+																 &certified));
+		if (certified)
+		{
+			*done = 1;
+			p_mpq->exact_info.race_winner = (int) racer->precision;
+			snprintf (label, sizeof (label), "Precision race won by %u bits "
+								"(0 is double) in ", racer->precision);
+			log_timing (label, ILLutil_real_zeit () - start);
+		}
+	}
+CLEANUP:
+	pthread_mutex_lock (&race.mt);
+	race.cancel = 1;
+	pthread_mutex_unlock (&race.mt);
+	for (i = 0; i < race.nracer; i++)
+	{
+		racer = race.racer + i;
+		if (racer->started)
+			pthread_join (racer->thread, 0);
+		if (racer->started && !racer->rval && !racer->cancelled)
+		{
+			snprintf (label, sizeof (label), "Racer at %u bits (0 is double) "
+								"took ", racer->precision);
+			log_timing (label, racer->time);
+		}
+		if (racer->basis && (!best || racer->precision > best->precision))
+			best = racer;
+	}
+	/* hand the best basis over to the sequential ladder */
+	if (!*done && !rval)
+	{
+		*status = QS_LP_UNSOLVED;
+		if (best)
+		{
+			*basis = best->basis;
+			best->basis = 0;
+			*last_status = best->status;
+			*last_iter = best->iter;
+		}
+		*precision = race.racer[race.nracer - 1].precision;
+		*lost = QSexact_lost_bits_mpf (race.racer[race.nracer - 1].p_mpf);
+		*rung = nmpf;
+	}
+	for (i = 0; i < race.nracer; i++)
+	{
+		racer = race.racer + i;
+		if (racer->basis)
+			mpq_QSfree_basis (racer->basis);
+		mpq_EGlpNumFreeArray (racer->x);
+		mpq_EGlpNumFreeArray (racer->y);
+		dbl_QSfree_prob (racer->p_dbl);
+		mpf_QSfree_prob (racer->p_mpf);
+	}
+	QSexact_set_precision (old_precision);
+	pthread_cond_destroy (&race.cv);
+	pthread_mutex_destroy (&race.mt);
+	EG_RETURN (rval);
+}
+/** @} */
+#endif
+
 /* ========================================================================= */
 int QSexact_solver (mpq_QSdata * p_mpq, mpq_t * const x, mpq_t * const y, QSbasis * const ebasis, int simplexalgo, int *status)
 { 
@@ -1806,8 +3730,12 @@ int QSexact_solver (mpq_QSdata * p_mpq, mpq_t * const x, mpq_t * const y, QSbasi
 	int last_status = 0, last_iter = 0;
 	QSbasis *basis = 0;
 	unsigned precision = EGLPNUM_PRECISION;
+	double lost = 0;
+	double cond = 0,
+	  growth = 0,
+	  cond_bits = 0;
 	int rval = 0,
-	  it = QS_EXACT_MAX_ITER;
+	  rung = 0;
 	dbl_QSdata *p_dbl = 0;
 	mpf_QSdata *p_mpf = 0;
 	double *x_dbl = 0,
@@ -1818,6 +3746,10 @@ int QSexact_solver (mpq_QSdata * p_mpq, mpq_t * const x, mpq_t * const y, QSbasi
 	 *y_mpf = 0;
 	int const msg_lvl = __QS_SB_VERB <= DEBUG ? 0: (1 - p_mpq->simplex_display) * 10000;
 	*status = 0;
+	p_mpq->exact_info.race_winner = -1;
+	p_mpq->exact_info.rung = -1;
+	p_mpq->exact_info.resumed = -1;
+	p_mpq->exact_info.nsaved = 0;
 	/* save the problem if we are really debugging */
 	if(DEBUG >= __QS_SB_VERB)
 	{
@@ -1913,7 +3845,68 @@ int QSexact_solver (mpq_QSdata * p_mpq, mpq_t * const x, mpq_t * const y, QSbasi
 		p_mpf = 0;
 	}
 	#endif
+	/* pick up a previous solve where it was left, if asked to */
+	if (p_mpq->exact_resume && p_mpq->exact_checkpoint)
+	{
+		QSexact_checkpoint ck;
+		p_mpq->exact_resume = 0;
+		if (QSexact_read_checkpoint (p_mpq->exact_checkpoint, &ck))
+		{
+			IFMESSAGE (p_mpq->simplex_display, "no checkpoint to resume from in %s",
+								 p_mpq->exact_checkpoint);
+		}
+		else if (ck.ncols != p_mpq->qslp->nstruct ||
+						 ck.nrows != p_mpq->qslp->nrows)
+		{
+			IFMESSAGE (p_mpq->simplex_display, "checkpoint %s is for a %dx%d "
+								 "problem, ignoring it", p_mpq->exact_checkpoint, ck.nrows,
+								 ck.ncols);
+			QSexact_free_checkpoint (&ck);
+		}
+		else
+		{
+			IFMESSAGE (p_mpq->simplex_display, "resuming from %s at rung %d after "
+								 "%u bits", p_mpq->exact_checkpoint, ck.rung, ck.precision);
+			rung = ck.rung;
+			p_mpq->exact_info.resumed = rung;
+			precision = ck.precision;
+			lost = ck.lost;
+			last_status = ck.status;
+			last_iter = ck.iter;
+			if (basis)
+				mpq_QSfree_basis (basis);
+			basis = ck.basis;
+			ck.basis = 0;
+			goto MPF_PRECISION;
+		}
+	}
 	DOUBLE_PHASE:
+#if HAVE_EG_THREAD
+	if (p_mpq->exact_race != QS_EXACT_RACE_OFF)
+	{
+		QSbasis *race_basis = 0;
+		int race_done = 0;
+		EGcallD(QSexact_race (p_mpq, x, y, (basis && basis->nstruct) ? basis : ebasis,
+													simplexalgo, msg_lvl, status, &race_basis, &precision,
+													&lost, &last_status, &last_iter, &rung, &race_done));
+		if (race_done)
+		{
+			if (*status == QS_LP_OBJ_LIMIT)
+				rval = 1;
+			goto CLEANUP;
+		}
+		if (race_basis)
+		{
+			if (basis)
+				mpq_QSfree_basis (basis);
+			basis = race_basis;
+		}
+		goto MPF_PRECISION;
+	}
+#else
+	IFMESSAGE (p_mpq->exact_race != QS_EXACT_RACE_OFF && p_mpq->simplex_display,
+						 "precision racing needs thread support, solving sequentially");
+#endif
 	/* First try with double precision */
 	if (p_mpq->simplex_display || DEBUG >= __QS_SB_VERB)
 	{
@@ -1961,6 +3954,16 @@ int QSexact_solver (mpq_QSdata * p_mpq, mpq_t * const x, mpq_t * const y, QSbasi
 	EGcallD(dbl_QSget_status (p_dbl, status));
 	last_status = *status;
 	EGcallD(dbl_QSget_itcnt(p_dbl, 0, 0, 0, 0, &last_iter));
+	/* estimate how much of the double solution we can trust */
+	if (p_dbl->lp && p_dbl->lp->basisid != -1 &&
+			!dbl_QSget_basis_condition (p_dbl, &cond, &growth))
+	{
+		cond_bits = cond > 1 ? log2 (cond) : 0;
+		log_message ("Double basis condition estimate %.3e, growth %.3e",
+								 cond, growth);
+		MESSAGE (msg_lvl, "double basis condition estimate %.3e (%.1lf bits), "
+						 "growth %.3e", cond, cond_bits, growth);
+	}
 	/* deal with the problem depending on what status we got from our optimizer */
 	switch (*status)
 	{
@@ -1974,13 +3977,28 @@ int QSexact_solver (mpq_QSdata * p_mpq, mpq_t * const x, mpq_t * const y, QSbasi
 		dbl_EGlpNumFreeArray (x_dbl);
 		dbl_EGlpNumFreeArray (y_dbl);
 		basis = dbl_QSget_basis (p_dbl);
-		if (QSexact_optimal_test (p_mpq, x_mpq, y_mpq, basis))
+		if (QSexact_reconstructed_test (p_mpq, x_mpq, y_mpq, basis, DBL_MANT_DIG,
+																		msg_lvl))
 		{
 			optimal_output (p_mpq, x, y, x_mpq, y_mpq);
 			goto CLEANUP;
 		}
+		else if (cond_bits > QS_EXACT_MAX_DBL_COND_BITS)
+		{
+			MESSAGE (msg_lvl, "double basis too ill conditioned, skipping its "
+							 "exact verification");
+		}
 		else
 		{
+#if QSEXACT_ITERATIVE_REFINEMENT
+			int refined = 0;
+			EGcallD(QSexact_refine (p_mpq, p_dbl, x_mpq, y_mpq, &basis, msg_lvl, &refined));
+			if (refined)
+			{
+				optimal_output (p_mpq, x, y, x_mpq, y_mpq);
+				goto CLEANUP;
+			}
+#endif
 			EGcallD(QSexact_basis_status (p_mpq, status, basis, msg_lvl, &simplexalgo));
 			if (*status == QS_LP_OPTIMAL)
 			{
@@ -2072,14 +4090,22 @@ int QSexact_solver (mpq_QSdata * p_mpq, mpq_t * const x, mpq_t * const y, QSbasi
 	/* if we reach this point, then we have to keep going, we use the previous
 	 * basis ONLY if the previous precision thinks that it has the optimal
 	 * solution, otherwise we start from scratch. */
-	precision = 128;
+	precision = DBL_MANT_DIG;
+	lost = QSexact_lost_bits_dbl (p_dbl);
+	if (cond_bits > lost)
+		lost = cond_bits;
 	MPF_PRECISION:
 		dbl_QSfree_prob (p_dbl);
 	p_dbl = 0;
-	/* try with multiple precision floating points */
-	for (; it--; precision = (unsigned) (precision * 1.5))
+	QSexact_save_checkpoint (p_mpq, rung, precision, lost, last_status,
+													 last_iter, basis, msg_lvl);
+	/* try with multiple precision floating points, following the schedule */
+	rung = QSexact_next_rung (p_mpq, rung, precision, lost, msg_lvl);
+	for (; (precision = QSexact_rung_bits (p_mpq, rung)) != 0;
+			 rung = QSexact_next_rung (p_mpq, rung + 1, precision, lost, msg_lvl))
 	{
 		clock_t mpf_start = clock();
+		p_mpq->exact_info.rung = rung;
 
 		// AP: save precision to file
 		EGioFile_t *out = 0;
@@ -2092,12 +4118,21 @@ int QSexact_solver (mpq_QSdata * p_mpq, mpq_t * const x, mpq_t * const y, QSbasi
 		{
 			QSlog("Trying mpf with %u bits", precision);
 		}
+#if QSEXACT_REUSE_SKELETON
+		if (p_mpf && mpf_QSrematerialize_prob (p_mpq, p_mpf, precision))
+		{
+			mpf_QSfree_prob (p_mpf);
+			p_mpf = 0;
+		}
+		if (!p_mpf)
+#endif
 		p_mpf = QScopy_prob_mpq_mpf (p_mpq, "mpf_problem");
 		if(DEBUG >= __QS_SB_VERB)
 		{
 			EGcallD(mpf_QSwrite_prob(p_mpf, "qsxprob.mpf.lp","LP"));
 		}
 		if(__QS_SB_VERB <= DEBUG) p_mpf->simplex_display = 1;
+		QSexact_rung_limit (p_mpq, p_mpf, rung);
 		simplexalgo = PRIMAL_SIMPLEX;
 		if(!last_iter) last_status = QS_LP_UNSOLVED;
 
@@ -2122,12 +4157,16 @@ int QSexact_solver (mpq_QSdata * p_mpq, mpq_t * const x, mpq_t * const y, QSbasi
 				mpf_QSload_basis (p_mpf, ebasis);
 				simplexalgo = DUAL_SIMPLEX;
 			}
+#if QSEXACT_REUSE_SKELETON
+			EGcallD(mpf_QSseed_factor (p_mpq, p_mpf));
+#endif
 		}
 		else
 		{
 			if(p_mpf->basis)
 			{
 				mpf_ILLlp_basis_free(p_mpf->basis);
+				ILL_IFFREE(p_mpf->basis);
 				p_mpf->lp->basisid = -1;
 				p_mpf->factorok = 0;
 			}
@@ -2176,7 +4215,8 @@ int QSexact_solver (mpq_QSdata * p_mpq, mpq_t * const x, mpq_t * const y, QSbasi
 			y_mpq = QScopy_array_mpf_mpq (y_mpf);
 			mpf_EGlpNumFreeArray (x_mpf);
 			mpf_EGlpNumFreeArray (y_mpf);
-			if (QSexact_optimal_test (p_mpq, x_mpq, y_mpq, basis))
+			if (QSexact_reconstructed_test (p_mpq, x_mpq, y_mpq, basis, precision,
+																			msg_lvl))
 			{
 				optimal_output (p_mpq, x, y, x_mpq, y_mpq);
             			clock_t mpf_end = clock();
@@ -2276,14 +4316,19 @@ int QSexact_solver (mpq_QSdata * p_mpq, mpq_t * const x, mpq_t * const y, QSbasi
 			break;
 		}
 	NEXT_PRECISION:
+		lost = QSexact_lost_bits_mpf (p_mpf);
+		QSexact_save_checkpoint (p_mpq, rung + 1, precision, lost, last_status,
+														 last_iter, basis, msg_lvl);
 		clock_t mpf_end = clock();
         	double elapsed_mpf = (double)(mpf_end - mpf_start) / CLOCKS_PER_SEC;
         	char label[128];
         	snprintf(label, sizeof(label), "MPF solve at %u bits took ", precision);
         	log_timing(label, elapsed_mpf);	
 	
+#if !QSEXACT_REUSE_SKELETON
 		mpf_QSfree_prob (p_mpf);
 		p_mpf = 0;
+#endif
 	}
 	/* ending */
 CLEANUP:
@@ -2334,6 +4379,18 @@ void QSexactStart(void)
 	__QSexact_setup = 1;
 }
 /* ========================================================================= */
+void QSexactThreadStart(const unsigned precision)
+{
+	EGlpNumThreadStart(precision);
+	mpf_ILLchange_precision();
+}
+/* ========================================================================= */
+void QSexactThreadClear(void)
+{
+	mpf_ILLend();
+	EGlpNumThreadClear();
+}
+/* ========================================================================= */
 void QSexactClear(void)
 {
 	if(!__QSexact_setup) return;
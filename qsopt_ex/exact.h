@@ -93,6 +93,50 @@
  * #QScopy_prob_mpq_dbl and #QScopy_prob_mpq_mpf */
 #define QSEXACT_SAVE_INT 0
 
+/* ========================================================================= */
+/** @brief If enabled, #QSexact_solver keeps a single mpf_QSdata alive across
+ * all precision levels. On each new precision only the numeric arrays are
+ * re-materialized from the rational problem (index arrays, row copy and symbol
+ * tables are kept), and when the rational side holds a factorization of the
+ * basis being loaded, it is converted to seed the LU at the new precision
+ * instead of refactoring from scratch. */
+#define QSEXACT_REUSE_SKELETON 1
+
+/* ========================================================================= */
+/** @brief If enabled, when the double precision solution fails the exact
+ * optimality test, #QSexact_solver first tries rational iterative refinement
+ * on the (still factored) double problem: the exact primal and dual residuals
+ * of the current solution are scaled by powers of two, the resulting
+ * correction LP is re-solved warm-started in double, and the corrections are
+ * accumulated in rational arithmetic. The mpf precision ladder is only used
+ * if refinement stalls. */
+#define QSEXACT_ITERATIVE_REFINEMENT 1
+
+#ifndef QS_EXACT_IR_MAX_ROUNDS
+/* ========================================================================= */
+/** @brief maximum number of correction LPs solved by the iterative refinement
+ * before giving up and falling back to the mpf precision ladder. */
+#define QS_EXACT_IR_MAX_ROUNDS 10
+#endif
+
+#ifndef QS_EXACT_IR_SCALE_STEP
+/* ========================================================================= */
+/** @brief maximum number of bits by which the primal (or dual) scaling
+ * factor of the correction LP may grow from one refinement round to the
+ * next. */
+#define QS_EXACT_IR_SCALE_STEP 32
+#endif
+
+#ifndef QS_EXACT_MAX_DBL_COND_BITS
+/* ========================================================================= */
+/** @brief if the estimated condition number of the final double basis (see
+ * #dbl_QSget_basis_condition) is above two to this power, the double
+ * solution carries no correct bits, and #QSexact_solver goes straight to the
+ * mpf precision ladder (warm started from that basis) instead of spending a
+ * rational basis solve and iterative refinement on it. */
+#define QS_EXACT_MAX_DBL_COND_BITS 52
+#endif
+
 /* ========================================================================= */
 /** @brief Copy an exact problem (mpq_QSdata) to a regular double version of the
  * problem (dbl_QSdata) */
@@ -140,6 +184,29 @@ int QSexact_optimal_test (mpq_QSdata * p,
 													mpq_t * d_sol,
 													QSbasis * basis);
 
+/* ========================================================================= */
+/** @brief Snap approximate solution values to nearby rationals with small
+ * denominators (rational reconstruction).
+ * @param array values to snap, usually the rational image of a floating point
+ * solution.
+ * @param n number of entries in array.
+ * @param maxden largest denominator to snap to.
+ * @param precision number of bits of the arithmetic that computed the values.
+ * @return the number of entries that were changed.
+ * @par Description:
+ * Each entry whose denominator is larger than maxden is expanded as a
+ * continued fraction, and replaced by its first convergent \f$p/q\f$ with
+ * \f$q\leq\f$ maxden and \f$|a-p/q|\leq 2^{-precision/2}\max(1,|a|)\f$; if
+ * there is no such convergent the entry is left as it is. maxden is lowered to
+ * \f$2^{precision/4-1}\f$ if needed, so that no two candidates lie within
+ * the tolerance of the same value. When the exact solution has small
+ * denominators this usually recovers it, so that #QSexact_optimal_test
+ * succeeds without any rational factorization. */
+int QSexact_reconstruct (mpq_t * array,
+												 int n,
+												 unsigned long maxden,
+												 unsigned precision);
+
 /* ========================================================================= */
 /** @brief Print into a file the optimal solution.
  * @param p original problem.
@@ -149,6 +216,163 @@ int QSexact_optimal_test (mpq_QSdata * p,
 int QSexact_print_sol (mpq_QSdata * p,
 											 EGioFile_t * out_f);
 
+/* ========================================================================= */
+/** @name Binary certificates
+ * A compact binary alternative to #QSexact_print_sol, whose size (and I/O
+ * time) is proportional to the number of limbs of the rationals rather than
+ * to their number of decimal digits. All fields are little endian and every
+ * record starts at a multiple of 8 bytes, so that an uncompressed file can be
+ * mapped and walked directly:
+ *
+ * - header: the 8 bytes "QSXCERT1", then four 32 bit words: the QS_LP_xxx
+ *   status, the number of columns, the number of rows and a set of flags
+ *   (#QS_CERT_BASIS, #QS_CERT_X, #QS_CERT_Y, #QS_CERT_RC) telling which of the
+ *   sections below are present;
+ * - basis: cstat (one byte per column) followed by rstat (one byte per row),
+ *   with the QS_COL_BSTAT_xxx / QS_ROW_BSTAT_xxx values, zero padded to a
+ *   multiple of 8 bytes;
+ * - x (one rational per column), y (one per row, the dual solution, or the
+ *   Farkas multipliers if the problem is infeasible) and rc (one per column).
+ *
+ * A rational is its numerator followed by its (positive) denominator, in
+ * canonical form. An integer is a signed 64 bit limb count n (negative for
+ * negative numbers, zero for zero) followed by |n| 64 bit limbs, least
+ * significant first, as given by mpz_export.
+ *
+ * The file may be compressed through the gz/bz2 backends of #EGioOpen. */
+/** @{ */
+#define QS_CERT_BASIS 1					/**< the certificate holds a basis */
+#define QS_CERT_X 2							/**< the certificate holds x */
+#define QS_CERT_Y 4							/**< the certificate holds y */
+#define QS_CERT_RC 8						/**< the certificate holds rc */
+
+/* ========================================================================= */
+/** @brief an exact certificate as read by #QSexact_read_cert, absent
+ * sections are null pointers */
+typedef struct
+{
+	int status;										/**< QS_LP_xxx status of the problem */
+	int ncols;										/**< number of structural columns */
+	int nrows;										/**< number of rows */
+	QSbasis *basis;								/**< final basis */
+	mpq_t *x;											/**< primal solution */
+	mpq_t *y;											/**< dual solution or Farkas multipliers */
+	mpq_t *rc;										/**< reduced costs */
+}
+QSexact_cert;
+
+/* ========================================================================= */
+/** @brief Write the binary certificate of a solved problem.
+ * @param p problem solved by #QSexact_solver.
+ * @param status status returned by #QSexact_solver.
+ * @param y if not null, the dual solution (or, for infeasible problems, the
+ * Farkas multipliers) returned by #QSexact_solver; otherwise whatever p can
+ * provide is used.
+ * @param out_f file where to write, opened in binary mode.
+ * @return zero on success, non-zero otherwise. */
+int QSexact_write_cert (mpq_QSdata * p,
+												const int status,
+												mpq_t * const y,
+												EGioFile_t * out_f);
+
+/* ========================================================================= */
+/** @brief Read a binary certificate written by #QSexact_write_cert.
+ * @param in_f file to read from, opened in binary mode.
+ * @param cert where to store the certificate, to be released with
+ * #QSexact_free_cert; it is left empty on failure.
+ * @return zero on success, non-zero if the file is not a valid certificate. */
+int QSexact_read_cert (EGioFile_t * in_f,
+											 QSexact_cert * cert);
+
+/* ========================================================================= */
+/** @brief Release the data of a certificate read by #QSexact_read_cert. */
+void QSexact_free_cert (QSexact_cert * cert);
+
+/* ========================================================================= */
+/** @brief Check a certificate against a problem in exact arithmetic.
+ *
+ * For optimal certificates this checks primal feasibility of x (and of the
+ * logicals it implies), dual feasibility and complementary slackness of y,
+ * that rc (if present) are the reduced costs of y, and that the primal and
+ * dual objectives agree. For infeasible certificates it checks that y is a
+ * Farkas ray, as #QSexact_infeasible_test does. Unlike #QSexact_optimal_test
+ * no basis is needed, and the work is split across threads, each one with
+ * its own accumulators.
+ * @param p problem the certificate was written for.
+ * @param cert certificate as read by #QSexact_read_cert.
+ * @param nthreads number of threads to use (one if thread support is
+ * disabled).
+ * @return one if the certificate proves its status, zero otherwise. */
+int QSexact_check_cert (mpq_QSdata * p,
+												QSexact_cert * cert,
+												int nthreads);
+/** @} */
+
+/* ========================================================================= */
+/** @name Checkpoints
+ * When a checkpoint file is set with #QSexact_set_checkpoint,
+ * #QSexact_solver rewrites it after the double solve and after every mpf
+ * rung, so that a solve killed at a high precision can be resumed at the next
+ * rung, warm started from the best basis found so far, instead of starting
+ * over. A checkpoint is written to a temporary file and renamed over the
+ * previous one, so that a crash while writing leaves the old one intact. Its
+ * layout follows the certificates:
+ *
+ * - header: the 8 bytes "QSXCKPT1", then eight 32 bit little endian words:
+ *   the number of columns and of rows of the problem, the next rung of the
+ *   precision schedule to run, the bits of the last precision run and the
+ *   bits it lost (see #QSexact_set_precision_schedule), the QS_LP_xxx status
+ *   and simplex iteration count of the last solve, and the flags
+ *   (#QS_CERT_BASIS if a basis follows);
+ * - basis: as in a certificate. */
+/** @{ */
+/* ========================================================================= */
+/** @brief the state of #QSexact_solver saved in a checkpoint */
+typedef struct
+{
+	int ncols;										/**< number of structural columns */
+	int nrows;										/**< number of rows */
+	int rung;											/**< next rung to run */
+	unsigned precision;						/**< bits of the last precision run */
+	int lost;											/**< bits it lost, rounded up */
+	int status;										/**< QS_LP_xxx status of the last solve */
+	int iter;											/**< iterations of the last solve */
+	QSbasis *basis;								/**< best basis so far, or null */
+}
+QSexact_checkpoint;
+
+/* ========================================================================= */
+/** @brief Write (atomically) a checkpoint to the given file, uncompressed.
+ * @return zero on success, non-zero otherwise. */
+int QSexact_write_checkpoint (const char *fname,
+															const QSexact_checkpoint * ck);
+
+/* ========================================================================= */
+/** @brief Read a checkpoint written by #QSexact_write_checkpoint.
+ * @param ck where to store it, to be released with
+ * #QSexact_free_checkpoint; it is left empty on failure.
+ * @return zero on success, non-zero if the file can't be read or is not a
+ * checkpoint. */
+int QSexact_read_checkpoint (const char *fname,
+														 QSexact_checkpoint * ck);
+
+/* ========================================================================= */
+/** @brief Release the basis of a checkpoint. */
+void QSexact_free_checkpoint (QSexact_checkpoint * ck);
+
+/* ========================================================================= */
+/** @brief Set the checkpoint file of #QSexact_solver.
+ * @param p problem to set the checkpoint of.
+ * @param fname file to write the checkpoints to, null to stop writing them.
+ * @param resume if non-zero and fname holds a checkpoint for a problem of
+ * the same size, the next call to #QSexact_solver skips the double solve
+ * and resumes the precision schedule where the checkpoint left it.
+ * @return zero on success, non-zero otherwise. */
+int QSexact_set_checkpoint (mpq_QSdata * p,
+														const char *fname,
+														int resume);
+/** @} */
+
 /* ========================================================================= */
 /** @brief Check if the given dual vector is a proof of infeasibility for the
  * given exact problem. 
@@ -185,7 +409,7 @@ int QSexact_infeasible_test (mpq_QSdata * p,
 			__lres[__lsz] = dbl_ILL_MAXDOUBLE;\
 		else if(mpq_equal(__larray[__lsz],mpq_ILL_MINDOUBLE))\
 			__lres[__lsz] = dbl_ILL_MINDOUBLE;\
-		else __lres[__lsz] = mpq_get_d(__larray[__lsz]);\
+		else __lres[__lsz] = mpq_EGlpNumGetD(__larray[__lsz]);\
 	}\
 	__lres;})
 
@@ -257,10 +481,32 @@ void QSexact_write_row (EGioFile_t * out_f,
 #ifndef QS_EXACT_MAX_ITER
 /* ========================================================================= */
 /** @brief This constant define the maximum number of try's for the exact solver
- * with mpf_t numbers while incrementing the precision */
+ * with mpf_t numbers while incrementing the precision (in the default
+ * schedule, see #QSexact_set_precision_schedule) */
 #define QS_EXACT_MAX_ITER 12
 #endif
 
+/* ========================================================================= */
+/** @brief Set the precisions #QSexact_solver tries after the double solve.
+ * @param p problem to set the schedule of.
+ * @param nrungs number of rungs, zero to go back to the default schedule (128
+ * bits, growing by half at each rung, for #QS_EXACT_MAX_ITER rungs).
+ * @param bits number of bits of each rung, at least 32 each.
+ * @param seconds if not null, the (CPU) time allowed to the simplex of each
+ * rung, zero or less for no limit; a rung that runs out of time hands its
+ * basis over to the next one.
+ * @return zero on success, non-zero otherwise (the schedule is then left
+ * unchanged).
+ * @note With the QS_PARAM_EXACT_PRECISION_SCHEDULE parameter set to
+ * #QS_EXACT_SCHEDULE_SKIP, after a rung fails the following rungs are skipped
+ * until one has as many bits as the failed one plus the bits it lost to
+ * element growth in its factorization (the base two logarithm of
+ * maxelem_factor / maxelem_orig); the last rung is never skipped. */
+int QSexact_set_precision_schedule (mpq_QSdata * p,
+																		int nrungs,
+																		const unsigned *bits,
+																		const double *seconds);
+
 /* ========================================================================= */
 /** @brief test whether given basis is primal and dual feasible in rational arithmetic. 
  * @param p_mpq   the problem data.
@@ -291,6 +537,27 @@ int QSexact_basis_dualstatus(
    const int msg_lvl
    );
 
+/* ========================================================================= */
+/** @brief compute the exact basic solution of the given basis.
+ *
+ * The basis matrix is factored once modulo a word sized prime, and the
+ * solution is recovered by p-adic (Dixon) lifting plus rational
+ * reconstruction, and certified by an exact residual check. Neither a
+ * rational LU of the basis nor a previous call to the simplex is needed, and
+ * the basis does not have to be feasible.
+ * @param p_mpq the problem data.
+ * @param basis basis whose basic solution we want.
+ * @param x if not null, where to store the values of the structural
+ * variables (as #mpq_QSget_x_array would).
+ * @param y if not null, where to store the dual values of the rows (as
+ * #mpq_QSget_pi_array would).
+ * @return zero on success, non-zero otherwise (in particular if the basis is
+ * singular). */
+int QSexact_lift_solution (mpq_QSdata * p_mpq,
+													 QSbasis * basis,
+													 mpq_t * x,
+													 mpq_t * y);
+
 /* ========================================================================= */
 /** @brief test whether given basis is dual feasible in rational arithmetic. 
  * if wanted it will first directly test the corresponding approximate dual and primal solution 
@@ -332,7 +599,12 @@ int QSexact_verify (
  * to optimality the problem.
  * @param basis if not null, use the given basis to start the
  * iteration of simplex, and store here the optimal basis (if found).
- * @return zero on success, non-zero otherwise. */
+ * @return zero on success, non-zero otherwise.
+ * @note If the QS_PARAM_EXACT_RACE parameter of p_mpq is set (and the library
+ * was built with thread support), the double solve and the first mpf rungs
+ * run concurrently, and the first of them whose result passes the exact test
+ * wins; otherwise the precision ladder continues sequentially from the basis
+ * of the highest precision racer. */
 int QSexact_solver (mpq_QSdata * p_mpq,
 										mpq_t * const x,
 										mpq_t * const y,
@@ -356,6 +628,46 @@ int mpq_factor_work_to_dbl_factor_work(dbl_factor_work *dest, const mpq_factor_w
  */
 int mpq_factor_work_to_mpf_factor_work(mpf_factor_work *dest, const mpq_factor_work *src);
 
+/* ========================================================================= */
+/** @brief Replace the column at position row of the cached LU f by the given
+ * spike, and apply the same update to its 128-bit copy.
+ * @param f rational LU, updated in place.
+ * @param shadow 128-bit copy of f (as made by
+ * #mpq_factor_work_to_mpf_factor_work), or a pointer to null. A copy that
+ * cannot take the update is released and set to null.
+ * @param spike column in the form #mpq_ILLfactor_update takes it.
+ * @param row position whose column is replaced.
+ * @param refactor set to one if f has to be refactored.
+ * @return zero on success, non-zero on failure.
+ * @note The copy is updated at the current mpf precision, which should be
+ * the 128 bits it was made with. */
+int QSexact_lu_update (mpq_factor_work * f,
+											 mpf_factor_work ** shadow,
+											 mpq_svector * spike,
+											 const int row,
+											 int *refactor);
+
+/* ========================================================================= */
+/** @brief Release a copy of the cached LU made by
+ * #mpq_factor_work_to_mpf_factor_work, and the structure itself. */
+void QSexact_free_lu_shadow (mpf_factor_work * shadow);
+
+/* ========================================================================= */
+/** @brief Copy the cached LU statistics accumulated by the exact solves of
+ * p into stats. */
+void QSexact_get_lu_stats (mpq_QSdata * p,
+													 QSexact_lu_stats * stats);
+
+/* ========================================================================= */
+/** @brief Reset the cached LU statistics of p. */
+void QSexact_reset_lu_stats (mpq_QSdata * p);
+
+/* ========================================================================= */
+/** @brief Copy the path taken by the last #QSexact_solver call on p into
+ * info. */
+void QSexact_get_solve_info (mpq_QSdata * p,
+														 QSexact_solve_info * info);
+
 /* ========================================================================= */
 /** @brief Initializator for global data, this is needed mainly for defining
  * constants in extended floating point precision and for rational precision.
@@ -368,6 +680,20 @@ extern void QSexactStart(void);
  * */
 extern void QSexactClear(void);
 /* ========================================================================= */
+/** @brief Set up the precision dependent state (mpf epsilon and tolerances)
+ * of a thread other than the one that called #QSexactStart. Any mpf problem
+ * carries the precision it was built with, and a thread switches to it
+ * before solving, so that threads working at different precisions do not
+ * interfere; calling this is only needed to choose the starting precision,
+ * but #QSexactThreadClear must be called before the thread exits to release
+ * that state.
+ * @param precision number of bits for the mpf numbers of this thread. */
+extern void QSexactThreadStart(const unsigned precision);
+/* ========================================================================= */
+/** @brief Release the state of the calling thread set up by
+ * #QSexactThreadStart (or on the fly by its first mpf solve). */
+extern void QSexactThreadClear(void);
+/* ========================================================================= */
 /** @brief indicate if the global data needed for QSexact has been initialized,
  * if zero, initialization routine should be called. This is provided to allow
  * syncronization between libraries */
@@ -0,0 +1,1856 @@
+/* ========================================================================= */
+/* ESolver "Exact Mixed Integer Linear Solver" provides some basic structures
+ * and algorithms commons in solving MIP's
+ *
+ * Copyright (C) 2005 Daniel Espinoza.
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation; either version 2.1 of the License, or (at your
+ * option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ * */
+/* ========================================================================= */
+/** @file
+ * @ingroup Esolver
+ * Alternative exact solvers for the basis systems B x_B = r and B^T pi = c_B
+ * used when verifying a basis in rational arithmetic. */
+/** @addtogroup Esolver */
+/** @{ */
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "exact_basis.h"
+
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "logging-private.h"
+
+#include "util.h"
+#include "except.h"
+#include "eg_macros.h"
+#include "timing_log.h"
+
+/* ========================================================================= */
+/** @brief one row of the fraction-free elimination. The stored values are
+ * those of elimination step @a hist; the value at a later step k is the
+ * stored value times rho[k] divided (exactly) by rho[hist]. Rows that are
+ * not touched by a pivot are thus never rescaled until they are needed. */
+typedef struct
+{
+	int nz;
+	int *ind;
+	mpz_t *val;
+	mpz_t rhs;
+	int hist;
+}
+QSbareiss_row_t;
+
+/* ========================================================================= */
+/** @brief working structure for the sparse Bareiss elimination of an n x n
+ * integer system. */
+typedef struct
+{
+	int n;
+	QSbareiss_row_t *row;
+	mpz_t *rho;										/**< rho[k] is the pivot of step k, rho[0] = 1 */
+	int *pivrow;									/**< row pivoted at step k (steps are 1-based) */
+	int *pivcol;									/**< column pivoted at step k */
+	char *rowdone;
+	char *coldone;
+	int *colcnt;									/**< active rows with a nonzero in the column */
+	int **colrows;								/**< rows that may have a nonzero in the column */
+	int *colrows_nz;
+	int *colrows_sz;
+	mpz_t *work;									/**< dense accumulator for row updates */
+	char *mark;
+	int *list;
+	int fill;											/**< number of fill-in entries created */
+}
+QSbareiss_t;
+
+/* ========================================================================= */
+static void QSbareiss_row_free (QSbareiss_row_t * r)
+{
+	register int i;
+	for (i = r->nz; i--;)
+		mpz_clear (r->val[i]);
+	ILL_IFFREE (r->val);
+	ILL_IFFREE (r->ind);
+	r->nz = 0;
+}
+
+/* ========================================================================= */
+static int QSbareiss_row_alloc (QSbareiss_row_t * r,
+																int nz)
+{
+	int rval = 0;
+	register int i;
+	r->nz = 0;
+	if (nz)
+	{
+		ILL_SAFE_MALLOC (r->ind, nz, int);
+		ILL_SAFE_MALLOC (r->val, nz, mpz_t);
+		for (i = 0; i < nz; i++)
+			mpz_init (r->val[i]);
+	}
+	r->nz = nz;
+CLEANUP:
+	if (rval)
+		ILL_IFFREE (r->ind);
+	return rval;
+}
+
+/* ========================================================================= */
+static void QSbareiss_free (QSbareiss_t * B)
+{
+	register int i;
+	/* numbers and per-column lists only exist once the init finished */
+	if (B->n)
+	{
+		for (i = 0; i < B->n; i++)
+		{
+			QSbareiss_row_free (B->row + i);
+			mpz_clear (B->row[i].rhs);
+			mpz_clear (B->work[i]);
+			ILL_IFFREE (B->colrows[i]);
+		}
+		for (i = 0; i <= B->n; i++)
+			mpz_clear (B->rho[i]);
+	}
+	ILL_IFFREE (B->row);
+	ILL_IFFREE (B->rho);
+	ILL_IFFREE (B->work);
+	ILL_IFFREE (B->colrows);
+	ILL_IFFREE (B->colrows_nz);
+	ILL_IFFREE (B->colrows_sz);
+	ILL_IFFREE (B->colcnt);
+	ILL_IFFREE (B->pivrow);
+	ILL_IFFREE (B->pivcol);
+	ILL_IFFREE (B->rowdone);
+	ILL_IFFREE (B->coldone);
+	ILL_IFFREE (B->mark);
+	ILL_IFFREE (B->list);
+	B->n = 0;
+}
+
+/* ========================================================================= */
+static int QSbareiss_init (QSbareiss_t * B,
+													 const int n)
+{
+	int rval = 0;
+	register int i;
+	memset (B, 0, sizeof (QSbareiss_t));
+	ILL_SAFE_MALLOC (B->row, n, QSbareiss_row_t);
+	ILL_SAFE_MALLOC (B->rho, n + 1, mpz_t);
+	ILL_SAFE_MALLOC (B->work, n, mpz_t);
+	ILL_SAFE_MALLOC (B->colrows, n, int *);
+	ILL_SAFE_MALLOC (B->colrows_nz, n, int);
+	ILL_SAFE_MALLOC (B->colrows_sz, n, int);
+	ILL_SAFE_MALLOC (B->colcnt, n, int);
+	ILL_SAFE_MALLOC (B->pivrow, n + 1, int);
+	ILL_SAFE_MALLOC (B->pivcol, n + 1, int);
+	ILL_SAFE_MALLOC (B->rowdone, n, char);
+	ILL_SAFE_MALLOC (B->coldone, n, char);
+	ILL_SAFE_MALLOC (B->mark, n, char);
+	ILL_SAFE_MALLOC (B->list, n, int);
+	memset (B->row, 0, sizeof (QSbareiss_row_t) * n);
+	memset (B->colrows, 0, sizeof (int *) * n);
+	memset (B->colrows_nz, 0, sizeof (int) * n);
+	memset (B->colrows_sz, 0, sizeof (int) * n);
+	memset (B->colcnt, 0, sizeof (int) * n);
+	memset (B->rowdone, 0, sizeof (char) * n);
+	memset (B->coldone, 0, sizeof (char) * n);
+	memset (B->mark, 0, sizeof (char) * n);
+	for (i = 0; i < n; i++)
+	{
+		mpz_init (B->row[i].rhs);
+		mpz_init (B->work[i]);
+	}
+	for (i = 0; i <= n; i++)
+		mpz_init (B->rho[i]);
+	mpz_set_ui (B->rho[0], 1UL);
+	B->n = n;
+CLEANUP:
+	if (rval)
+		QSbareiss_free (B);
+	return rval;
+}
+
+/* ========================================================================= */
+/** @brief record that row @a i may have a nonzero in column @a j of the lazy
+ * column lists @a colrows. */
+static int QScolrows_add (int **colrows,
+													int *colrows_nz,
+													int *colrows_sz,
+													const int j,
+													const int i)
+{
+	int rval = 0;
+	if (colrows_nz[j] == colrows_sz[j])
+	{
+		int sz = colrows_sz[j] ? 2 * colrows_sz[j] : 4;
+		EGcallD(ILLutil_reallocrus_count ((void **) &(colrows[j]), sz,
+																			sizeof (int)));
+		colrows_sz[j] = sz;
+	}
+	colrows[j][colrows_nz[j]++] = i;
+CLEANUP:
+	return rval;
+}
+
+/* ========================================================================= */
+/** @brief build the column counts and column lists once all rows are loaded. */
+static int QSbareiss_setup_columns (QSbareiss_t * B)
+{
+	int rval = 0;
+	register int i,
+	  k;
+	for (i = 0; i < B->n; i++)
+		for (k = 0; k < B->row[i].nz; k++)
+			B->colcnt[B->row[i].ind[k]]++;
+	for (i = 0; i < B->n; i++)
+	{
+		if (!B->colcnt[i])
+			continue;
+		ILL_SAFE_MALLOC (B->colrows[i], B->colcnt[i], int);
+		B->colrows_sz[i] = B->colcnt[i];
+	}
+	for (i = 0; i < B->n; i++)
+		for (k = 0; k < B->row[i].nz; k++)
+			B->colrows[B->row[i].ind[k]][B->colrows_nz[B->row[i].ind[k]]++] = i;
+CLEANUP:
+	return rval;
+}
+
+/* ========================================================================= */
+static inline int QSbareiss_find (const QSbareiss_row_t * r,
+																	const int j)
+{
+	register int k;
+	for (k = r->nz; k--;)
+		if (r->ind[k] == j)
+			return k;
+	return -1;
+}
+
+/* ========================================================================= */
+/** @brief bring row @a i to the values it has after elimination step @a k. */
+static void QSbareiss_lift (QSbareiss_t * B,
+														const int i,
+														const int k)
+{
+	QSbareiss_row_t *r = B->row + i;
+	register int e;
+	if (r->hist == k)
+		return;
+	for (e = 0; e < r->nz; e++)
+	{
+		mpz_mul (r->val[e], r->val[e], B->rho[k]);
+		mpz_divexact (r->val[e], r->val[e], B->rho[r->hist]);
+	}
+	mpz_mul (r->rhs, r->rhs, B->rho[k]);
+	mpz_divexact (r->rhs, r->rhs, B->rho[r->hist]);
+	r->hist = k;
+}
+
+/* ========================================================================= */
+/** @brief eliminate column @a q from row @a i (whose entry in @a q is at
+ * position @a qi) using the pivot row @a p of step @a k. */
+static int QSbareiss_update (QSbareiss_t * B,
+														 const int i,
+														 const int qi,
+														 const int p,
+														 const int q,
+														 const int k,
+														 mpz_t siq)
+{
+	int rval = 0;
+	QSbareiss_row_t *r = B->row + i;
+	const QSbareiss_row_t *pr = B->row + p;
+	QSbareiss_row_t nr;
+	mpz_t *const work = B->work;
+	char *const mark = B->mark;
+	int *const list = B->list;
+	const int h = r->hist;
+	int nlist = 0,
+	  newnz = 0;
+	register int e,
+	  j;
+	memset (&nr, 0, sizeof (nr));
+	mpz_set (siq, r->val[qi]);
+	/* scatter rho_k times the old row */
+	for (e = 0; e < r->nz; e++)
+	{
+		j = r->ind[e];
+		B->colcnt[j]--;
+		if (j == q)
+			continue;
+		mpz_mul (work[j], B->rho[k], r->val[e]);
+		mark[j] = 1;
+		list[nlist++] = j;
+	}
+	/* subtract s_iq times the pivot row */
+	for (e = 0; e < pr->nz; e++)
+	{
+		j = pr->ind[e];
+		if (j == q)
+			continue;
+		if (mark[j])
+			mpz_submul (work[j], siq, pr->val[e]);
+		else
+		{
+			mpz_mul (work[j], siq, pr->val[e]);
+			mpz_neg (work[j], work[j]);
+			mark[j] = 2;
+			list[nlist++] = j;
+		}
+	}
+	mpz_mul (r->rhs, r->rhs, B->rho[k]);
+	mpz_submul (r->rhs, siq, pr->rhs);
+	if (h)
+		mpz_divexact (r->rhs, r->rhs, B->rho[h]);
+	for (e = 0; e < nlist; e++)
+	{
+		j = list[e];
+		if (mpz_sgn (work[j]))
+		{
+			if (h)
+				mpz_divexact (work[j], work[j], B->rho[h]);
+			newnz++;
+		}
+	}
+	/* store the new row */
+	EGcallD(QSbareiss_row_alloc (&nr, newnz));
+	newnz = 0;
+	for (e = 0; e < nlist; e++)
+	{
+		j = list[e];
+		if (mpz_sgn (work[j]))
+		{
+			nr.ind[newnz] = j;
+			mpz_swap (nr.val[newnz], work[j]);
+			newnz++;
+			B->colcnt[j]++;
+			if (mark[j] == 2)
+			{
+				B->fill++;
+				EGcallD(QScolrows_add (B->colrows, B->colrows_nz, B->colrows_sz,
+															 j, i));
+			}
+		}
+		mark[j] = 0;
+	}
+	QSbareiss_row_free (r);
+	r->nz = nr.nz;
+	r->ind = nr.ind;
+	r->val = nr.val;
+	r->hist = k;
+	nr.ind = 0;
+	nr.val = 0;
+CLEANUP:
+	if (rval)
+	{
+		for (e = 0; e < nlist; e++)
+			mark[list[e]] = 0;
+		QSbareiss_row_free (&nr);
+	}
+	return rval;
+}
+
+/* ========================================================================= */
+/** @brief solve the loaded integer system. On return X[j] holds det * x_j,
+ * where det = rho[n] is the determinant (up to sign) of the system and x the
+ * rational solution. */
+static int QSbareiss_solve (QSbareiss_t * B,
+														mpz_t * X,
+														int *singular)
+{
+	int rval = 0;
+	const int n = B->n;
+	int p,
+	  q,
+	  pi,
+	  best_bits = 0;
+	size_t bits;
+	mpz_t siq,
+	  acc,
+	  rem;
+	register int i,
+	  j,
+	  k,
+	  e;
+	mpz_init (siq);
+	mpz_init (acc);
+	mpz_init (rem);
+	*singular = 0;
+	EGcallD(QSbareiss_setup_columns (B));
+	for (k = 1; k <= n; k++)
+	{
+		/* sparsest remaining column, then sparsest row with the smallest entry */
+		q = -1;
+		for (j = 0; j < n; j++)
+			if (!B->coldone[j] && B->colcnt[j] > 0 &&
+					(q < 0 || B->colcnt[j] < B->colcnt[q]))
+				q = j;
+		if (q < 0)
+		{
+			*singular = 1;
+			goto CLEANUP;
+		}
+		p = -1;
+		pi = -1;
+		for (e = 0; e < B->colrows_nz[q]; e++)
+		{
+			i = B->colrows[q][e];
+			if (B->rowdone[i])
+				continue;
+			j = QSbareiss_find (B->row + i, q);
+			if (j < 0)
+				continue;
+			bits = mpz_sizeinbase (B->row[i].val[j], 2);
+			if (p < 0 || B->row[i].nz < B->row[p].nz ||
+					(B->row[i].nz == B->row[p].nz && (int) bits < best_bits))
+			{
+				p = i;
+				pi = j;
+				best_bits = (int) bits;
+			}
+		}
+		if (p < 0)
+		{
+			QSlog ("Bareiss column %d has count %d but no active row", q,
+						 B->colcnt[q]);
+			rval = 1;
+			goto CLEANUP;
+		}
+		QSbareiss_lift (B, p, k - 1);
+		mpz_set (B->rho[k], B->row[p].val[pi]);
+		B->rowdone[p] = 1;
+		B->coldone[q] = 1;
+		B->pivrow[k] = p;
+		B->pivcol[k] = q;
+		for (e = 0; e < B->row[p].nz; e++)
+			B->colcnt[B->row[p].ind[e]]--;
+		for (e = 0; e < B->colrows_nz[q]; e++)
+		{
+			i = B->colrows[q][e];
+			if (B->rowdone[i])
+				continue;
+			j = QSbareiss_find (B->row + i, q);
+			if (j < 0)
+				continue;
+			EGcallD(QSbareiss_update (B, i, j, p, q, k, siq));
+		}
+		ILL_IFFREE (B->colrows[q]);
+		B->colrows_nz[q] = B->colrows_sz[q] = 0;
+	}
+	/* back substitution, every X[j] is an integer by Cramer's rule */
+	for (k = n; k >= 1; k--)
+	{
+		const QSbareiss_row_t *r = B->row + B->pivrow[k];
+		q = B->pivcol[k];
+		mpz_mul (acc, B->rho[n], r->rhs);
+		for (e = 0; e < r->nz; e++)
+			if (r->ind[e] != q)
+				mpz_submul (acc, r->val[e], X[r->ind[e]]);
+		mpz_tdiv_qr (X[q], rem, acc, B->rho[k]);
+		if (mpz_sgn (rem))
+		{
+			QSlog ("Bareiss back substitution is not integral at step %d", k);
+			rval = 1;
+			goto CLEANUP;
+		}
+	}
+CLEANUP:
+	mpz_clear (siq);
+	mpz_clear (acc);
+	mpz_clear (rem);
+	return rval;
+}
+
+/* ========================================================================= */
+/** @brief set the right hand side of the loaded system to D * r, where D is
+ * the least common multiple of the denominators of @a r. */
+static void QSbareiss_load_rhs (QSbareiss_t * B,
+																mpq_t * r,
+																mpz_t D)
+{
+	mpz_t t;
+	register int i;
+	mpz_init (t);
+	mpz_set_ui (D, 1UL);
+	for (i = 0; i < B->n; i++)
+		if (mpq_sgn (r[i]))
+			mpz_lcm (D, D, mpq_denref (r[i]));
+	for (i = 0; i < B->n; i++)
+	{
+		mpz_divexact (t, D, mpq_denref (r[i]));
+		mpz_mul (B->row[i].rhs, t, mpq_numref (r[i]));
+	}
+	mpz_clear (t);
+}
+
+/* ========================================================================= */
+/** @brief load the integer matrix Z = B S, where B is the current basis and
+ * S the diagonal of per-column scales @a s, or its transpose. */
+static int QSbareiss_load_basis (QSbareiss_t * B,
+																 mpq_lpinfo * lp,
+																 mpz_t * s,
+																 const int transpose)
+{
+	int rval = 0;
+	const int n = lp->nrows;
+	int *cnt = 0;
+	mpz_t t;
+	register int i,
+	  k,
+	  e;
+	mpz_init (t);
+	ILL_SAFE_MALLOC (cnt, n, int);
+	memset (cnt, 0, sizeof (int) * n);
+	for (k = 0; k < n; k++)
+	{
+		const int col = lp->baz[k];
+		for (e = lp->matbeg[col]; e < lp->matbeg[col] + lp->matcnt[col]; e++)
+			if (mpq_sgn (lp->matval[e]))
+				cnt[transpose ? k : lp->matind[e]]++;
+	}
+	for (i = 0; i < n; i++)
+	{
+		EGcallD(QSbareiss_row_alloc (B->row + i, cnt[i]));
+		B->row[i].nz = 0;
+		B->row[i].hist = 0;
+	}
+	for (k = 0; k < n; k++)
+	{
+		const int col = lp->baz[k];
+		for (e = lp->matbeg[col]; e < lp->matbeg[col] + lp->matcnt[col]; e++)
+		{
+			QSbareiss_row_t *r;
+			if (!mpq_sgn (lp->matval[e]))
+				continue;
+			r = B->row + (transpose ? k : lp->matind[e]);
+			mpz_divexact (t, s[k], mpq_denref (lp->matval[e]));
+			mpz_mul (r->val[r->nz], t, mpq_numref (lp->matval[e]));
+			r->ind[r->nz++] = transpose ? lp->matind[e] : k;
+		}
+	}
+CLEANUP:
+	/* rows keep their allocated size in nz for QSbareiss_row_free */
+	if (rval)
+		for (i = 0; i < n; i++)
+			if (B->row[i].val)
+				B->row[i].nz = cnt[i];
+	ILL_IFFREE (cnt);
+	mpz_clear (t);
+	return rval;
+}
+
+/* ========================================================================= */
+/** @name Multi-modular and p-adic solvers
+ * The integer system is solved modulo primes just above 2^30, so residues fit
+ * in 31 bits and the product of two of them in an unsigned 64 bit word. The
+ * residues (modulo several primes, or the p-adic digits for a single prime)
+ * are combined into the solution modulo a large integer, the rational
+ * solution is recovered by rational reconstruction and finally certified by
+ * one exact residual computation. */
+/*@{*/
+/** @brief number of consecutive primes for which the basis may look singular
+ * (or the pivot order of the first prime breaks down) before giving up. */
+#define QS_MODULAR_MAX_UNLUCKY 3
+
+/* ========================================================================= */
+static inline uint64_t QSmod_mul (const uint64_t a,
+																	const uint64_t b,
+																	const uint64_t p)
+{
+	return (a * b) % p;
+}
+
+/* ========================================================================= */
+static uint64_t QSmod_inv (const uint64_t a,
+													 const uint64_t p)
+{
+	int64_t r0 = (int64_t) p,
+	  r1 = (int64_t) a,
+	  t0 = 0,
+	  t1 = 1,
+	  q,
+	  tmp;
+	while (r1)
+	{
+		q = r0 / r1;
+		tmp = r0 - q * r1;
+		r0 = r1;
+		r1 = tmp;
+		tmp = t0 - q * t1;
+		t0 = t1;
+		t1 = tmp;
+	}
+	return (uint64_t) (t0 < 0 ? t0 + (int64_t) p : t0);
+}
+
+/* ========================================================================= */
+/** @brief working structure for the sparse elimination modulo a prime. */
+typedef struct
+{
+	int n;
+	uint64_t p;
+	int *nz;
+	int **ind;
+	uint64_t **val;
+	uint64_t *rhs;
+	uint64_t *pivinv;							/**< inverse of the pivot of each step */
+	int *lbeg;										/**< row operations of step k are */
+	int *lrow;										/**< lrow/lval[lbeg[k] .. lbeg[k+1]-1] */
+	uint64_t *lval;
+	int lnz;
+	int lsz;
+	char *rowdone;
+	char *coldone;
+	int *colcnt;
+	int **colrows;
+	int *colrows_nz;
+	int *colrows_sz;
+	uint64_t *work;
+	char *mark;
+	int *list;
+}
+QSmodelim_t;
+
+/* ========================================================================= */
+static void QSmodelim_free (QSmodelim_t * E)
+{
+	register int i;
+	for (i = 0; i < E->n; i++)
+	{
+		if (E->ind)
+			ILL_IFFREE (E->ind[i]);
+		if (E->val)
+			ILL_IFFREE (E->val[i]);
+		if (E->colrows)
+			ILL_IFFREE (E->colrows[i]);
+	}
+	ILL_IFFREE (E->nz);
+	ILL_IFFREE (E->ind);
+	ILL_IFFREE (E->val);
+	ILL_IFFREE (E->rhs);
+	ILL_IFFREE (E->pivinv);
+	ILL_IFFREE (E->lbeg);
+	ILL_IFFREE (E->lrow);
+	ILL_IFFREE (E->lval);
+	ILL_IFFREE (E->rowdone);
+	ILL_IFFREE (E->coldone);
+	ILL_IFFREE (E->colcnt);
+	ILL_IFFREE (E->colrows);
+	ILL_IFFREE (E->colrows_nz);
+	ILL_IFFREE (E->colrows_sz);
+	ILL_IFFREE (E->work);
+	ILL_IFFREE (E->mark);
+	ILL_IFFREE (E->list);
+	E->n = 0;
+}
+
+/* ========================================================================= */
+static int QSmodelim_init (QSmodelim_t * E,
+													 const int n)
+{
+	int rval = 0;
+	memset (E, 0, sizeof (QSmodelim_t));
+	ILL_SAFE_MALLOC (E->nz, n, int);
+	ILL_SAFE_MALLOC (E->ind, n, int *);
+	ILL_SAFE_MALLOC (E->val, n, uint64_t *);
+	ILL_SAFE_MALLOC (E->rhs, n, uint64_t);
+	ILL_SAFE_MALLOC (E->pivinv, n, uint64_t);
+	ILL_SAFE_MALLOC (E->lbeg, n + 1, int);
+	ILL_SAFE_MALLOC (E->rowdone, n, char);
+	ILL_SAFE_MALLOC (E->coldone, n, char);
+	ILL_SAFE_MALLOC (E->colcnt, n, int);
+	ILL_SAFE_MALLOC (E->colrows, n, int *);
+	ILL_SAFE_MALLOC (E->colrows_nz, n, int);
+	ILL_SAFE_MALLOC (E->colrows_sz, n, int);
+	ILL_SAFE_MALLOC (E->work, n, uint64_t);
+	ILL_SAFE_MALLOC (E->mark, n, char);
+	ILL_SAFE_MALLOC (E->list, n, int);
+	memset (E->nz, 0, sizeof (int) * n);
+	memset (E->ind, 0, sizeof (int *) * n);
+	memset (E->val, 0, sizeof (uint64_t *) * n);
+	memset (E->colrows, 0, sizeof (int *) * n);
+	memset (E->colrows_sz, 0, sizeof (int) * n);
+	memset (E->mark, 0, sizeof (char) * n);
+	E->n = n;
+CLEANUP:
+	if (rval)
+		QSmodelim_free (E);
+	return rval;
+}
+
+/* ========================================================================= */
+/** @brief reduce the integer system @a Z modulo @a p. */
+static int QSmodelim_load (QSmodelim_t * E,
+													 const QSbareiss_t * Z,
+													 const uint64_t p)
+{
+	int rval = 0;
+	register int i,
+	  e,
+	  nz;
+	unsigned long v;
+	E->p = p;
+	E->lnz = 0;
+	memset (E->rowdone, 0, sizeof (char) * E->n);
+	memset (E->coldone, 0, sizeof (char) * E->n);
+	memset (E->colcnt, 0, sizeof (int) * E->n);
+	memset (E->colrows_nz, 0, sizeof (int) * E->n);
+	for (i = 0; i < E->n; i++)
+	{
+		const QSbareiss_row_t *r = Z->row + i;
+		ILL_IFFREE (E->ind[i]);
+		ILL_IFFREE (E->val[i]);
+		E->nz[i] = 0;
+		E->rhs[i] = mpz_fdiv_ui (r->rhs, (unsigned long) p);
+		if (!r->nz)
+			continue;
+		ILL_SAFE_MALLOC (E->ind[i], r->nz, int);
+		ILL_SAFE_MALLOC (E->val[i], r->nz, uint64_t);
+		for (e = 0, nz = 0; e < r->nz; e++)
+		{
+			v = mpz_fdiv_ui (r->val[e], (unsigned long) p);
+			if (!v)
+				continue;
+			E->ind[i][nz] = r->ind[e];
+			E->val[i][nz++] = v;
+			E->colcnt[r->ind[e]]++;
+			EGcallD(QScolrows_add (E->colrows, E->colrows_nz, E->colrows_sz,
+														 r->ind[e], i));
+		}
+		E->nz[i] = nz;
+	}
+CLEANUP:
+	return rval;
+}
+
+/* ========================================================================= */
+static inline int QSmodelim_find (const QSmodelim_t * E,
+																	const int i,
+																	const int j)
+{
+	register int k;
+	for (k = E->nz[i]; k--;)
+		if (E->ind[i][k] == j)
+			return k;
+	return -1;
+}
+
+/* ========================================================================= */
+/** @brief row[i] -= f * row[pr], which removes column @a q from row @a i. */
+static int QSmodelim_update (QSmodelim_t * E,
+														 const int i,
+														 const int pr,
+														 const int q,
+														 const uint64_t f)
+{
+	int rval = 0;
+	const uint64_t p = E->p;
+	uint64_t *const work = E->work;
+	char *const mark = E->mark;
+	int *const list = E->list;
+	int *nind = 0;
+	uint64_t *nval = 0,
+	  t;
+	int nlist = 0,
+	  newnz = 0;
+	register int e,
+	  j;
+	for (e = 0; e < E->nz[i]; e++)
+	{
+		j = E->ind[i][e];
+		E->colcnt[j]--;
+		if (j == q)
+			continue;
+		work[j] = E->val[i][e];
+		mark[j] = 1;
+		list[nlist++] = j;
+	}
+	for (e = 0; e < E->nz[pr]; e++)
+	{
+		j = E->ind[pr][e];
+		if (j == q)
+			continue;
+		t = QSmod_mul (f, E->val[pr][e], p);
+		if (mark[j])
+			work[j] = (work[j] + p - t) % p;
+		else
+		{
+			work[j] = p - t;
+			mark[j] = 2;
+			list[nlist++] = j;
+		}
+	}
+	E->rhs[i] = (E->rhs[i] + p - QSmod_mul (f, E->rhs[pr], p)) % p;
+	for (e = 0; e < nlist; e++)
+		if (work[list[e]])
+			newnz++;
+	if (newnz)
+	{
+		ILL_SAFE_MALLOC (nind, newnz, int);
+		ILL_SAFE_MALLOC (nval, newnz, uint64_t);
+	}
+	newnz = 0;
+	for (e = 0; e < nlist; e++)
+	{
+		j = list[e];
+		if (work[j])
+		{
+			nind[newnz] = j;
+			nval[newnz++] = work[j];
+			E->colcnt[j]++;
+			if (mark[j] == 2)
+				EGcallD(QScolrows_add (E->colrows, E->colrows_nz, E->colrows_sz,
+															 j, i));
+		}
+		mark[j] = 0;
+	}
+	ILL_IFFREE (E->ind[i]);
+	ILL_IFFREE (E->val[i]);
+	E->ind[i] = nind;
+	E->val[i] = nval;
+	E->nz[i] = newnz;
+	nind = 0;
+	nval = 0;
+CLEANUP:
+	if (rval)
+		for (e = 0; e < nlist; e++)
+			mark[list[e]] = 0;
+	ILL_IFFREE (nind);
+	ILL_IFFREE (nval);
+	return rval;
+}
+
+/* ========================================================================= */
+/** @brief back substitution on the eliminated rows for the transformed right
+ * hand side @a b (indexed by row). */
+static void QSmodelim_backsolve (const QSmodelim_t * E,
+																 const int *order_row,
+																 const int *order_col,
+																 const uint64_t * b,
+																 uint64_t * x)
+{
+	const uint64_t p = E->p;
+	int pr,
+	  q;
+	uint64_t acc;
+	register int k,
+	  e;
+	for (k = E->n; k--;)
+	{
+		pr = order_row[k];
+		q = order_col[k];
+		acc = b[pr];
+		for (e = 0; e < E->nz[pr]; e++)
+			if (E->ind[pr][e] != q)
+				acc = (acc + p - QSmod_mul (E->val[pr][e], x[E->ind[pr][e]], p)) % p;
+		x[q] = QSmod_mul (acc, E->pivinv[k], p);
+	}
+}
+
+/* ========================================================================= */
+/** @brief solve the loaded system modulo E->p. If @a have_order is zero, the
+ * pivots are chosen by column count and row length and stored in
+ * @a order_row and @a order_col, otherwise that order is replayed.
+ * @param fail set to one if the system is singular modulo E->p, or if the
+ * replayed order hits a zero pivot. */
+static int QSmodelim_solve (QSmodelim_t * E,
+														int *order_row,
+														int *order_col,
+														const int have_order,
+														uint64_t * x,
+														int *fail)
+{
+	int rval = 0;
+	const int n = E->n;
+	const uint64_t p = E->p;
+	int pr,
+	  q,
+	  pos;
+	uint64_t f;
+	register int i,
+	  j,
+	  k,
+	  e;
+	*fail = 0;
+	for (k = 0; k < n; k++)
+	{
+		if (have_order)
+		{
+			pr = order_row[k];
+			q = order_col[k];
+			pos = QSmodelim_find (E, pr, q);
+		}
+		else
+		{
+			q = -1;
+			for (j = 0; j < n; j++)
+				if (!E->coldone[j] && E->colcnt[j] > 0 &&
+						(q < 0 || E->colcnt[j] < E->colcnt[q]))
+					q = j;
+			pr = -1;
+			pos = -1;
+			for (e = 0; q >= 0 && e < E->colrows_nz[q]; e++)
+			{
+				i = E->colrows[q][e];
+				if (E->rowdone[i] || (pr >= 0 && E->nz[i] >= E->nz[pr]))
+					continue;
+				j = QSmodelim_find (E, i, q);
+				if (j < 0)
+					continue;
+				pr = i;
+				pos = j;
+			}
+			order_row[k] = pr;
+			order_col[k] = q;
+		}
+		if (pos < 0)
+		{
+			*fail = 1;
+			goto CLEANUP;
+		}
+		E->rowdone[pr] = 1;
+		E->coldone[q] = 1;
+		for (e = 0; e < E->nz[pr]; e++)
+			E->colcnt[E->ind[pr][e]]--;
+		E->pivinv[k] = QSmod_inv (E->val[pr][pos], p);
+		E->lbeg[k] = E->lnz;
+		for (e = 0; e < E->colrows_nz[q]; e++)
+		{
+			i = E->colrows[q][e];
+			if (E->rowdone[i])
+				continue;
+			j = QSmodelim_find (E, i, q);
+			if (j < 0)
+				continue;
+			f = QSmod_mul (E->val[i][j], E->pivinv[k], p);
+			if (E->lnz == E->lsz)
+			{
+				int sz = E->lsz ? 2 * E->lsz : n;
+				EGcallD(ILLutil_reallocrus_count ((void **) &(E->lrow), sz,
+																					sizeof (int)));
+				EGcallD(ILLutil_reallocrus_count ((void **) &(E->lval), sz,
+																					sizeof (uint64_t)));
+				E->lsz = sz;
+			}
+			E->lrow[E->lnz] = i;
+			E->lval[E->lnz++] = f;
+			EGcallD(QSmodelim_update (E, i, pr, q, f));
+		}
+		E->colrows_nz[q] = 0;
+	}
+	E->lbeg[n] = E->lnz;
+	QSmodelim_backsolve (E, order_row, order_col, E->rhs, x);
+CLEANUP:
+	return rval;
+}
+
+/* ========================================================================= */
+/** @brief solve the system factored by #QSmodelim_solve for another right
+ * hand side @a b (indexed by row, overwritten) modulo E->p. */
+static void QSmodelim_resolve (const QSmodelim_t * E,
+															 const int *order_row,
+															 const int *order_col,
+															 uint64_t * b,
+															 uint64_t * x)
+{
+	const uint64_t p = E->p;
+	register int k,
+	  t;
+	for (k = 0; k < E->n; k++)
+	{
+		const uint64_t bp = b[order_row[k]];
+		if (!bp)
+			continue;
+		for (t = E->lbeg[k]; t < E->lbeg[k + 1]; t++)
+			b[E->lrow[t]] = (b[E->lrow[t]] + p - QSmod_mul (E->lval[t], bp, p)) % p;
+	}
+	QSmodelim_backsolve (E, order_row, order_col, b, x);
+}
+
+/* ========================================================================= */
+/** @brief Hadamard-type bound on the number of primes after which rational
+ * reconstruction of the solution of @a Z must succeed. */
+static int QSmodular_prime_bound (const QSbareiss_t * Z,
+																	int *maxprimes)
+{
+	int rval = 0;
+	const int n = Z->n;
+	int *cnt = 0;
+	size_t *maxbits = 0,
+	  rhsbits = 1,
+	  b;
+	double bits = 0.0;
+	register int i,
+	  e;
+	ILL_SAFE_MALLOC (cnt, n, int);
+	ILL_SAFE_MALLOC (maxbits, n, size_t);
+	memset (cnt, 0, sizeof (int) * n);
+	memset (maxbits, 0, sizeof (size_t) * n);
+	for (i = 0; i < n; i++)
+	{
+		const QSbareiss_row_t *r = Z->row + i;
+		for (e = 0; e < r->nz; e++)
+		{
+			b = mpz_sizeinbase (r->val[e], 2);
+			cnt[r->ind[e]]++;
+			if (b > maxbits[r->ind[e]])
+				maxbits[r->ind[e]] = b;
+		}
+		b = mpz_sizeinbase (r->rhs, 2);
+		if (b > rhsbits)
+			rhsbits = b;
+	}
+	/* log2 of the column norms bounds log2 |det|, replacing one column by
+	 * the right hand side bounds the numerators of Cramer's rule */
+	for (i = 0; i < n; i++)
+		if (cnt[i])
+			bits += (double) maxbits[i] + 0.5 * log2 ((double) cnt[i]);
+	bits += (double) rhsbits + 0.5 * log2 ((double) n);
+	*maxprimes = (int) ((2.0 * bits + 2.0) / 30.0) + 2;
+CLEANUP:
+	ILL_IFFREE (cnt);
+	ILL_IFFREE (maxbits);
+	return rval;
+}
+
+/* ========================================================================= */
+/** @brief recover num[i] / den from the residues R[i] modulo M, with a common
+ * denominator den. Each entry is reconstructed after multiplying by the
+ * denominator found so far, so that typically only the first few entries
+ * need the full extended euclidean algorithm.
+ * @param ok set to one if every entry has numerator and denominator below
+ * sqrt(M/2). */
+static int QSmodular_reconstruct (const int n,
+																	mpz_t * R,
+																	mpz_t M,
+																	mpz_t * num,
+																	mpz_t den,
+																	int *ok)
+{
+	int rval = 0;
+	mpz_t *dd = 0;
+	mpz_t N,
+	  y,
+	  r0,
+	  r1,
+	  t0,
+	  t1,
+	  q,
+	  tmp;
+	register int i;
+	*ok = 0;
+	mpz_init (N);
+	mpz_init (y);
+	mpz_init (r0);
+	mpz_init (r1);
+	mpz_init (t0);
+	mpz_init (t1);
+	mpz_init (q);
+	mpz_init (tmp);
+	ILL_SAFE_MALLOC (dd, n, mpz_t);
+	for (i = 0; i < n; i++)
+		mpz_init (dd[i]);
+	mpz_fdiv_q_2exp (N, M, 1);
+	mpz_sqrt (N, N);
+	mpz_set_ui (den, 1UL);
+	for (i = 0; i < n; i++)
+	{
+		mpz_mul (y, den, R[i]);
+		mpz_mod (y, y, M);
+		mpz_set (r0, M);
+		mpz_set (r1, y);
+		mpz_set_ui (t0, 0UL);
+		mpz_set_ui (t1, 1UL);
+		while (mpz_cmp (r1, N) > 0)
+		{
+			mpz_fdiv_qr (q, tmp, r0, r1);
+			mpz_swap (r0, r1);
+			mpz_swap (r1, tmp);
+			mpz_submul (t0, q, t1);
+			mpz_swap (t0, t1);
+		}
+		if (!mpz_sgn (t1))
+			goto CLEANUP;
+		mpz_abs (tmp, t1);
+		mpz_mul (tmp, tmp, den);
+		if (mpz_cmp (tmp, N) > 0)
+			goto CLEANUP;
+		mpz_gcd (tmp, r1, t1);
+		if (mpz_cmp_ui (tmp, 1UL))
+			goto CLEANUP;
+		if (mpz_sgn (t1) < 0)
+		{
+			mpz_neg (r1, r1);
+			mpz_neg (t1, t1);
+		}
+		mpz_set (num[i], r1);
+		mpz_mul (den, den, t1);
+		mpz_set (dd[i], den);
+	}
+	for (i = 0; i < n; i++)
+	{
+		mpz_divexact (tmp, den, dd[i]);
+		mpz_mul (num[i], num[i], tmp);
+	}
+	*ok = 1;
+CLEANUP:
+	if (dd)
+		for (i = 0; i < n; i++)
+			mpz_clear (dd[i]);
+	ILL_IFFREE (dd);
+	mpz_clear (N);
+	mpz_clear (y);
+	mpz_clear (r0);
+	mpz_clear (r1);
+	mpz_clear (t0);
+	mpz_clear (t1);
+	mpz_clear (q);
+	mpz_clear (tmp);
+	return rval;
+}
+
+/* ========================================================================= */
+/** @brief check Z num = den rhs in exact integer arithmetic. */
+static int QSmodular_certify (const QSbareiss_t * Z,
+															mpz_t * num,
+															mpz_t den)
+{
+	int ok = 1;
+	mpz_t acc;
+	register int i,
+	  e;
+	mpz_init (acc);
+	for (i = 0; ok && i < Z->n; i++)
+	{
+		const QSbareiss_row_t *r = Z->row + i;
+		mpz_mul (acc, den, r->rhs);
+		mpz_neg (acc, acc);
+		for (e = 0; e < r->nz; e++)
+			mpz_addmul (acc, r->val[e], num[r->ind[e]]);
+		ok = !mpz_sgn (acc);
+	}
+	mpz_clear (acc);
+	return ok;
+}
+
+/* ========================================================================= */
+/** @brief solve the integer system loaded in @a Z by the multi-modular
+ * method; on success the solution is X / den. */
+static int QSmodular_solve (const QSbareiss_t * Z,
+														mpz_t * X,
+														mpz_t den,
+														int *singular)
+{
+	int rval = 0;
+	const int n = Z->n;
+	QSmodelim_t E;
+	int *order_row = 0,
+	 *order_col = 0;
+	uint64_t *xp = 0,
+	  p,
+	  minv,
+	  t;
+	mpz_t *R = 0;
+	mpz_t M,
+	  prime;
+	int have_order = 0,
+	  nprimes = 0,
+	  nfail = 0,
+	  maxprimes = 0,
+	  next_try = 1,
+	  fail,
+	  ok = 0;
+	register int i;
+	memset (&E, 0, sizeof (E));
+	mpz_init (M);
+	mpz_init (prime);
+	*singular = 0;
+	EGcallD(QSmodular_prime_bound (Z, &maxprimes));
+	EGcallD(QSmodelim_init (&E, n));
+	ILL_SAFE_MALLOC (order_row, n, int);
+	ILL_SAFE_MALLOC (order_col, n, int);
+	ILL_SAFE_MALLOC (xp, n, uint64_t);
+	ILL_SAFE_MALLOC (R, n, mpz_t);
+	for (i = 0; i < n; i++)
+		mpz_init (R[i]);
+	mpz_set_ui (prime, 1UL);
+	mpz_mul_2exp (prime, prime, 30);
+	while (!ok)
+	{
+		mpz_nextprime (prime, prime);
+		p = mpz_get_ui (prime);
+		EGcallD(QSmodelim_load (&E, Z, p));
+		EGcallD(QSmodelim_solve (&E, order_row, order_col, have_order, xp,
+														 &fail));
+		if (fail)
+		{
+			if (++nfail >= QS_MODULAR_MAX_UNLUCKY)
+			{
+				/* either singular, or too many unlucky primes in a row; the LU
+				 * path sorts out which one */
+				*singular = 1;
+				goto CLEANUP;
+			}
+			continue;
+		}
+		nfail = 0;
+		have_order = 1;
+		/* chinese remaindering, R[i] stays in [0, M) */
+		if (!nprimes)
+		{
+			for (i = 0; i < n; i++)
+				mpz_set_ui (R[i], (unsigned long) xp[i]);
+			mpz_set_ui (M, (unsigned long) p);
+		}
+		else
+		{
+			minv = QSmod_inv (mpz_fdiv_ui (M, (unsigned long) p), p);
+			for (i = 0; i < n; i++)
+			{
+				t = (xp[i] + p - mpz_fdiv_ui (R[i], (unsigned long) p)) % p;
+				t = QSmod_mul (t, minv, p);
+				if (t)
+					mpz_addmul_ui (R[i], M, (unsigned long) t);
+			}
+			mpz_mul_ui (M, M, (unsigned long) p);
+		}
+		nprimes++;
+		if (nprimes < next_try && nprimes < maxprimes)
+			continue;
+		next_try += (next_try + 1) / 2;
+		EGcallD(QSmodular_reconstruct (n, R, M, X, den, &ok));
+		if (ok)
+			ok = QSmodular_certify (Z, X, den);
+		if (!ok && nprimes >= maxprimes)
+		{
+			QSlog ("Modular basis solve failed to certify after %d primes",
+						 nprimes);
+			*singular = 1;
+			goto CLEANUP;
+		}
+	}
+	log_message ("Modular basis solve: %d rows, %d primes, denominator %lu bits",
+							 n, nprimes, (unsigned long) mpz_sizeinbase (den, 2));
+CLEANUP:
+	QSmodelim_free (&E);
+	if (R)
+		for (i = 0; i < n; i++)
+			mpz_clear (R[i]);
+	ILL_IFFREE (R);
+	ILL_IFFREE (order_row);
+	ILL_IFFREE (order_col);
+	ILL_IFFREE (xp);
+	mpz_clear (M);
+	mpz_clear (prime);
+	return rval;
+}
+
+/* ========================================================================= */
+/** @brief solve the integer system loaded in @a Z by Dixon's p-adic lifting:
+ * Z is factored once modulo a single prime p, and each step solves for the
+ * next p-adic digit of the solution and divides the integer residual by p,
+ * so that all work besides the residual update is on words. Rational
+ * reconstruction and the exact residual check are the same as for
+ * #QSmodular_solve; on success the solution is X / den. */
+static int QSdixon_solve (const QSbareiss_t * Z,
+													mpz_t * X,
+													mpz_t den,
+													int *singular)
+{
+	int rval = 0;
+	const int n = Z->n;
+	QSmodelim_t E;
+	int *order_row = 0,
+	 *order_col = 0;
+	uint64_t *xp = 0,
+	 *bp = 0,
+	  p = 0;
+	mpz_t *R = 0,
+	 *res = 0;
+	mpz_t P,
+	  prime;
+	int nsteps = 0,
+	  nfail = 0,
+	  maxsteps = 0,
+	  next_try = 1,
+	  fail = 1,
+	  ok = 0;
+	register int i,
+	  e;
+	memset (&E, 0, sizeof (E));
+	mpz_init (P);
+	mpz_init (prime);
+	*singular = 0;
+	EGcallD(QSmodular_prime_bound (Z, &maxsteps));
+	EGcallD(QSmodelim_init (&E, n));
+	ILL_SAFE_MALLOC (order_row, n, int);
+	ILL_SAFE_MALLOC (order_col, n, int);
+	ILL_SAFE_MALLOC (xp, n, uint64_t);
+	ILL_SAFE_MALLOC (bp, n, uint64_t);
+	ILL_SAFE_MALLOC (R, n, mpz_t);
+	ILL_SAFE_MALLOC (res, n, mpz_t);
+	for (i = 0; i < n; i++)
+	{
+		mpz_init (R[i]);
+		mpz_init_set (res[i], Z->row[i].rhs);
+	}
+	/* factor modulo the first prime that does not make the basis singular */
+	mpz_set_ui (prime, 1UL);
+	mpz_mul_2exp (prime, prime, 30);
+	while (fail)
+	{
+		if (nfail++ == QS_MODULAR_MAX_UNLUCKY)
+		{
+			*singular = 1;
+			goto CLEANUP;
+		}
+		mpz_nextprime (prime, prime);
+		p = mpz_get_ui (prime);
+		EGcallD(QSmodelim_load (&E, Z, p));
+		EGcallD(QSmodelim_solve (&E, order_row, order_col, 0, xp, &fail));
+	}
+	mpz_set_ui (P, 1UL);
+	while (!ok)
+	{
+		if (nsteps)
+		{
+			for (i = 0; i < n; i++)
+				bp[i] = mpz_fdiv_ui (res[i], (unsigned long) p);
+			QSmodelim_resolve (&E, order_row, order_col, bp, xp);
+		}
+		/* X += p^k x_k, res = (res - Z x_k) / p */
+		for (i = 0; i < n; i++)
+			if (xp[i])
+				mpz_addmul_ui (R[i], P, (unsigned long) xp[i]);
+		for (i = 0; i < n; i++)
+		{
+			const QSbareiss_row_t *r = Z->row + i;
+			for (e = 0; e < r->nz; e++)
+				if (xp[r->ind[e]])
+					mpz_submul_ui (res[i], r->val[e], (unsigned long) xp[r->ind[e]]);
+			mpz_divexact_ui (res[i], res[i], (unsigned long) p);
+		}
+		mpz_mul_ui (P, P, (unsigned long) p);
+		nsteps++;
+		if (nsteps < next_try && nsteps < maxsteps)
+			continue;
+		next_try += (next_try + 1) / 2;
+		EGcallD(QSmodular_reconstruct (n, R, P, X, den, &ok));
+		if (ok)
+			ok = QSmodular_certify (Z, X, den);
+		if (!ok && nsteps >= maxsteps)
+		{
+			QSlog ("Dixon lifting failed to certify after %d steps", nsteps);
+			*singular = 1;
+			goto CLEANUP;
+		}
+	}
+	log_message ("Dixon basis solve: %d rows, %d lifting steps, L etas %d, "
+							 "denominator %lu bits", n, nsteps, E.lnz,
+							 (unsigned long) mpz_sizeinbase (den, 2));
+CLEANUP:
+	QSmodelim_free (&E);
+	if (R)
+		for (i = 0; i < n; i++)
+			mpz_clear (R[i]);
+	if (res)
+		for (i = 0; i < n; i++)
+			mpz_clear (res[i]);
+	ILL_IFFREE (R);
+	ILL_IFFREE (res);
+	ILL_IFFREE (order_row);
+	ILL_IFFREE (order_col);
+	ILL_IFFREE (xp);
+	ILL_IFFREE (bp);
+	mpz_clear (P);
+	mpz_clear (prime);
+	return rval;
+}
+
+/*@}*/
+
+/* ========================================================================= */
+/** @brief store b - N x_N in @a r (of size lp->nrows), with the nonbasic
+ * variables at the bounds given by vstat. */
+static void QSbasis_primal_rhs (const mpq_lpinfo * lp,
+																mpq_t * r)
+{
+	const int n = lp->nrows;
+	mpq_t xval;
+	int i,
+	  j,
+	  e;
+	mpq_init (xval);
+	for (i = 0; i < n; i++)
+		mpq_set (r[i], lp->bz[i]);
+	for (j = 0; j < lp->nnbasic; j++)
+	{
+		const int col = lp->nbaz[j];
+		if (lp->vstat[col] == STAT_UPPER)
+			mpq_set (xval, lp->uz[col]);
+		else if (lp->vstat[col] == STAT_LOWER)
+			mpq_set (xval, lp->lz[col]);
+		else
+			continue;
+		if (!mpq_sgn (xval))
+			continue;
+		for (e = lp->matbeg[col]; e < lp->matbeg[col] + lp->matcnt[col]; e++)
+			mpq_EGlpNumSubInnProdTo (r[lp->matind[e]], xval, lp->matval[e]);
+	}
+	mpq_clear (xval);
+}
+
+/* ========================================================================= */
+/** @brief solve the integer system loaded in @a Z; on success the solution
+ * is X / den. */
+static int QSint_system_solve (QSbareiss_t * Z,
+															 const int solver,
+															 mpz_t * X,
+															 mpz_t den,
+															 int *singular)
+{
+	int rval = 0;
+	switch (solver)
+	{
+	case QS_EXACT_BASIS_SOLVER_BAREISS:
+		EGcallD(QSbareiss_solve (Z, X, singular));
+		if (*singular)
+			break;
+		mpz_set (den, Z->rho[Z->n]);
+		log_message ("Bareiss basis solve: %d rows, fill %d, determinant %lu bits",
+								 Z->n, Z->fill, (unsigned long) mpz_sizeinbase (den, 2));
+		break;
+	case QS_EXACT_BASIS_SOLVER_MODULAR:
+		EGcallD(QSmodular_solve (Z, X, den, singular));
+		break;
+	case QS_EXACT_BASIS_SOLVER_DIXON:
+		EGcallD(QSdixon_solve (Z, X, den, singular));
+		break;
+	default:
+		QSlog ("unknown exact basis solver %d", solver);
+		rval = 1;
+		goto CLEANUP;
+	}
+CLEANUP:
+	return rval;
+}
+
+/* ========================================================================= */
+int QSexact_basis_solve (mpq_lpinfo * lp,
+												 const int solver,
+												 const int what,
+												 int *singular)
+{
+	int rval = 0;
+	const int n = lp->nrows;
+	QSbareiss_t B;
+	mpz_t *s = 0,
+	 *X = 0;
+	mpq_t *r = 0;
+	mpz_t D,
+	  den;
+	register int i,
+	  k,
+	  e;
+	memset (&B, 0, sizeof (B));
+	mpz_init (D);
+	mpz_init (den);
+	*singular = 0;
+	if (!n)
+		goto CLEANUP;
+	ILL_SAFE_MALLOC (s, n, mpz_t);
+	ILL_SAFE_MALLOC (X, n, mpz_t);
+	for (i = 0; i < n; i++)
+	{
+		mpz_init_set_ui (s[i], 1UL);
+		mpz_init (X[i]);
+	}
+	r = mpq_EGlpNumAllocArray (n);
+	/* column scales making B S integral */
+	for (k = 0; k < n; k++)
+	{
+		const int col = lp->baz[k];
+		for (e = lp->matbeg[col]; e < lp->matbeg[col] + lp->matcnt[col]; e++)
+			mpz_lcm (s[k], s[k], mpq_denref (lp->matval[e]));
+	}
+	if (what & QS_EXACT_BASIS_PRIMAL)
+	{
+		/* (B S) w = b - N x_N, x_B = S w */
+		QSbasis_primal_rhs (lp, r);
+		EGcallD(QSbareiss_init (&B, n));
+		EGcallD(QSbareiss_load_basis (&B, lp, s, 0));
+		QSbareiss_load_rhs (&B, r, D);
+		EGcallD(QSint_system_solve (&B, solver, X, den, singular));
+		if (*singular)
+			goto CLEANUP;
+		mpz_mul (D, D, den);
+		for (k = 0; k < n; k++)
+		{
+			mpz_mul (mpq_numref (lp->xbz[k]), X[k], s[k]);
+			mpz_set (mpq_denref (lp->xbz[k]), D);
+			mpq_canonicalize (lp->xbz[k]);
+		}
+		QSbareiss_free (&B);
+	}
+	if (what & QS_EXACT_BASIS_DUAL)
+	{
+		/* (B S)^T pi = S c_B */
+		for (k = 0; k < n; k++)
+		{
+			mpz_set (mpq_numref (r[k]), s[k]);
+			mpz_set_ui (mpq_denref (r[k]), 1UL);
+			mpq_mul (r[k], r[k], lp->cz[lp->baz[k]]);
+		}
+		EGcallD(QSbareiss_init (&B, n));
+		EGcallD(QSbareiss_load_basis (&B, lp, s, 1));
+		QSbareiss_load_rhs (&B, r, D);
+		EGcallD(QSint_system_solve (&B, solver, X, den, singular));
+		if (*singular)
+			goto CLEANUP;
+		mpz_mul (D, D, den);
+		for (i = 0; i < n; i++)
+		{
+			mpz_set (mpq_numref (lp->piz[i]), X[i]);
+			mpz_set (mpq_denref (lp->piz[i]), D);
+			mpq_canonicalize (lp->piz[i]);
+		}
+	}
+CLEANUP:
+	QSbareiss_free (&B);
+	if (s)
+		for (i = 0; i < n; i++)
+			mpz_clear (s[i]);
+	if (X)
+		for (i = 0; i < n; i++)
+			mpz_clear (X[i]);
+	ILL_IFFREE (s);
+	ILL_IFFREE (X);
+	mpq_EGlpNumFreeArray (r);
+	mpz_clear (D);
+	mpz_clear (den);
+	return rval;
+}
+
+/* ========================================================================= */
+/** @name Schur complement of a frozen factorization */
+/*@{*/
+
+/* ========================================================================= */
+/** @brief factor the dense k x k rational matrix W (row-major) in place as
+ * P W = L U, with L unit lower triangular. Among the nonzero candidates the
+ * pivot with the shortest numerator and denominator is taken, to slow down
+ * the growth of the entries; perm[r] is the row of W used as r-th pivot. */
+static void QSschur_factor (mpq_t * W,
+														const int k,
+														int *perm,
+														mpq_t t,
+														int *singular)
+{
+	int r,
+	  i,
+	  j,
+	  best;
+	size_t bsz,
+	  sz;
+	*singular = 0;
+	for (r = 0; r < k; r++)
+		perm[r] = r;
+	for (r = 0; r < k; r++)
+	{
+		best = -1;
+		bsz = 0;
+		for (i = r; i < k; i++)
+		{
+			if (!mpq_sgn (W[i * k + r]))
+				continue;
+			sz = mpz_size (mpq_numref (W[i * k + r])) +
+				mpz_size (mpq_denref (W[i * k + r]));
+			if (best < 0 || sz < bsz)
+			{
+				best = i;
+				bsz = sz;
+			}
+		}
+		if (best < 0)
+		{
+			*singular = 1;
+			return;
+		}
+		if (best != r)
+		{
+			for (j = 0; j < k; j++)
+				mpq_swap (W[r * k + j], W[best * k + j]);
+			i = perm[r];
+			perm[r] = perm[best];
+			perm[best] = i;
+		}
+		for (i = r + 1; i < k; i++)
+		{
+			if (!mpq_sgn (W[i * k + r]))
+				continue;
+			mpq_div (W[i * k + r], W[i * k + r], W[r * k + r]);
+			for (j = r + 1; j < k; j++)
+			{
+				if (!mpq_sgn (W[r * k + j]))
+					continue;
+				mpq_mul (t, W[i * k + r], W[r * k + j]);
+				mpq_sub (W[i * k + j], W[i * k + j], t);
+			}
+		}
+	}
+}
+
+/* ========================================================================= */
+/** @brief solve W x = b (transpose = 0) or W^T x = b (transpose = 1) with
+ * the factorization of #QSschur_factor; b is overwritten by x. */
+static void QSschur_solve (mpq_t * W,
+													 const int k,
+													 const int *perm,
+													 const int transpose,
+													 mpq_t * b,
+													 mpq_t * w,
+													 mpq_t t)
+{
+	int r,
+	  j;
+	if (!transpose)
+	{
+		/* L U x = P b */
+		for (r = 0; r < k; r++)
+			mpq_set (w[r], b[perm[r]]);
+		for (r = 0; r < k; r++)
+			for (j = 0; j < r; j++)
+				if (mpq_sgn (W[r * k + j]))
+				{
+					mpq_mul (t, W[r * k + j], w[j]);
+					mpq_sub (w[r], w[r], t);
+				}
+		for (r = k; r--;)
+		{
+			for (j = r + 1; j < k; j++)
+				if (mpq_sgn (W[r * k + j]))
+				{
+					mpq_mul (t, W[r * k + j], w[j]);
+					mpq_sub (w[r], w[r], t);
+				}
+			mpq_div (w[r], w[r], W[r * k + r]);
+		}
+		for (r = 0; r < k; r++)
+			mpq_set (b[r], w[r]);
+	}
+	else
+	{
+		/* U^T L^T (P x) = b */
+		for (r = 0; r < k; r++)
+		{
+			mpq_set (w[r], b[r]);
+			for (j = 0; j < r; j++)
+				if (mpq_sgn (W[j * k + r]))
+				{
+					mpq_mul (t, W[j * k + r], w[j]);
+					mpq_sub (w[r], w[r], t);
+				}
+			mpq_div (w[r], w[r], W[r * k + r]);
+		}
+		for (r = k; r--;)
+			for (j = r + 1; j < k; j++)
+				if (mpq_sgn (W[j * k + r]))
+				{
+					mpq_mul (t, W[j * k + r], w[j]);
+					mpq_sub (w[r], w[r], t);
+				}
+		for (r = 0; r < k; r++)
+			mpq_set (b[perm[r]], w[r]);
+	}
+}
+
+/* ========================================================================= */
+int QSexact_schur_solve (mpq_lpinfo * lp,
+												 mpq_factor_work * f,
+												 const int *fbaz,
+												 const int what,
+												 int *singular)
+{
+	int rval = 0;
+	const int n = lp->nrows;
+	int k = 0,
+	  nv = 0,
+	  i,
+	  j,
+	  r;
+	int *pos = 0,
+	 *rowof = 0,
+	 *perm = 0;
+	mpq_svector *V = 0,
+	  a,
+	  x;
+	mpq_t *W = 0,
+	 *y = 0,
+	 *tk = 0,
+	 *wk = 0;
+	mpq_t t;
+	mpq_init (t);
+	mpq_ILLsvector_init (&a);
+	mpq_ILLsvector_init (&x);
+	*singular = 0;
+	if (!n)
+		goto CLEANUP;
+	ILL_SAFE_MALLOC (pos, n, int);
+	ILL_SAFE_MALLOC (rowof, n, int);
+	for (i = 0; i < n; i++)
+	{
+		rowof[i] = -1;
+		if (fbaz[i] != lp->baz[i])
+		{
+			rowof[i] = k;
+			pos[k++] = i;
+		}
+	}
+	EGcallD(mpq_ILLsvector_alloc (&a, n));
+	EGcallD(mpq_ILLsvector_alloc (&x, n));
+	y = mpq_EGlpNumAllocArray (n);
+
+	/* V = B0^{-1} A_E and its rows at the replaced positions, W */
+	if (k)
+	{
+		ILL_SAFE_MALLOC (V, k, mpq_svector);
+		ILL_SAFE_MALLOC (perm, k, int);
+		W = mpq_EGlpNumAllocArray (k * k);
+		tk = mpq_EGlpNumAllocArray (k);
+		wk = mpq_EGlpNumAllocArray (k);
+		for (j = 0; j < k; j++)
+		{
+			const int col = lp->baz[pos[j]];
+			a.nzcnt = lp->matcnt[col];
+			for (i = 0; i < a.nzcnt; i++)
+			{
+				a.indx[i] = lp->matind[lp->matbeg[col] + i];
+				mpq_set (a.coef[i], lp->matval[lp->matbeg[col] + i]);
+			}
+			mpq_ILLfactor_ftran (f, &a, &x);
+			EGcallD(mpq_ILLsvector_copy (&x, V + j));
+			nv++;
+			for (i = 0; i < x.nzcnt; i++)
+			{
+				r = rowof[x.indx[i]];
+				if (r >= 0)
+					mpq_set (W[r * k + j], x.coef[i]);
+			}
+		}
+		QSschur_factor (W, k, perm, t, singular);
+		if (*singular)
+			goto CLEANUP;
+	}
+
+	if (what & QS_EXACT_BASIS_PRIMAL)
+	{
+		/* y = B0^{-1} r, W x_P = y_P, x_i = y_i - V_i x_P elsewhere */
+		QSbasis_primal_rhs (lp, y);
+		a.nzcnt = 0;
+		for (i = 0; i < n; i++)
+		{
+			if (mpq_sgn (y[i]))
+			{
+				a.indx[a.nzcnt] = i;
+				mpq_set (a.coef[a.nzcnt++], y[i]);
+				mpq_set_ui (y[i], 0UL, 1UL);
+			}
+		}
+		mpq_ILLfactor_ftran (f, &a, &x);
+		for (i = 0; i < x.nzcnt; i++)
+			mpq_set (y[x.indx[i]], x.coef[i]);
+		for (r = 0; r < k; r++)
+			mpq_set (tk[r], y[pos[r]]);
+		if (k)
+			QSschur_solve (W, k, perm, 0, tk, wk, t);
+		for (j = 0; j < k; j++)
+		{
+			if (!mpq_sgn (tk[j]))
+				continue;
+			for (i = 0; i < V[j].nzcnt; i++)
+			{
+				if (rowof[V[j].indx[i]] < 0)
+					mpq_EGlpNumSubInnProdTo (y[V[j].indx[i]], V[j].coef[i], tk[j]);
+			}
+		}
+		for (r = 0; r < k; r++)
+			mpq_set (y[pos[r]], tk[r]);
+		for (i = 0; i < n; i++)
+			mpq_set (lp->xbz[i], y[i]);
+	}
+	if (what & QS_EXACT_BASIS_DUAL)
+	{
+		/* W^T z_P = c_P - V^T c elsewhere, z = c elsewhere, pi = B0^{-T} z */
+		for (i = 0; i < n; i++)
+			mpq_set (y[i], lp->cz[lp->baz[i]]);
+		for (j = 0; j < k; j++)
+		{
+			mpq_set (tk[j], y[pos[j]]);
+			for (i = 0; i < V[j].nzcnt; i++)
+			{
+				if (rowof[V[j].indx[i]] < 0)
+					mpq_EGlpNumSubInnProdTo (tk[j], V[j].coef[i], y[V[j].indx[i]]);
+			}
+		}
+		if (k)
+			QSschur_solve (W, k, perm, 1, tk, wk, t);
+		for (r = 0; r < k; r++)
+			mpq_set (y[pos[r]], tk[r]);
+		a.nzcnt = 0;
+		for (i = 0; i < n; i++)
+		{
+			if (mpq_sgn (y[i]))
+			{
+				a.indx[a.nzcnt] = i;
+				mpq_set (a.coef[a.nzcnt++], y[i]);
+			}
+		}
+		mpq_ILLfactor_btran (f, &a, &x);
+		for (i = 0; i < n; i++)
+			mpq_set_ui (lp->piz[i], 0UL, 1UL);
+		for (i = 0; i < x.nzcnt; i++)
+			mpq_set (lp->piz[x.indx[i]], x.coef[i]);
+	}
+	log_message ("Schur basis solve: %d of %d columns replaced", k, n);
+
+CLEANUP:
+	for (j = 0; j < nv; j++)
+		mpq_ILLsvector_free (V + j);
+	ILL_IFFREE (V);
+	mpq_EGlpNumFreeArray (W);
+	mpq_EGlpNumFreeArray (tk);
+	mpq_EGlpNumFreeArray (wk);
+	mpq_EGlpNumFreeArray (y);
+	mpq_ILLsvector_free (&a);
+	mpq_ILLsvector_free (&x);
+	ILL_IFFREE (perm);
+	ILL_IFFREE (rowof);
+	ILL_IFFREE (pos);
+	mpq_clear (t);
+	return rval;
+}
+
+/*@}*/
+
+/** @} */
+/* ========================================================================= */
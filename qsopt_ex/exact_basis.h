@@ -0,0 +1,107 @@
+/* ========================================================================= */
+/* ESolver "Exact Mixed Integer Linear Solver" provides some basic structures
+ * and algorithms commons in solving MIP's
+ *
+ * Copyright (C) 2005 Daniel Espinoza.
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation; either version 2.1 of the License, or (at your
+ * option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ * */
+/* ========================================================================= */
+#ifndef __EXACT_BASIS_H__
+#define __EXACT_BASIS_H__
+
+#include <gmp.h>
+
+#include "basicdefs.h"
+#include "lpdefs_mpq.h"
+
+/* ========================================================================= */
+/** @addtogroup Esolver */
+/** @{ */
+/* ========================================================================= */
+/** @name Systems computed by #QSexact_basis_solve */
+/*@{*/
+#define QS_EXACT_BASIS_PRIMAL 1				/**< lp->xbz */
+#define QS_EXACT_BASIS_DUAL 2					/**< lp->piz */
+/*@}*/
+
+/* ========================================================================= */
+/** @brief Compute the primal and/or dual values of the basis currently loaded
+ * in the internal lp without going through the rational LU factorization.
+ *
+ * On success lp->xbz (indexed by basis position) and lp->piz (indexed by row)
+ * hold the exact solutions of B x_B = b - N x_N and B^T pi = c_B, exactly as
+ * #mpq_ILLfct_compute_xbz and #mpq_ILLfct_compute_piz would leave them, but
+ * lp->f is not touched.
+ *
+ * In both methods every basis column is first scaled to integers, and each
+ * right hand side by the lcm of its denominators.
+ * - #QS_EXACT_BASIS_SOLVER_BAREISS solves the integer systems by
+ * fraction-free (Bareiss) elimination, so all intermediate numbers are
+ * sub-determinants of the scaled basis and no gcd is computed until the very
+ * last division.
+ * - #QS_EXACT_BASIS_SOLVER_MODULAR solves them modulo word sized primes,
+ * combines the residues by the chinese remainder theorem until rational
+ * reconstruction gives a candidate, and accepts it only after an exact
+ * residual check, so the result never depends on the primes chosen.
+ * - #QS_EXACT_BASIS_SOLVER_DIXON factors them once modulo a single prime and
+ * computes the p-adic expansion of the solution by lifting (Dixon's method),
+ * with the same reconstruction and residual check.
+ * @param lp internal lp with a loaded basis (see #mpq_ILLbasis_load).
+ * @param solver one of the QS_EXACT_BASIS_SOLVER_xxx values other than
+ * #QS_EXACT_BASIS_SOLVER_LU.
+ * @param what a combination of #QS_EXACT_BASIS_PRIMAL and
+ * #QS_EXACT_BASIS_DUAL.
+ * @param singular set to one if the basis is singular (for the modular method
+ * also if no certified solution was found), in which case xbz and piz are
+ * left undefined and the caller should fall back to #mpq_ILLbasis_factor,
+ * which knows how to repair the basis.
+ * @return zero on success, non-zero on failure.
+ * */
+int QSexact_basis_solve (mpq_lpinfo * lp,
+												 const int solver,
+												 const int what,
+												 int *singular);
+
+/* ========================================================================= */
+/** @brief Compute the primal and/or dual values of the basis currently loaded
+ * in the internal lp from a factorization of a different, nearby basis.
+ *
+ * The factorization @a f of the basis @a fbaz is left untouched. If the
+ * current basis B replaces the columns of B0 at k positions, then
+ * B = B0 M, where M is the identity with those columns replaced by
+ * V = B0^{-1} A_E. Every solve with B reduces to a solve with B0 and one with
+ * the k x k block W of V at the replaced positions (the Schur complement),
+ * which is factored densely; unlike an eta file the cost and the size of the
+ * numbers involved do not grow with the number of bases verified against the
+ * same B0.
+ * @param lp internal lp with a loaded basis (see #mpq_ILLbasis_load).
+ * @param f rational factorization of the basis @a fbaz.
+ * @param fbaz basis factored by @a f, by position.
+ * @param what a combination of #QS_EXACT_BASIS_PRIMAL and
+ * #QS_EXACT_BASIS_DUAL.
+ * @param singular set to one if the current basis is singular, in which case
+ * xbz and piz are left undefined.
+ * @return zero on success, non-zero on failure.
+ * */
+int QSexact_schur_solve (mpq_lpinfo * lp,
+												 mpq_factor_work * f,
+												 const int *fbaz,
+												 const int what,
+												 int *singular);
+
+/** @} */
+/* ========================================================================= */
+#endif
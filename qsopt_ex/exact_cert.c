@@ -0,0 +1,895 @@
+/* ========================================================================= */
+/* ESolver "Exact Mixed Integer Linear Solver" provides some basic structures
+ * and algorithms commons in solving MIP's
+ *
+ * Copyright (C) 2005 Daniel Espinoza.
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation; either version 2.1 of the License, or (at your
+ * option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ * */
+/* ========================================================================= */
+/** @file
+ * @ingroup Esolver
+ * Binary exact certificates, see #QSexact_write_cert for the format. */
+/** @addtogroup Esolver */
+/** @{ */
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+#include "qs_config.h"
+
+#include <limits.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#if HAVE_EG_THREAD
+#include <pthread.h>
+#endif
+
+#include "exact.h"
+
+#include "logging-private.h"
+
+#include "util.h"
+#include "except.h"
+#include "eg_macros.h"
+#include "qsopt_mpq.h"
+
+/* ========================================================================= */
+/** @brief magic number at the start of every certificate */
+static const char QScert_magic[8] = { 'Q', 'S', 'X', 'C', 'E', 'R', 'T', '1' };
+
+/* ========================================================================= */
+/** @brief magic number at the start of every checkpoint */
+static const char QSckpt_magic[8] = { 'Q', 'S', 'X', 'C', 'K', 'P', 'T', '1' };
+
+/* ========================================================================= */
+/** @brief scratch space for the limbs of one integer */
+typedef struct
+{
+	uint64_t *limb;
+	size_t sz;
+	size_t left;									/**< bound on the bytes left in the input */
+}
+QScert_buf_t;
+
+/* ========================================================================= */
+/** @brief make room for n limbs in buf */
+static int QScert_reserve (QScert_buf_t * buf,
+													 size_t n)
+{
+	uint64_t *limb;
+	if (n <= buf->sz)
+		return 0;
+	if (n > SIZE_MAX / sizeof (uint64_t))
+		return 1;
+	limb = (uint64_t *) realloc (buf->limb, sizeof (uint64_t) * n);
+	if (!limb)
+		return 1;
+	buf->limb = limb;
+	buf->sz = n;
+	return 0;
+}
+
+/* ========================================================================= */
+/** @brief write v as n little endian bytes */
+static int QScert_write_le (EGioFile_t * out_f,
+														uint64_t v,
+														const int n)
+{
+	unsigned char b[8];
+	int i;
+	for (i = 0; i < n; i++, v >>= 8)
+		b[i] = (unsigned char) (v & 0xff);
+	return EGioFwrite (b, (size_t) n, out_f) != (size_t) n;
+}
+
+/* ========================================================================= */
+/** @brief read n little endian bytes into v */
+static int QScert_read_le (EGioFile_t * in_f,
+													 uint64_t * v,
+													 const int n)
+{
+	unsigned char b[8];
+	int i;
+	if (EGioFread (b, (size_t) n, in_f) != (size_t) n)
+		return 1;
+	for (*v = 0, i = n; i--;)
+		*v = (*v << 8) | b[i];
+	return 0;
+}
+
+/* ========================================================================= */
+/** @brief write an integer as its signed limb count and its limbs */
+static int QScert_write_mpz (EGioFile_t * out_f,
+														 mpz_t z,
+														 QScert_buf_t * buf)
+{
+	int rval = 0;
+	size_t n = mpz_sgn (z) ? (mpz_sizeinbase (z, 2) + 63) / 64 : 0,
+	  i;
+	int64_t const cnt = mpz_sgn (z) < 0 ? -(int64_t) n : (int64_t) n;
+	EGcallD(QScert_write_le (out_f, (uint64_t) cnt, 8));
+	if (!n)
+		goto CLEANUP;
+	EGcallD(QScert_reserve (buf, n));
+	mpz_export (buf->limb, &n, -1, sizeof (uint64_t), -1, 0, z);
+	for (i = 0; i < n; i++)
+		EGcallD(QScert_write_le (out_f, buf->limb[i], 8));
+CLEANUP:
+	return rval;
+}
+
+/* ========================================================================= */
+/** @brief read an integer written by #QScert_write_mpz. The limb count
+ * comes from the file, so it is checked against what is left of it, and
+ * when that is not known (compressed input) the buffer only grows as the
+ * limbs actually arrive. */
+static int QScert_read_mpz (EGioFile_t * in_f,
+														mpz_t z,
+														QScert_buf_t * buf)
+{
+	int rval = 0;
+	uint64_t v;
+	int64_t cnt;
+	size_t n,
+	  i;
+	EGcallD(QScert_read_le (in_f, &v, 8));
+	buf->left -= buf->left < 8 ? buf->left : 8;
+	cnt = (int64_t) v;
+	if (cnt == INT64_MIN || (uint64_t) (cnt < 0 ? -cnt : cnt) >
+			(uint64_t) (buf->left / sizeof (uint64_t)))
+	{
+		QSlog ("integer of %lld limbs in certificate is too long",
+					 (long long) cnt);
+		rval = 1;
+		goto CLEANUP;
+	}
+	n = (size_t) (cnt < 0 ? -cnt : cnt);
+	if (!n)
+	{
+		mpz_set_ui (z, 0UL);
+		goto CLEANUP;
+	}
+	buf->left -= n * sizeof (uint64_t);
+	for (i = 0; i < n; i++)
+	{
+		if (i == buf->sz)
+			EGcallD(QScert_reserve (buf, n - i > i + 64 ? 2 * i + 64 : n));
+		EGcallD(QScert_read_le (in_f, buf->limb + i, 8));
+	}
+	mpz_import (z, n, -1, sizeof (uint64_t), -1, 0, buf->limb);
+	if (cnt < 0)
+		mpz_neg (z, z);
+CLEANUP:
+	return rval;
+}
+
+/* ========================================================================= */
+/** @brief write n rationals */
+static int QScert_write_array (EGioFile_t * out_f,
+															 mpq_t * const v,
+															 const int n,
+															 QScert_buf_t * buf)
+{
+	int rval = 0;
+	register int i;
+	for (i = 0; i < n; i++)
+	{
+		EGcallD(QScert_write_mpz (out_f, mpq_numref (v[i]), buf));
+		EGcallD(QScert_write_mpz (out_f, mpq_denref (v[i]), buf));
+	}
+CLEANUP:
+	return rval;
+}
+
+/* ========================================================================= */
+/** @brief read n rationals into a new array, n is a row or column count from
+ * the header. Every rational takes at least two limb counts, so n is checked
+ * against what is left of the file, and when that is not known (compressed
+ * input) the array only grows as the rationals actually arrive. */
+static int QScert_read_array (EGioFile_t * in_f,
+															mpq_t ** v,
+															const int n,
+															QScert_buf_t * buf)
+{
+	int rval = 0;
+	register int i;
+	if ((size_t) n > buf->left / 16)
+	{
+		QSlog ("%d rationals do not fit in what is left of the certificate", n);
+		rval = 1;
+		goto CLEANUP;
+	}
+	*v = mpq_EGlpNumAllocArray (n < 64 ? n : 64);
+	for (i = 0; i < n; i++)
+	{
+		if (i >= 64 && !(i & (i - 1)))
+			mpq_EGlpNumReallocArray (v, (size_t) (n - i > i ? 2 * i : n));
+		EGcallD(QScert_read_mpz (in_f, mpq_numref ((*v)[i]), buf));
+		EGcallD(QScert_read_mpz (in_f, mpq_denref ((*v)[i]), buf));
+		if (mpz_sgn (mpq_denref ((*v)[i])) <= 0)
+		{
+			QSlog ("non positive denominator in certificate");
+			rval = 1;
+			goto CLEANUP;
+		}
+		mpq_canonicalize ((*v)[i]);
+	}
+CLEANUP:
+	return rval;
+}
+
+/* ========================================================================= */
+/** @brief write (or skip) the zero padding after len bytes */
+static int QScert_pad (EGioFile_t * f,
+											 size_t len,
+											 const int reading)
+{
+	char pad[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+	size_t const n = (8 - len % 8) % 8;
+	if (!n)
+		return 0;
+	if (reading)
+		return EGioFread (pad, n, f) != n;
+	return EGioFwrite (pad, n, f) != n;
+}
+
+/* ========================================================================= */
+int QSexact_write_cert (mpq_QSdata * p,
+												const int status,
+												mpq_t * const y,
+												EGioFile_t * out_f)
+{
+	int rval = 0,
+	  flags = 0;
+	const int ncols = mpq_QSget_colcount (p);
+	const int nrows = mpq_QSget_rowcount (p);
+	QSbasis *basis = mpq_QSget_basis (p);
+	mpq_t *x_mpq = mpq_EGlpNumAllocArray (ncols);
+	mpq_t *y_mpq = mpq_EGlpNumAllocArray (nrows);
+	mpq_t *rc_mpq = mpq_EGlpNumAllocArray (ncols);
+	QScert_buf_t buf = { 0, 0, SIZE_MAX };
+	register int i;
+
+	/* find out what we can certify */
+	if (basis)
+		flags |= QS_CERT_BASIS;
+	if (status == QS_LP_OPTIMAL && !mpq_QSget_x_array (p, x_mpq))
+		flags |= QS_CERT_X;
+	if (status == QS_LP_OPTIMAL && !mpq_QSget_rc_array (p, rc_mpq))
+		flags |= QS_CERT_RC;
+	if (y)
+	{
+		for (i = 0; i < nrows; i++)
+			mpq_set (y_mpq[i], y[i]);
+		flags |= QS_CERT_Y;
+	}
+	else if ((status == QS_LP_OPTIMAL && !mpq_QSget_pi_array (p, y_mpq)) ||
+					 (status == QS_LP_INFEASIBLE && !mpq_QSget_infeas_array (p, y_mpq)))
+		flags |= QS_CERT_Y;
+
+	/* header */
+	if (EGioFwrite (QScert_magic, sizeof (QScert_magic), out_f) !=
+			sizeof (QScert_magic))
+		goto WRITE_ERROR;
+	EGcallD(QScert_write_le (out_f, (uint64_t) status, 4));
+	EGcallD(QScert_write_le (out_f, (uint64_t) ncols, 4));
+	EGcallD(QScert_write_le (out_f, (uint64_t) nrows, 4));
+	EGcallD(QScert_write_le (out_f, (uint64_t) flags, 4));
+	/* sections */
+	if (flags & QS_CERT_BASIS)
+	{
+		if (EGioFwrite (basis->cstat, (size_t) ncols, out_f) != (size_t) ncols ||
+				EGioFwrite (basis->rstat, (size_t) nrows, out_f) != (size_t) nrows)
+			goto WRITE_ERROR;
+		EGcallD(QScert_pad (out_f, (size_t) (ncols + nrows), 0));
+	}
+	if (flags & QS_CERT_X)
+		EGcallD(QScert_write_array (out_f, x_mpq, ncols, &buf));
+	if (flags & QS_CERT_Y)
+		EGcallD(QScert_write_array (out_f, y_mpq, nrows, &buf));
+	if (flags & QS_CERT_RC)
+		EGcallD(QScert_write_array (out_f, rc_mpq, ncols, &buf));
+	if (!EGioError (out_f))
+		goto CLEANUP;
+
+WRITE_ERROR:
+	QSlog ("failed writing exact certificate");
+	rval = 1;
+CLEANUP:
+	free (buf.limb);
+	mpq_EGlpNumFreeArray (x_mpq);
+	mpq_EGlpNumFreeArray (y_mpq);
+	mpq_EGlpNumFreeArray (rc_mpq);
+	if (basis)
+		mpq_QSfree_basis (basis);
+	return rval;
+}
+
+/* ========================================================================= */
+int QSexact_read_cert (EGioFile_t * in_f,
+											 QSexact_cert * cert)
+{
+	int rval = 0,
+	  flags;
+	char magic[8];
+	uint64_t v;
+	QScert_buf_t buf = { 0, 0, SIZE_MAX };
+
+	memset (cert, 0, sizeof (QSexact_cert));
+	/* header */
+	if (EGioFread (magic, sizeof (magic), in_f) != sizeof (magic) ||
+			memcmp (magic, QScert_magic, sizeof (magic)))
+	{
+		QSlog ("not an exact certificate");
+		rval = 1;
+		goto CLEANUP;
+	}
+	EGcallD(QScert_read_le (in_f, &v, 4));
+	cert->status = (int) v;
+	EGcallD(QScert_read_le (in_f, &v, 4));
+	cert->ncols = (int) v;
+	EGcallD(QScert_read_le (in_f, &v, 4));
+	cert->nrows = (int) v;
+	EGcallD(QScert_read_le (in_f, &v, 4));
+	flags = (int) v;
+	if (cert->ncols < 0 || cert->nrows < 0 || cert->ncols == INT_MAX ||
+			cert->nrows == INT_MAX ||
+			(flags & ~(QS_CERT_BASIS | QS_CERT_X | QS_CERT_Y | QS_CERT_RC)))
+		goto READ_ERROR;
+	buf.left = EGioLeft (in_f);
+	/* sections */
+	if (flags & QS_CERT_BASIS)
+	{
+		if ((size_t) cert->ncols + (size_t) cert->nrows > buf.left)
+			goto READ_ERROR;
+		buf.left -= (size_t) cert->ncols + (size_t) cert->nrows;
+		cert->basis = EGsMalloc (QSbasis, 1);
+		cert->basis->nstruct = cert->ncols;
+		cert->basis->nrows = cert->nrows;
+		cert->basis->cstat = EGsMalloc (char, cert->ncols + 1);
+		cert->basis->rstat = EGsMalloc (char, cert->nrows + 1);
+		if (EGioFread (cert->basis->cstat, (size_t) cert->ncols, in_f) !=
+				(size_t) cert->ncols ||
+				EGioFread (cert->basis->rstat, (size_t) cert->nrows, in_f) !=
+				(size_t) cert->nrows)
+			goto READ_ERROR;
+		cert->basis->cstat[cert->ncols] = 0;
+		cert->basis->rstat[cert->nrows] = 0;
+		EGcallD(QScert_pad (in_f, (size_t) (cert->ncols + cert->nrows), 1));
+	}
+	if (flags & QS_CERT_X)
+		EGcallD(QScert_read_array (in_f, &cert->x, cert->ncols, &buf));
+	if (flags & QS_CERT_Y)
+		EGcallD(QScert_read_array (in_f, &cert->y, cert->nrows, &buf));
+	if (flags & QS_CERT_RC)
+		EGcallD(QScert_read_array (in_f, &cert->rc, cert->ncols, &buf));
+	goto CLEANUP;
+
+READ_ERROR:
+	QSlog ("malformed exact certificate");
+	rval = 1;
+CLEANUP:
+	free (buf.limb);
+	if (rval)
+		QSexact_free_cert (cert);
+	return rval;
+}
+
+/* ========================================================================= */
+void QSexact_free_cert (QSexact_cert * cert)
+{
+	if (cert->basis)
+		mpq_QSfree_basis (cert->basis);
+	mpq_EGlpNumFreeArray (cert->x);
+	mpq_EGlpNumFreeArray (cert->y);
+	mpq_EGlpNumFreeArray (cert->rc);
+	memset (cert, 0, sizeof (QSexact_cert));
+}
+
+/* ========================================================================= */
+int QSexact_write_checkpoint (const char *fname,
+															const QSexact_checkpoint * ck)
+{
+	int rval = 0;
+	size_t const len = strlen (fname) + 5;
+	char *tmpname = EGsMalloc (char, len);
+	EGioFile_t *out_f = 0;
+
+	/* write aside and rename, so that a crash leaves the previous one intact */
+	snprintf (tmpname, len, "%s.tmp", fname);
+	out_f = EGioOpen (tmpname, "w");
+	if (!out_f)
+	{
+		QSlog ("could not open %s", tmpname);
+		rval = 1;
+		goto CLEANUP;
+	}
+	if (EGioFwrite (QSckpt_magic, sizeof (QSckpt_magic), out_f) !=
+			sizeof (QSckpt_magic))
+		goto WRITE_ERROR;
+	EGcallD(QScert_write_le (out_f, (uint64_t) ck->ncols, 4));
+	EGcallD(QScert_write_le (out_f, (uint64_t) ck->nrows, 4));
+	EGcallD(QScert_write_le (out_f, (uint64_t) ck->rung, 4));
+	EGcallD(QScert_write_le (out_f, (uint64_t) ck->precision, 4));
+	EGcallD(QScert_write_le (out_f, (uint64_t) ck->lost, 4));
+	EGcallD(QScert_write_le (out_f, (uint64_t) ck->status, 4));
+	EGcallD(QScert_write_le (out_f, (uint64_t) ck->iter, 4));
+	EGcallD(QScert_write_le (out_f, (uint64_t) (ck->basis ? QS_CERT_BASIS : 0),
+													 4));
+	if (ck->basis)
+	{
+		if (EGioFwrite (ck->basis->cstat, (size_t) ck->ncols, out_f) !=
+				(size_t) ck->ncols ||
+				EGioFwrite (ck->basis->rstat, (size_t) ck->nrows, out_f) !=
+				(size_t) ck->nrows)
+			goto WRITE_ERROR;
+		EGcallD(QScert_pad (out_f, (size_t) (ck->ncols + ck->nrows), 0));
+	}
+	if (!EGioError (out_f))
+	{
+		EGioClose (out_f);
+		out_f = 0;
+		if (!rename (tmpname, fname))
+			goto CLEANUP;
+	}
+
+WRITE_ERROR:
+	QSlog ("failed writing checkpoint %s", fname);
+	rval = 1;
+CLEANUP:
+	if (out_f)
+		EGioClose (out_f);
+	if (rval)
+		remove (tmpname);
+	EGfree (tmpname);
+	return rval;
+}
+
+/* ========================================================================= */
+int QSexact_read_checkpoint (const char *fname,
+														 QSexact_checkpoint * ck)
+{
+	int rval = 0,
+	  flags;
+	char magic[8];
+	uint64_t v;
+	EGioFile_t *in_f = EGioOpen (fname, "r");
+
+	memset (ck, 0, sizeof (QSexact_checkpoint));
+	if (!in_f)
+	{
+		rval = 1;
+		goto CLEANUP;
+	}
+	if (EGioFread (magic, sizeof (magic), in_f) != sizeof (magic) ||
+			memcmp (magic, QSckpt_magic, sizeof (magic)))
+		goto READ_ERROR;
+	EGcallD(QScert_read_le (in_f, &v, 4));
+	ck->ncols = (int) v;
+	EGcallD(QScert_read_le (in_f, &v, 4));
+	ck->nrows = (int) v;
+	EGcallD(QScert_read_le (in_f, &v, 4));
+	ck->rung = (int) v;
+	EGcallD(QScert_read_le (in_f, &v, 4));
+	ck->precision = (unsigned) v;
+	EGcallD(QScert_read_le (in_f, &v, 4));
+	ck->lost = (int) v;
+	EGcallD(QScert_read_le (in_f, &v, 4));
+	ck->status = (int) v;
+	EGcallD(QScert_read_le (in_f, &v, 4));
+	ck->iter = (int) v;
+	EGcallD(QScert_read_le (in_f, &v, 4));
+	flags = (int) v;
+	if (ck->ncols < 0 || ck->nrows < 0 || ck->rung < 0 || ck->lost < 0 ||
+			ck->ncols == INT_MAX || ck->nrows == INT_MAX || (flags & ~QS_CERT_BASIS))
+		goto READ_ERROR;
+	if (flags & QS_CERT_BASIS)
+	{
+		if ((size_t) ck->ncols + (size_t) ck->nrows > EGioLeft (in_f))
+			goto READ_ERROR;
+		ck->basis = EGsMalloc (QSbasis, 1);
+		ck->basis->nstruct = ck->ncols;
+		ck->basis->nrows = ck->nrows;
+		ck->basis->cstat = EGsMalloc (char, ck->ncols + 1);
+		ck->basis->rstat = EGsMalloc (char, ck->nrows + 1);
+		if (EGioFread (ck->basis->cstat, (size_t) ck->ncols, in_f) !=
+				(size_t) ck->ncols ||
+				EGioFread (ck->basis->rstat, (size_t) ck->nrows, in_f) !=
+				(size_t) ck->nrows)
+			goto READ_ERROR;
+		ck->basis->cstat[ck->ncols] = 0;
+		ck->basis->rstat[ck->nrows] = 0;
+	}
+	goto CLEANUP;
+
+READ_ERROR:
+	QSlog ("malformed checkpoint %s", fname);
+	rval = 1;
+CLEANUP:
+	if (in_f)
+		EGioClose (in_f);
+	if (rval)
+		QSexact_free_checkpoint (ck);
+	return rval;
+}
+
+/* ========================================================================= */
+void QSexact_free_checkpoint (QSexact_checkpoint * ck)
+{
+	if (ck->basis)
+		mpq_QSfree_basis (ck->basis);
+	memset (ck, 0, sizeof (QSexact_checkpoint));
+}
+
+
+/* ========================================================================= */
+/** @name Certificate checker
+ * The rows and columns are split in contiguous ranges, one per thread. In a
+ * first pass every thread walks its structural columns, accumulating its own
+ * share of A x on a private row vector, its own share of the objectives, and
+ * checking bounds, dual signs and complementary slackness. In a second pass
+ * every thread walks its rows, adds up the partial row activities of all
+ * threads to get the logical variables, and checks them as well. The partial
+ * objectives are reduced at the end. */
+/** @{ */
+/* ========================================================================= */
+/** @brief state of one checker thread */
+typedef struct QScert_check_t
+{
+	mpq_ILLlpdata *qslp;					/**< problem being checked */
+	QSexact_cert *cert;						/**< certificate being checked */
+	struct QScert_check_t *all;		/**< state of all threads */
+	int nthreads;									/**< number of threads */
+	int first,										/**< first column (or row) of the range */
+	  last;												/**< one past the last column (or row) */
+	int phase;										/**< 0 for columns, 1 for rows */
+	int msg_lvl;									/**< message level, see #MESSAGE */
+	int valid;										/**< cleared on the first violation */
+	mpq_EGlpNumDot_t *ax;					/**< partial row activities */
+	mpq_EGlpNumDot_t acc;					/**< row and reduced cost accumulator */
+	mpq_EGlpNumDot_t p_obj,				/**< partial primal objective */
+	  d_obj;											/**< partial dual objective */
+	mpq_t val,
+	  dz;
+#if HAVE_EG_THREAD
+	pthread_t thread;
+	int started;
+#endif
+}
+QScert_check_t;
+
+/* ========================================================================= */
+/** @brief check the reduced cost dz of a column with value x (ignored for
+ * infeasibility certificates), and add its bound term to the dual objective.
+ * @return one if everything is fine, zero otherwise */
+static int QScert_check_dual (QScert_check_t * ck,
+															const int col,
+															mpq_t x,
+															const char *name)
+{
+	mpq_ILLlpdata *qslp = ck->qslp;
+	int const optimal = ck->cert->status == QS_LP_OPTIMAL;
+	int const sense = optimal && qslp->objsense != QS_MIN ? -1 : 1;
+	int const sgn = sense * mpq_sgn (ck->dz);
+	mpq_t *bound = sgn > 0 ? qslp->lower : qslp->upper;
+	if (!sgn)
+		return 1;
+	if (mpq_equal (bound[col], sgn > 0 ? mpq_ILL_MINDOUBLE : mpq_ILL_MAXDOUBLE))
+	{
+		MESSAGE (ck->msg_lvl, "%s bound of %s is infinite, and its dual is "
+						 "non-zero %lg", sgn > 0 ? "lower" : "upper", name,
+						 mpq_get_d (ck->dz));
+		return 0;
+	}
+	if (optimal && !mpq_equal (x, bound[col]))
+	{
+		MESSAGE (ck->msg_lvl, "%s slack of %s (%lg) and its dual (%lg) don't "
+						 "satisfy complementary slackness", sgn > 0 ? "lower" : "upper",
+						 name, mpq_get_d (x) - mpq_get_d (bound[col]),
+						 mpq_get_d (ck->dz));
+		return 0;
+	}
+	mpq_EGlpNumDotAddProd (ck->d_obj, ck->dz, bound[col]);
+	return 1;
+}
+
+/* ========================================================================= */
+/** @brief check that x lies within the bounds of column col */
+static int QScert_check_bounds (QScert_check_t * ck,
+																const int col,
+																mpq_t x,
+																const char *name)
+{
+	if (mpq_cmp (x, ck->qslp->lower[col]) < 0 ||
+			mpq_cmp (x, ck->qslp->upper[col]) > 0)
+	{
+		MESSAGE (ck->msg_lvl, "%s (%lg) is outside its bounds [%lg,%lg]", name,
+						 mpq_get_d (x), mpq_get_d (ck->qslp->lower[col]),
+						 mpq_get_d (ck->qslp->upper[col]));
+		return 0;
+	}
+	return 1;
+}
+
+/* ========================================================================= */
+/** @brief set ck->dz to the reduced cost of column col */
+static void QScert_reduced_cost (QScert_check_t * ck,
+																 const int col)
+{
+	mpq_ILLlpdata *qslp = ck->qslp;
+	mpq_t *const y = ck->cert->y;
+	mpq_t *const matval = qslp->A.matval + qslp->A.matbeg[col];
+	int *const matind = qslp->A.matind + qslp->A.matbeg[col];
+	register int j;
+	mpq_EGlpNumDotZero (ck->acc);
+	if (ck->cert->status == QS_LP_OPTIMAL)
+		mpq_EGlpNumDotAdd (ck->acc, qslp->obj[col]);
+	for (j = qslp->A.matcnt[col]; j--;)
+		mpq_EGlpNumDotSubProd (ck->acc, matval[j], y[matind[j]]);
+	mpq_EGlpNumDotGet (ck->dz, ck->acc);
+}
+
+/* ========================================================================= */
+/** @brief first pass, over the structural columns first..last-1 */
+static void QScert_check_cols (QScert_check_t * ck)
+{
+	mpq_ILLlpdata *qslp = ck->qslp;
+	QSexact_cert *cert = ck->cert;
+	int const optimal = cert->status == QS_LP_OPTIMAL;
+	register int i,
+	  j;
+	int col;
+	for (i = ck->first; ck->valid && i < ck->last; i++)
+	{
+		col = qslp->structmap[i];
+		if (optimal)
+		{
+			if (!QScert_check_bounds (ck, col, cert->x[i], qslp->colnames[i]))
+				goto FAIL;
+			mpq_EGlpNumDotAddProd (ck->p_obj, qslp->obj[col], cert->x[i]);
+			if (mpq_sgn (cert->x[i]))
+				for (j = qslp->A.matbeg[col];
+						 j < qslp->A.matbeg[col] + qslp->A.matcnt[col]; j++)
+					mpq_EGlpNumDotAddProd (ck->ax[qslp->A.matind[j]], qslp->A.matval[j],
+																 cert->x[i]);
+		}
+		QScert_reduced_cost (ck, col);
+		if (optimal && cert->rc && !mpq_equal (cert->rc[i], ck->dz))
+		{
+			MESSAGE (ck->msg_lvl, "reduced cost of %s is %lg, not %lg",
+							 qslp->colnames[i], mpq_get_d (ck->dz), mpq_get_d (cert->rc[i]));
+			goto FAIL;
+		}
+		if (!QScert_check_dual (ck, col, optimal ? cert->x[i] : ck->dz,
+														qslp->colnames[i]))
+			goto FAIL;
+	}
+	return;
+FAIL:
+	ck->valid = 0;
+}
+
+/* ========================================================================= */
+/** @brief second pass, over the rows first..last-1 */
+static void QScert_check_rows (QScert_check_t * ck)
+{
+	mpq_ILLlpdata *qslp = ck->qslp;
+	QSexact_cert *cert = ck->cert;
+	int const optimal = cert->status == QS_LP_OPTIMAL;
+	register int i,
+	  t;
+	int col;
+	mpq_t *coef;
+	for (i = ck->first; ck->valid && i < ck->last; i++)
+	{
+		col = qslp->rowmap[i];
+		if (qslp->A.matcnt[col] != 1)
+		{
+			MESSAGE (ck->msg_lvl, "logical of %s has %d non-zeros",
+							 qslp->rownames[i], qslp->A.matcnt[col]);
+			goto FAIL;
+		}
+		mpq_EGlpNumDotAddProd (ck->d_obj, qslp->rhs[i], cert->y[i]);
+		if (optimal)
+		{
+			/* value of the logical, from the reduced row activities */
+			mpq_EGlpNumDotZero (ck->acc);
+			mpq_EGlpNumDotAdd (ck->acc, qslp->rhs[i]);
+			for (t = 0; t < ck->nthreads; t++)
+				mpq_EGlpNumDotSubDot (ck->acc, ck->all[t].ax[i]);
+			mpq_EGlpNumDotGet (ck->val, ck->acc);
+			/* logicals almost always have a unit coefficient */
+			coef = qslp->A.matval + qslp->A.matbeg[col];
+			if (mpq_cmp_si (*coef, -1L, 1UL) == 0)
+				mpq_neg (ck->val, ck->val);
+			else if (mpq_cmp_ui (*coef, 1UL, 1UL))
+				mpq_div (ck->val, ck->val, *coef);
+			if (!QScert_check_bounds (ck, col, ck->val, qslp->rownames[i]))
+				goto FAIL;
+			mpq_EGlpNumDotAddProd (ck->p_obj, qslp->obj[col], ck->val);
+		}
+		QScert_reduced_cost (ck, col);
+		if (!QScert_check_dual (ck, col, ck->val, qslp->rownames[i]))
+			goto FAIL;
+	}
+	return;
+FAIL:
+	ck->valid = 0;
+}
+
+/* ========================================================================= */
+/** @brief run the current pass of one thread */
+static void *QScert_check_work (void *arg)
+{
+	QScert_check_t *ck = (QScert_check_t *) arg;
+	if (ck->phase)
+		QScert_check_rows (ck);
+	else
+		QScert_check_cols (ck);
+	return 0;
+}
+
+/* ========================================================================= */
+/** @brief split n items among the threads and run the given pass on all of
+ * them, the calling thread works on the last range. */
+static void QScert_check_pass (QScert_check_t * all,
+															 const int nthreads,
+															 const int n,
+															 const int phase)
+{
+	register int t;
+	for (t = 0; t < nthreads; t++)
+	{
+		all[t].phase = phase;
+		all[t].first = (int) (((long long) n * t) / nthreads);
+		all[t].last = (int) (((long long) n * (t + 1)) / nthreads);
+	}
+#if HAVE_EG_THREAD
+	for (t = 0; t < nthreads - 1; t++)
+		all[t].started = !pthread_create (&all[t].thread, 0, QScert_check_work,
+																			all + t);
+	QScert_check_work (all + nthreads - 1);
+	for (t = 0; t < nthreads - 1; t++)
+	{
+		if (all[t].started)
+			pthread_join (all[t].thread, 0);
+		else
+			QScert_check_work (all + t);
+		all[t].started = 0;
+	}
+#else
+	for (t = 0; t < nthreads; t++)
+		QScert_check_work (all + t);
+#endif
+}
+
+/* ========================================================================= */
+int QSexact_check_cert (mpq_QSdata * p,
+												QSexact_cert * cert,
+												int nthreads)
+{
+	mpq_ILLlpdata *qslp = p->qslp;
+	QScert_check_t *all = 0;
+	int const msg_lvl = __QS_SB_VERB <= DEBUG ? 0 : 100000 * (1 - p->simplex_display);
+	int const optimal = cert->status == QS_LP_OPTIMAL;
+	int valid = 0;
+	register int t;
+	mpq_t p_obj,
+	  d_obj;
+	mpq_init (p_obj);
+	mpq_init (d_obj);
+
+	/* make sure the certificate fits the problem */
+	if (cert->ncols != qslp->nstruct || cert->nrows != qslp->nrows)
+	{
+		MESSAGE (msg_lvl, "certificate is for %d x %d, problem is %d x %d",
+						 cert->nrows, cert->ncols, qslp->nrows, qslp->nstruct);
+		goto CLEANUP;
+	}
+	if ((!optimal && cert->status != QS_LP_INFEASIBLE) || !cert->y ||
+			(optimal && !cert->x))
+	{
+		MESSAGE (msg_lvl, "certificate with status %d can not be checked",
+						 cert->status);
+		goto CLEANUP;
+	}
+#if HAVE_EG_THREAD
+	if (nthreads < 1)
+		nthreads = 1;
+	if (nthreads > qslp->nstruct && nthreads > qslp->nrows)
+		nthreads = qslp->nstruct > qslp->nrows ? qslp->nstruct : qslp->nrows;
+	if (nthreads < 1)
+		nthreads = 1;
+#else
+	nthreads = 1;
+#endif
+	all = EGsMalloc (QScert_check_t, nthreads);
+	memset (all, 0, sizeof (QScert_check_t) * (size_t) nthreads);
+	for (t = 0; t < nthreads; t++)
+	{
+		all[t].qslp = qslp;
+		all[t].cert = cert;
+		all[t].all = all;
+		all[t].nthreads = nthreads;
+		all[t].msg_lvl = msg_lvl;
+		all[t].valid = 1;
+		if (optimal)
+			all[t].ax = mpq_EGlpNumDotAllocArray (qslp->nrows);
+		mpq_EGlpNumDotInit (all[t].acc);
+		mpq_EGlpNumDotInit (all[t].p_obj);
+		mpq_EGlpNumDotInit (all[t].d_obj);
+		mpq_init (all[t].val);
+		mpq_init (all[t].dz);
+	}
+
+	/* the two passes, and the reduction of the objectives */
+	QScert_check_pass (all, nthreads, qslp->nstruct, 0);
+	for (valid = 1, t = 0; t < nthreads; t++)
+		valid = valid && all[t].valid;
+	if (!valid)
+		goto CLEANUP;
+	QScert_check_pass (all, nthreads, qslp->nrows, 1);
+	for (t = 0; t < nthreads; t++)
+	{
+		valid = valid && all[t].valid;
+		if (t)
+		{
+			mpq_EGlpNumDotAddDot (all[0].p_obj, all[t].p_obj);
+			mpq_EGlpNumDotAddDot (all[0].d_obj, all[t].d_obj);
+		}
+	}
+	if (!valid)
+		goto CLEANUP;
+	mpq_EGlpNumDotGet (p_obj, all[0].p_obj);
+	mpq_EGlpNumDotGet (d_obj, all[0].d_obj);
+	if (optimal && !mpq_equal (p_obj, d_obj))
+	{
+		MESSAGE (msg_lvl, "primal and dual objective value differ %lg %lg",
+						 mpq_get_d (p_obj), mpq_get_d (d_obj));
+		valid = 0;
+	}
+	else if (!optimal && mpq_sgn (d_obj) <= 0)
+	{
+		MESSAGE (msg_lvl, "dual ray is feasible, but objective is non positive "
+						 "%lg", mpq_get_d (d_obj));
+		valid = 0;
+	}
+	else
+		MESSAGE (msg_lvl, "certificate checked with %d threads, %s", nthreads,
+						 optimal ? "optimal" : "infeasible");
+
+CLEANUP:
+	if (all)
+	{
+		for (t = 0; t < nthreads; t++)
+		{
+			mpq_EGlpNumDotFreeArray (all[t].ax);
+			mpq_EGlpNumDotClear (all[t].acc);
+			mpq_EGlpNumDotClear (all[t].p_obj);
+			mpq_EGlpNumDotClear (all[t].d_obj);
+			mpq_clear (all[t].val);
+			mpq_clear (all[t].dz);
+		}
+		EGfree (all);
+	}
+	mpq_clear (p_obj);
+	mpq_clear (d_obj);
+	return valid;
+}
+/** @} */
+
+/** @} */
@@ -51,6 +51,10 @@
 #include <stdlib.h>
 #include <math.h>
 
+#include "qs_config.h"
+#if HAVE_EG_THREAD
+#include <pthread.h>
+#endif
 #include "logging-private.h"
 
 #include "allocrus.h"
@@ -74,6 +78,33 @@
 #undef TRACK_FACTOR
 #undef NOTICE_BLOWUP
 
+/* number of columns of the dense kernel updated in one sweep over the rows,
+ * 512 doubles of the pivot row fit comfortably in the L1 cache */
+#define DENSE_TILE 512
+
+/* the dense solves go through the solve snapshots only where the numbers are
+ * stored in the arrays themselves (doubles, the same types that have the
+ * dense kernel); an mpf or mpq coefficient points to its limbs, so packing
+ * it copies the number at every factorization and gains no locality */
+#if EGLPNUM_TYPENAME_EGLPNUM_DENSE_KERNEL
+#define SOLVE_SNAP 1
+#else
+#define SOLVE_SNAP 0
+#endif
+
+/* with f->nthreads > 1, the sparse elimination takes sets of compatible
+ * pivots at once while at least PAR_MIN_DIM rows remain and the sets have at
+ * least PAR_MIN_PIVOTS pivots, each of Markowitz cost at most PAR_COST_MUL
+ * times (one plus) the cost of the first pivot of the set. After that, single
+ * pivots are eliminated in parallel if they touch more than PAR_MIN_ROWS rows
+ * and about PAR_MIN_WORK entries. */
+#define PAR_MIN_DIM 1000
+#define PAR_MIN_PIVOTS 32
+#define PAR_MAX_PIVOTS 4096
+#define PAR_COST_MUL 2
+#define PAR_MIN_ROWS 16
+#define PAR_MIN_WORK 20000
+
 #undef  FACTOR_STATS
 #undef  UPDATE_STATS
 #undef  GROWTH_STATS
@@ -82,14 +113,38 @@
 
 #undef  SORT_RESULTS
 
+/* the study counters are per thread, factorizations may run side by side */
 #ifdef UPDATE_STUDY
-int nupdate = 0;
-long int colspiketot = 0.0;
-long int rowspiketot = 0.0;
-long int permshifttot = 0.0;
-long int leftetatot = 0.0;
+static EGLPNUM_TLS int nupdate = 0;
+static EGLPNUM_TLS long int colspiketot = 0.0;
+static EGLPNUM_TLS long int rowspiketot = 0.0;
+static EGLPNUM_TLS long int permshifttot = 0.0;
+static EGLPNUM_TLS long int leftetatot = 0.0;
 #endif
 
+static void snap_init (
+	EGLPNUM_TYPENAME_solve_snap * s)
+{
+	s->nsteps = 0;
+	s->space = 0;
+	s->beg = 0;
+	s->piv = 0;
+	s->out = 0;
+	s->indx = 0;
+	s->coef = 0;
+}
+
+static void snap_free (
+	EGLPNUM_TYPENAME_solve_snap * s)
+{
+	ILL_IFFREE(s->beg);
+	ILL_IFFREE(s->piv);
+	ILL_IFFREE(s->out);
+	ILL_IFFREE(s->indx);
+	EGLPNUM_TYPENAME_EGlpNumFreeArray (s->coef);
+	snap_init (s);
+}
+
 void EGLPNUM_TYPENAME_ILLfactor_init_factor_work (
 	EGLPNUM_TYPENAME_factor_work * f)
 {
@@ -109,6 +164,8 @@ void EGLPNUM_TYPENAME_ILLfactor_init_factor_work (
 	f->updmaxmult = 1e7;
 	f->dense_fract = 0.25;
 	f->dense_min = 25;
+	f->nthreads = 1;
+	f->par_rounds = 0;
 	EGLPNUM_TYPENAME_EGlpNumCopy (f->partial_cur, f->partial_tol);
 	f->work_coef = 0;
 	f->work_indx = 0;
@@ -133,6 +190,17 @@ void EGLPNUM_TYPENAME_ILLfactor_init_factor_work (
 	f->rrank = 0;
 	f->cperm = 0;
 	f->crank = 0;
+	f->reach_list = 0;
+	f->reach_stack = 0;
+	f->reach_pos = 0;
+	f->ftran_dens = 1.0;
+	f->btran_dens = 1.0;
+	snap_init (&f->lc_snap);
+	snap_init (&f->lr_snap);
+	snap_init (&f->uc_snap);
+	snap_init (&f->ur_snap);
+	f->snap_l = 0;
+	f->snap_u = 0;
 	f->dmat = 0;
 	EGLPNUM_TYPENAME_ILLsvector_init (&f->xtmp);
 }
@@ -185,6 +253,15 @@ void EGLPNUM_TYPENAME_ILLfactor_free_factor_work (
 	ILL_IFFREE(f->rrank);
 	ILL_IFFREE(f->cperm);
 	ILL_IFFREE(f->crank);
+	ILL_IFFREE(f->reach_list);
+	ILL_IFFREE(f->reach_stack);
+	ILL_IFFREE(f->reach_pos);
+	snap_free (&f->lc_snap);
+	snap_free (&f->lr_snap);
+	snap_free (&f->uc_snap);
+	snap_free (&f->ur_snap);
+	f->snap_l = 0;
+	f->snap_u = 0;
 
 	EGLPNUM_TYPENAME_EGlpNumFreeArray (f->dmat);
 	EGLPNUM_TYPENAME_ILLsvector_free (&f->xtmp);
@@ -209,6 +286,9 @@ int EGLPNUM_TYPENAME_ILLfactor_set_factor_iparam (
 	case QS_FACTOR_DENSE_MIN:
 		f->dense_min = val;
 		break;
+	case QS_FACTOR_NTHREADS:
+		f->nthreads = val;
+		break;
 	default:
 		QSlog("Invalid param %d in EGLPNUM_TYPENAME_ILLfactor_set_factor_iparam",
 								param);
@@ -289,6 +369,9 @@ int EGLPNUM_TYPENAME_ILLfactor_create_factor_work (
 	ILL_SAFE_MALLOC (f->rrank, dim, int);
 	ILL_SAFE_MALLOC (f->cperm, dim, int);
 	ILL_SAFE_MALLOC (f->crank, dim, int);
+	ILL_SAFE_MALLOC (f->reach_list, dim, int);
+	ILL_SAFE_MALLOC (f->reach_stack, dim, int);
+	ILL_SAFE_MALLOC (f->reach_pos, dim, int);
 
 	for (i = dim + f->max_k + 1; i--;)
 		EGLPNUM_TYPENAME_EGlpNumInitVar (f->ur_inf[i].max);
@@ -1800,1287 +1883,3056 @@ static int find_pivot (
 	}
 }
 
-static int create_factor_space (
-	EGLPNUM_TYPENAME_factor_work * f)
+/* ========================================================================= */
+/* Parallel elimination of a set of compatible pivots.
+ *
+ * Pivots (r_i,c_i) are compatible if no pivot row has a nonzero in the column
+ * of another pivot. Then the pivot rows are not changed by the other pivots,
+ * and every other row j in the pivot columns becomes
+ * a_j - sum_i (a_j,c_i / a_r_i,c_i) a_r_i, where the multipliers only depend
+ * on the original a_j. Each of these rows is worked out by one thread, in a
+ * private dense work row, and written to space reserved past ur_freebeg. The
+ * column lists, the count lists, the L data and the permutations are then
+ * updated by the calling thread, in the same way as #elim does. Every row is
+ * computed in the same order whatever the number of threads, so the factors
+ * do not depend on it. */
+
+/* flags of an entry of the dense work row */
+#define PAR_ACTIVE 1						/* in the first pivcnt entries of the row */
+#define PAR_OTHER 2							/* past the first pivcnt entries */
+#define PAR_TOUCHED 4						/* updated by some pivot */
+#define PAR_FILL 8							/* not in the original row */
+
+typedef struct par_thread
 {
-	EGLPNUM_TYPENAME_uc_info *uc_inf = f->uc_inf;
-	EGLPNUM_TYPENAME_ur_info *ur_inf = f->ur_inf;
-	int dim = f->dim;
-	int nzcnt;
-	int i;
-	int rval;
+	struct par_info *par;
+	EGLPNUM_TYPE *coef;						/* dense work row */
+	int *mark;										/* PAR_xxx flags of the work row */
+	int first;										/* range of touched rows of the thread */
+	int last;
+#if HAVE_EG_THREAD
+	pthread_t thread;
+	int round;										/* last round run by the thread */
+#endif
+}
+par_thread;
 
-	nzcnt = 0;
-	for (i = 0; i < dim; i++)
-	{
-		nzcnt += ur_inf[i].nzcnt;
-	}
+typedef struct par_info
+{
+	EGLPNUM_TYPENAME_factor_work *f;
+	int nthreads;									/* zero if the parallel elimination is off */
+	int nalloc;										/* threads with work rows */
+	unsigned precision;						/* of the calling thread */
+	par_thread *th;
+	int npiv;
+	int *pr;											/* pivot rows of the set */
+	int *pc;											/* pivot columns of the set */
+	EGLPNUM_TYPE *pval;						/* pivot elements */
+	int *rpiv;										/* position of each row in pr, or -1 */
+	int *cpiv;										/* position of each column in pc, or -1 */
+	int naff;
+	int *aff;											/* rows touched by the set */
+	int *apos;										/* position of each row in aff, or -1 */
+	int *abeg;										/* first touch of each touched row */
+	int *nrbeg;										/* space reserved for each touched row */
+	int *ebeg;										/* fills and then cancellations of each row */
+	int *nfill;
+	int *ncancel;
+	int tspace;
+	int *tpiv;										/* pivot of each touch */
+	int *tslot;										/* L entry of each touch */
+	int evspace;
+	int *ev;
+#if HAVE_EG_THREAD
+	/* threads 0 to nthreads-2 wait for the rounds, the calling thread works as
+	 * thread nthreads-1 */
+	pthread_mutex_t mt;
+	pthread_cond_t go;						/* signaled when a round starts */
+	pthread_cond_t done;					/* signaled when the last worker is done */
+	int round;
+	int pending;									/* workers still busy in this round */
+	int quit;
+#endif
+}
+par_info;
 
-	if (f->ucindx == 0)
+static void par_free (
+	par_info * par)
+{
+	int t;
+
+#if HAVE_EG_THREAD
+	if (par->nthreads > 1)
 	{
-		f->uc_space = nzcnt * f->uc_space_mul;
-		ILL_SAFE_MALLOC (f->ucindx, f->uc_space + 1, int);
+		pthread_mutex_lock (&par->mt);
+		par->quit = 1;
+		pthread_cond_broadcast (&par->go);
+		pthread_mutex_unlock (&par->mt);
+		for (t = 0; t < par->nthreads - 1; t++)
+			pthread_join (par->th[t].thread, 0);
+		pthread_cond_destroy (&par->done);
+		pthread_cond_destroy (&par->go);
+		pthread_mutex_destroy (&par->mt);
 	}
+#endif
+	if (par->th)
+	{
+		for (t = 0; t < par->nalloc; t++)
+		{
+			EGLPNUM_TYPENAME_EGlpNumFreeArray (par->th[t].coef);
+			ILL_IFFREE (par->th[t].mark);
+		}
+	}
+	ILL_IFFREE (par->th);
+	ILL_IFFREE (par->pr);
+	ILL_IFFREE (par->pc);
+	EGLPNUM_TYPENAME_EGlpNumFreeArray (par->pval);
+	ILL_IFFREE (par->rpiv);
+	ILL_IFFREE (par->cpiv);
+	ILL_IFFREE (par->aff);
+	ILL_IFFREE (par->apos);
+	ILL_IFFREE (par->abeg);
+	ILL_IFFREE (par->nrbeg);
+	ILL_IFFREE (par->ebeg);
+	ILL_IFFREE (par->nfill);
+	ILL_IFFREE (par->ncancel);
+	ILL_IFFREE (par->tpiv);
+	ILL_IFFREE (par->tslot);
+	ILL_IFFREE (par->ev);
+	par->nthreads = 0;
+	par->nalloc = 0;
+	par->tspace = 0;
+	par->evspace = 0;
+}
 
-	if (f->urindx == 0 || f->urcoef == 0)
-	{
-		ILL_IFFREE(f->urindx);
+#if HAVE_EG_THREAD
+static void *par_thread_main (
+	void *arg);
+#endif
 
-		EGLPNUM_TYPENAME_EGlpNumFreeArray (f->urcoef);
-		f->ur_space = nzcnt * f->ur_space_mul;
-		ILL_SAFE_MALLOC (f->urindx, f->ur_space + 1, int);
+static int par_init (
+	EGLPNUM_TYPENAME_factor_work * f,
+	par_info * par)
+{
+	int dim = f->dim;
+	int i;
+	int t;
+	int rval = 0;
 
-		f->urcoef = EGLPNUM_TYPENAME_EGlpNumAllocArray (f->ur_space);
-	}
+	par->f = f;
+	par->nthreads = 0;
+	par->nalloc = 0;
+	par->precision = EGLPNUM_PRECISION;
+	par->th = 0;
+	par->npiv = 0;
+	par->pr = par->pc = par->rpiv = par->cpiv = 0;
+	par->pval = 0;
+	par->naff = 0;
+	par->aff = par->apos = par->abeg = par->nrbeg = par->ebeg = 0;
+	par->nfill = par->ncancel = 0;
+	par->tspace = par->evspace = 0;
+	par->tpiv = par->tslot = par->ev = 0;
+	if (!HAVE_EG_THREAD || f->nthreads < 2 || dim < PAR_MIN_DIM)
+		return 0;
 
-	if (f->lcindx == 0 || f->lccoef == 0)
+	ILL_SAFE_MALLOC (par->th, f->nthreads, par_thread);
+	for (t = 0; t < f->nthreads; t++)
 	{
-		ILL_IFFREE(f->lcindx);
-
-		EGLPNUM_TYPENAME_EGlpNumFreeArray (f->lccoef);
-		f->lc_space = nzcnt * f->lc_space_mul;
-		ILL_SAFE_MALLOC (f->lcindx, f->lc_space, int);
-
-		f->lccoef = EGLPNUM_TYPENAME_EGlpNumAllocArray (f->lc_space);
+		par->th[t].par = par;
+		par->th[t].coef = 0;
+		par->th[t].mark = 0;
+		par->th[t].first = 0;
+		par->th[t].last = 0;
 	}
-
-	nzcnt = 0;
+	par->nalloc = f->nthreads;
+	for (t = 0; t < par->nalloc; t++)
+	{
+		par->th[t].coef = EGLPNUM_TYPENAME_EGlpNumAllocArray (dim);
+		ILL_SAFE_MALLOC (par->th[t].mark, dim, int);
+		for (i = 0; i < dim; i++)
+			par->th[t].mark[i] = 0;
+	}
+	ILL_SAFE_MALLOC (par->pr, PAR_MAX_PIVOTS, int);
+	ILL_SAFE_MALLOC (par->pc, PAR_MAX_PIVOTS, int);
+	par->pval = EGLPNUM_TYPENAME_EGlpNumAllocArray (PAR_MAX_PIVOTS);
+	ILL_SAFE_MALLOC (par->rpiv, dim, int);
+	ILL_SAFE_MALLOC (par->cpiv, dim, int);
+	ILL_SAFE_MALLOC (par->aff, dim, int);
+	ILL_SAFE_MALLOC (par->apos, dim, int);
+	ILL_SAFE_MALLOC (par->abeg, dim + 1, int);
+	ILL_SAFE_MALLOC (par->nrbeg, dim + 1, int);
+	ILL_SAFE_MALLOC (par->ebeg, dim, int);
+	ILL_SAFE_MALLOC (par->nfill, dim, int);
+	ILL_SAFE_MALLOC (par->ncancel, dim, int);
 	for (i = 0; i < dim; i++)
 	{
-		ur_inf[i].rbeg = nzcnt;
-		nzcnt += ur_inf[i].nzcnt;
-		ur_inf[i].nzcnt = ur_inf[i].rbeg;
+		par->rpiv[i] = -1;
+		par->cpiv[i] = -1;
+		par->apos[i] = -1;
 	}
-	f->ur_freebeg = nzcnt;
 
-	nzcnt = 0;
-	for (i = 0; i < dim; i++)
+#if HAVE_EG_THREAD
+	/* start the workers, with fewer threads if some can not be created */
+	pthread_mutex_init (&par->mt, 0);
+	pthread_cond_init (&par->go, 0);
+	pthread_cond_init (&par->done, 0);
+	par->round = 0;
+	par->pending = 0;
+	par->quit = 0;
+	for (t = 0; t < par->nalloc - 1; t++)
 	{
-		uc_inf[i].cbeg = nzcnt;
-		nzcnt += uc_inf[i].nzcnt;
-		uc_inf[i].nzcnt = uc_inf[i].cbeg;
+		par->th[t].round = 0;
+		if (pthread_create (&par->th[t].thread, 0, par_thread_main, par->th + t))
+			break;
 	}
-	f->uc_freebeg = nzcnt;
-
-	f->lc_freebeg = 0;
+	par->nthreads = t + 1;
+	if (par->nthreads == 1)
+	{
+		pthread_cond_destroy (&par->done);
+		pthread_cond_destroy (&par->go);
+		pthread_mutex_destroy (&par->mt);
+		par_free (par);
+	}
+#endif
 
-	rval = 0;
 CLEANUP:
+	if (rval)
+		par_free (par);
 	EG_RETURN (rval);
 }
 
-static int init_matrix (
+/* pick a set of compatible pivots among the columns of low count, with the
+ * same test as #find_pivot_column */
+static void par_select (
 	EGLPNUM_TYPENAME_factor_work * f,
-	int *basis,
-	int *cbeg,
-	int *clen,
-	int *in_ucindx,
-	EGLPNUM_TYPE * in_uccoef)
+	par_info * par)
 {
 	EGLPNUM_TYPENAME_uc_info *uc_inf = f->uc_inf;
 	EGLPNUM_TYPENAME_ur_info *ur_inf = f->ur_inf;
+	int *ucindx = f->ucindx;
+	int *urindx = f->urindx;
 	int dim = f->dim;
-	int max_k = f->max_k;
-	int *ucindx;
-	int *urindx;
-	EGLPNUM_TYPE *urcoef;
-	int nzcnt;
-	int beg;
-	int i;
-	int j;
+	int npiv = 0;
+	int mm = -1;
+	int m;
+	int k;
+	int c;
 	int r;
-	int rval = 0;
-	EGLPNUM_TYPE v;
-	EGLPNUM_TYPE max;
-
-	EGLPNUM_TYPENAME_EGlpNumInitVar (v);
-	EGLPNUM_TYPENAME_EGlpNumInitVar (max);
+	int i;
 
-	for (i = 0; i < dim; i++)
+	for (k = 2; k <= f->max_k && npiv < PAR_MAX_PIVOTS; k++)
 	{
-		ur_inf[i].nzcnt = 0;
-	}
-	for (i = 0; i < dim; i++)
-	{
-		nzcnt = clen[basis[i]];
-		beg = cbeg[basis[i]];
-		uc_inf[i].nzcnt = nzcnt;
-		for (j = 0; j < nzcnt; j++)
+		for (c = uc_inf[dim + k].next; c != dim + k && npiv < PAR_MAX_PIVOTS;
+				 c = uc_inf[c].next)
 		{
-			r = in_ucindx[beg + j];
-			ur_inf[r].nzcnt++;
+			for (i = 0; i < uc_inf[c].nzcnt; i++)
+			{
+				if (par->rpiv[ucindx[uc_inf[c].cbeg + i]] >= 0)
+					break;
+			}
+			if (i < uc_inf[c].nzcnt)
+				continue;
+			find_pivot_column (f, c, &r);
+			if (r < 0)
+			{
+				c = uc_inf[c].prev;
+				disable_col (f, uc_inf[c].next);
+				continue;
+			}
+			for (i = 0; i < ur_inf[r].nzcnt; i++)
+			{
+				if (par->cpiv[urindx[ur_inf[r].rbeg + i]] >= 0)
+					break;
+			}
+			if (i < ur_inf[r].nzcnt)
+				continue;
+			m = (uc_inf[c].nzcnt - 1) * (ur_inf[r].pivcnt - 1);
+			if (mm < 0)
+				mm = m;
+			else if (m > PAR_COST_MUL * (mm + 1))
+				continue;
+			par->pr[npiv] = r;
+			par->pc[npiv] = c;
+			par->rpiv[r] = npiv;
+			par->cpiv[c] = npiv;
+			npiv++;
 		}
 	}
+	par->npiv = npiv;
+}
 
-	rval = create_factor_space (f);
-	CHECKRVALG (rval, CLEANUP);
-
-	urindx = f->urindx;
-	ucindx = f->ucindx;
-	urcoef = f->urcoef;
+/* list the touched rows, and reserve their L entries and their row space */
+static int par_prepare (
+	EGLPNUM_TYPENAME_factor_work * f,
+	par_info * par)
+{
+	EGLPNUM_TYPENAME_uc_info *uc_inf = f->uc_inf;
+	EGLPNUM_TYPENAME_ur_info *ur_inf = f->ur_inf;
+	int *ucindx = f->ucindx;
+	int *aff = par->aff;
+	int *apos = par->apos;
+	int *abeg = par->abeg;
+	int npiv = par->npiv;
+	int naff = 0;
+	int ntouch = 0;
+	int space = 0;
+	int nev = 0;
+	int slot;
+	int cbeg;
+	int nzcnt;
+	int i;
+	int j;
+	int q;
+	int t;
+	int rval = 0;
 
-	for (i = 0; i < dim; i++)
+	for (i = 0; i < npiv; i++)
 	{
-		nzcnt = clen[basis[i]];
-		beg = cbeg[basis[i]];
-		for (j = 0; j < nzcnt; j++)
+		find_coef (f, par->pr[i], par->pc[i], &(par->pval[i]));
+		cbeg = uc_inf[par->pc[i]].cbeg;
+		nzcnt = uc_inf[par->pc[i]].nzcnt;
+		for (t = 0; t < nzcnt; t++)
 		{
-			EGLPNUM_TYPENAME_EGlpNumCopy (v, in_uccoef[beg + j]);
-			if (!(EGLPNUM_TYPENAME_EGlpNumIsNeqZero (v, f->fzero_tol)))
+			j = ucindx[cbeg + t];
+			if (j == par->pr[i])
 				continue;
-			r = in_ucindx[beg + j];
-			ucindx[uc_inf[i].nzcnt++] = r;
-			urindx[ur_inf[r].nzcnt] = i;
-			EGLPNUM_TYPENAME_EGlpNumCopy (urcoef[ur_inf[r].nzcnt], v);
-			ur_inf[r].nzcnt++;
+			if (apos[j] < 0)
+			{
+				apos[j] = naff;
+				aff[naff] = j;
+				abeg[naff] = 0;
+				naff++;
+			}
+			abeg[apos[j]]++;
 		}
+		ntouch += nzcnt - 1;
 	}
-
-	for (i = 0; i < dim; i++)
+	par->naff = naff;
+	for (q = 0, i = 0; i < naff; i++)
 	{
-		uc_inf[i].nzcnt -= uc_inf[i].cbeg;
-		ur_inf[i].nzcnt -= ur_inf[i].rbeg;
+		t = abeg[i];
+		abeg[i] = q;
+		par->nfill[i] = q;
+		q += t;
 	}
+	abeg[naff] = q;
 
-	j = f->uc_space;
-	for (i = f->uc_freebeg; i < j; i++)
+	if (ntouch > par->tspace)
 	{
-		ucindx[i] = -1;
+		ILL_IFFREE (par->tpiv);
+		ILL_IFFREE (par->tslot);
+		par->tspace = 0;
+		ILL_SAFE_MALLOC (par->tpiv, ntouch, int);
+		ILL_SAFE_MALLOC (par->tslot, ntouch, int);
+		par->tspace = ntouch;
 	}
-	ucindx[j] = 0;
-
-	j = f->ur_space;
-	for (i = f->ur_freebeg; i < j; i++)
+	if (f->lc_freebeg + ntouch >= f->lc_space)
 	{
-		urindx[i] = -1;
+		rval = make_lc_space (f, ntouch);
+		CHECKRVALG (rval, CLEANUP);
 	}
-	urindx[j] = 0;
-
-	for (i = 0; i < dim; i++)
+	slot = f->lc_freebeg;
+	for (i = 0; i < npiv; i++)
 	{
-		nzcnt = ur_inf[i].nzcnt;
-		ur_inf[i].pivcnt = nzcnt;
-		beg = ur_inf[i].rbeg;
-		EGLPNUM_TYPENAME_EGlpNumZero (max);
-		for (j = 0; j < nzcnt; j++)
+		cbeg = uc_inf[par->pc[i]].cbeg;
+		nzcnt = uc_inf[par->pc[i]].nzcnt;
+		for (t = 0; t < nzcnt; t++)
 		{
-			EGLPNUM_TYPENAME_EGlpNumSetToMaxAbs (max, urcoef[beg + j]);
+			j = ucindx[cbeg + t];
+			if (j == par->pr[i])
+				continue;
+			q = par->nfill[apos[j]]++;
+			par->tpiv[q] = i;
+			par->tslot[q] = slot;
+			f->lcindx[slot] = j;
+			slot++;
 		}
-		EGLPNUM_TYPENAME_EGlpNumCopy (ur_inf[i].max, max);
 	}
 
-	for (i = 0; i <= max_k; i++)
+	/* a touched row loses its entries in the pivot columns, and gains at most
+	 * the other entries of the pivot rows */
+	for (i = 0; i < naff; i++)
 	{
-		ur_inf[dim + i].next = dim + i;
-		ur_inf[dim + i].prev = dim + i;
-		uc_inf[dim + i].next = dim + i;
-		uc_inf[dim + i].prev = dim + i;
+		nzcnt = ur_inf[aff[i]].nzcnt;
+		par->nrbeg[i] = space;
+		par->ebeg[i] = nev;
+		for (q = abeg[i]; q < abeg[i + 1]; q++)
+			nzcnt += ur_inf[par->pr[par->tpiv[q]]].nzcnt - 2;
+		space += nzcnt;
+		nev += nzcnt + ur_inf[aff[i]].nzcnt;
 	}
-
-	for (i = 0; i < dim; i++)
+	par->nrbeg[naff] = space;
+	if (f->ur_freebeg + space >= f->ur_space)
 	{
-		nzcnt = uc_inf[i].nzcnt;
-		if (nzcnt >= max_k)
-			nzcnt = max_k;
-		uc_inf[i].next = uc_inf[dim + nzcnt].next;
-		uc_inf[i].prev = dim + nzcnt;
-		uc_inf[dim + nzcnt].next = i;
-		uc_inf[uc_inf[i].next].prev = i;
-
-		nzcnt = ur_inf[i].pivcnt;
-		if (nzcnt >= max_k)
-			nzcnt = max_k;
-		ur_inf[i].next = ur_inf[dim + nzcnt].next;
-		ur_inf[i].prev = dim + nzcnt;
-		ur_inf[dim + nzcnt].next = i;
-		ur_inf[ur_inf[i].next].prev = i;
+		rval = make_ur_space (f, space);
+		CHECKRVALG (rval, CLEANUP);
 	}
+	for (i = 0; i <= naff; i++)
+		par->nrbeg[i] += f->ur_freebeg;
+	f->ur_freebeg += space;
 
-#ifdef TRACK_FACTOR
-	EGLPNUM_TYPENAME_EGlpNumZero (max);
-	nzcnt = 0;
-	for (i = 0; i < dim; i++)
+	if (nev > par->evspace)
 	{
-		if (EGLPNUM_TYPENAME_EGlpNumIsLess (max, ur_inf[i].max))
-			EGLPNUM_TYPENAME_EGlpNumCopy (max, ur_inf[i].max);
-		nzcnt += ur_inf[i].nzcnt;
+		ILL_IFFREE (par->ev);
+		par->evspace = 0;
+		ILL_SAFE_MALLOC (par->ev, nev, int);
+		par->evspace = nev;
 	}
 
-	EGLPNUM_TYPENAME_EGlpNumCopy (f->maxelem_orig, max);
-	f->nzcnt_orig = nzcnt;
-	EGLPNUM_TYPENAME_EGlpNumCopy (f->maxelem_factor, f->maxelem_orig);
-	f->nzcnt_factor = f->nzcnt_orig;
-#endif /* TRACK_FACTOR */
-
-	/* sentinal for column space */
-	ucindx[f->uc_space] = 0;
-
-	clear_work (f);
-
 CLEANUP:
-	EGLPNUM_TYPENAME_EGlpNumClearVar (max);
-	EGLPNUM_TYPENAME_EGlpNumClearVar (v);
 	EG_RETURN (rval);
 }
 
-static int build_iteration_u_data (
-	EGLPNUM_TYPENAME_factor_work * f)
+/* compute the touched rows first to last-1 of a thread */
+static void par_work (
+	par_thread * th)
 {
-	int dim = f->dim;
+	par_info *par = th->par;
+	EGLPNUM_TYPENAME_factor_work *f = par->f;
 	EGLPNUM_TYPENAME_ur_info *ur_inf = f->ur_inf;
-	EGLPNUM_TYPENAME_uc_info *uc_inf = f->uc_inf;
-	EGLPNUM_TYPE *uccoef = 0;
-	int *ucindx = 0;
-	int *urindx = f->urindx;
 	EGLPNUM_TYPE *urcoef = f->urcoef;
-	int *ucrind = 0;
-	int *urcind = 0;
+	EGLPNUM_TYPE *lccoef = f->lccoef;
+	int *urindx = f->urindx;
+	EGLPNUM_TYPE *coef = th->coef;
+	int *mark = th->mark;
+	EGLPNUM_TYPE mult;
+	EGLPNUM_TYPE max;
+	int *fill;
+	int *cancel;
+	int nfill;
+	int ncancel;
+	int rbeg;
 	int nzcnt;
-	int beg;
-	int cbeg;
-	int cnzcnt;
-	int uc_space = f->uc_space;
-	int er_space;
+	int pivcnt;
+	int nbeg;
+	int nspace;
+	int prbeg;
+	int prnzcnt;
+	int prpivcnt;
+	int pass;
+	int n;
+	int a;
+	int q;
+	int t;
 	int i;
 	int j;
 	int k;
-	int rval;
+	int r;
+	int c;
 
-	nzcnt = 0;
-	for (i = 0; i < dim; i++)
-	{
-		nzcnt += ur_inf[i].nzcnt;
-	}
+	EGLPNUM_TYPENAME_EGlpNumInitVar (mult);
+	EGLPNUM_TYPENAME_EGlpNumInitVar (max);
 
-#ifdef TRACK_FACTOR
-	f->nzcnt_factor = nzcnt;
-#endif /* TRACK_FACTOR */
-
-	EGLPNUM_TYPENAME_EGlpNumFreeArray (f->uccoef);
-	uccoef = EGLPNUM_TYPENAME_EGlpNumAllocArray (nzcnt);
-	f->uccoef = uccoef;
+	for (a = th->first; a < th->last; a++)
+	{
+		j = par->aff[a];
+		rbeg = ur_inf[j].rbeg;
+		nzcnt = ur_inf[j].nzcnt;
+		pivcnt = ur_inf[j].pivcnt;
+		nbeg = par->nrbeg[a];
+		nspace = par->nrbeg[a + 1] - nbeg;
+		fill = par->ev + par->ebeg[a];
+		cancel = fill + nspace;
+		nfill = 0;
+		ncancel = 0;
+
+		for (t = 0; t < nzcnt; t++)
+		{
+			k = urindx[rbeg + t];
+			EGLPNUM_TYPENAME_EGlpNumCopy (coef[k], urcoef[rbeg + t]);
+			mark[k] = t < pivcnt ? PAR_ACTIVE : PAR_OTHER;
+		}
+		for (q = par->abeg[a]; q < par->abeg[a + 1]; q++)
+		{
+			i = par->tpiv[q];
+			r = par->pr[i];
+			c = par->pc[i];
+			EGLPNUM_TYPENAME_EGlpNumCopy (mult, coef[c]);
+			EGLPNUM_TYPENAME_EGlpNumDivTo (mult, par->pval[i]);
+			EGLPNUM_TYPENAME_EGlpNumCopy (lccoef[par->tslot[q]], mult);
+			mark[c] = 0;
+			prbeg = ur_inf[r].rbeg;
+			prnzcnt = ur_inf[r].nzcnt;
+			prpivcnt = ur_inf[r].pivcnt;
+			for (t = 0; t < prnzcnt; t++)
+			{
+				k = urindx[prbeg + t];
+				if (k == c)
+					continue;
+				if (mark[k])
+				{
+					EGLPNUM_TYPENAME_EGlpNumSubInnProdTo (coef[k], mult, urcoef[prbeg + t]);
+					mark[k] |= PAR_TOUCHED;
+				}
+				else
+				{
+					EGLPNUM_TYPENAME_EGlpNumCopyNeg (coef[k], mult);
+					EGLPNUM_TYPENAME_EGlpNumMultTo (coef[k], urcoef[prbeg + t]);
+					mark[k] = (t < prpivcnt ? PAR_ACTIVE : PAR_OTHER) | PAR_FILL;
+					fill[nfill++] = k;
+				}
+			}
+		}
 
-	ILL_IFFREE(f->ucrind);
-	ILL_SAFE_MALLOC (ucrind, nzcnt, int);
+		/* write the new row, the active entries first, dropping the ones that
+		 * cancelled */
+		EGLPNUM_TYPENAME_EGlpNumZero (max);
+		n = 0;
+		pivcnt = 0;
+		for (pass = PAR_ACTIVE; pass <= PAR_OTHER; pass++)
+		{
+			for (t = 0; t < nzcnt; t++)
+			{
+				k = urindx[rbeg + t];
+				if ((mark[k] & (PAR_ACTIVE | PAR_OTHER)) != pass)
+					continue;
+				if ((mark[k] & PAR_TOUCHED) &&
+						!(EGLPNUM_TYPENAME_EGlpNumIsNeqZero (coef[k], f->fzero_tol)))
+				{
+					cancel[ncancel++] = k;
+					continue;
+				}
+				urindx[nbeg + n] = k;
+				EGLPNUM_TYPENAME_EGlpNumCopy (urcoef[nbeg + n], coef[k]);
+				if (pass == PAR_ACTIVE)
+					EGLPNUM_TYPENAME_EGlpNumSetToMaxAbs (max, coef[k]);
+				n++;
+			}
+			for (t = 0; t < nfill; t++)
+			{
+				k = fill[t];
+				if ((mark[k] & (PAR_ACTIVE | PAR_OTHER)) != pass)
+					continue;
+				if (!(EGLPNUM_TYPENAME_EGlpNumIsNeqZero (coef[k], f->fzero_tol)))
+				{
+					mark[k] = 0;
+					continue;
+				}
+				urindx[nbeg + n] = k;
+				EGLPNUM_TYPENAME_EGlpNumCopy (urcoef[nbeg + n], coef[k]);
+				if (pass == PAR_ACTIVE)
+					EGLPNUM_TYPENAME_EGlpNumSetToMaxAbs (max, coef[k]);
+				n++;
+			}
+			if (pass == PAR_ACTIVE)
+				pivcnt = n;
+		}
+		for (q = 0, t = 0; t < nfill; t++)
+		{
+			k = fill[t];
+			if (mark[k])
+				fill[q++] = k;
+			mark[k] = 0;
+		}
+		nfill = q;
+		for (t = 0; t < nzcnt; t++)
+		{
+			mark[urindx[rbeg + t]] = 0;
+			urindx[rbeg + t] = -1;
+		}
+		for (t = n; t < nspace; t++)
+			urindx[nbeg + t] = -1;
 
-	f->ucrind = ucrind;
+		ur_inf[j].rbeg = nbeg;
+		ur_inf[j].nzcnt = n;
+		ur_inf[j].pivcnt = pivcnt;
+		EGLPNUM_TYPENAME_EGlpNumCopy (ur_inf[j].max, max);
+		par->nfill[a] = nfill;
+		par->ncancel[a] = ncancel;
+	}
 
-	ILL_IFFREE(f->urcind);
-	ILL_SAFE_MALLOC (urcind, f->ur_space, int);
+	EGLPNUM_TYPENAME_EGlpNumClearVar (max);
+	EGLPNUM_TYPENAME_EGlpNumClearVar (mult);
+}
 
-	f->urcind = urcind;
+#if HAVE_EG_THREAD
+static void *par_thread_main (
+	void *arg)
+{
+	par_thread *th = (par_thread *) arg;
+	par_info *par = th->par;
 
-	if (uc_space < nzcnt)
+	EGlpNumThreadStart (par->precision);
+	pthread_mutex_lock (&par->mt);
+	for (;;)
 	{
-		ILL_IFFREE(f->ucindx);
-		ILL_SAFE_MALLOC (f->ucindx, nzcnt + 1, int);
-	}
-	f->uc_space = nzcnt;
-	uc_space = nzcnt;
-	ucindx = f->ucindx;
+		while (th->round == par->round && !par->quit)
+			pthread_cond_wait (&par->go, &par->mt);
+		if (par->quit)
+			break;
+		th->round = par->round;
+		pthread_mutex_unlock (&par->mt);
+		par_work (th);
+		pthread_mutex_lock (&par->mt);
+		if (--par->pending == 0)
+			pthread_cond_signal (&par->done);
+	}
+	pthread_mutex_unlock (&par->mt);
+	EGlpNumThreadClear ();
+	return 0;
+}
+#endif
 
-	for (i = 0; i < dim; i++)
-	{
-		uc_inf[i].nzcnt = 0;
-	}
+/* split the touched rows among the threads, the calling thread works on the
+ * first range; return one if other threads took part */
+static int par_run (
+	par_info * par)
+{
+	par_thread *th = par->th;
+	int nthreads = par->nthreads;
+	int nrun = nthreads;
+	int t;
 
-	for (i = 0; i < dim; i++)
+	if (nrun > 1 + par->naff / PAR_MIN_ROWS)
+		nrun = 1 + par->naff / PAR_MIN_ROWS;
+	for (t = 0; t < nthreads; t++)
 	{
-		nzcnt = ur_inf[i].nzcnt;
-		beg = ur_inf[i].rbeg;
-		for (j = 0; j < nzcnt; j++)
+		th[nthreads - 1 - t].first = 0;
+		th[nthreads - 1 - t].last = 0;
+		if (t < nrun)
 		{
-			uc_inf[urindx[beg + j]].nzcnt++;
+			th[nthreads - 1 - t].first = (int) (((long long) par->naff * t) / nrun);
+			th[nthreads - 1 - t].last =
+				(int) (((long long) par->naff * (t + 1)) / nrun);
 		}
-		ur_inf[i].delay = 0;
 	}
-
-	nzcnt = 0;
-	for (i = 0; i < dim; i++)
+#if HAVE_EG_THREAD
+	if (nrun > 1)
 	{
-		uc_inf[i].cbeg = nzcnt;
-		nzcnt += uc_inf[i].nzcnt;
-		uc_inf[i].nzcnt = 0;
-		uc_inf[i].delay = 0;
+		pthread_mutex_lock (&par->mt);
+		par->pending = nthreads - 1;
+		par->round++;
+		pthread_cond_broadcast (&par->go);
+		pthread_mutex_unlock (&par->mt);
 	}
-
-	f->uc_freebeg = nzcnt;
-	for (i = nzcnt; i < uc_space; i++)
+	par_work (th + nthreads - 1);
+	if (nrun > 1)
 	{
-		ucindx[i] = -1;
+		pthread_mutex_lock (&par->mt);
+		while (par->pending)
+			pthread_cond_wait (&par->done, &par->mt);
+		pthread_mutex_unlock (&par->mt);
 	}
-	ucindx[uc_space] = 0;
+	return nrun > 1;
+#else
+	for (t = 0; t < nthreads; t++)
+		par_work (th + t);
+	return 0;
+#endif
+}
 
-	for (i = 0; i < dim; i++)
+/* bring the column lists, the count lists, the L data and the permutations
+ * up to date, as #elim does for one pivot */
+static int par_commit (
+	EGLPNUM_TYPENAME_factor_work * f,
+	par_info * par)
+{
+	EGLPNUM_TYPENAME_uc_info *uc_inf = f->uc_inf;
+	EGLPNUM_TYPENAME_ur_info *ur_inf = f->ur_inf;
+	EGLPNUM_TYPENAME_lc_info *lc_inf = f->lc_inf;
+	int *urindx;
+	EGLPNUM_TYPE *urcoef;
+	EGLPNUM_TYPE pivot_coef;
+	int *fill;
+	int *cancel;
+	int slot = f->lc_freebeg;
+	int nzcnt;
+	int s;
+	int a;
+	int i;
+	int j;
+	int r;
+	int c;
+	int t;
+	int rval = 0;
+
+	EGLPNUM_TYPENAME_EGlpNumInitVar (pivot_coef);
+
+	for (a = 0; a < par->naff; a++)
 	{
-		nzcnt = ur_inf[i].nzcnt;
-		beg = ur_inf[i].rbeg;
-		k = urindx[beg];
-		cbeg = uc_inf[k].cbeg;
-		cnzcnt = uc_inf[k].nzcnt;
-		if (cnzcnt != 0)
-		{
-			ucindx[cbeg + cnzcnt] = ucindx[cbeg];
-			EGLPNUM_TYPENAME_EGlpNumCopy (uccoef[cbeg + cnzcnt], uccoef[cbeg]);
-			ucrind[cbeg + cnzcnt] = ucrind[cbeg];
-			urcind[ur_inf[ucindx[cbeg]].rbeg + ucrind[cbeg]] = cnzcnt;
-		}
-		ucindx[cbeg] = i;
-		EGLPNUM_TYPENAME_EGlpNumCopy (uccoef[cbeg], urcoef[beg]);
-		ucrind[cbeg] = 0;
-		urcind[beg] = 0;
-		uc_inf[k].nzcnt = cnzcnt + 1;
-		for (j = 1; j < nzcnt; j++)
+		j = par->aff[a];
+		fill = par->ev + par->ebeg[a];
+		cancel = fill + (par->nrbeg[a + 1] - par->nrbeg[a]);
+		for (t = 0; t < par->ncancel[a]; t++)
+			remove_col_nz (f, j, cancel[t]);
+		for (t = 0; t < par->nfill[a]; t++)
 		{
-			k = urindx[beg + j];
-			cbeg = uc_inf[k].cbeg;
-			cnzcnt = uc_inf[k].nzcnt;
-			ucindx[cbeg + cnzcnt] = i;
-			EGLPNUM_TYPENAME_EGlpNumCopy (uccoef[cbeg + cnzcnt], urcoef[beg + j]);
-			ucrind[cbeg + cnzcnt] = j;
-			urcind[beg + j] = cnzcnt;
-			uc_inf[k].nzcnt++;
+			rval = add_col_nz (f, j, fill[t]);
+			CHECKRVALG (rval, CLEANUP);
 		}
+		set_row_nz (f, j);
+		par->apos[j] = -1;
+#ifdef TRACK_FACTOR
+		if (EGLPNUM_TYPENAME_EGlpNumIsLess (f->maxelem_factor, ur_inf[j].max))
+			EGLPNUM_TYPENAME_EGlpNumCopy (f->maxelem_factor, ur_inf[j].max);
+#endif /* TRACK_FACTOR */
 	}
 
-	for (i = 0; i < dim; i++)
+	for (i = 0; i < par->npiv; i++)
 	{
-		f->rrank[f->rperm[i]] = i;
+		r = par->pr[i];
+		c = par->pc[i];
+		s = f->stage;
+		SETPERM (f, s, r, c);
+		f->stage++;
+
+		lc_inf[s].cbeg = slot;
+		lc_inf[s].c = r;
+		lc_inf[s].nzcnt = uc_inf[c].nzcnt - 1;
+		slot += lc_inf[s].nzcnt;
+#ifdef TRACK_FACTOR
+		for (t = lc_inf[s].cbeg; t < slot; t++)
+			EGLPNUM_TYPENAME_EGlpNumSetToMaxAbs (f->maxelem_factor, f->lccoef[t]);
+#endif /* TRACK_FACTOR */
+
+		urindx = f->urindx + ur_inf[r].rbeg;
+		urcoef = f->urcoef + ur_inf[r].rbeg;
+		nzcnt = ur_inf[r].nzcnt;
+		for (t = 0; t < nzcnt; t++)
+		{
+			j = urindx[t];
+			remove_col_nz (f, r, j);
+			if (j == c)
+			{
+				urindx[t] = urindx[0];
+				urindx[0] = c;
+				EGLPNUM_TYPENAME_EGLPNUM_SWAP (urcoef[0], urcoef[t], pivot_coef);
+			}
+		}
+		remove_row (f, r);
+		remove_col (f, c);
+		par->rpiv[r] = -1;
+		par->cpiv[c] = -1;
 	}
+	f->lc_freebeg = slot;
+	par->npiv = 0;
+	par->naff = 0;
 
-	nzcnt = f->ur_space;
+CLEANUP:
+	EGLPNUM_TYPENAME_EGlpNumClearVar (pivot_coef);
+	EG_RETURN (rval);
+}
 
-	for (i = f->ur_freebeg; i < nzcnt; i++)
+/* eliminate the pivots in par->pr and par->pc */
+static int par_eliminate (
+	EGLPNUM_TYPENAME_factor_work * f,
+	par_info * par)
+{
+	int rval = 0;
+
+#ifdef FACTOR_DEBUG
+	MESSAGE (0, "parallel stage %d: %d pivots", f->stage, par->npiv);
+#endif /* FACTOR_DEBUG */
+	rval = par_prepare (f, par);
+	CHECKRVALG (rval, CLEANUP);
+	if (par_run (par))
+		f->par_rounds++;
+	rval = par_commit (f, par);
+	CHECKRVALG (rval, CLEANUP);
+
+CLEANUP:
+	EG_RETURN (rval);
+}
+
+/* eliminate a set of compatible pivots, and return one in *p_done if the set
+ * was large enough to be worth it */
+static int par_elim_set (
+	EGLPNUM_TYPENAME_factor_work * f,
+	par_info * par,
+	int *p_done)
+{
+	int i;
+	int rval = 0;
+
+	*p_done = 0;
+	if (f->nstages - f->stage < PAR_MIN_DIM)
+		return 0;
+	par_select (f, par);
+	if (par->npiv < PAR_MIN_PIVOTS)
 	{
-		urindx[i] = -1;
+		for (i = 0; i < par->npiv; i++)
+		{
+			par->rpiv[par->pr[i]] = -1;
+			par->cpiv[par->pc[i]] = -1;
+		}
+		par->npiv = 0;
+		return 0;
 	}
-	urindx[nzcnt] = 0;
-
-	clear_work (f);
+	rval = par_eliminate (f, par);
+	CHECKRVALG (rval, CLEANUP);
+	*p_done = 1;
 
-	er_space = f->er_space_mul * f->etamax;
-	ILL_SAFE_MALLOC (f->er_inf, f->etamax, EGLPNUM_TYPENAME_er_info);
-	ILL_SAFE_MALLOC (f->erindx, er_space, int);
+CLEANUP:
+	EG_RETURN (rval);
+}
 
-	f->ercoef = EGLPNUM_TYPENAME_EGlpNumAllocArray (er_space);
-	f->etacnt = 0;
-	f->er_freebeg = 0;
-	f->er_space = er_space;
+/* eliminate the pivot (r,c) in parallel if it updates enough entries, and
+ * return one in *p_done if so */
+static int par_elim_one (
+	EGLPNUM_TYPENAME_factor_work * f,
+	par_info * par,
+	int r,
+	int c,
+	int *p_done)
+{
+	EGLPNUM_TYPENAME_uc_info *uc_inf = f->uc_inf;
+	EGLPNUM_TYPENAME_ur_info *ur_inf = f->ur_inf;
+	int *ucindx = f->ucindx + uc_inf[c].cbeg;
+	int nzcnt = uc_inf[c].nzcnt;
+	long work = (long) (nzcnt - 1) * ur_inf[r].nzcnt;
+	int i;
+	int rval = 0;
 
-	rval = 0;
+	*p_done = 0;
+	if (nzcnt <= PAR_MIN_ROWS || ur_inf[r].nzcnt == 1)
+		return 0;
+	for (i = 0; i < nzcnt && work < PAR_MIN_WORK; i++)
+		work += ur_inf[ucindx[i]].nzcnt;
+	if (work < PAR_MIN_WORK)
+		return 0;
+	par->pr[0] = r;
+	par->pc[0] = c;
+	par->rpiv[r] = 0;
+	par->cpiv[c] = 0;
+	par->npiv = 1;
+	rval = par_eliminate (f, par);
+	CHECKRVALG (rval, CLEANUP);
+	*p_done = 1;
 
 CLEANUP:
 	EG_RETURN (rval);
 }
 
-static int build_iteration_l_data (
+static int create_factor_space (
 	EGLPNUM_TYPENAME_factor_work * f)
 {
+	EGLPNUM_TYPENAME_uc_info *uc_inf = f->uc_inf;
+	EGLPNUM_TYPENAME_ur_info *ur_inf = f->ur_inf;
 	int dim = f->dim;
-	EGLPNUM_TYPENAME_lc_info *lc_inf = f->lc_inf;
-	EGLPNUM_TYPENAME_lr_info *lr_inf = f->lr_inf;
-	EGLPNUM_TYPE *lrcoef = 0;
-	int *lrindx = 0;
-	EGLPNUM_TYPE *lccoef = f->lccoef;
-	int *lcindx = f->lcindx;
 	int nzcnt;
-	int beg;
-	int rnzcnt;
-	int rbeg;
 	int i;
-	int j;
-	int k;
-	int c;
 	int rval;
 
 	nzcnt = 0;
 	for (i = 0; i < dim; i++)
 	{
-		nzcnt += lc_inf[i].nzcnt;
-		lr_inf[i].nzcnt = 0;
-		lr_inf[i].delay = 0;
-		lc_inf[lc_inf[i].c].crank = i;
+		nzcnt += ur_inf[i].nzcnt;
 	}
 
-	EGLPNUM_TYPENAME_EGlpNumFreeArray (f->lrcoef);
-	if (nzcnt)
+	if (f->ucindx == 0)
 	{
-		lrcoef = EGLPNUM_TYPENAME_EGlpNumAllocArray (nzcnt);
-		f->lrcoef = lrcoef;
+		f->uc_space = nzcnt * f->uc_space_mul;
+		ILL_SAFE_MALLOC (f->ucindx, f->uc_space + 1, int);
 	}
 
-	ILL_IFFREE(f->lrindx);
-	ILL_SAFE_MALLOC (lrindx, nzcnt + 1, int);
+	if (f->urindx == 0 || f->urcoef == 0)
+	{
+		ILL_IFFREE(f->urindx);
 
-	f->lrindx = lrindx;
+		EGLPNUM_TYPENAME_EGlpNumFreeArray (f->urcoef);
+		f->ur_space = nzcnt * f->ur_space_mul;
+		ILL_SAFE_MALLOC (f->urindx, f->ur_space + 1, int);
 
-	for (i = 0; i < dim; i++)
-	{
-		nzcnt = lc_inf[i].nzcnt;
-		beg = lc_inf[i].cbeg;
-		lc_inf[i].delay = 0;
-		for (j = 0; j < nzcnt; j++)
-		{
-			lr_inf[lc_inf[lcindx[beg + j]].crank].nzcnt++;
-		}
+		f->urcoef = EGLPNUM_TYPENAME_EGlpNumAllocArray (f->ur_space);
 	}
 
-	nzcnt = 0;
-	for (i = 0; i < dim; i++)
+	if (f->lcindx == 0 || f->lccoef == 0)
 	{
-		lr_inf[i].rbeg = nzcnt;
-		nzcnt += lr_inf[i].nzcnt;
-		lr_inf[i].nzcnt = 0;
-		lr_inf[i].r = lc_inf[i].c;
-		lr_inf[lr_inf[i].r].rrank = i;
+		ILL_IFFREE(f->lcindx);
+
+		EGLPNUM_TYPENAME_EGlpNumFreeArray (f->lccoef);
+		f->lc_space = nzcnt * f->lc_space_mul;
+		ILL_SAFE_MALLOC (f->lcindx, f->lc_space, int);
+
+		f->lccoef = EGLPNUM_TYPENAME_EGlpNumAllocArray (f->lc_space);
 	}
 
+	nzcnt = 0;
 	for (i = 0; i < dim; i++)
 	{
-		nzcnt = lc_inf[i].nzcnt;
-		beg = lc_inf[i].cbeg;
-		c = lc_inf[i].c;
-		for (j = 0; j < nzcnt; j++)
-		{
-			k = lc_inf[lcindx[beg + j]].crank;
-			rbeg = lr_inf[k].rbeg;
-			rnzcnt = lr_inf[k].nzcnt;
-			lrindx[rbeg + rnzcnt] = c;
-			EGLPNUM_TYPENAME_EGlpNumCopy (lrcoef[rbeg + rnzcnt], lccoef[beg + j]);
-			lr_inf[k].nzcnt++;
-		}
+		ur_inf[i].rbeg = nzcnt;
+		nzcnt += ur_inf[i].nzcnt;
+		ur_inf[i].nzcnt = ur_inf[i].rbeg;
 	}
+	f->ur_freebeg = nzcnt;
 
-#ifdef TRACK_FACTOR
-	nzcnt = f->nzcnt_factor;
+	nzcnt = 0;
 	for (i = 0; i < dim; i++)
 	{
-		nzcnt += lc_inf[i].nzcnt;
+		uc_inf[i].cbeg = nzcnt;
+		nzcnt += uc_inf[i].nzcnt;
+		uc_inf[i].nzcnt = uc_inf[i].cbeg;
 	}
-	f->nzcnt_factor = nzcnt;
-
-	EGLPNUM_TYPENAME_EGlpNumCopy (f->maxelem_cur, f->maxelem_factor);
-	f->nzcnt_cur = f->nzcnt_factor;
+	f->uc_freebeg = nzcnt;
 
-/*
-    dump_factor_stats (f);
-    QSlog("orig max  %e nzcnt %d", f->maxelem_orig, f->nzcnt_orig);
-    QSlog("f maxelem %e nzcnt %d", f->maxelem_cur, f->nzcnt_cur);
-*/
-#endif /* TRACK_FACTOR */
+	f->lc_freebeg = 0;
 
 	rval = 0;
-
-CLEANUP:
-	EG_RETURN (rval);
-}
-
-static int handle_singularity (
-	EGLPNUM_TYPENAME_factor_work * f)
-{
-	int rval = 0;
-	int nsing;
-	int *singr = 0;
-	int *singc = 0;
-	int i;
-
-	if (f->p_nsing == 0 || f->p_singr == 0 || f->p_singc == 0)
-	{
-		QSlog("singular basis, but no place for singularity data");
-		return E_SING_NO_DATA;
-	}
-
-	nsing = f->nstages - f->stage;
-	ILL_SAFE_MALLOC (singr, nsing, int);
-	ILL_SAFE_MALLOC (singc, nsing, int);
-
-	for (i = f->stage; i < f->nstages; i++)
-	{
-		singr[i - f->stage] = f->rperm[i];
-		singc[i - f->stage] = f->cperm[i];
-	}
-	*f->p_nsing = nsing;
-	*f->p_singr = singr;
-	*f->p_singc = singc;
-	singr = 0;
-	singc = 0;
-
 CLEANUP:
-	ILL_IFFREE(singr);
-	ILL_IFFREE(singc);
-
 	EG_RETURN (rval);
 }
 
-static int dense_build_matrix (
-	EGLPNUM_TYPENAME_factor_work * f)
+static int init_matrix (
+	EGLPNUM_TYPENAME_factor_work * f,
+	int *basis,
+	int *cbeg,
+	int *clen,
+	int *in_ucindx,
+	EGLPNUM_TYPE * in_uccoef)
 {
-	EGLPNUM_TYPE *dmat = 0;
-	int stage = f->stage;
-	int drows = f->nstages - stage;
-	int dcols = f->dim - stage;
-	int dsize = drows * dcols;
-	int *crank = f->crank;
-	EGLPNUM_TYPE *urcoef = f->urcoef;
-	int *urindx = f->urindx;
+	EGLPNUM_TYPENAME_uc_info *uc_inf = f->uc_inf;
+	EGLPNUM_TYPENAME_ur_info *ur_inf = f->ur_inf;
+	int dim = f->dim;
+	int max_k = f->max_k;
+	int *ucindx;
+	int *urindx;
+	EGLPNUM_TYPE *urcoef;
 	int nzcnt;
 	int beg;
 	int i;
-	int r;
 	int j;
+	int r;
 	int rval = 0;
+	EGLPNUM_TYPE v;
+	EGLPNUM_TYPE max;
 
-	dmat = EGLPNUM_TYPENAME_EGlpNumAllocArray (dsize);
-
-	for (i = 0; i < dsize; i++)
-		EGLPNUM_TYPENAME_EGlpNumZero (dmat[i]);
+	EGLPNUM_TYPENAME_EGlpNumInitVar (v);
+	EGLPNUM_TYPENAME_EGlpNumInitVar (max);
 
-	for (i = 0; i < drows; i++)
+	for (i = 0; i < dim; i++)
 	{
-		r = f->rperm[i + stage];
-		nzcnt = f->ur_inf[r].nzcnt;
-		beg = f->ur_inf[r].rbeg;
+		ur_inf[i].nzcnt = 0;
+	}
+	for (i = 0; i < dim; i++)
+	{
+		nzcnt = clen[basis[i]];
+		beg = cbeg[basis[i]];
+		uc_inf[i].nzcnt = nzcnt;
 		for (j = 0; j < nzcnt; j++)
 		{
-			EGLPNUM_TYPENAME_EGlpNumCopy (dmat[i * dcols - stage + crank[urindx[beg + j]]],
-									 urcoef[beg + j]);
+			r = in_ucindx[beg + j];
+			ur_inf[r].nzcnt++;
 		}
 	}
 
-	f->drows = drows;
-	f->dcols = dcols;
-	f->dense_base = f->stage;
-	f->dmat = dmat;
-	dmat = 0;
-
-//CLEANUP:
-	EGLPNUM_TYPENAME_EGlpNumFreeArray (dmat);
-	EG_RETURN (rval);
-}
+	rval = create_factor_space (f);
+	CHECKRVALG (rval, CLEANUP);
 
-static int dense_find_pivot (
-	EGLPNUM_TYPENAME_factor_work * f,
-	int *p_r,
-	int *p_c)
-{
-	int dcols = f->dcols;
-	int drows = f->drows;
-	EGLPNUM_TYPE *dmat = f->dmat;
-	int dense_base = f->dense_base;
-	int s = f->stage - dense_base;
-	EGLPNUM_TYPENAME_ur_info *ur_inf = f->ur_inf;
-	int *rperm = f->rperm;
-	EGLPNUM_TYPE maxval;
-	int max_r;
-	int max_c;
-	int i;
+	urindx = f->urindx;
+	ucindx = f->ucindx;
+	urcoef = f->urcoef;
 
-	EGLPNUM_TYPENAME_EGlpNumInitVar (maxval);
-	EGLPNUM_TYPENAME_EGlpNumZero (maxval);
-	max_r = -1;
-	for (i = s; i < drows; i++)
+	for (i = 0; i < dim; i++)
 	{
-		if (EGLPNUM_TYPENAME_EGlpNumIsLess (maxval, ur_inf[rperm[dense_base + i]].max))
+		nzcnt = clen[basis[i]];
+		beg = cbeg[basis[i]];
+		for (j = 0; j < nzcnt; j++)
 		{
-			EGLPNUM_TYPENAME_EGlpNumCopy (maxval, ur_inf[rperm[dense_base + i]].max);
-			max_r = i;
+			EGLPNUM_TYPENAME_EGlpNumCopy (v, in_uccoef[beg + j]);
+			if (!(EGLPNUM_TYPENAME_EGlpNumIsNeqZero (v, f->fzero_tol)))
+				continue;
+			r = in_ucindx[beg + j];
+			ucindx[uc_inf[i].nzcnt++] = r;
+			urindx[ur_inf[r].nzcnt] = i;
+			EGLPNUM_TYPENAME_EGlpNumCopy (urcoef[ur_inf[r].nzcnt], v);
+			ur_inf[r].nzcnt++;
 		}
 	}
-	if (max_r == -1)
+
+	for (i = 0; i < dim; i++)
 	{
-		return E_NO_PIVOT;
+		uc_inf[i].nzcnt -= uc_inf[i].cbeg;
+		ur_inf[i].nzcnt -= ur_inf[i].rbeg;
 	}
 
-	EGLPNUM_TYPENAME_EGlpNumZero (maxval);
-	max_c = -1;
-	for (i = s; i < drows; i++)
+	j = f->uc_space;
+	for (i = f->uc_freebeg; i < j; i++)
 	{
-		EGlpNumSetToMaxAbsAndDo (maxval, dmat[max_r * dcols + i], max_c = i);
+		ucindx[i] = -1;
 	}
-	if (max_c == -1)
+	ucindx[j] = 0;
+
+	j = f->ur_space;
+	for (i = f->ur_freebeg; i < j; i++)
 	{
-		return E_NO_PIVOT;
+		urindx[i] = -1;
 	}
-	*p_r = max_r;
-	*p_c = max_c;
-
-	EGLPNUM_TYPENAME_EGlpNumClearVar (maxval);
-	return 0;
-}
-
-static void dense_swap (
-	EGLPNUM_TYPENAME_factor_work * f,
-	int r,
-	int c)
-{
-	int dcols = f->dcols;
-	int drows = f->drows;
-	EGLPNUM_TYPE *dmat = f->dmat;
-	int dense_base = f->dense_base;
-	int s = f->stage - dense_base;
-	int i;
-	EGLPNUM_TYPE v;
-
-	EGLPNUM_TYPENAME_EGlpNumInitVar (v);
+	urindx[j] = 0;
 
-	if (r != s)
+	for (i = 0; i < dim; i++)
 	{
-		ILL_SWAP (f->rperm[dense_base + s], f->rperm[dense_base + r], i);
-		f->rrank[f->rperm[dense_base + s]] = dense_base + s;
-		f->rrank[f->rperm[dense_base + r]] = dense_base + r;
-		for (i = 0; i < dcols; i++)
+		nzcnt = ur_inf[i].nzcnt;
+		ur_inf[i].pivcnt = nzcnt;
+		beg = ur_inf[i].rbeg;
+		EGLPNUM_TYPENAME_EGlpNumZero (max);
+		for (j = 0; j < nzcnt; j++)
 		{
-			EGLPNUM_TYPENAME_EGLPNUM_SWAP (dmat[s * dcols + i], dmat[r * dcols + i], v);
+			EGLPNUM_TYPENAME_EGlpNumSetToMaxAbs (max, urcoef[beg + j]);
 		}
+		EGLPNUM_TYPENAME_EGlpNumCopy (ur_inf[i].max, max);
 	}
-	if (c != s)
+
+	for (i = 0; i <= max_k; i++)
 	{
-		ILL_SWAP (f->cperm[dense_base + s], f->cperm[dense_base + c], i);
-		f->crank[f->cperm[dense_base + s]] = dense_base + s;
-		f->crank[f->cperm[dense_base + c]] = dense_base + c;
-		for (i = 0; i < drows; i++)
-		{
-			EGLPNUM_TYPENAME_EGLPNUM_SWAP (dmat[i * dcols + s], dmat[i * dcols + c], v);
-		}
+		ur_inf[dim + i].next = dim + i;
+		ur_inf[dim + i].prev = dim + i;
+		uc_inf[dim + i].next = dim + i;
+		uc_inf[dim + i].prev = dim + i;
 	}
-	EGLPNUM_TYPENAME_EGlpNumClearVar (v);
-}
-
-static void dense_elim (
-	EGLPNUM_TYPENAME_factor_work * f,
-	int r,
-	int c)
-{
-	int dcols = f->dcols;
-	int drows = f->drows;
-	EGLPNUM_TYPE *dmat = f->dmat;
-	int dense_base = f->dense_base;
-	int s = f->stage - dense_base;
-	EGLPNUM_TYPENAME_ur_info *ur_inf = f->ur_inf;
-	int *rperm = f->rperm;
-	int i;
-	int j;
-	EGLPNUM_TYPE pivval;
-	EGLPNUM_TYPE max;
-	EGLPNUM_TYPE v;
-	EGLPNUM_TYPE w;
 
-#ifdef TRACK_FACTOR
-	EGLPNUM_TYPE maxelem_factor;
+	for (i = 0; i < dim; i++)
+	{
+		nzcnt = uc_inf[i].nzcnt;
+		if (nzcnt >= max_k)
+			nzcnt = max_k;
+		uc_inf[i].next = uc_inf[dim + nzcnt].next;
+		uc_inf[i].prev = dim + nzcnt;
+		uc_inf[dim + nzcnt].next = i;
+		uc_inf[uc_inf[i].next].prev = i;
 
-	EGLPNUM_TYPENAME_EGlpNumInitVar (maxelem_factor);
-	EGLPNUM_TYPENAME_EGlpNumCopy (maxelem_factor, f->maxelem_factor);
-#endif
-	EGLPNUM_TYPENAME_EGlpNumInitVar (pivval);
-	EGLPNUM_TYPENAME_EGlpNumInitVar (max);
-	EGLPNUM_TYPENAME_EGlpNumInitVar (v);
-	EGLPNUM_TYPENAME_EGlpNumInitVar (w);
+		nzcnt = ur_inf[i].pivcnt;
+		if (nzcnt >= max_k)
+			nzcnt = max_k;
+		ur_inf[i].next = ur_inf[dim + nzcnt].next;
+		ur_inf[i].prev = dim + nzcnt;
+		ur_inf[dim + nzcnt].next = i;
+		ur_inf[ur_inf[i].next].prev = i;
+	}
 
-	dense_swap (f, r, c);
-	f->stage++;
-	EGLPNUM_TYPENAME_EGlpNumCopyFrac (pivval, EGLPNUM_TYPENAME_oneLpNum, dmat[s * dcols + s]);
-	for (i = s + 1; i < drows; i++)
+	/* the largest entry of the basis is kept even without TRACK_FACTOR, the
+	 * element growth of the factor is measured against it */
+	EGLPNUM_TYPENAME_EGlpNumZero (max);
+	nzcnt = 0;
+	for (i = 0; i < dim; i++)
 	{
-		EGLPNUM_TYPENAME_EGlpNumCopy (v, dmat[i * dcols + s]);
-		if (EGLPNUM_TYPENAME_EGlpNumIsNeqqZero (v))
-		{
-			EGLPNUM_TYPENAME_EGlpNumMultTo (v, pivval);
-			if (EGLPNUM_TYPENAME_EGlpNumIsNeqZero (v, f->fzero_tol))
-			{
-				EGLPNUM_TYPENAME_EGlpNumCopy (dmat[i * dcols + s], v);
-#ifdef TRACK_FACTOR
-				EGLPNUM_TYPENAME_EGlpNumSetToMaxAbs (maxelem_factor, v);
-#endif
-				EGLPNUM_TYPENAME_EGlpNumZero (max);
-				for (j = s + 1; j < drows; j++)
-				{
-					EGLPNUM_TYPENAME_EGlpNumCopy (w, dmat[i * dcols + j]);
-					EGLPNUM_TYPENAME_EGlpNumSubInnProdTo (w, v, dmat[s * dcols + j]);
-					EGLPNUM_TYPENAME_EGlpNumCopy (dmat[i * dcols + j], w);
-					EGLPNUM_TYPENAME_EGlpNumSetToMaxAbs (max, w);
-				}
-				for (j = drows; j < dcols; j++)
-				{
-					EGLPNUM_TYPENAME_EGlpNumCopy (w, dmat[i * dcols + j]);
-					EGLPNUM_TYPENAME_EGlpNumSubInnProdTo (w, v, dmat[s * dcols + j]);
-					EGLPNUM_TYPENAME_EGlpNumCopy (dmat[i * dcols + j], w);
-				}
-				EGLPNUM_TYPENAME_EGlpNumCopy (ur_inf[rperm[dense_base + i]].max, max);
-#ifdef TRACK_FACTOR
-				if (EGLPNUM_TYPENAME_EGlpNumIsLess (maxelem_factor, max))
-					EGLPNUM_TYPENAME_EGlpNumCopy (maxelem_factor, max);
-#endif
-			}
-			else
-			{
-				EGLPNUM_TYPENAME_EGlpNumZero (dmat[i * dcols + s]);
-			}
-		}
+		if (EGLPNUM_TYPENAME_EGlpNumIsLess (max, ur_inf[i].max))
+			EGLPNUM_TYPENAME_EGlpNumCopy (max, ur_inf[i].max);
+		nzcnt += ur_inf[i].nzcnt;
 	}
+
+	EGLPNUM_TYPENAME_EGlpNumCopy (f->maxelem_orig, max);
+	EGLPNUM_TYPENAME_EGlpNumCopy (f->maxelem_factor, f->maxelem_orig);
 #ifdef TRACK_FACTOR
-	EGLPNUM_TYPENAME_EGlpNumCopy (f->maxelem_factor, maxelem_factor);
-	EGLPNUM_TYPENAME_EGlpNumClearVar (maxelem_factor);
-#endif
-	EGLPNUM_TYPENAME_EGlpNumClearVar (pivval);
+	f->nzcnt_orig = nzcnt;
+	f->nzcnt_factor = f->nzcnt_orig;
+#endif /* TRACK_FACTOR */
+
+	/* sentinal for column space */
+	ucindx[f->uc_space] = 0;
+
+	clear_work (f);
+
+CLEANUP:
 	EGLPNUM_TYPENAME_EGlpNumClearVar (max);
 	EGLPNUM_TYPENAME_EGlpNumClearVar (v);
-	EGLPNUM_TYPENAME_EGlpNumClearVar (w);
+	EG_RETURN (rval);
 }
 
-static int dense_replace_row (
-	EGLPNUM_TYPENAME_factor_work * f,
-	int i)
+static int build_iteration_u_data (
+	EGLPNUM_TYPENAME_factor_work * f)
 {
-	int dcols = f->dcols;
-	int dense_base = f->dense_base;
-	EGLPNUM_TYPE *dmat = f->dmat + i * dcols;
-	EGLPNUM_TYPE *urcoef;
+	int dim = f->dim;
 	EGLPNUM_TYPENAME_ur_info *ur_inf = f->ur_inf;
-	int *cperm = f->cperm;
-	int r = f->rperm[dense_base + i];
-	int *urindx;
+	EGLPNUM_TYPENAME_uc_info *uc_inf = f->uc_inf;
+	EGLPNUM_TYPE *uccoef = 0;
+	int *ucindx = 0;
+	int *urindx = f->urindx;
+	EGLPNUM_TYPE *urcoef = f->urcoef;
+	int *ucrind = 0;
+	int *urcind = 0;
 	int nzcnt;
 	int beg;
+	int cbeg;
+	int cnzcnt;
+	int uc_space = f->uc_space;
+	int er_space;
+	int i;
 	int j;
-	int rval = 0;
+	int k;
+	int rval;
 
 	nzcnt = 0;
-	for (j = i; j < dcols; j++)
+	for (i = 0; i < dim; i++)
 	{
-		if (EGLPNUM_TYPENAME_EGlpNumIsNeqZero (dmat[j], f->fzero_tol))
-		{
-			nzcnt++;
-		}
+		nzcnt += ur_inf[i].nzcnt;
 	}
-	if (nzcnt > ur_inf[r].nzcnt)
+
+#ifdef TRACK_FACTOR
+	f->nzcnt_factor = nzcnt;
+#endif /* TRACK_FACTOR */
+
+	EGLPNUM_TYPENAME_EGlpNumFreeArray (f->uccoef);
+	uccoef = EGLPNUM_TYPENAME_EGlpNumAllocArray (nzcnt);
+	f->uccoef = uccoef;
+
+	ILL_IFFREE(f->ucrind);
+	ILL_SAFE_MALLOC (ucrind, nzcnt, int);
+
+	f->ucrind = ucrind;
+
+	ILL_IFFREE(f->urcind);
+	ILL_SAFE_MALLOC (urcind, f->ur_space, int);
+
+	f->urcind = urcind;
+
+	if (uc_space < nzcnt)
 	{
-		if (ur_inf[r].rbeg + ur_inf[r].nzcnt == f->ur_freebeg)
-		{
-			f->ur_freebeg = ur_inf[r].rbeg;
-		}
-		ur_inf[r].nzcnt = 0;
-		if (f->ur_freebeg + nzcnt > f->ur_space)
-		{
-			rval = make_ur_space (f, nzcnt);
-			CHECKRVALG (rval, CLEANUP);
-		}
-		ur_inf[r].rbeg = f->ur_freebeg;
-		f->ur_freebeg += nzcnt;
+		ILL_IFFREE(f->ucindx);
+		ILL_SAFE_MALLOC (f->ucindx, nzcnt + 1, int);
 	}
-	beg = ur_inf[r].rbeg;
-	urcoef = f->urcoef;
-	urindx = f->urindx;
-	for (j = i; j < dcols; j++)
+	f->uc_space = nzcnt;
+	uc_space = nzcnt;
+	ucindx = f->ucindx;
+
+	for (i = 0; i < dim; i++)
 	{
-		if (EGLPNUM_TYPENAME_EGlpNumIsNeqZero (dmat[j], f->fzero_tol))
+		uc_inf[i].nzcnt = 0;
+	}
+
+	for (i = 0; i < dim; i++)
+	{
+		nzcnt = ur_inf[i].nzcnt;
+		beg = ur_inf[i].rbeg;
+		for (j = 0; j < nzcnt; j++)
 		{
-			EGLPNUM_TYPENAME_EGlpNumCopy (urcoef[beg], dmat[j]);
-			urindx[beg] = cperm[dense_base + j];
-			beg++;
+			uc_inf[urindx[beg + j]].nzcnt++;
 		}
+		ur_inf[i].delay = 0;
 	}
-	ur_inf[r].nzcnt = beg - ur_inf[r].rbeg;
-CLEANUP:
-	EG_RETURN (rval);
-}
-
-static int dense_create_col (
-	EGLPNUM_TYPENAME_factor_work * f,
-	int i)
-{
-	int dcols = f->dcols;
-	int drows = f->drows;
-	int dense_base = f->dense_base;
-	EGLPNUM_TYPE *dmat = f->dmat;
-	EGLPNUM_TYPE *lccoef;
-	EGLPNUM_TYPENAME_lc_info *lc_inf = f->lc_inf;
-	int *rperm = f->rperm;
-	int *lcindx;
-	int nzcnt;
-	int beg;
-	int j;
-	int rval = 0;
 
 	nzcnt = 0;
-	for (j = i + 1; j < drows; j++)
+	for (i = 0; i < dim; i++)
 	{
-		if (EGLPNUM_TYPENAME_EGlpNumIsNeqZero (dmat[j * dcols + i], f->fzero_tol))
-		{
-			nzcnt++;
-		}
+		uc_inf[i].cbeg = nzcnt;
+		nzcnt += uc_inf[i].nzcnt;
+		uc_inf[i].nzcnt = 0;
+		uc_inf[i].delay = 0;
 	}
 
-	if (f->lc_freebeg + nzcnt >= f->lc_space)
+	f->uc_freebeg = nzcnt;
+	for (i = nzcnt; i < uc_space; i++)
 	{
-		rval = make_lc_space (f, nzcnt);
-		CHECKRVALG (rval, CLEANUP);
+		ucindx[i] = -1;
 	}
-	beg = f->lc_freebeg;
-	lc_inf[dense_base + i].cbeg = beg;
-	lc_inf[dense_base + i].c = rperm[dense_base + i];
-	lcindx = f->lcindx;
-	lccoef = f->lccoef;
+	ucindx[uc_space] = 0;
 
-	for (j = i + 1; j < drows; j++)
+	for (i = 0; i < dim; i++)
 	{
-		if (EGLPNUM_TYPENAME_EGlpNumIsNeqZero (dmat[j * dcols + i], f->fzero_tol))
+		nzcnt = ur_inf[i].nzcnt;
+		beg = ur_inf[i].rbeg;
+		k = urindx[beg];
+		cbeg = uc_inf[k].cbeg;
+		cnzcnt = uc_inf[k].nzcnt;
+		if (cnzcnt != 0)
 		{
-			EGLPNUM_TYPENAME_EGlpNumCopy (lccoef[beg], dmat[j * dcols + i]);
-			lcindx[beg] = rperm[dense_base + j];
-			beg++;
+			ucindx[cbeg + cnzcnt] = ucindx[cbeg];
+			EGLPNUM_TYPENAME_EGlpNumCopy (uccoef[cbeg + cnzcnt], uccoef[cbeg]);
+			ucrind[cbeg + cnzcnt] = ucrind[cbeg];
+			urcind[ur_inf[ucindx[cbeg]].rbeg + ucrind[cbeg]] = cnzcnt;
+		}
+		ucindx[cbeg] = i;
+		EGLPNUM_TYPENAME_EGlpNumCopy (uccoef[cbeg], urcoef[beg]);
+		ucrind[cbeg] = 0;
+		urcind[beg] = 0;
+		uc_inf[k].nzcnt = cnzcnt + 1;
+#ifndef TRACK_FACTOR
+		EGLPNUM_TYPENAME_EGlpNumSetToMaxAbs (f->maxelem_factor, urcoef[beg]);
+#endif
+		for (j = 1; j < nzcnt; j++)
+		{
+#ifndef TRACK_FACTOR
+			EGLPNUM_TYPENAME_EGlpNumSetToMaxAbs (f->maxelem_factor, urcoef[beg + j]);
+#endif
+			k = urindx[beg + j];
+			cbeg = uc_inf[k].cbeg;
+			cnzcnt = uc_inf[k].nzcnt;
+			ucindx[cbeg + cnzcnt] = i;
+			EGLPNUM_TYPENAME_EGlpNumCopy (uccoef[cbeg + cnzcnt], urcoef[beg + j]);
+			ucrind[cbeg + cnzcnt] = j;
+			urcind[beg + j] = cnzcnt;
+			uc_inf[k].nzcnt++;
 		}
 	}
-	lc_inf[dense_base + i].nzcnt = beg - lc_inf[dense_base + i].cbeg;
-	f->lc_freebeg = beg;
-CLEANUP:
-	EG_RETURN (rval);
-}
 
-static int dense_replace (
-	EGLPNUM_TYPENAME_factor_work * f)
-{
-	int drows = f->drows;
-	int rval = 0;
-	int i;
+	for (i = 0; i < dim; i++)
+	{
+		f->rrank[f->rperm[i]] = i;
+	}
 
-	for (i = 0; i < drows; i++)
+	nzcnt = f->ur_space;
+
+	for (i = f->ur_freebeg; i < nzcnt; i++)
 	{
-		rval = dense_replace_row (f, i);
-		CHECKRVALG (rval, CLEANUP);
-		rval = dense_create_col (f, i);
-		CHECKRVALG (rval, CLEANUP);
+		urindx[i] = -1;
 	}
-	EGLPNUM_TYPENAME_EGlpNumFreeArray (f->dmat);
-	f->drows = 0;
-	f->dcols = 0;
+	urindx[nzcnt] = 0;
+
+	clear_work (f);
+
+	er_space = f->er_space_mul * f->etamax;
+	ILL_SAFE_MALLOC (f->er_inf, f->etamax, EGLPNUM_TYPENAME_er_info);
+	ILL_SAFE_MALLOC (f->erindx, er_space, int);
+
+	f->ercoef = EGLPNUM_TYPENAME_EGlpNumAllocArray (er_space);
+	f->etacnt = 0;
+	f->er_freebeg = 0;
+	f->er_space = er_space;
+
+	rval = 0;
+
 CLEANUP:
 	EG_RETURN (rval);
 }
 
-static int dense_factor (
+static int build_iteration_l_data (
 	EGLPNUM_TYPENAME_factor_work * f)
 {
-	int r;
+	int dim = f->dim;
+	EGLPNUM_TYPENAME_lc_info *lc_inf = f->lc_inf;
+	EGLPNUM_TYPENAME_lr_info *lr_inf = f->lr_inf;
+	EGLPNUM_TYPE *lrcoef = 0;
+	int *lrindx = 0;
+	EGLPNUM_TYPE *lccoef = f->lccoef;
+	int *lcindx = f->lcindx;
+	int nzcnt;
+	int beg;
+	int rnzcnt;
+	int rbeg;
+	int i;
+	int j;
+	int k;
 	int c;
-	int rval = 0;
+	int rval;
 
-#ifdef TRACK_FACTOR
-#ifdef NOTICE_BLOWUP
-	double tmpsize;
-#endif
-#endif
+	nzcnt = 0;
+	for (i = 0; i < dim; i++)
+	{
+		nzcnt += lc_inf[i].nzcnt;
+		lr_inf[i].nzcnt = 0;
+		lr_inf[i].delay = 0;
+		lc_inf[lc_inf[i].c].crank = i;
+	}
 
-/*
-    QSlog("dense kernel, %d rows, %d  cols...", f->nstages - f->stage,
-		            f->dim - f->stage);
-*/
+	EGLPNUM_TYPENAME_EGlpNumFreeArray (f->lrcoef);
+	if (nzcnt)
+	{
+		lrcoef = EGLPNUM_TYPENAME_EGlpNumAllocArray (nzcnt);
+		f->lrcoef = lrcoef;
+	}
 
-	rval = dense_build_matrix (f);
-	CHECKRVALG (rval, CLEANUP);
+	ILL_IFFREE(f->lrindx);
+	ILL_SAFE_MALLOC (lrindx, nzcnt + 1, int);
 
-#ifdef FACTOR_DEBUG
-#if (FACTOR_DEBUG+0>1)
-	MESSAGE (0,"before Dense EGLPNUM_TYPENAME_ILLfactor");
-	dump_matrix (f, 1);
-#endif
-#endif
+	f->lrindx = lrindx;
 
-	while (f->stage < f->nstages)
+	for (i = 0; i < dim; i++)
 	{
-		r = f->stage - f->dense_base;
-		rval = dense_find_pivot (f, &r, &c);
-		if (rval == E_NO_PIVOT)
-		{
-			rval = handle_singularity (f);
-			CHECKRVALG (rval, CLEANUP);
-			return E_SINGULAR_INTERNAL;
-		}
-		else
+		nzcnt = lc_inf[i].nzcnt;
+		beg = lc_inf[i].cbeg;
+		lc_inf[i].delay = 0;
+		for (j = 0; j < nzcnt; j++)
 		{
-			CHECKRVALG (rval, CLEANUP);
+			lr_inf[lc_inf[lcindx[beg + j]].crank].nzcnt++;
 		}
-#ifdef FACTOR_DEBUG
-#if (FACTOR_DEBUG+0>2)
-		MESSAGE (0,"dense pivot elem: %d %d", r, c);
-#endif
-#endif /* FACTOR_DEBUG */
-		dense_elim (f, r, c);
+	}
 
-#ifdef TRACK_FACTOR
-#ifdef NOTICE_BLOWUP
-		tmpsize = f->maxmult * EGLPNUM_TYPENAME_EGlpNumToLf (f->maxelem_orig);
-		if (tmpsize < EGLPNUM_TYPENAME_EGlpNumToLf (f->maxelem_factor) &&
-				EGLPNUM_TYPENAME_EGlpNumIsLess (f->partial_cur, EGLPNUM_TYPENAME_oneLpNum))
+	nzcnt = 0;
+	for (i = 0; i < dim; i++)
+	{
+		lr_inf[i].rbeg = nzcnt;
+		nzcnt += lr_inf[i].nzcnt;
+		lr_inf[i].nzcnt = 0;
+		lr_inf[i].r = lc_inf[i].c;
+		lr_inf[lr_inf[i].r].rrank = i;
+	}
+
+	for (i = 0; i < dim; i++)
+	{
+		nzcnt = lc_inf[i].nzcnt;
+		beg = lc_inf[i].cbeg;
+		c = lc_inf[i].c;
+		for (j = 0; j < nzcnt; j++)
 		{
-			return E_FACTOR_BLOWUP;
+			k = lc_inf[lcindx[beg + j]].crank;
+			rbeg = lr_inf[k].rbeg;
+			rnzcnt = lr_inf[k].nzcnt;
+			lrindx[rbeg + rnzcnt] = c;
+			EGLPNUM_TYPENAME_EGlpNumCopy (lrcoef[rbeg + rnzcnt], lccoef[beg + j]);
+			lr_inf[k].nzcnt++;
 		}
-#endif /* NOTICE_BLOWUP */
-#endif /* TRACK_FACTOR */
+	}
 
-#ifdef FACTOR_DEBUG
-#if (FACTOR_DEBUG+0>1)
-		MESSAGE (0,"After dense pivot stage %d (%d) of %d (%d)",
-						f->stage - f->dense_base, f->stage,
-						f->nstages - f->dense_base, f->nstages);
-#endif
-#if (FACTOR_DEBUG+0>2)
-		dump_matrix (f, 1);
-#endif
-#endif /* FACTOR_DEBUG */
+#ifdef TRACK_FACTOR
+	nzcnt = f->nzcnt_factor;
+	for (i = 0; i < dim; i++)
+	{
+		nzcnt += lc_inf[i].nzcnt;
 	}
+	f->nzcnt_factor = nzcnt;
 
-#ifdef FACTOR_DEBUG
-	MESSAGE (0,"After dense EGLPNUM_TYPENAME_ILLfactor:\n");
-	dump_matrix (f, 0);
-#endif /* FACTOR_DEBUG */
+	EGLPNUM_TYPENAME_EGlpNumCopy (f->maxelem_cur, f->maxelem_factor);
+	f->nzcnt_cur = f->nzcnt_factor;
 
-	rval = dense_replace (f);
-	CHECKRVALG (rval, CLEANUP);
+/*
+    dump_factor_stats (f);
+    QSlog("orig max  %e nzcnt %d", f->maxelem_orig, f->nzcnt_orig);
+    QSlog("f maxelem %e nzcnt %d", f->maxelem_cur, f->nzcnt_cur);
+*/
+#endif /* TRACK_FACTOR */
 
-#ifdef FACTOR_DEBUG
-	MESSAGE (0,"After replacement:\n");
-	dump_matrix (f, 0);
-#endif /* FACTOR_DEBUG */
+	rval = 0;
 
 CLEANUP:
 	EG_RETURN (rval);
 }
 
-#ifdef RECORD
-EGioFile_t *fsave = 0;
-int fsavecnt = 0;
-#endif /* RECORD */
-
-static int ILLfactor_try (
-	EGLPNUM_TYPENAME_factor_work * f,
-	int *basis,
-	int *cbeg,
-	int *clen,
-	int *cindx,
-	EGLPNUM_TYPE * ccoef)
+static int handle_singularity (
+	EGLPNUM_TYPENAME_factor_work * f)
 {
 	int rval = 0;
-	int r;
-	int c;
+	int nsing;
+	int *singr = 0;
+	int *singc = 0;
+	int i;
 
-#ifdef TRACK_FACTOR
-#ifdef NOTICE_BLOWUP
-	EGLPNUM_TYPE tmpsize;
+	if (f->p_nsing == 0 || f->p_singr == 0 || f->p_singc == 0)
+	{
+		QSlog("singular basis, but no place for singularity data");
+		return E_SING_NO_DATA;
+	}
 
-	EGLPNUM_TYPENAME_EGlpNumInitVar (tmpsize);
-#endif
-#endif
+	nsing = f->nstages - f->stage;
+	ILL_SAFE_MALLOC (singr, nsing, int);
+	ILL_SAFE_MALLOC (singc, nsing, int);
 
-#ifdef RECORD
+	for (i = f->stage; i < f->nstages; i++)
 	{
-		int ncol = 0;
-		int nzcnt = 0;
-		int dim = f->dim;
-		int i;
-		int j;
-		char fnambuf[40];
-
-		for (i = 0; i < dim; i++)
-		{
-			if (basis[i] > ncol)
-				ncol = basis[i];
-		}
-		ncol++;
+		singr[i - f->stage] = f->rperm[i];
+		singc[i - f->stage] = f->cperm[i];
+	}
+	*f->p_nsing = nsing;
+	*f->p_singr = singr;
+	*f->p_singc = singc;
+	singr = 0;
+	singc = 0;
+
+CLEANUP:
+	ILL_IFFREE(singr);
+	ILL_IFFREE(singc);
+
+	EG_RETURN (rval);
+}
+
+static int dense_build_matrix (
+	EGLPNUM_TYPENAME_factor_work * f)
+{
+	EGLPNUM_TYPE *dmat = 0;
+	int stage = f->stage;
+	int drows = f->nstages - stage;
+	int dcols = f->dim - stage;
+	int dsize = drows * dcols;
+	int *crank = f->crank;
+	EGLPNUM_TYPE *urcoef = f->urcoef;
+	int *urindx = f->urindx;
+	int nzcnt;
+	int beg;
+	int i;
+	int r;
+	int j;
+	int rval = 0;
+
+	dmat = EGLPNUM_TYPENAME_EGlpNumAllocArray (dsize);
+
+	for (i = 0; i < dsize; i++)
+		EGLPNUM_TYPENAME_EGlpNumZero (dmat[i]);
+
+	for (i = 0; i < drows; i++)
+	{
+		r = f->rperm[i + stage];
+		nzcnt = f->ur_inf[r].nzcnt;
+		beg = f->ur_inf[r].rbeg;
+		for (j = 0; j < nzcnt; j++)
+		{
+			EGLPNUM_TYPENAME_EGlpNumCopy (dmat[i * dcols - stage + crank[urindx[beg + j]]],
+									 urcoef[beg + j]);
+		}
+	}
+
+	f->drows = drows;
+	f->dcols = dcols;
+	f->dense_base = f->stage;
+	f->dmat = dmat;
+	dmat = 0;
+
+//CLEANUP:
+	EGLPNUM_TYPENAME_EGlpNumFreeArray (dmat);
+	EG_RETURN (rval);
+}
+
+static int dense_find_pivot (
+	EGLPNUM_TYPENAME_factor_work * f,
+	int *p_r,
+	int *p_c)
+{
+	int dcols = f->dcols;
+	int drows = f->drows;
+	EGLPNUM_TYPE *dmat = f->dmat;
+	int dense_base = f->dense_base;
+	int s = f->stage - dense_base;
+	EGLPNUM_TYPENAME_ur_info *ur_inf = f->ur_inf;
+	int *rperm = f->rperm;
+	EGLPNUM_TYPE maxval;
+	int max_r;
+	int max_c;
+	int i;
+
+	EGLPNUM_TYPENAME_EGlpNumInitVar (maxval);
+	EGLPNUM_TYPENAME_EGlpNumZero (maxval);
+	max_r = -1;
+	for (i = s; i < drows; i++)
+	{
+		if (EGLPNUM_TYPENAME_EGlpNumIsLess (maxval, ur_inf[rperm[dense_base + i]].max))
+		{
+			EGLPNUM_TYPENAME_EGlpNumCopy (maxval, ur_inf[rperm[dense_base + i]].max);
+			max_r = i;
+		}
+	}
+	if (max_r == -1)
+	{
+		return E_NO_PIVOT;
+	}
+
+	EGLPNUM_TYPENAME_EGlpNumZero (maxval);
+	max_c = -1;
+	for (i = s; i < drows; i++)
+	{
+		EGlpNumSetToMaxAbsAndDo (maxval, dmat[max_r * dcols + i], max_c = i);
+	}
+	if (max_c == -1)
+	{
+		return E_NO_PIVOT;
+	}
+	*p_r = max_r;
+	*p_c = max_c;
+
+	EGLPNUM_TYPENAME_EGlpNumClearVar (maxval);
+	return 0;
+}
+
+static void dense_swap (
+	EGLPNUM_TYPENAME_factor_work * f,
+	int r,
+	int c)
+{
+	int dcols = f->dcols;
+	int drows = f->drows;
+	EGLPNUM_TYPE *dmat = f->dmat;
+	int dense_base = f->dense_base;
+	int s = f->stage - dense_base;
+	int i;
+	EGLPNUM_TYPE v;
+
+	EGLPNUM_TYPENAME_EGlpNumInitVar (v);
+
+	if (r != s)
+	{
+		ILL_SWAP (f->rperm[dense_base + s], f->rperm[dense_base + r], i);
+		f->rrank[f->rperm[dense_base + s]] = dense_base + s;
+		f->rrank[f->rperm[dense_base + r]] = dense_base + r;
+		for (i = 0; i < dcols; i++)
+		{
+			EGLPNUM_TYPENAME_EGLPNUM_SWAP (dmat[s * dcols + i], dmat[r * dcols + i], v);
+		}
+	}
+	if (c != s)
+	{
+		ILL_SWAP (f->cperm[dense_base + s], f->cperm[dense_base + c], i);
+		f->crank[f->cperm[dense_base + s]] = dense_base + s;
+		f->crank[f->cperm[dense_base + c]] = dense_base + c;
+		for (i = 0; i < drows; i++)
+		{
+			EGLPNUM_TYPENAME_EGLPNUM_SWAP (dmat[i * dcols + s], dmat[i * dcols + c], v);
+		}
+	}
+	EGLPNUM_TYPENAME_EGlpNumClearVar (v);
+}
+
+static void dense_elim (
+	EGLPNUM_TYPENAME_factor_work * f,
+	int r,
+	int c)
+{
+	int dcols = f->dcols;
+	int drows = f->drows;
+	EGLPNUM_TYPE *dmat = f->dmat;
+	int dense_base = f->dense_base;
+	int s = f->stage - dense_base;
+	EGLPNUM_TYPENAME_ur_info *ur_inf = f->ur_inf;
+	int *rperm = f->rperm;
+	int i;
+	int j;
+#if EGLPNUM_TYPENAME_EGLPNUM_DENSE_KERNEL
+	int jt,
+	  je,
+	  jm;
+#else
+	EGLPNUM_TYPE max;
+#endif
+	EGLPNUM_TYPE pivval;
+	EGLPNUM_TYPE v;
+	EGLPNUM_TYPE w;
+
+#ifdef TRACK_FACTOR
+	EGLPNUM_TYPE maxelem_factor;
+
+	EGLPNUM_TYPENAME_EGlpNumInitVar (maxelem_factor);
+	EGLPNUM_TYPENAME_EGlpNumCopy (maxelem_factor, f->maxelem_factor);
+#endif
+	EGLPNUM_TYPENAME_EGlpNumInitVar (pivval);
+#if !EGLPNUM_TYPENAME_EGLPNUM_DENSE_KERNEL
+	EGLPNUM_TYPENAME_EGlpNumInitVar (max);
+#endif
+	EGLPNUM_TYPENAME_EGlpNumInitVar (v);
+	EGLPNUM_TYPENAME_EGlpNumInitVar (w);
+
+	dense_swap (f, r, c);
+	f->stage++;
+	EGLPNUM_TYPENAME_EGlpNumCopyFrac (pivval, EGLPNUM_TYPENAME_oneLpNum, dmat[s * dcols + s]);
+#if EGLPNUM_TYPENAME_EGLPNUM_DENSE_KERNEL
+	/* first the multipliers, zero for the rows left alone */
+	for (i = s + 1; i < drows; i++)
+	{
+		EGLPNUM_TYPENAME_EGlpNumCopy (v, dmat[i * dcols + s]);
+		if (EGLPNUM_TYPENAME_EGlpNumIsNeqqZero (v))
+		{
+			EGLPNUM_TYPENAME_EGlpNumMultTo (v, pivval);
+			if (EGLPNUM_TYPENAME_EGlpNumIsNeqZero (v, f->fzero_tol))
+			{
+				EGLPNUM_TYPENAME_EGlpNumCopy (dmat[i * dcols + s], v);
+#ifdef TRACK_FACTOR
+				EGLPNUM_TYPENAME_EGlpNumSetToMaxAbs (maxelem_factor, v);
+#endif
+				EGLPNUM_TYPENAME_EGlpNumZero (ur_inf[rperm[dense_base + i]].max);
+			}
+			else
+			{
+				EGLPNUM_TYPENAME_EGlpNumZero (dmat[i * dcols + s]);
+			}
+		}
+	}
+	/* then the update, one tile of columns at a time so that the tile of the
+	 * pivot row stays in cache while the rows go by; every entry sees the same
+	 * operations as in the plain loop below */
+	for (jt = s + 1; jt < dcols; jt += DENSE_TILE)
+	{
+		je = jt + DENSE_TILE < dcols ? jt + DENSE_TILE : dcols;
+		jm = je < drows ? je : drows;
+		for (i = s + 1; i < drows; i++)
+		{
+			if (EGLPNUM_TYPENAME_EGlpNumIsEqqual (dmat[i * dcols + s], EGLPNUM_TYPENAME_zeroLpNum))
+				continue;
+			EGLPNUM_TYPENAME_EGlpNumCopy (v, dmat[i * dcols + s]);
+			if (jt < jm)
+			{
+				w = EGLPNUM_TYPENAME_EGlpNumDenseAxpy (dmat + i * dcols + jt,
+																	dmat + s * dcols + jt, v, jm - jt);
+				EGLPNUM_TYPENAME_EGlpNumSetToMaxAbs (ur_inf[rperm[dense_base + i]].max, w);
+			}
+			if (je > drows)
+			{
+				j = jt > drows ? jt : drows;
+				EGLPNUM_TYPENAME_EGlpNumDenseAxpy (dmat + i * dcols + j,
+															dmat + s * dcols + j, v, je - j);
+			}
+		}
+	}
+#ifdef TRACK_FACTOR
+	for (i = s + 1; i < drows; i++)
+	{
+		if (EGLPNUM_TYPENAME_EGlpNumIsLess (maxelem_factor, ur_inf[rperm[dense_base + i]].max) &&
+				EGLPNUM_TYPENAME_EGlpNumIsNeqqZero (dmat[i * dcols + s]))
+			EGLPNUM_TYPENAME_EGlpNumCopy (maxelem_factor, ur_inf[rperm[dense_base + i]].max);
+	}
+#endif
+#else
+	for (i = s + 1; i < drows; i++)
+	{
+		EGLPNUM_TYPENAME_EGlpNumCopy (v, dmat[i * dcols + s]);
+		if (EGLPNUM_TYPENAME_EGlpNumIsNeqqZero (v))
+		{
+			EGLPNUM_TYPENAME_EGlpNumMultTo (v, pivval);
+			if (EGLPNUM_TYPENAME_EGlpNumIsNeqZero (v, f->fzero_tol))
+			{
+				EGLPNUM_TYPENAME_EGlpNumCopy (dmat[i * dcols + s], v);
+#ifdef TRACK_FACTOR
+				EGLPNUM_TYPENAME_EGlpNumSetToMaxAbs (maxelem_factor, v);
+#endif
+				EGLPNUM_TYPENAME_EGlpNumZero (max);
+				for (j = s + 1; j < drows; j++)
+				{
+					EGLPNUM_TYPENAME_EGlpNumCopy (w, dmat[i * dcols + j]);
+					EGLPNUM_TYPENAME_EGlpNumSubInnProdTo (w, v, dmat[s * dcols + j]);
+					EGLPNUM_TYPENAME_EGlpNumCopy (dmat[i * dcols + j], w);
+					EGLPNUM_TYPENAME_EGlpNumSetToMaxAbs (max, w);
+				}
+				for (j = drows; j < dcols; j++)
+				{
+					EGLPNUM_TYPENAME_EGlpNumCopy (w, dmat[i * dcols + j]);
+					EGLPNUM_TYPENAME_EGlpNumSubInnProdTo (w, v, dmat[s * dcols + j]);
+					EGLPNUM_TYPENAME_EGlpNumCopy (dmat[i * dcols + j], w);
+				}
+				EGLPNUM_TYPENAME_EGlpNumCopy (ur_inf[rperm[dense_base + i]].max, max);
+#ifdef TRACK_FACTOR
+				if (EGLPNUM_TYPENAME_EGlpNumIsLess (maxelem_factor, max))
+					EGLPNUM_TYPENAME_EGlpNumCopy (maxelem_factor, max);
+#endif
+			}
+			else
+			{
+				EGLPNUM_TYPENAME_EGlpNumZero (dmat[i * dcols + s]);
+			}
+		}
+	}
+#endif
+#ifdef TRACK_FACTOR
+	EGLPNUM_TYPENAME_EGlpNumCopy (f->maxelem_factor, maxelem_factor);
+	EGLPNUM_TYPENAME_EGlpNumClearVar (maxelem_factor);
+#endif
+	EGLPNUM_TYPENAME_EGlpNumClearVar (pivval);
+#if !EGLPNUM_TYPENAME_EGLPNUM_DENSE_KERNEL
+	EGLPNUM_TYPENAME_EGlpNumClearVar (max);
+#endif
+	EGLPNUM_TYPENAME_EGlpNumClearVar (v);
+	EGLPNUM_TYPENAME_EGlpNumClearVar (w);
+}
+
+static int dense_replace_row (
+	EGLPNUM_TYPENAME_factor_work * f,
+	int i)
+{
+	int dcols = f->dcols;
+	int dense_base = f->dense_base;
+	EGLPNUM_TYPE *dmat = f->dmat + i * dcols;
+	EGLPNUM_TYPE *urcoef;
+	EGLPNUM_TYPENAME_ur_info *ur_inf = f->ur_inf;
+	int *cperm = f->cperm;
+	int r = f->rperm[dense_base + i];
+	int *urindx;
+	int nzcnt;
+	int beg;
+	int j;
+	int rval = 0;
+
+	nzcnt = 0;
+	for (j = i; j < dcols; j++)
+	{
+		if (EGLPNUM_TYPENAME_EGlpNumIsNeqZero (dmat[j], f->fzero_tol))
+		{
+			nzcnt++;
+		}
+	}
+	if (nzcnt > ur_inf[r].nzcnt)
+	{
+		if (ur_inf[r].rbeg + ur_inf[r].nzcnt == f->ur_freebeg)
+		{
+			f->ur_freebeg = ur_inf[r].rbeg;
+		}
+		ur_inf[r].nzcnt = 0;
+		if (f->ur_freebeg + nzcnt > f->ur_space)
+		{
+			rval = make_ur_space (f, nzcnt);
+			CHECKRVALG (rval, CLEANUP);
+		}
+		ur_inf[r].rbeg = f->ur_freebeg;
+		f->ur_freebeg += nzcnt;
+	}
+	beg = ur_inf[r].rbeg;
+	urcoef = f->urcoef;
+	urindx = f->urindx;
+	for (j = i; j < dcols; j++)
+	{
+		if (EGLPNUM_TYPENAME_EGlpNumIsNeqZero (dmat[j], f->fzero_tol))
+		{
+			EGLPNUM_TYPENAME_EGlpNumCopy (urcoef[beg], dmat[j]);
+			urindx[beg] = cperm[dense_base + j];
+			beg++;
+		}
+	}
+	ur_inf[r].nzcnt = beg - ur_inf[r].rbeg;
+CLEANUP:
+	EG_RETURN (rval);
+}
+
+static int dense_create_col (
+	EGLPNUM_TYPENAME_factor_work * f,
+	int i)
+{
+	int dcols = f->dcols;
+	int drows = f->drows;
+	int dense_base = f->dense_base;
+	EGLPNUM_TYPE *dmat = f->dmat;
+	EGLPNUM_TYPE *lccoef;
+	EGLPNUM_TYPENAME_lc_info *lc_inf = f->lc_inf;
+	int *rperm = f->rperm;
+	int *lcindx;
+	int nzcnt;
+	int beg;
+	int j;
+	int rval = 0;
+
+	nzcnt = 0;
+	for (j = i + 1; j < drows; j++)
+	{
+		if (EGLPNUM_TYPENAME_EGlpNumIsNeqZero (dmat[j * dcols + i], f->fzero_tol))
+		{
+			nzcnt++;
+		}
+	}
+
+	if (f->lc_freebeg + nzcnt >= f->lc_space)
+	{
+		rval = make_lc_space (f, nzcnt);
+		CHECKRVALG (rval, CLEANUP);
+	}
+	beg = f->lc_freebeg;
+	lc_inf[dense_base + i].cbeg = beg;
+	lc_inf[dense_base + i].c = rperm[dense_base + i];
+	lcindx = f->lcindx;
+	lccoef = f->lccoef;
+
+	for (j = i + 1; j < drows; j++)
+	{
+		if (EGLPNUM_TYPENAME_EGlpNumIsNeqZero (dmat[j * dcols + i], f->fzero_tol))
+		{
+			EGLPNUM_TYPENAME_EGlpNumCopy (lccoef[beg], dmat[j * dcols + i]);
+			lcindx[beg] = rperm[dense_base + j];
+			beg++;
+		}
+	}
+	lc_inf[dense_base + i].nzcnt = beg - lc_inf[dense_base + i].cbeg;
+	f->lc_freebeg = beg;
+CLEANUP:
+	EG_RETURN (rval);
+}
+
+static int dense_replace (
+	EGLPNUM_TYPENAME_factor_work * f)
+{
+	int drows = f->drows;
+	int rval = 0;
+	int i;
+
+	for (i = 0; i < drows; i++)
+	{
+		rval = dense_replace_row (f, i);
+		CHECKRVALG (rval, CLEANUP);
+		rval = dense_create_col (f, i);
+		CHECKRVALG (rval, CLEANUP);
+	}
+	EGLPNUM_TYPENAME_EGlpNumFreeArray (f->dmat);
+	f->drows = 0;
+	f->dcols = 0;
+CLEANUP:
+	EG_RETURN (rval);
+}
+
+static int dense_factor (
+	EGLPNUM_TYPENAME_factor_work * f)
+{
+	int r;
+	int c;
+	int rval = 0;
+
+#ifdef TRACK_FACTOR
+#ifdef NOTICE_BLOWUP
+	double tmpsize;
+#endif
+#endif
+
+/*
+    QSlog("dense kernel, %d rows, %d  cols...", f->nstages - f->stage,
+		            f->dim - f->stage);
+*/
+
+	rval = dense_build_matrix (f);
+	CHECKRVALG (rval, CLEANUP);
+
+#ifdef FACTOR_DEBUG
+#if (FACTOR_DEBUG+0>1)
+	MESSAGE (0,"before Dense EGLPNUM_TYPENAME_ILLfactor");
+	dump_matrix (f, 1);
+#endif
+#endif
+
+	while (f->stage < f->nstages)
+	{
+		r = f->stage - f->dense_base;
+		rval = dense_find_pivot (f, &r, &c);
+		if (rval == E_NO_PIVOT)
+		{
+			rval = handle_singularity (f);
+			CHECKRVALG (rval, CLEANUP);
+			return E_SINGULAR_INTERNAL;
+		}
+		else
+		{
+			CHECKRVALG (rval, CLEANUP);
+		}
+#ifdef FACTOR_DEBUG
+#if (FACTOR_DEBUG+0>2)
+		MESSAGE (0,"dense pivot elem: %d %d", r, c);
+#endif
+#endif /* FACTOR_DEBUG */
+		dense_elim (f, r, c);
+
+#ifdef TRACK_FACTOR
+#ifdef NOTICE_BLOWUP
+		tmpsize = f->maxmult * EGLPNUM_TYPENAME_EGlpNumToLf (f->maxelem_orig);
+		if (tmpsize < EGLPNUM_TYPENAME_EGlpNumToLf (f->maxelem_factor) &&
+				EGLPNUM_TYPENAME_EGlpNumIsLess (f->partial_cur, EGLPNUM_TYPENAME_oneLpNum))
+		{
+			return E_FACTOR_BLOWUP;
+		}
+#endif /* NOTICE_BLOWUP */
+#endif /* TRACK_FACTOR */
+
+#ifdef FACTOR_DEBUG
+#if (FACTOR_DEBUG+0>1)
+		MESSAGE (0,"After dense pivot stage %d (%d) of %d (%d)",
+						f->stage - f->dense_base, f->stage,
+						f->nstages - f->dense_base, f->nstages);
+#endif
+#if (FACTOR_DEBUG+0>2)
+		dump_matrix (f, 1);
+#endif
+#endif /* FACTOR_DEBUG */
+	}
+
+#ifdef FACTOR_DEBUG
+	MESSAGE (0,"After dense EGLPNUM_TYPENAME_ILLfactor:\n");
+	dump_matrix (f, 0);
+#endif /* FACTOR_DEBUG */
+
+	rval = dense_replace (f);
+	CHECKRVALG (rval, CLEANUP);
+
+#ifdef FACTOR_DEBUG
+	MESSAGE (0,"After replacement:\n");
+	dump_matrix (f, 0);
+#endif /* FACTOR_DEBUG */
+
+CLEANUP:
+	EG_RETURN (rval);
+}
+
+#ifdef RECORD
+static EGLPNUM_TLS EGioFile_t *fsave = 0;
+static EGLPNUM_TLS int fsavecnt = 0;
+#endif /* RECORD */
+
+#if SOLVE_SNAP
+/* make room for nsteps steps with nzcnt entries in s, the arrays are kept
+ * from one factorization to the next */
+static int snap_alloc (
+	EGLPNUM_TYPENAME_solve_snap * s,
+	int nsteps,
+	int nzcnt)
+{
+	int rval = 0;
+
+	if (!s->beg)
+	{
+		ILL_SAFE_MALLOC (s->beg, nsteps + 1, int);
+		ILL_SAFE_MALLOC (s->piv, nsteps, int);
+		ILL_SAFE_MALLOC (s->out, nsteps, int);
+	}
+	if (nzcnt > s->space)
+	{
+		ILL_IFFREE(s->indx);
+		EGLPNUM_TYPENAME_EGlpNumFreeArray (s->coef);
+		s->space = 0;
+		ILL_SAFE_MALLOC (s->indx, nzcnt, int);
+		s->coef = EGLPNUM_TYPENAME_EGlpNumAllocArray (nzcnt);
+		s->space = nzcnt;
+	}
+
+CLEANUP:
+	EG_RETURN (rval);
+}
+
+/* pack L and U into the solve snapshots. The dense solves then stream through
+ * contiguous index and coefficient arrays in the order they visit them,
+ * instead of going through the lc/lr/uc/ur_info structs and the permutations
+ * for every step. Steps of L without entries are dropped. L does not change
+ * until the next factorization, U changes with the first update. */
+static int build_solve_snap (
+	EGLPNUM_TYPENAME_factor_work * f)
+{
+	int dim = f->dim;
+	EGLPNUM_TYPENAME_lc_info *lc_inf = f->lc_inf;
+	EGLPNUM_TYPENAME_lr_info *lr_inf = f->lr_inf;
+	EGLPNUM_TYPENAME_uc_info *uc_inf = f->uc_inf;
+	EGLPNUM_TYPENAME_ur_info *ur_inf = f->ur_inf;
+	EGLPNUM_TYPENAME_solve_snap *s;
+	int *rperm = f->rperm;
+	int *cperm = f->cperm;
+	int lnz = 0;
+	int unz = 0;
+	int beg;
+	int nzcnt;
+	int i;
+	int j;
+	int k;
+	int n;
+	int rval = 0;
+
+	f->snap_l = 0;
+	f->snap_u = 0;
+
+	for (i = 0; i < dim; i++)
+	{
+		lnz += lc_inf[i].nzcnt;
+		unz += uc_inf[i].nzcnt;
+	}
+
+	rval = snap_alloc (&f->lc_snap, dim, lnz);
+	CHECKRVALG (rval, CLEANUP);
+	rval = snap_alloc (&f->lr_snap, dim, lnz);
+	CHECKRVALG (rval, CLEANUP);
+	rval = snap_alloc (&f->uc_snap, dim, unz);
+	CHECKRVALG (rval, CLEANUP);
+	rval = snap_alloc (&f->ur_snap, dim, unz);
+	CHECKRVALG (rval, CLEANUP);
+
+	s = &f->lc_snap;
+	for (i = 0, k = 0, n = 0; i < dim; i++)
+	{
+		nzcnt = lc_inf[i].nzcnt;
+		if (nzcnt == 0)
+			continue;
+		beg = lc_inf[i].cbeg;
+		s->beg[k] = n;
+		s->piv[k++] = lc_inf[i].c;
+		for (j = 0; j < nzcnt; j++, n++)
+		{
+			s->indx[n] = f->lcindx[beg + j];
+			EGLPNUM_TYPENAME_EGlpNumCopy (s->coef[n], f->lccoef[beg + j]);
+		}
+	}
+	s->beg[k] = n;
+	s->nsteps = k;
+
+	s = &f->lr_snap;
+	for (i = dim - 1, k = 0, n = 0; i >= 0; i--)
+	{
+		nzcnt = lr_inf[i].nzcnt;
+		if (nzcnt == 0)
+			continue;
+		beg = lr_inf[i].rbeg;
+		s->beg[k] = n;
+		s->piv[k++] = lr_inf[i].r;
+		for (j = 0; j < nzcnt; j++, n++)
+		{
+			s->indx[n] = f->lrindx[beg + j];
+			EGLPNUM_TYPENAME_EGlpNumCopy (s->coef[n], f->lrcoef[beg + j]);
+		}
+	}
+	s->beg[k] = n;
+	s->nsteps = k;
+
+	s = &f->uc_snap;
+	for (i = dim - 1, k = 0, n = 0; i >= 0; i--, k++)
+	{
+		s->beg[k] = n;
+		s->piv[k] = rperm[i];
+		s->out[k] = cperm[i];
+		nzcnt = uc_inf[cperm[i]].nzcnt;
+		beg = uc_inf[cperm[i]].cbeg;
+		for (j = 0; j < nzcnt; j++, n++)
+		{
+			s->indx[n] = f->ucindx[beg + j];
+			EGLPNUM_TYPENAME_EGlpNumCopy (s->coef[n], f->uccoef[beg + j]);
+		}
+	}
+	s->beg[k] = n;
+	s->nsteps = k;
+
+	s = &f->ur_snap;
+	for (i = 0, k = 0, n = 0; i < dim; i++, k++)
+	{
+		s->beg[k] = n;
+		s->piv[k] = cperm[i];
+		s->out[k] = rperm[i];
+		nzcnt = ur_inf[rperm[i]].nzcnt;
+		beg = ur_inf[rperm[i]].rbeg;
+		for (j = 0; j < nzcnt; j++, n++)
+		{
+			s->indx[n] = f->urindx[beg + j];
+			EGLPNUM_TYPENAME_EGlpNumCopy (s->coef[n], f->urcoef[beg + j]);
+		}
+	}
+	s->beg[k] = n;
+	s->nsteps = k;
+
+	f->snap_l = 1;
+	f->snap_u = 1;
+
+CLEANUP:
+	EG_RETURN (rval);
+}
+#endif
+
+static int ILLfactor_try (
+	EGLPNUM_TYPENAME_factor_work * f,
+	int *basis,
+	int *cbeg,
+	int *clen,
+	int *cindx,
+	EGLPNUM_TYPE * ccoef)
+{
+	int rval = 0;
+	int r;
+	int c;
+	int dim = f->dim;
+	int par_sets;
+	int done;
+	par_info par;
+
+#ifdef TRACK_FACTOR
+#ifdef NOTICE_BLOWUP
+	EGLPNUM_TYPE tmpsize;
+
+	EGLPNUM_TYPENAME_EGlpNumInitVar (tmpsize);
+#endif
+#endif
+
+#ifdef RECORD
+	{
+		int ncol = 0;
+		int nzcnt = 0;
+		int dim = f->dim;
+		int i;
+		int j;
+		char fnambuf[40];
+
+		for (i = 0; i < dim; i++)
+		{
+			if (basis[i] > ncol)
+				ncol = basis[i];
+		}
+		ncol++;
+		for (i = 0; i < ncol; i++)
+		{
+			nzcnt += clen[i];
+		}
+		if (fsave)
+			EGioClose (fsave);
+#if HAVE_LIBZ
+		sprintf (fnambuf, "prob.mat.%d.gz", fsavecnt);
+#elif HAVE_LIBBZ2
+		sprintf (fnambuf, "prob.mat.%d.bz2", fsavecnt);
+#else
+		sprintf (fnambuf, "prob.mat.%d", fsavecnt);
+#endif
+		fsavecnt++;
+		fsave = EGioOpen (fnambuf, "w");
+		EGioPrintf (fsave, "%d %d %d\n", f->dim, ncol, nzcnt);
+		for (i = 0; i < dim; i++)
+		{
+			EGioPrintf (fsave, "%d ", basis[i]);
+		}
+		EGioPrintf (fsave, "\n");
 		for (i = 0; i < ncol; i++)
 		{
-			nzcnt += clen[i];
+			EGioPrintf (fsave, "%d", clen[i]);
+			for (j = 0; j < clen[i]; j++)
+			{
+				EGioPrintf (fsave, " %d %.16lg", cindx[cbeg[i] + j],
+								 EGLPNUM_TYPENAME_EGlpNumToLf (ccoef[cbeg[i] + j]));
+			}
+			EGioPrintf (fsave, "\n");
+		}
+		EGioPrintf (fsave, "\n");
+		EGioFlush (fsave);
+	}
+#endif /* RECORD */
+
+	rval = par_init (f, &par);
+	CHECKRVALG (rval, CLEANUP);
+	par_sets = par.nthreads > 0;
+
+	rval = init_matrix (f, basis, cbeg, clen, cindx, ccoef);
+	CHECKRVALG (rval, CLEANUP);
+
+	f->stage = 0;
+	f->nstages = f->dim;
+
+#ifdef FACTOR_DEBUG
+	MESSAGE (0,"Initial matrix:");
+#if (FACTOR_DEBUG+0>1)
+	dump_matrix (f, 0);
+#endif
+#endif /* FACTOR_DEBUG */
+#ifdef FACTOR_STATS
+	QSlog("Initial matrix: ");
+	dump_factor_stats (f);
+#endif /* FACTOR_STATS */
+
+	while (f->stage < f->nstages)
+	{
+		if (par_sets && f->uc_inf[dim + 1].next == dim + 1 &&
+				f->ur_inf[dim + 1].next == dim + 1)
+		{
+			rval = par_elim_set (f, &par, &par_sets);
+			CHECKRVALG (rval, CLEANUP);
+			if (par_sets)
+				continue;
+		}
+		rval = find_pivot (f, &r, &c);
+		if (rval == E_NO_PIVOT)
+		{
+			rval = handle_singularity (f);
+			CHECKRVALG (rval, CLEANUP);
+			goto CLEANUP;
+		}
+		else
+		{
+			CHECKRVALG (rval, CLEANUP);
+		}
+		if (f->ur_inf[r].pivcnt > f->dense_fract * (f->nstages - f->stage) &&
+				f->uc_inf[c].nzcnt > f->dense_fract * (f->nstages - f->stage) &&
+				f->nstages - f->stage > f->dense_min)
+		{
+			rval = dense_factor (f);
+			if (rval == E_SINGULAR_INTERNAL)
+			{
+				rval = 0;
+				goto CLEANUP;
+			}
+			if (rval)
+			{
+				par_free (&par);
+				return rval;
+			}
+			break;
+		}
+#ifdef FACTOR_DEBUG
+		MESSAGE (0,"pivot elem: %d %d", r, c);
+#endif /* FACTOR_DEBUG */
+		done = 0;
+		if (par.nthreads)
+		{
+			rval = par_elim_one (f, &par, r, c, &done);
+			CHECKRVALG (rval, CLEANUP);
+		}
+		if (!done)
+		{
+			rval = elim (f, r, c);
+			CHECKRVALG (rval, CLEANUP);
+		}
+
+#ifdef TRACK_FACTOR
+#ifdef NOTICE_BLOWUP
+		EGLPNUM_TYPENAME_EGlpNumSet (tmpsize, f->maxmult);
+		EGLPNUM_TYPENAME_EGlpNumMultTo (tmpsize, f->maxelem_orig);
+		if (EGLPNUM_TYPENAME_EGlpNumIsLess (tmpsize, f->maxelem_factor) &&
+				EGLPNUM_TYPENAME_EGlpNumIsLess (f->partial_cur, EGLPNUM_TYPENAME_oneLpNum))
+		{
+			par_free (&par);
+			return E_FACTOR_BLOWUP;
+		}
+#endif /* NOTICE_BLOWUP */
+#endif /* TRACK_FACTOR */
+
+#ifdef FACTOR_DEBUG
+#if (FACTOR_DEBUG+0>3)
+		MESSAGE (0,"After pivot stage %d of %d", f->stage, f->nstages);
+		dump_matrix (f, 0);
+#endif
+#endif /* FACTOR_DEBUG */
+	}
+
+	rval = build_iteration_u_data (f);
+	CHECKRVALG (rval, CLEANUP);
+
+	rval = build_iteration_l_data (f);
+	CHECKRVALG (rval, CLEANUP);
+
+#if SOLVE_SNAP
+	rval = build_solve_snap (f);
+	CHECKRVALG (rval, CLEANUP);
+#endif
+
+#ifdef TRACK_FACTOR
+#ifdef NOTICE_BLOWUP
+	EGLPNUM_TYPENAME_EGlpNumSet (tmpsize, f->minmult);
+	EGLPNUM_TYPENAME_EGlpNumMultTo (tmpsize, f->maxelem_orig);
+	if (EGLPNUM_TYPENAME_EGlpNumIsLess (f->maxelem_factor, tmpsize) &&
+			EGLPNUM_TYPENAME_EGlpNumIsLess (f->partial_tol, f->partial_cur))
+	{
+		if (EGLPNUM_TYPENAME_EGlpNumIsGreaDbl (f->partial_cur, 0.5))
+		{
+			EGLPNUM_TYPENAME_EGlpNumSet (f->partial_cur, 0.5);
+		}
+		else if (EGLPNUM_TYPENAME_EGlpNumIsGreaDbl (f->partial_cur, 0.25))
+		{
+			EGLPNUM_TYPENAME_EGlpNumSet (f->partial_cur, 0.25);
+		}
+		else if (EGLPNUM_TYPENAME_EGlpNumIsGreaDbl (f->partial_cur, 0.1))
+		{
+			EGLPNUM_TYPENAME_EGlpNumSet (f->partial_cur, 0.1);
+		}
+		else
+		{
+			EGLPNUM_TYPENAME_EGlpNumDivUiTo (f->partial_cur, 10);
+		}
+		if (EGLPNUM_TYPENAME_EGlpNumIsLess (f->partial_cur, f->partial_tol))
+		{
+			EGLPNUM_TYPENAME_EGlpNumCopy (f->partial_cur, f->partial_tol);
+		}
+/*  Bico - comment out for dist 
+        QSlog("factor good, lowering partial tolerance to %.2f",
+                    f->partial_cur);
+*/
+	}
+#endif /* NOTICE_BLOWUP */
+#endif /* TRACK_FACTOR */
+
+#ifdef FACTOR_DEBUG
+	MESSAGE(0,"Factored matrix:");
+#if (FACTOR_DEBUG+0>1)
+	dump_matrix (f, 0);
+#endif
+#endif /* FACTOR_DEBUG */
+
+#ifdef FACTOR_STATS
+	QSlog("Factored matrix: ");
+	dump_factor_stats (f);
+#endif /* FACTOR_STATS */
+CLEANUP:
+	par_free (&par);
+#ifdef TRACK_FACTOR
+#ifdef NOTICE_BLOWUP
+	EGLPNUM_TYPENAME_EGlpNumClearVar (tmpsize);
+#endif
+#endif
+	EG_RETURN (rval);
+}
+
+int EGLPNUM_TYPENAME_ILLfactor (
+	EGLPNUM_TYPENAME_factor_work * f,
+	int *basis,
+	int *cbeg,
+	int *clen,
+	int *cindx,
+	EGLPNUM_TYPE * ccoef,
+	int *p_nsing,
+	int **p_singr,
+	int **p_singc)
+{
+	int rval;
+
+	f->p_nsing = p_nsing;
+	f->p_singr = p_singr;
+	f->p_singc = p_singc;
+	*p_nsing = 0;
+	f->snap_l = 0;
+	f->snap_u = 0;
+
+AGAIN:
+	rval = ILLfactor_try (f, basis, cbeg, clen, cindx, ccoef);
+	if (rval == E_FACTOR_BLOWUP)
+	{
+		if (EGLPNUM_TYPENAME_EGlpNumIsLessDbl (f->partial_cur, 0.1))
+		{
+			EGLPNUM_TYPENAME_EGlpNumMultUiTo (f->partial_cur, 10);
+		}
+		else if (EGLPNUM_TYPENAME_EGlpNumIsLessDbl (f->partial_cur, 0.25))
+		{
+			EGLPNUM_TYPENAME_EGlpNumSet (f->partial_cur, 0.25);
+		}
+		else if (EGLPNUM_TYPENAME_EGlpNumIsLessDbl (f->partial_cur, 0.5))
+		{
+			EGLPNUM_TYPENAME_EGlpNumSet (f->partial_cur, 0.5);
+		}
+		else if (EGLPNUM_TYPENAME_EGlpNumIsLess (f->partial_cur, EGLPNUM_TYPENAME_oneLpNum))
+		{
+			EGLPNUM_TYPENAME_EGlpNumOne (f->partial_cur);
+		}
+		else
+		{
+			EG_RETURN (rval);
+		}
+/* Bico - comment out for dist
+        QSlog("factor blowup, changing partial tolerance to %.2f",
+                    f->partial_cur);
+*/
+		goto AGAIN;
+	}
+	EG_RETURN (rval);
+}
+
+/* the four graphs searched by hyper_reach, the nodes are the indices of the
+ * vectors that each triangular solve works on */
+#define REACH_FTRANL 0
+#define REACH_FTRANU 1
+#define REACH_BTRANU 2
+#define REACH_BTRANL 3
+
+/* the mark of node n, these are the delay counters of the l3 and u3 solves,
+ * which are zero between solves */
+static inline int *reach_mark (
+	EGLPNUM_TYPENAME_factor_work * f,
+	int which,
+	int n)
+{
+	switch (which)
+	{
+	case REACH_FTRANL:
+		return &f->lc_inf[n].delay;
+	case REACH_FTRANU:
+		return &f->uc_inf[n].delay;
+	case REACH_BTRANU:
+		return &f->ur_inf[n].delay;
+	default:
+		return &f->lr_inf[n].delay;
+	}
+}
+
+/* sets *indx to the nodes that node n updates and returns how many */
+static inline int reach_edges (
+	EGLPNUM_TYPENAME_factor_work * f,
+	int which,
+	int n,
+	int **indx)
+{
+	switch (which)
+	{
+	case REACH_FTRANL:
+		n = f->lc_inf[n].crank;
+		*indx = f->lcindx + f->lc_inf[n].cbeg;
+		return f->lc_inf[n].nzcnt;
+	case REACH_FTRANU:
+		n = f->cperm[f->rrank[n]];
+		*indx = f->ucindx + f->uc_inf[n].cbeg + 1;
+		return f->uc_inf[n].nzcnt - 1;
+	case REACH_BTRANU:
+		n = f->rperm[f->crank[n]];
+		*indx = f->urindx + f->ur_inf[n].rbeg + 1;
+		return f->ur_inf[n].nzcnt - 1;
+	default:
+		n = f->lr_inf[n].rrank;
+		*indx = f->lrindx + f->lr_inf[n].rbeg;
+		return f->lr_inf[n].nzcnt;
+	}
+}
+
+/* hyper_reach finds the nodes reachable from the nonzeros of a by a depth
+ * first search without recursion (Gilbert and Peierls). They are left in
+ * f->reach_list[start..dim-1] in topological order, and start is returned.
+ * The nodes of the reach are marked, the caller must clear the marks. */
+static inline int hyper_reach (
+	EGLPNUM_TYPENAME_factor_work * f,
+	int which,
+	EGLPNUM_TYPENAME_svector * a)
+{
+	int *list = f->reach_list;
+	int *stack = f->reach_stack;
+	int *pos = f->reach_pos;
+	int start = f->dim;
+	int *indx;
+	int nzcnt;
+	int head;
+	int i;
+	int j;
+	int n;
+
+	for (i = 0; i < a->nzcnt; i++)
+	{
+		n = a->indx[i];
+		if (*reach_mark (f, which, n))
+			continue;
+		*reach_mark (f, which, n) = 1;
+		head = 0;
+		stack[0] = n;
+		pos[0] = 0;
+		while (head >= 0)
+		{
+			n = stack[head];
+			nzcnt = reach_edges (f, which, n, &indx);
+			for (j = pos[head]; j < nzcnt; j++)
+			{
+				if (*reach_mark (f, which, indx[j]) == 0)
+					break;
+			}
+			if (j < nzcnt)
+			{
+				pos[head] = j + 1;
+				n = indx[j];
+				*reach_mark (f, which, n) = 1;
+				stack[++head] = n;
+				pos[head] = 0;
+			}
+			else
+			{
+				list[--start] = n;
+				head--;
+			}
+		}
+	}
+	return start;
+}
+
+/* whether a solve with nzcnt nonzeros on input, whose recent results had
+ * density dens, should go by hyper_reach instead of the delay counters */
+static inline int hyper_solve (
+	EGLPNUM_TYPENAME_factor_work * f,
+	int nzcnt,
+	double dens)
+{
+	return nzcnt < HYPER_FACTOR * f->dim && dens < HYPER_FACTOR;
+}
+
+/* folds the density of a result with nzcnt nonzeros into dens */
+static inline double hyper_density (
+	EGLPNUM_TYPENAME_factor_work * f,
+	double dens,
+	int nzcnt)
+{
+	return HYPER_DECAY * dens + (1.0 - HYPER_DECAY) * nzcnt / f->dim;
+}
+
+#if SOLVE_SNAP
+/* the dense solves with L and U from the snapshots of build_solve_snap, the
+ * same for both directions since the snapshots are in solve order */
+static void snap_solve_l (
+	EGLPNUM_TYPENAME_solve_snap * s,
+	EGLPNUM_TYPE * a)
+{
+	int nsteps = s->nsteps;
+	int *beg = s->beg;
+	int *piv = s->piv;
+	int *indx = s->indx;
+	EGLPNUM_TYPE *coef = s->coef;
+	int end;
+	int j;
+	int k;
+	EGLPNUM_TYPE v;
+
+	EGLPNUM_TYPENAME_EGlpNumInitVar (v);
+
+	for (k = 0; k < nsteps; k++)
+	{
+		EGLPNUM_TYPENAME_EGlpNumCopy (v, a[piv[k]]);
+		if (EGLPNUM_TYPENAME_EGlpNumIsNeqqZero (v))
+		{
+			end = beg[k + 1];
+			for (j = beg[k]; j < end; j++)
+			{
+				EGLPNUM_TYPENAME_EGlpNumSubInnProdTo (a[indx[j]], v, coef[j]);
+			}
+		}
+	}
+	EGLPNUM_TYPENAME_EGlpNumClearVar (v);
+}
+
+static void snap_solve_u (
+	EGLPNUM_TYPENAME_factor_work * f,
+	EGLPNUM_TYPENAME_solve_snap * s,
+	EGLPNUM_TYPE * a,
+	EGLPNUM_TYPENAME_svector * x)
+{
+	int nsteps = s->nsteps;
+	int *beg = s->beg;
+	int *piv = s->piv;
+	int *out = s->out;
+	int *indx = s->indx;
+	EGLPNUM_TYPE *coef = s->coef;
+	int xnzcnt = 0;
+	int *xindx = x->indx;
+	EGLPNUM_TYPE *xcoef = x->coef;
+	int end;
+	int j;
+	int k;
+	EGLPNUM_TYPE v;
+
+	EGLPNUM_TYPENAME_EGlpNumInitVar (v);
+
+	for (k = 0; k < nsteps; k++)
+	{
+		EGLPNUM_TYPENAME_EGlpNumCopy (v, a[piv[k]]);
+		if (EGLPNUM_TYPENAME_EGlpNumIsNeqqZero (v))
+		{
+			j = beg[k];
+			end = beg[k + 1];
+			EGLPNUM_TYPENAME_EGlpNumDivTo (v, coef[j]);
+			if (EGLPNUM_TYPENAME_EGlpNumIsNeqZero (v, f->szero_tol))
+			{
+				xindx[xnzcnt] = out[k];
+				EGLPNUM_TYPENAME_EGlpNumCopy (xcoef[xnzcnt], v);
+				xnzcnt++;
+			}
+			for (j++; j < end; j++)
+			{
+				EGLPNUM_TYPENAME_EGlpNumSubInnProdTo (a[indx[j]], v, coef[j]);
+			}
+			EGLPNUM_TYPENAME_EGlpNumZero (a[piv[k]]);
+		}
+	}
+	x->nzcnt = xnzcnt;
+	EGLPNUM_TYPENAME_EGlpNumClearVar (v);
+}
+#endif
+
+static void ILLfactor_ftranl (
+	EGLPNUM_TYPENAME_factor_work * f,
+	EGLPNUM_TYPE * a)
+{
+	int *lcindx = f->lcindx;
+	EGLPNUM_TYPENAME_lc_info *lc_inf = f->lc_inf;
+	EGLPNUM_TYPE *lccoef = f->lccoef;
+	int dim = f->dim;
+	int beg;
+	int nzcnt;
+	int i;
+	int j;
+	EGLPNUM_TYPE v;
+
+#if SOLVE_SNAP
+	if (f->snap_l)
+	{
+		snap_solve_l (&f->lc_snap, a);
+		return;
+	}
+#endif
+
+	EGLPNUM_TYPENAME_EGlpNumInitVar (v);
+
+	for (i = 0; i < dim; i++)
+	{
+		EGLPNUM_TYPENAME_EGlpNumCopy (v, a[lc_inf[i].c]);
+		if (EGLPNUM_TYPENAME_EGlpNumIsNeqqZero (v))
+		{
+			nzcnt = lc_inf[i].nzcnt;
+			beg = lc_inf[i].cbeg;
+			for (j = 0; j < nzcnt; j++)
+			{
+				EGLPNUM_TYPENAME_EGlpNumSubInnProdTo (a[lcindx[beg + j]], v, lccoef[beg + j]);
+			}
+		}
+#ifdef SOLVE_DEBUG
+#if (SOLVE_DEBUG+0 > 1)
+		QSlog("EGLPNUM_TYPENAME_ILLfactor_ftran a after l %d:", i);
+		for (j = 0; j < f->dim; j++)
+		{
+			QSlog(" %.3f", EGLPNUM_TYPENAME_EGlpNumToLf (a[j]));
+		}
+		MESSAGE(0," ");
+#endif
+#endif /* SOLVE_DEBUG */
+	}
+#ifdef SOLVE_DEBUG
+#if (SOLVE_DEBUG+0 <= 1)
+	QSlog("EGLPNUM_TYPENAME_ILLfactor_ftran a after l:");
+	for (j = 0; j < f->dim; j++)
+	{
+		QSlog(" %.3f", EGLPNUM_TYPENAME_EGlpNumToLf (a[j]));
+	}
+#endif
+#endif /* SOLVE_DEBUG */
+	EGLPNUM_TYPENAME_EGlpNumClearVar (v);
+}
+
+#if 0
+static void ftranl3_delay (
+	EGLPNUM_TYPENAME_factor_work * f,
+	int c)
+{
+	EGLPNUM_TYPENAME_lc_info *lc_inf = f->lc_inf;
+	int nzcnt;
+	int *indx;
+	int i;
+
+	c = lc_inf[c].crank;
+	nzcnt = lc_inf[c].nzcnt;
+	indx = f->lcindx + lc_inf[c].cbeg;
+	for (i = 0; i < nzcnt; i++)
+	{
+		c = indx[i];
+		if (lc_inf[c].delay++ == 0)
+		{
+			ftranl3_delay (f, c);
 		}
-		if (fsave)
-			EGioClose (fsave);
-#if HAVE_LIBZ
-		sprintf (fnambuf, "prob.mat.%d.gz", fsavecnt);
-#elif HAVE_LIBBZ2
-		sprintf (fnambuf, "prob.mat.%d.bz2", fsavecnt);
-#else
-		sprintf (fnambuf, "prob.mat.%d", fsavecnt);
+	}
+}
 #endif
-		fsavecnt++;
-		fsave = EGioOpen (fnambuf, "w");
-		EGioPrintf (fsave, "%d %d %d\n", f->dim, ncol, nzcnt);
-		for (i = 0; i < dim; i++)
-		{
-			EGioPrintf (fsave, "%d ", basis[i]);
-		}
-		EGioPrintf (fsave, "\n");
-		for (i = 0; i < ncol; i++)
+
+static void ftranl3_delay2 (
+	EGLPNUM_TYPENAME_factor_work * f,
+	int c)
+{
+	EGLPNUM_TYPENAME_lc_info *lc_inf = f->lc_inf;
+	int nzcnt;
+	int *indx;
+	int i;
+	int last;
+
+	do
+	{
+		c = lc_inf[c].crank;
+		nzcnt = lc_inf[c].nzcnt;
+		indx = f->lcindx + lc_inf[c].cbeg;
+		last = -1;
+		for (i = 0; i < nzcnt; i++)
 		{
-			EGioPrintf (fsave, "%d", clen[i]);
-			for (j = 0; j < clen[i]; j++)
+			c = indx[i];
+			if (lc_inf[c].delay++ == 0)
 			{
-				EGioPrintf (fsave, " %d %.16lg", cindx[cbeg[i] + j],
-								 EGLPNUM_TYPENAME_EGlpNumToLf (ccoef[cbeg[i] + j]));
+				if (last >= 0)
+				{
+					ftranl3_delay2 (f, last);
+				}
+				last = c;
 			}
-			EGioPrintf (fsave, "\n");
 		}
-		EGioPrintf (fsave, "\n");
-		EGioFlush (fsave);
-	}
-#endif /* RECORD */
+		c = last;
+	} while (c >= 0);
+}
 
-	rval = init_matrix (f, basis, cbeg, clen, cindx, ccoef);
-	CHECKRVALG (rval, CLEANUP);
+#if 0
+static void ftranl3_process (
+	EGLPNUM_TYPENAME_factor_work * f,
+	int c,
+	EGLPNUM_TYPENAME_svector * x)
+{
+	EGLPNUM_TYPENAME_lc_info *lc_inf = f->lc_inf;
+	EGLPNUM_TYPE *work = f->work_coef;
+	int nzcnt;
+	int *indx;
+	int i;
+	EGLPNUM_TYPE *coef;
+	EGLPNUM_TYPE v;
 
-	f->stage = 0;
-	f->nstages = f->dim;
+	EGLPNUM_TYPENAME_EGlpNumInitVar (v);
 
-#ifdef FACTOR_DEBUG
-	MESSAGE (0,"Initial matrix:");
-#if (FACTOR_DEBUG+0>1)
-	dump_matrix (f, 0);
+	EGLPNUM_TYPENAME_EGlpNumCopy (v, work[c]);
+	EGLPNUM_TYPENAME_EGlpNumZero (work[c]);
+	if (EGLPNUM_TYPENAME_EGlpNumIsNeqqZero (v))
+	{
+		x->indx[x->nzcnt] = c;
+		EGLPNUM_TYPENAME_EGlpNumCopy (x->coef[x->nzcnt], v);
+		x->nzcnt++;
+	}
+	c = lc_inf[c].crank;
+	nzcnt = lc_inf[c].nzcnt;
+	indx = f->lcindx + lc_inf[c].cbeg;
+	coef = f->lccoef + lc_inf[c].cbeg;
+	for (i = 0; i < nzcnt; i++)
+	{
+		c = indx[i];
+		EGLPNUM_TYPENAME_EGlpNumSubInnProdTo (work[c], v, coef[i]);
+		if (--lc_inf[c].delay == 0)
+		{
+			ftranl3_process (f, c, x);
+		}
+	}
+	EGLPNUM_TYPENAME_EGlpNumClearVar (v);
+}
 #endif
-#endif /* FACTOR_DEBUG */
-#ifdef FACTOR_STATS
-	QSlog("Initial matrix: ");
-	dump_factor_stats (f);
-#endif /* FACTOR_STATS */
 
-	while (f->stage < f->nstages)
+static void ftranl3_process2 (
+	EGLPNUM_TYPENAME_factor_work * f,
+	int c,
+	EGLPNUM_TYPENAME_svector * x)
+{
+	EGLPNUM_TYPENAME_lc_info *lc_inf = f->lc_inf;
+	EGLPNUM_TYPE *work = f->work_coef;
+	int nzcnt;
+	int *indx;
+	EGLPNUM_TYPE *coef;
+	int i;
+	int last;
+	EGLPNUM_TYPE v;
+
+	EGLPNUM_TYPENAME_EGlpNumInitVar (v);
+
+	do
 	{
-		rval = find_pivot (f, &r, &c);
-		if (rval == E_NO_PIVOT)
+		EGLPNUM_TYPENAME_EGlpNumCopy (v, work[c]);
+		EGLPNUM_TYPENAME_EGlpNumZero (work[c]);
+		if (EGLPNUM_TYPENAME_EGlpNumIsNeqqZero (v))
 		{
-			rval = handle_singularity (f);
-			CHECKRVALG (rval, CLEANUP);
-			return 0;
+			x->indx[x->nzcnt] = c;
+			EGLPNUM_TYPENAME_EGlpNumCopy (x->coef[x->nzcnt], v);
+			x->nzcnt++;
 		}
-		else
+		c = lc_inf[c].crank;
+		nzcnt = lc_inf[c].nzcnt;
+		indx = f->lcindx + lc_inf[c].cbeg;
+		coef = f->lccoef + lc_inf[c].cbeg;
+		last = -1;
+		for (i = 0; i < nzcnt; i++)
 		{
-			CHECKRVALG (rval, CLEANUP);
+			c = indx[i];
+			EGLPNUM_TYPENAME_EGlpNumSubInnProdTo (work[c], v, coef[i]);
+			if (--lc_inf[c].delay == 0)
+			{
+				if (last >= 0)
+				{
+					ftranl3_process2 (f, last, x);
+				}
+				last = c;
+			}
 		}
-		if (f->ur_inf[r].pivcnt > f->dense_fract * (f->nstages - f->stage) &&
-				f->uc_inf[c].nzcnt > f->dense_fract * (f->nstages - f->stage) &&
-				f->nstages - f->stage > f->dense_min)
+		c = last;
+	} while (c >= 0);
+	EGLPNUM_TYPENAME_EGlpNumClearVar (v);
+}
+
+/* hypersparse version of ILLfactor_ftranl3, the columns of L are applied in
+ * the order found by hyper_reach */
+static void ILLfactor_ftranl_hyper (
+	EGLPNUM_TYPENAME_factor_work * f,
+	EGLPNUM_TYPENAME_svector * a,
+	EGLPNUM_TYPENAME_svector * x)
+{
+	EGLPNUM_TYPE *work = f->work_coef;
+	EGLPNUM_TYPENAME_lc_info *lc_inf = f->lc_inf;
+	int *list = f->reach_list;
+	int dim = f->dim;
+	int nzcnt;
+	int *indx;
+	EGLPNUM_TYPE *coef;
+	int i;
+	int j;
+	int c;
+	EGLPNUM_TYPE v;
+
+	EGLPNUM_TYPENAME_EGlpNumInitVar (v);
+
+	for (i = 0; i < a->nzcnt; i++)
+	{
+		EGLPNUM_TYPENAME_EGlpNumCopy (work[a->indx[i]], a->coef[i]);
+	}
+	x->nzcnt = 0;
+	for (i = hyper_reach (f, REACH_FTRANL, a); i < dim; i++)
+	{
+		c = list[i];
+		lc_inf[c].delay = 0;
+		EGLPNUM_TYPENAME_EGlpNumCopy (v, work[c]);
+		EGLPNUM_TYPENAME_EGlpNumZero (work[c]);
+		if (!EGLPNUM_TYPENAME_EGlpNumIsNeqqZero (v))
+			continue;
+		x->indx[x->nzcnt] = c;
+		EGLPNUM_TYPENAME_EGlpNumCopy (x->coef[x->nzcnt], v);
+		x->nzcnt++;
+		c = lc_inf[c].crank;
+		nzcnt = lc_inf[c].nzcnt;
+		indx = f->lcindx + lc_inf[c].cbeg;
+		coef = f->lccoef + lc_inf[c].cbeg;
+		for (j = 0; j < nzcnt; j++)
 		{
-			rval = dense_factor (f);
-			if (rval == E_SINGULAR_INTERNAL)
-				return 0;
-			if (rval)
-				return rval;
-			break;
+			EGLPNUM_TYPENAME_EGlpNumSubInnProdTo (work[indx[j]], v, coef[j]);
 		}
-#ifdef FACTOR_DEBUG
-		MESSAGE (0,"pivot elem: %d %d", r, c);
-#endif /* FACTOR_DEBUG */
-		rval = elim (f, r, c);
-		CHECKRVALG (rval, CLEANUP);
+	}
+	EGLPNUM_TYPENAME_EGlpNumClearVar (v);
+}
 
-#ifdef TRACK_FACTOR
-#ifdef NOTICE_BLOWUP
-		EGLPNUM_TYPENAME_EGlpNumSet (tmpsize, f->maxmult);
-		EGLPNUM_TYPENAME_EGlpNumMultTo (tmpsize, f->maxelem_orig);
-		if (EGLPNUM_TYPENAME_EGlpNumIsLess (tmpsize, f->maxelem_factor) &&
-				EGLPNUM_TYPENAME_EGlpNumIsLess (f->partial_cur, EGLPNUM_TYPENAME_oneLpNum))
+static void ILLfactor_ftranl3 (
+	EGLPNUM_TYPENAME_factor_work * f,
+	EGLPNUM_TYPENAME_svector * a,
+	EGLPNUM_TYPENAME_svector * x)
+{
+	EGLPNUM_TYPE *work = f->work_coef;
+	int anzcnt = a->nzcnt;
+	int *aindx = a->indx;
+	EGLPNUM_TYPE *acoef = a->coef;
+	EGLPNUM_TYPENAME_lc_info *lc_inf = f->lc_inf;
+	int i;
+
+	if (hyper_solve (f, anzcnt, f->ftran_dens))
+	{
+		ILLfactor_ftranl_hyper (f, a, x);
+		return;
+	}
+	for (i = 0; i < anzcnt; i++)
+	{
+		if (lc_inf[aindx[i]].delay++ == 0)
 		{
-			return E_FACTOR_BLOWUP;
+			ftranl3_delay2 (f, aindx[i]);
 		}
-#endif /* NOTICE_BLOWUP */
-#endif /* TRACK_FACTOR */
-
-#ifdef FACTOR_DEBUG
-#if (FACTOR_DEBUG+0>3)
-		MESSAGE (0,"After pivot stage %d of %d", f->stage, f->nstages);
-		dump_matrix (f, 0);
-#endif
-#endif /* FACTOR_DEBUG */
+		EGLPNUM_TYPENAME_EGlpNumCopy (work[aindx[i]], acoef[i]);
+	}
+	x->nzcnt = 0;
+	for (i = 0; i < anzcnt; i++)
+	{
+		if (--lc_inf[aindx[i]].delay == 0)
+		{
+			ftranl3_process2 (f, aindx[i], x);
+		}
+	}
+#ifdef SOLVE_DEBUG
+	QSlog("EGLPNUM_TYPENAME_ILLfactor_ftran x after l3:");
+	for (i = 0; i < x->nzcnt; i++)
+	{
+		QSlog(" %.3f*%d", EGLPNUM_TYPENAME_EGlpNumToLf (x->coef[i]), x->indx[i]);
 	}
+#endif /* SOLVE_DEBUG */
+}
 
-	rval = build_iteration_u_data (f);
-	CHECKRVALG (rval, CLEANUP);
+static void ILLfactor_ftrane (
+	EGLPNUM_TYPENAME_factor_work * f,
+	EGLPNUM_TYPE * a)
+{
+	int *erindx = f->erindx;
+	EGLPNUM_TYPE *ercoef = f->ercoef;
+	EGLPNUM_TYPENAME_er_info *er_inf = f->er_inf;
+	int etacnt = f->etacnt;
+	int beg;
+	int nzcnt;
+	int i;
+	int j;
+	EGLPNUM_TYPE v;
 
-	rval = build_iteration_l_data (f);
-	CHECKRVALG (rval, CLEANUP);
+	EGLPNUM_TYPENAME_EGlpNumInitVar (v);
 
-#ifdef TRACK_FACTOR
-#ifdef NOTICE_BLOWUP
-	EGLPNUM_TYPENAME_EGlpNumSet (tmpsize, f->minmult);
-	EGLPNUM_TYPENAME_EGlpNumMultTo (tmpsize, f->maxelem_orig);
-	if (EGLPNUM_TYPENAME_EGlpNumIsLess (f->maxelem_factor, tmpsize) &&
-			EGLPNUM_TYPENAME_EGlpNumIsLess (f->partial_tol, f->partial_cur))
+	for (i = 0; i < etacnt; i++)
 	{
-		if (EGLPNUM_TYPENAME_EGlpNumIsGreaDbl (f->partial_cur, 0.5))
-		{
-			EGLPNUM_TYPENAME_EGlpNumSet (f->partial_cur, 0.5);
-		}
-		else if (EGLPNUM_TYPENAME_EGlpNumIsGreaDbl (f->partial_cur, 0.25))
-		{
-			EGLPNUM_TYPENAME_EGlpNumSet (f->partial_cur, 0.25);
-		}
-		else if (EGLPNUM_TYPENAME_EGlpNumIsGreaDbl (f->partial_cur, 0.1))
-		{
-			EGLPNUM_TYPENAME_EGlpNumSet (f->partial_cur, 0.1);
-		}
-		else
+		EGLPNUM_TYPENAME_EGlpNumCopy (v, a[er_inf[i].r]);
+		nzcnt = er_inf[i].nzcnt;
+		beg = er_inf[i].rbeg;
+		for (j = 0; j < nzcnt; j++)
 		{
-			EGLPNUM_TYPENAME_EGlpNumDivUiTo (f->partial_cur, 10);
+			EGLPNUM_TYPENAME_EGlpNumSubInnProdTo (v, ercoef[beg + j], a[erindx[beg + j]]);
 		}
-		if (EGLPNUM_TYPENAME_EGlpNumIsLess (f->partial_cur, f->partial_tol))
+		EGLPNUM_TYPENAME_EGlpNumCopy (a[er_inf[i].r], v);
+#ifdef SOLVE_DEBUG
+#if (SOLVE_DEBUG+0 > 1)
+		QSlog("EGLPNUM_TYPENAME_ILLfactor_ftran a after eta %d:", i);
+		for (j = 0; j < f->dim; j++)
 		{
-			EGLPNUM_TYPENAME_EGlpNumCopy (f->partial_cur, f->partial_tol);
+			QSlog(" %.3f", EGLPNUM_TYPENAME_EGlpNumToLf (a[j]));
 		}
-/*  Bico - comment out for dist 
-        QSlog("factor good, lowering partial tolerance to %.2f",
-                    f->partial_cur);
-*/
-	}
-#endif /* NOTICE_BLOWUP */
-#endif /* TRACK_FACTOR */
-
-#ifdef FACTOR_DEBUG
-	MESSAGE(0,"Factored matrix:");
-#if (FACTOR_DEBUG+0>1)
-	dump_matrix (f, 0);
-#endif
-#endif /* FACTOR_DEBUG */
-
-#ifdef FACTOR_STATS
-	QSlog("Factored matrix: ");
-	dump_factor_stats (f);
-#endif /* FACTOR_STATS */
-CLEANUP:
-#ifdef TRACK_FACTOR
-#ifdef NOTICE_BLOWUP
-	EGLPNUM_TYPENAME_EGlpNumClearVar (tmpsize);
 #endif
+#endif /* SOLVE_DEBUG */
+	}
+#ifdef SOLVE_DEBUG
+#if (SOLVE_DEBUG+0 <= 1)
+	QSlog("EGLPNUM_TYPENAME_ILLfactor_ftran a after eta:");
+	for (j = 0; j < f->dim; j++)
+	{
+		QSlog(" %.3f", EGLPNUM_TYPENAME_EGlpNumToLf (a[j]));
+	}
 #endif
-	EG_RETURN (rval);
+#endif /* SOLVE_DEBUG */
+	EGLPNUM_TYPENAME_EGlpNumClearVar (v);
 }
 
-int EGLPNUM_TYPENAME_ILLfactor (
+/* applies the row etas start..etacnt-1 to the sparse vector a, which must
+ * have room for f->dim entries */
+static void ILLfactor_ftrane2_from (
 	EGLPNUM_TYPENAME_factor_work * f,
-	int *basis,
-	int *cbeg,
-	int *clen,
-	int *cindx,
-	EGLPNUM_TYPE * ccoef,
-	int *p_nsing,
-	int **p_singr,
-	int **p_singc)
+	int start,
+	EGLPNUM_TYPENAME_svector * a)
 {
-	int rval;
+	int *erindx = f->erindx;
+	EGLPNUM_TYPE *ercoef = f->ercoef;
+	EGLPNUM_TYPENAME_er_info *er_inf = f->er_inf;
+	int etacnt = f->etacnt;
+	int beg;
+	int nzcnt;
+	int anzcnt = a->nzcnt;
+	int *aindx = a->indx;
+	EGLPNUM_TYPE *acoef = a->coef;
+	EGLPNUM_TYPE *work_coef = f->work_coef;
+	int *work_indx = f->work_indx;
+	int i;
+	int j;
+	int r;
+	EGLPNUM_TYPE v;
 
-	f->p_nsing = p_nsing;
-	f->p_singr = p_singr;
-	f->p_singc = p_singc;
-	*p_nsing = 0;
+	EGLPNUM_TYPENAME_EGlpNumInitVar (v);
 
-AGAIN:
-	rval = ILLfactor_try (f, basis, cbeg, clen, cindx, ccoef);
-	if (rval == E_FACTOR_BLOWUP)
+	for (i = 0; i < anzcnt; i++)
 	{
-		if (EGLPNUM_TYPENAME_EGlpNumIsLessDbl (f->partial_cur, 0.1))
+		EGLPNUM_TYPENAME_EGlpNumCopy (work_coef[aindx[i]], acoef[i]);
+		work_indx[aindx[i]] = i + 1;
+	}
+	for (i = start; i < etacnt; i++)
+	{
+		r = er_inf[i].r;
+		EGLPNUM_TYPENAME_EGlpNumCopy (v, work_coef[r]);
+		nzcnt = er_inf[i].nzcnt;
+		beg = er_inf[i].rbeg;
+		for (j = 0; j < nzcnt; j++)
 		{
-			EGLPNUM_TYPENAME_EGlpNumMultUiTo (f->partial_cur, 10);
+			EGLPNUM_TYPENAME_EGlpNumSubInnProdTo (v, ercoef[beg + j], work_coef[erindx[beg + j]]);
 		}
-		else if (EGLPNUM_TYPENAME_EGlpNumIsLessDbl (f->partial_cur, 0.25))
+		if (EGLPNUM_TYPENAME_EGlpNumIsNeqqZero (v))
 		{
-			EGLPNUM_TYPENAME_EGlpNumSet (f->partial_cur, 0.25);
+			EGLPNUM_TYPENAME_EGlpNumCopy (work_coef[r], v);
+			if (work_indx[r] == 0)
+			{
+				EGLPNUM_TYPENAME_EGlpNumCopy (acoef[anzcnt], v);
+				aindx[anzcnt] = r;
+				work_indx[r] = anzcnt + 1;
+				anzcnt++;
+			}
+			else
+			{
+				EGLPNUM_TYPENAME_EGlpNumCopy (acoef[work_indx[r] - 1], v);
+			}
 		}
-		else if (EGLPNUM_TYPENAME_EGlpNumIsLessDbl (f->partial_cur, 0.5))
+		else
 		{
-			EGLPNUM_TYPENAME_EGlpNumSet (f->partial_cur, 0.5);
+			EGLPNUM_TYPENAME_EGlpNumZero (work_coef[r]);
+			if (work_indx[r])
+			{
+				EGLPNUM_TYPENAME_EGlpNumZero (acoef[work_indx[r] - 1]);
+			}
 		}
-		else if (EGLPNUM_TYPENAME_EGlpNumIsLess (f->partial_cur, EGLPNUM_TYPENAME_oneLpNum))
+#ifdef SOLVE_DEBUG
+#if (SOLVE_DEBUG+0 > 1)
+		QSlog("EGLPNUM_TYPENAME_ILLfactor_ftran a after eta2 %d:", i);
+		for (j = 0; j < anzcnt; j++)
 		{
-			EGLPNUM_TYPENAME_EGlpNumOne (f->partial_cur);
+			QSlog(" %.3f*%d", EGLPNUM_TYPENAME_EGlpNumToLf (acoef[j]), aindx[j]);
+		}
+#endif
+#endif /* SOLVE_DEBUG */
+	}
+	i = 0;
+	while (i < anzcnt)
+	{
+		EGLPNUM_TYPENAME_EGlpNumZero (work_coef[aindx[i]]);
+		work_indx[aindx[i]] = 0;
+		if (EGLPNUM_TYPENAME_EGlpNumIsNeqZero (acoef[i], f->fzero_tol))
+		{
+			/*if (acoef[i] > fzero_tol || acoef[i] < -fzero_tol) */
+			i++;
 		}
 		else
 		{
-			EG_RETURN (rval);
+			--anzcnt;
+			EGLPNUM_TYPENAME_EGlpNumCopy (acoef[i], acoef[anzcnt]);
+			aindx[i] = aindx[anzcnt];
 		}
-/* Bico - comment out for dist
-        QSlog("factor blowup, changing partial tolerance to %.2f",
-                    f->partial_cur);
-*/
-		goto AGAIN;
 	}
-	EG_RETURN (rval);
+	a->nzcnt = anzcnt;
+
+#ifdef SOLVE_DEBUG
+#if (SOLVE_DEBUG+0 <= 1)
+	QSlog("EGLPNUM_TYPENAME_ILLfactor_ftran a after eta2:");
+	for (j = 0; j < anzcnt; j++)
+	{
+		QSlog(" %.3f*%d", EGLPNUM_TYPENAME_EGlpNumToLf (acoef[j]), aindx[j]);
+	}
+#endif
+#endif /* SOLVE_DEBUG */
+	EGLPNUM_TYPENAME_EGlpNumClearVar (v);
 }
 
-static void ILLfactor_ftranl (
+static void ILLfactor_ftrane2 (
 	EGLPNUM_TYPENAME_factor_work * f,
-	EGLPNUM_TYPE * a)
+	EGLPNUM_TYPENAME_svector * a)
 {
-	int *lcindx = f->lcindx;
-	EGLPNUM_TYPENAME_lc_info *lc_inf = f->lc_inf;
-	EGLPNUM_TYPE *lccoef = f->lccoef;
+	ILLfactor_ftrane2_from (f, 0, a);
+}
+
+static void ILLfactor_ftranu (
+	EGLPNUM_TYPENAME_factor_work * f,
+	EGLPNUM_TYPE * a,
+	EGLPNUM_TYPENAME_svector * x)
+{
+	int *ucindx = f->ucindx;
+	EGLPNUM_TYPE *uccoef = f->uccoef;
+	EGLPNUM_TYPENAME_uc_info *uc_inf = f->uc_inf;
+	int *cperm = f->cperm;
+	int *rperm = f->rperm;
 	int dim = f->dim;
-	int beg;
+	int xnzcnt = 0;
+	int *xindx = x->indx;
+	EGLPNUM_TYPE *xcoef = x->coef;
 	int nzcnt;
+	int beg;
 	int i;
 	int j;
 	EGLPNUM_TYPE v;
 
+#if SOLVE_SNAP
+	if (f->snap_u)
+	{
+		snap_solve_u (f, &f->uc_snap, a, x);
+		return;
+	}
+#endif
+
 	EGLPNUM_TYPENAME_EGlpNumInitVar (v);
 
-	for (i = 0; i < dim; i++)
+	for (i = dim - 1; i >= 0; i--)
 	{
-		EGLPNUM_TYPENAME_EGlpNumCopy (v, a[lc_inf[i].c]);
-		if (EGLPNUM_TYPENAME_EGlpNumIsNeqqZero (v))
+		EGLPNUM_TYPENAME_EGlpNumCopy (v, a[rperm[i]]);
+		if (EGLPNUM_TYPENAME_EGlpNumIsNeqqZero (v))	/*((v = a[rperm[i]]) != 0.0) */
 		{
-			nzcnt = lc_inf[i].nzcnt;
-			beg = lc_inf[i].cbeg;
-			for (j = 0; j < nzcnt; j++)
+			j = cperm[i];
+			beg = uc_inf[j].cbeg;
+			EGLPNUM_TYPENAME_EGlpNumDivTo (v, uccoef[beg]);
+			if (EGLPNUM_TYPENAME_EGlpNumIsNeqZero (v, f->szero_tol))
 			{
-				EGLPNUM_TYPENAME_EGlpNumSubInnProdTo (a[lcindx[beg + j]], v, lccoef[beg + j]);
+				/*if (v > szero_tol || v < -szero_tol) */
+				xindx[xnzcnt] = j;
+				EGLPNUM_TYPENAME_EGlpNumCopy (xcoef[xnzcnt], v);
+				xnzcnt++;
 			}
+			nzcnt = uc_inf[j].nzcnt;
+			for (j = 1; j < nzcnt; j++)
+			{
+				EGLPNUM_TYPENAME_EGlpNumSubInnProdTo (a[ucindx[beg + j]], v, uccoef[beg + j]);
+			}
+			EGLPNUM_TYPENAME_EGlpNumZero (a[rperm[i]]);
 		}
-#ifdef SOLVE_DEBUG
-#if (SOLVE_DEBUG+0 > 1)
-		QSlog("EGLPNUM_TYPENAME_ILLfactor_ftran a after l %d:", i);
-		for (j = 0; j < f->dim; j++)
-		{
-			QSlog(" %.3f", EGLPNUM_TYPENAME_EGlpNumToLf (a[j]));
-		}
-		MESSAGE(0," ");
-#endif
-#endif /* SOLVE_DEBUG */
 	}
+	x->nzcnt = xnzcnt;
 #ifdef SOLVE_DEBUG
-#if (SOLVE_DEBUG+0 <= 1)
-	QSlog("EGLPNUM_TYPENAME_ILLfactor_ftran a after l:");
-	for (j = 0; j < f->dim; j++)
+	QSlog("EGLPNUM_TYPENAME_ILLfactor_ftran x after u:");
+	for (j = 0; j < x->nzcnt; j++)
 	{
-		QSlog(" %.3f", EGLPNUM_TYPENAME_EGlpNumToLf (a[j]));
+		QSlog(" %.3f*%d", EGLPNUM_TYPENAME_EGlpNumToLf (x->coef[j]), x->indx[j]);
 	}
-#endif
 #endif /* SOLVE_DEBUG */
 	EGLPNUM_TYPENAME_EGlpNumClearVar (v);
 }
 
+
 #if 0
-static void ftranl3_delay (
+static void ftranu3_delay (
 	EGLPNUM_TYPENAME_factor_work * f,
 	int c)
 {
-	EGLPNUM_TYPENAME_lc_info *lc_inf = f->lc_inf;
+	EGLPNUM_TYPENAME_uc_info *uc_inf = f->uc_inf;
 	int nzcnt;
 	int *indx;
 	int i;
 
-	c = lc_inf[c].crank;
-	nzcnt = lc_inf[c].nzcnt;
-	indx = f->lcindx + lc_inf[c].cbeg;
-	for (i = 0; i < nzcnt; i++)
+	c = f->cperm[f->rrank[c]];
+	nzcnt = uc_inf[c].nzcnt;
+	indx = f->ucindx + uc_inf[c].cbeg;
+	for (i = 1; i < nzcnt; i++)
 	{
 		c = indx[i];
-		if (lc_inf[c].delay++ == 0)
+		if (uc_inf[c].delay++ == 0)
 		{
-			ftranl3_delay (f, c);
+			ftranu3_delay (f, c);
 		}
 	}
 }
 #endif
 
-static void ftranl3_delay2 (
+static void ftranu3_delay2 (
 	EGLPNUM_TYPENAME_factor_work * f,
 	int c)
 {
-	EGLPNUM_TYPENAME_lc_info *lc_inf = f->lc_inf;
+	EGLPNUM_TYPENAME_uc_info *uc_inf = f->uc_inf;
 	int nzcnt;
 	int *indx;
 	int i;
@@ -3088,18 +4940,18 @@ static void ftranl3_delay2 (
 
 	do
 	{
-		c = lc_inf[c].crank;
-		nzcnt = lc_inf[c].nzcnt;
-		indx = f->lcindx + lc_inf[c].cbeg;
+		c = f->cperm[f->rrank[c]];
+		nzcnt = uc_inf[c].nzcnt;
+		indx = f->ucindx + uc_inf[c].cbeg;
 		last = -1;
-		for (i = 0; i < nzcnt; i++)
+		for (i = 1; i < nzcnt; i++)
 		{
 			c = indx[i];
-			if (lc_inf[c].delay++ == 0)
+			if (uc_inf[c].delay++ == 0)
 			{
 				if (last >= 0)
 				{
-					ftranl3_delay2 (f, last);
+					ftranu3_delay2 (f, last);
 				}
 				last = c;
 			}
@@ -3109,52 +4961,54 @@ static void ftranl3_delay2 (
 }
 
 #if 0
-static void ftranl3_process (
+static void ftranu3_process (
 	EGLPNUM_TYPENAME_factor_work * f,
 	int c,
 	EGLPNUM_TYPENAME_svector * x)
 {
-	EGLPNUM_TYPENAME_lc_info *lc_inf = f->lc_inf;
+	EGLPNUM_TYPENAME_uc_info *uc_inf = f->uc_inf;
 	EGLPNUM_TYPE *work = f->work_coef;
 	int nzcnt;
 	int *indx;
-	int i;
 	EGLPNUM_TYPE *coef;
+	int i;
 	EGLPNUM_TYPE v;
 
 	EGLPNUM_TYPENAME_EGlpNumInitVar (v);
 
 	EGLPNUM_TYPENAME_EGlpNumCopy (v, work[c]);
 	EGLPNUM_TYPENAME_EGlpNumZero (work[c]);
-	if (EGLPNUM_TYPENAME_EGlpNumIsNeqqZero (v))
+	c = f->cperm[f->rrank[c]];
+	nzcnt = uc_inf[c].nzcnt;
+	indx = f->ucindx + uc_inf[c].cbeg;
+	coef = f->uccoef + uc_inf[c].cbeg;
+	EGLPNUM_TYPENAME_EGlpNumDivTo (v, coef[0]);
+	if (EGLPNUM_TYPENAME_EGlpNumIsNeqZero (v, f->szero_tol))
+		/*if (v > szero_tol || v < -szero_tol) */
 	{
 		x->indx[x->nzcnt] = c;
 		EGLPNUM_TYPENAME_EGlpNumCopy (x->coef[x->nzcnt], v);
 		x->nzcnt++;
 	}
-	c = lc_inf[c].crank;
-	nzcnt = lc_inf[c].nzcnt;
-	indx = f->lcindx + lc_inf[c].cbeg;
-	coef = f->lccoef + lc_inf[c].cbeg;
-	for (i = 0; i < nzcnt; i++)
+	for (i = 1; i < nzcnt; i++)
 	{
 		c = indx[i];
 		EGLPNUM_TYPENAME_EGlpNumSubInnProdTo (work[c], v, coef[i]);
-		if (--lc_inf[c].delay == 0)
+		if (--uc_inf[c].delay == 0)
 		{
-			ftranl3_process (f, c, x);
+			ftranu3_process (f, c, x);
 		}
 	}
 	EGLPNUM_TYPENAME_EGlpNumClearVar (v);
 }
 #endif
 
-static void ftranl3_process2 (
+static void ftranu3_process2 (
 	EGLPNUM_TYPENAME_factor_work * f,
 	int c,
 	EGLPNUM_TYPENAME_svector * x)
 {
-	EGLPNUM_TYPENAME_lc_info *lc_inf = f->lc_inf;
+	EGLPNUM_TYPENAME_uc_info *uc_inf = f->uc_inf;
 	EGLPNUM_TYPE *work = f->work_coef;
 	int nzcnt;
 	int *indx;
@@ -3169,26 +5023,28 @@ static void ftranl3_process2 (
 	{
 		EGLPNUM_TYPENAME_EGlpNumCopy (v, work[c]);
 		EGLPNUM_TYPENAME_EGlpNumZero (work[c]);
-		if (EGLPNUM_TYPENAME_EGlpNumIsNeqqZero (v))
+		c = f->cperm[f->rrank[c]];
+		nzcnt = uc_inf[c].nzcnt;
+		indx = f->ucindx + uc_inf[c].cbeg;
+		coef = f->uccoef + uc_inf[c].cbeg;
+		EGLPNUM_TYPENAME_EGlpNumDivTo (v, coef[0]);
+		if (EGLPNUM_TYPENAME_EGlpNumIsNeqZero (v, f->szero_tol))
+			/*if (v > szero_tol || v < -szero_tol) */
 		{
 			x->indx[x->nzcnt] = c;
 			EGLPNUM_TYPENAME_EGlpNumCopy (x->coef[x->nzcnt], v);
 			x->nzcnt++;
 		}
-		c = lc_inf[c].crank;
-		nzcnt = lc_inf[c].nzcnt;
-		indx = f->lcindx + lc_inf[c].cbeg;
-		coef = f->lccoef + lc_inf[c].cbeg;
 		last = -1;
-		for (i = 0; i < nzcnt; i++)
+		for (i = 1; i < nzcnt; i++)
 		{
 			c = indx[i];
 			EGLPNUM_TYPENAME_EGlpNumSubInnProdTo (work[c], v, coef[i]);
-			if (--lc_inf[c].delay == 0)
+			if (--uc_inf[c].delay == 0)
 			{
 				if (last >= 0)
 				{
-					ftranl3_process2 (f, last, x);
+					ftranu3_process2 (f, last, x);
 				}
 				last = c;
 			}
@@ -3198,7 +5054,59 @@ static void ftranl3_process2 (
 	EGLPNUM_TYPENAME_EGlpNumClearVar (v);
 }
 
-static void ILLfactor_ftranl3 (
+/* hypersparse version of ILLfactor_ftranu3 */
+static void ILLfactor_ftranu_hyper (
+	EGLPNUM_TYPENAME_factor_work * f,
+	EGLPNUM_TYPENAME_svector * a,
+	EGLPNUM_TYPENAME_svector * x)
+{
+	EGLPNUM_TYPE *work = f->work_coef;
+	EGLPNUM_TYPENAME_uc_info *uc_inf = f->uc_inf;
+	int *list = f->reach_list;
+	int dim = f->dim;
+	int nzcnt;
+	int *indx;
+	EGLPNUM_TYPE *coef;
+	int i;
+	int j;
+	int c;
+	EGLPNUM_TYPE v;
+
+	EGLPNUM_TYPENAME_EGlpNumInitVar (v);
+
+	for (i = 0; i < a->nzcnt; i++)
+	{
+		EGLPNUM_TYPENAME_EGlpNumCopy (work[a->indx[i]], a->coef[i]);
+	}
+	x->nzcnt = 0;
+	for (i = hyper_reach (f, REACH_FTRANU, a); i < dim; i++)
+	{
+		c = list[i];
+		uc_inf[c].delay = 0;
+		EGLPNUM_TYPENAME_EGlpNumCopy (v, work[c]);
+		EGLPNUM_TYPENAME_EGlpNumZero (work[c]);
+		if (!EGLPNUM_TYPENAME_EGlpNumIsNeqqZero (v))
+			continue;
+		c = f->cperm[f->rrank[c]];
+		nzcnt = uc_inf[c].nzcnt;
+		indx = f->ucindx + uc_inf[c].cbeg;
+		coef = f->uccoef + uc_inf[c].cbeg;
+		EGLPNUM_TYPENAME_EGlpNumDivTo (v, coef[0]);
+		if (EGLPNUM_TYPENAME_EGlpNumIsNeqZero (v, f->szero_tol))
+		{
+			x->indx[x->nzcnt] = c;
+			EGLPNUM_TYPENAME_EGlpNumCopy (x->coef[x->nzcnt], v);
+			x->nzcnt++;
+		}
+		for (j = 1; j < nzcnt; j++)
+		{
+			EGLPNUM_TYPENAME_EGlpNumSubInnProdTo (work[indx[j]], v, coef[j]);
+		}
+	}
+	EGLPNUM_TYPENAME_EGlpNumClearVar (v);
+}
+
+static void ILLfactor_ftranu3 (
 	EGLPNUM_TYPENAME_factor_work * f,
 	EGLPNUM_TYPENAME_svector * a,
 	EGLPNUM_TYPENAME_svector * x)
@@ -3207,27 +5115,32 @@ static void ILLfactor_ftranl3 (
 	int anzcnt = a->nzcnt;
 	int *aindx = a->indx;
 	EGLPNUM_TYPE *acoef = a->coef;
-	EGLPNUM_TYPENAME_lc_info *lc_inf = f->lc_inf;
+	EGLPNUM_TYPENAME_uc_info *uc_inf = f->uc_inf;
 	int i;
 
+	if (hyper_solve (f, anzcnt, f->ftran_dens))
+	{
+		ILLfactor_ftranu_hyper (f, a, x);
+		return;
+	}
 	for (i = 0; i < anzcnt; i++)
 	{
-		if (lc_inf[aindx[i]].delay++ == 0)
+		if (uc_inf[aindx[i]].delay++ == 0)
 		{
-			ftranl3_delay2 (f, aindx[i]);
+			ftranu3_delay2 (f, aindx[i]);
 		}
 		EGLPNUM_TYPENAME_EGlpNumCopy (work[aindx[i]], acoef[i]);
 	}
 	x->nzcnt = 0;
 	for (i = 0; i < anzcnt; i++)
 	{
-		if (--lc_inf[aindx[i]].delay == 0)
+		if (--uc_inf[aindx[i]].delay == 0)
 		{
-			ftranl3_process2 (f, aindx[i], x);
+			ftranu3_process2 (f, aindx[i], x);
 		}
 	}
 #ifdef SOLVE_DEBUG
-	QSlog("EGLPNUM_TYPENAME_ILLfactor_ftran x after l3:");
+	QSlog("EGLPNUM_TYPENAME_ILLfactor_ftran x after u3:");
 	for (i = 0; i < x->nzcnt; i++)
 	{
 		QSlog(" %.3f*%d", EGLPNUM_TYPENAME_EGlpNumToLf (x->coef[i]), x->indx[i]);
@@ -3235,593 +5148,682 @@ static void ILLfactor_ftranl3 (
 #endif /* SOLVE_DEBUG */
 }
 
-static void ILLfactor_ftrane (
+/* EGLPNUM_TYPENAME_ILLfactor_ftran solves Bx=a for x */
+void EGLPNUM_TYPENAME_ILLfactor_ftran (
 	EGLPNUM_TYPENAME_factor_work * f,
-	EGLPNUM_TYPE * a)
+	EGLPNUM_TYPENAME_svector * a,
+	EGLPNUM_TYPENAME_svector * x)
 {
-	int *erindx = f->erindx;
-	EGLPNUM_TYPE *ercoef = f->ercoef;
-	EGLPNUM_TYPENAME_er_info *er_inf = f->er_inf;
-	int etacnt = f->etacnt;
-	int beg;
-	int nzcnt;
 	int i;
-	int j;
-	EGLPNUM_TYPE v;
-
-	EGLPNUM_TYPENAME_EGlpNumInitVar (v);
+	int nzcnt;
+	int sparse;
+	int *aindx;
+	EGLPNUM_TYPE *acoef;
+	EGLPNUM_TYPE *work_coef = f->work_coef;
 
-	for (i = 0; i < etacnt; i++)
+#ifdef RECORD
 	{
-		EGLPNUM_TYPENAME_EGlpNumCopy (v, a[er_inf[i].r]);
-		nzcnt = er_inf[i].nzcnt;
-		beg = er_inf[i].rbeg;
-		for (j = 0; j < nzcnt; j++)
-		{
-			EGLPNUM_TYPENAME_EGlpNumSubInnProdTo (v, ercoef[beg + j], a[erindx[beg + j]]);
-		}
-		EGLPNUM_TYPENAME_EGlpNumCopy (a[er_inf[i].r], v);
-#ifdef SOLVE_DEBUG
-#if (SOLVE_DEBUG+0 > 1)
-		QSlog("EGLPNUM_TYPENAME_ILLfactor_ftran a after eta %d:", i);
-		for (j = 0; j < f->dim; j++)
+		EGioPrintf (fsave, "f %d", a->nzcnt);
+		for (i = 0; i < a->nzcnt; i++)
 		{
-			QSlog(" %.3f", EGLPNUM_TYPENAME_EGlpNumToLf (a[j]));
+			EGioPrintf (fsave, " %d %.16e", a->indx[i], EGLPNUM_TYPENAME_EGlpNumToLf (a->coef[i]));
 		}
-#endif
-#endif /* SOLVE_DEBUG */
+		EGioPrintf (fsave, "\n");
+		EGioFlush (fsave);
 	}
-#ifdef SOLVE_DEBUG
-#if (SOLVE_DEBUG+0 <= 1)
-	QSlog("EGLPNUM_TYPENAME_ILLfactor_ftran a after eta:");
-	for (j = 0; j < f->dim; j++)
+#endif /* RECORD */
+#ifdef DEBUG_FACTOR
 	{
-		QSlog(" %.3f", EGLPNUM_TYPENAME_EGlpNumToLf (a[j]));
+		QSlog("EGLPNUM_TYPENAME_ILLfactor_ftran a:");
+		for (i = 0; i < a->nzcnt; i++)
+		{
+			QSlog(" %d %la", a->indx[i], EGLPNUM_TYPENAME_EGlpNumToLf (a->coef[i]));
+		}
 	}
-#endif
-#endif /* SOLVE_DEBUG */
-	EGLPNUM_TYPENAME_EGlpNumClearVar (v);
-}
-
-static void ILLfactor_ftrane2 (
-	EGLPNUM_TYPENAME_factor_work * f,
-	EGLPNUM_TYPENAME_svector * a)
-{
-	int *erindx = f->erindx;
-	EGLPNUM_TYPE *ercoef = f->ercoef;
-	EGLPNUM_TYPENAME_er_info *er_inf = f->er_inf;
-	int etacnt = f->etacnt;
-	int beg;
-	int nzcnt;
-	int anzcnt = a->nzcnt;
-	int *aindx = a->indx;
-	EGLPNUM_TYPE *acoef = a->coef;
-	EGLPNUM_TYPE *work_coef = f->work_coef;
-	int *work_indx = f->work_indx;
-	int i;
-	int j;
-	int r;
-	EGLPNUM_TYPE v;
-
-	EGLPNUM_TYPENAME_EGlpNumInitVar (v);
+#endif /* DEBUG_FACTOR */
 
-	for (i = 0; i < anzcnt; i++)
-	{
-		EGLPNUM_TYPENAME_EGlpNumCopy (work_coef[aindx[i]], acoef[i]);
-		work_indx[aindx[i]] = i + 1;
-	}
-	for (i = 0; i < etacnt; i++)
+	if (a->nzcnt >= SPARSE_FACTOR * f->dim)
 	{
-		r = er_inf[i].r;
-		EGLPNUM_TYPENAME_EGlpNumCopy (v, work_coef[r]);
-		nzcnt = er_inf[i].nzcnt;
-		beg = er_inf[i].rbeg;
-		for (j = 0; j < nzcnt; j++)
+		nzcnt = a->nzcnt;
+		aindx = a->indx;
+		acoef = a->coef;
+		for (i = 0; i < nzcnt; i++)
 		{
-			EGLPNUM_TYPENAME_EGlpNumSubInnProdTo (v, ercoef[beg + j], work_coef[erindx[beg + j]]);
+			EGLPNUM_TYPENAME_EGlpNumCopy (work_coef[aindx[i]], acoef[i]);
 		}
-		if (EGLPNUM_TYPENAME_EGlpNumIsNeqqZero (v))
+		sparse = 0;
+	}
+	else
+	{
+		sparse = 1;
+	}
+
+	if (sparse)
+	{
+		ILLfactor_ftranl3 (f, a, &f->xtmp);
+		if (f->xtmp.nzcnt >= SPARSE_FACTOR * f->dim)
 		{
-			EGLPNUM_TYPENAME_EGlpNumCopy (work_coef[r], v);
-			if (work_indx[r] == 0)
-			{
-				EGLPNUM_TYPENAME_EGlpNumCopy (acoef[anzcnt], v);
-				aindx[anzcnt] = r;
-				work_indx[r] = anzcnt + 1;
-				anzcnt++;
-			}
-			else
+			nzcnt = f->xtmp.nzcnt;
+			aindx = f->xtmp.indx;
+			acoef = f->xtmp.coef;
+
+			for (i = 0; i < nzcnt; i++)
 			{
-				EGLPNUM_TYPENAME_EGlpNumCopy (acoef[work_indx[r] - 1], v);
+				EGLPNUM_TYPENAME_EGlpNumCopy (work_coef[aindx[i]], acoef[i]);
 			}
+			sparse = 0;
 		}
-		else
+	}
+	else
+	{
+		ILLfactor_ftranl (f, work_coef);
+	}
+
+	if (sparse)
+	{
+		ILLfactor_ftrane2 (f, &f->xtmp);
+		if (f->xtmp.nzcnt >= SPARSE_FACTOR * f->dim)
 		{
-			EGLPNUM_TYPENAME_EGlpNumZero (work_coef[r]);
-			if (work_indx[r])
+			nzcnt = f->xtmp.nzcnt;
+			aindx = f->xtmp.indx;
+			acoef = f->xtmp.coef;
+
+			for (i = 0; i < nzcnt; i++)
 			{
-				EGLPNUM_TYPENAME_EGlpNumZero (acoef[work_indx[r] - 1]);
+				EGLPNUM_TYPENAME_EGlpNumCopy (work_coef[aindx[i]], acoef[i]);
 			}
+			sparse = 0;
 		}
-#ifdef SOLVE_DEBUG
-#if (SOLVE_DEBUG+0 > 1)
-		QSlog("EGLPNUM_TYPENAME_ILLfactor_ftran a after eta2 %d:", i);
-		for (j = 0; j < anzcnt; j++)
-		{
-			QSlog(" %.3f*%d", EGLPNUM_TYPENAME_EGlpNumToLf (acoef[j]), aindx[j]);
-		}
-#endif
-#endif /* SOLVE_DEBUG */
 	}
-	i = 0;
-	while (i < anzcnt)
+	else
 	{
-		EGLPNUM_TYPENAME_EGlpNumZero (work_coef[aindx[i]]);
-		work_indx[aindx[i]] = 0;
-		if (EGLPNUM_TYPENAME_EGlpNumIsNeqZero (acoef[i], f->fzero_tol))
-		{
-			/*if (acoef[i] > fzero_tol || acoef[i] < -fzero_tol) */
-			i++;
-		}
-		else
-		{
-			--anzcnt;
-			EGLPNUM_TYPENAME_EGlpNumCopy (acoef[i], acoef[anzcnt]);
-			aindx[i] = aindx[anzcnt];
-		}
+		ILLfactor_ftrane (f, work_coef);
 	}
-	a->nzcnt = anzcnt;
 
-#ifdef SOLVE_DEBUG
-#if (SOLVE_DEBUG+0 <= 1)
-	QSlog("EGLPNUM_TYPENAME_ILLfactor_ftran a after eta2:");
-	for (j = 0; j < anzcnt; j++)
+	if (sparse)
 	{
-		QSlog(" %.3f*%d", EGLPNUM_TYPENAME_EGlpNumToLf (acoef[j]), aindx[j]);
+		ILLfactor_ftranu3 (f, &f->xtmp, x);
+	}
+	else
+	{
+		ILLfactor_ftranu (f, work_coef, x);
 	}
+
+	f->ftran_dens = hyper_density (f, f->ftran_dens, x->nzcnt);
+
+#ifdef SORT_RESULTS
+	sort_vector (x);
 #endif
-#endif /* SOLVE_DEBUG */
-	EGLPNUM_TYPENAME_EGlpNumClearVar (v);
+
+#ifdef DEBUG_FACTOR
+	{
+		QSlog("EGLPNUM_TYPENAME_ILLfactor_ftran x:");
+		for (i = 0; i < x->nzcnt; i++)
+		{
+			QSlog(" %d %la", x->indx[i], EGLPNUM_TYPENAME_EGlpNumToLf (x->coef[i]));
+		}
+	}
+#endif /* DEBUG_FACTOR */
+	return;
 }
 
-static void ILLfactor_ftranu (
+int EGLPNUM_TYPENAME_compute_spike (
+    EGLPNUM_TYPENAME_factor_work * f,
+    EGLPNUM_TYPENAME_svector * a,
+    EGLPNUM_TYPENAME_svector * spike)
+{
+    int i;
+    int nzcnt;
+    int sparse;
+    int *aindx;
+    EGLPNUM_TYPE *acoef;
+    EGLPNUM_TYPE *work_coef = f->work_coef;
+
+    // Determine if we should use sparse or dense methods
+    if (a->nzcnt >= SPARSE_FACTOR * f->dim)
+    {
+        // Dense case: copy input to work array
+        aindx = a->indx;
+        acoef = a->coef;
+        nzcnt = a->nzcnt;
+        for (i = 0; i < nzcnt; i++)
+        {
+            EGLPNUM_TYPENAME_EGlpNumCopy(work_coef[aindx[i]], acoef[i]);
+        }
+        sparse = 0;
+    }
+    else
+    {
+        sparse = 1;
+    }
+
+    // Apply L^{-1}
+    if (sparse)
+    {
+        ILLfactor_ftranl3(f, a, spike);  // Note: spike, not &spike
+        // Check if result became dense
+        if (spike->nzcnt >= SPARSE_FACTOR * f->dim)
+        {
+            nzcnt = spike->nzcnt;
+            aindx = spike->indx;
+            acoef = spike->coef;
+            for (i = 0; i < nzcnt; i++)
+            {
+                EGLPNUM_TYPENAME_EGlpNumCopy(work_coef[aindx[i]], acoef[i]);
+            }
+            sparse = 0;
+        }
+    }
+    else
+    {
+        ILLfactor_ftranl(f, work_coef);
+    }
+
+    // Apply E^{-1} (eta factors)
+    if (sparse)
+    {
+        ILLfactor_ftrane2(f, spike);
+    }
+    else
+    {
+        ILLfactor_ftrane(f, work_coef);
+        // Convert dense result back to sparse
+        nzcnt = 0;
+        aindx = spike->indx;
+        acoef = spike->coef;
+        for (i = 0; i < f->dim; i++)
+        {
+            if (EGLPNUM_TYPENAME_EGlpNumIsNeqZero(work_coef[i], f->szero_tol))
+            {
+                aindx[nzcnt] = i;
+                EGLPNUM_TYPENAME_EGlpNumCopy(acoef[nzcnt], work_coef[i]);
+                nzcnt++;
+            }
+            EGLPNUM_TYPENAME_EGlpNumZero(work_coef[i]); // Clean up
+        }
+        spike->nzcnt = nzcnt;
+    }
+	return 0;
+}
+
+/* EGLPNUM_TYPENAME_ILLfactor_spike_block computes the spikes of k columns at
+ * once, i.e. what EGLPNUM_TYPENAME_compute_spike returns for each of them.
+ * The columns are scattered into a dense row-major block, so that a single
+ * pass over L and over the eta file serves every column of the block; the
+ * block holds at most SPIKE_BLOCK_ENTRIES numbers. Each spike is allocated
+ * to its exact size and must be released with EGLPNUM_TYPENAME_ILLsvector_free,
+ * also when an error is returned. */
+int EGLPNUM_TYPENAME_ILLfactor_spike_block (
 	EGLPNUM_TYPENAME_factor_work * f,
-	EGLPNUM_TYPE * a,
-	EGLPNUM_TYPENAME_svector * x)
+	int k,
+	EGLPNUM_TYPENAME_svector * a,
+	EGLPNUM_TYPENAME_svector * spike)
 {
-	int *ucindx = f->ucindx;
-	EGLPNUM_TYPE *uccoef = f->uccoef;
-	EGLPNUM_TYPENAME_uc_info *uc_inf = f->uc_inf;
-	int *cperm = f->cperm;
-	int *rperm = f->rperm;
+	int *lcindx = f->lcindx;
+	EGLPNUM_TYPENAME_lc_info *lc_inf = f->lc_inf;
+	EGLPNUM_TYPE *lccoef = f->lccoef;
+	int *erindx = f->erindx;
+	EGLPNUM_TYPE *ercoef = f->ercoef;
+	EGLPNUM_TYPENAME_er_info *er_inf = f->er_inf;
+	int etacnt = f->etacnt;
 	int dim = f->dim;
-	int xnzcnt = 0;
-	int *xindx = x->indx;
-	EGLPNUM_TYPE *xcoef = x->coef;
-	int nzcnt;
-	int beg;
-	int i;
-	int j;
+	int kb = dim ? SPIKE_BLOCK_ENTRIES / dim : k;
+	int b, nb, i, j, l, r, beg, nzcnt, cnt;
+	int rval = 0;
+	EGLPNUM_TYPE *blk = 0;
 	EGLPNUM_TYPE v;
 
+	for (j = 0; j < k; j++)
+		EGLPNUM_TYPENAME_ILLsvector_init (spike + j);
+	if (k == 0 || dim == 0)
+		return 0;
+	if (kb < 1)
+		kb = 1;
+	if (kb > k)
+		kb = k;
+
 	EGLPNUM_TYPENAME_EGlpNumInitVar (v);
+	blk = EGLPNUM_TYPENAME_EGlpNumAllocArray (kb * dim);
+	for (i = 0; i < kb * dim; i++)
+		EGLPNUM_TYPENAME_EGlpNumZero (blk[i]);
 
-	for (i = dim - 1; i >= 0; i--)
+	for (b = 0; b < k; b += kb)
 	{
-		EGLPNUM_TYPENAME_EGlpNumCopy (v, a[rperm[i]]);
-		if (EGLPNUM_TYPENAME_EGlpNumIsNeqqZero (v))	/*((v = a[rperm[i]]) != 0.0) */
+		nb = (k - b < kb) ? k - b : kb;
+		for (j = 0; j < nb; j++)
 		{
-			j = cperm[i];
-			beg = uc_inf[j].cbeg;
-			EGLPNUM_TYPENAME_EGlpNumDivTo (v, uccoef[beg]);
-			if (EGLPNUM_TYPENAME_EGlpNumIsNeqZero (v, f->szero_tol))
-			{
-				/*if (v > szero_tol || v < -szero_tol) */
-				xindx[xnzcnt] = j;
-				EGLPNUM_TYPENAME_EGlpNumCopy (xcoef[xnzcnt], v);
-				xnzcnt++;
-			}
-			nzcnt = uc_inf[j].nzcnt;
-			for (j = 1; j < nzcnt; j++)
+			for (l = 0; l < a[b + j].nzcnt; l++)
 			{
-				EGLPNUM_TYPENAME_EGlpNumSubInnProdTo (a[ucindx[beg + j]], v, uccoef[beg + j]);
+				EGLPNUM_TYPENAME_EGlpNumCopy (blk[a[b + j].indx[l] * nb + j],
+																			a[b + j].coef[l]);
 			}
-			EGLPNUM_TYPENAME_EGlpNumZero (a[rperm[i]]);
 		}
-	}
-	x->nzcnt = xnzcnt;
-#ifdef SOLVE_DEBUG
-	QSlog("EGLPNUM_TYPENAME_ILLfactor_ftran x after u:");
-	for (j = 0; j < x->nzcnt; j++)
-	{
-		QSlog(" %.3f*%d", EGLPNUM_TYPENAME_EGlpNumToLf (x->coef[j]), x->indx[j]);
-	}
-#endif /* SOLVE_DEBUG */
-	EGLPNUM_TYPENAME_EGlpNumClearVar (v);
-}
 
+		/* L^{-1}, as in ILLfactor_ftranl */
+		for (i = 0; i < dim; i++)
+		{
+			nzcnt = lc_inf[i].nzcnt;
+			if (nzcnt == 0)
+				continue;
+			beg = lc_inf[i].cbeg;
+			r = lc_inf[i].c * nb;
+			for (j = 0; j < nb; j++)
+			{
+				if (EGLPNUM_TYPENAME_EGlpNumIsNeqqZero (blk[r + j]))
+				{
+					for (l = 0; l < nzcnt; l++)
+					{
+						EGLPNUM_TYPENAME_EGlpNumSubInnProdTo (blk[lcindx[beg + l] * nb + j],
+																									blk[r + j], lccoef[beg + l]);
+					}
+				}
+			}
+		}
 
-#if 0
-static void ftranu3_delay (
-	EGLPNUM_TYPENAME_factor_work * f,
-	int c)
-{
-	EGLPNUM_TYPENAME_uc_info *uc_inf = f->uc_inf;
-	int nzcnt;
-	int *indx;
-	int i;
-
-	c = f->cperm[f->rrank[c]];
-	nzcnt = uc_inf[c].nzcnt;
-	indx = f->ucindx + uc_inf[c].cbeg;
-	for (i = 1; i < nzcnt; i++)
-	{
-		c = indx[i];
-		if (uc_inf[c].delay++ == 0)
+		/* row etas, as in ILLfactor_ftrane */
+		for (i = 0; i < etacnt; i++)
 		{
-			ftranu3_delay (f, c);
+			nzcnt = er_inf[i].nzcnt;
+			beg = er_inf[i].rbeg;
+			r = er_inf[i].r * nb;
+			for (j = 0; j < nb; j++)
+			{
+				EGLPNUM_TYPENAME_EGlpNumCopy (v, blk[r + j]);
+				for (l = 0; l < nzcnt; l++)
+				{
+					EGLPNUM_TYPENAME_EGlpNumSubInnProdTo (v, ercoef[beg + l],
+																								blk[erindx[beg + l] * nb + j]);
+				}
+				EGLPNUM_TYPENAME_EGlpNumCopy (blk[r + j], v);
+			}
 		}
-	}
-}
-#endif
-
-static void ftranu3_delay2 (
-	EGLPNUM_TYPENAME_factor_work * f,
-	int c)
-{
-	EGLPNUM_TYPENAME_uc_info *uc_inf = f->uc_inf;
-	int nzcnt;
-	int *indx;
-	int i;
-	int last;
 
-	do
-	{
-		c = f->cperm[f->rrank[c]];
-		nzcnt = uc_inf[c].nzcnt;
-		indx = f->ucindx + uc_inf[c].cbeg;
-		last = -1;
-		for (i = 1; i < nzcnt; i++)
+		/* gather the spikes and clear the block */
+		for (j = 0; j < nb; j++)
 		{
-			c = indx[i];
-			if (uc_inf[c].delay++ == 0)
+			cnt = 0;
+			for (i = 0; i < dim; i++)
 			{
-				if (last >= 0)
+				if (EGLPNUM_TYPENAME_EGlpNumIsNeqZero (blk[i * nb + j], f->fzero_tol))
+					cnt++;
+			}
+			rval = EGLPNUM_TYPENAME_ILLsvector_alloc (spike + b + j, cnt);
+			CHECKRVALG (rval, CLEANUP);
+			cnt = 0;
+			for (i = 0; i < dim; i++)
+			{
+				if (EGLPNUM_TYPENAME_EGlpNumIsNeqZero (blk[i * nb + j], f->fzero_tol))
 				{
-					ftranu3_delay2 (f, last);
+					spike[b + j].indx[cnt] = i;
+					EGLPNUM_TYPENAME_EGlpNumCopy (spike[b + j].coef[cnt], blk[i * nb + j]);
+					cnt++;
 				}
-				last = c;
+				EGLPNUM_TYPENAME_EGlpNumZero (blk[i * nb + j]);
 			}
 		}
-		c = last;
-	} while (c >= 0);
+	}
+
+CLEANUP:
+	EGLPNUM_TYPENAME_EGlpNumFreeArray (blk);
+	EGLPNUM_TYPENAME_EGlpNumClearVar (v);
+	EG_RETURN (rval);
 }
 
-#if 0
-static void ftranu3_process (
+/* EGLPNUM_TYPENAME_ILLfactor_spike_refresh brings a spike computed when the
+ * factorization had start row etas up to date, by applying the etas added
+ * since then. spike must have room for f->dim entries. */
+void EGLPNUM_TYPENAME_ILLfactor_spike_refresh (
 	EGLPNUM_TYPENAME_factor_work * f,
-	int c,
-	EGLPNUM_TYPENAME_svector * x)
+	int start,
+	EGLPNUM_TYPENAME_svector * spike)
 {
-	EGLPNUM_TYPENAME_uc_info *uc_inf = f->uc_inf;
-	EGLPNUM_TYPE *work = f->work_coef;
-	int nzcnt;
-	int *indx;
-	EGLPNUM_TYPE *coef;
-	int i;
-	EGLPNUM_TYPE v;
+	if (start < f->etacnt)
+		ILLfactor_ftrane2_from (f, start, spike);
+}
 
-	EGLPNUM_TYPENAME_EGlpNumInitVar (v);
+/* whether any of the nb interleaved entries at row is nonzero */
+static inline int multi_live (
+	EGLPNUM_TYPE * row,
+	int nb)
+{
+	int j;
 
-	EGLPNUM_TYPENAME_EGlpNumCopy (v, work[c]);
-	EGLPNUM_TYPENAME_EGlpNumZero (work[c]);
-	c = f->cperm[f->rrank[c]];
-	nzcnt = uc_inf[c].nzcnt;
-	indx = f->ucindx + uc_inf[c].cbeg;
-	coef = f->uccoef + uc_inf[c].cbeg;
-	EGLPNUM_TYPENAME_EGlpNumDivTo (v, coef[0]);
-	if (EGLPNUM_TYPENAME_EGlpNumIsNeqZero (v, f->szero_tol))
-		/*if (v > szero_tol || v < -szero_tol) */
-	{
-		x->indx[x->nzcnt] = c;
-		EGLPNUM_TYPENAME_EGlpNumCopy (x->coef[x->nzcnt], v);
-		x->nzcnt++;
-	}
-	for (i = 1; i < nzcnt; i++)
+	for (j = 0; j < nb; j++)
 	{
-		c = indx[i];
-		EGLPNUM_TYPENAME_EGlpNumSubInnProdTo (work[c], v, coef[i]);
-		if (--uc_inf[c].delay == 0)
-		{
-			ftranu3_process (f, c, x);
-		}
+		if (EGLPNUM_TYPENAME_EGlpNumIsNeqqZero (row[j]))
+			return 1;
 	}
-	EGLPNUM_TYPENAME_EGlpNumClearVar (v);
+	return 0;
 }
-#endif
 
-static void ftranu3_process2 (
+/* the number of the k right hand sides that fit in one dense block */
+static inline int multi_block (
 	EGLPNUM_TYPENAME_factor_work * f,
-	int c,
+	int k)
+{
+	int kb = f->dim ? SPIKE_BLOCK_ENTRIES / f->dim : k;
+
+	if (kb < 1)
+		kb = 1;
+	if (kb > k)
+		kb = k;
+	return kb;
+}
+
+/* EGLPNUM_TYPENAME_ILLfactor_multi_width returns how many of k right hand
+ * sides EGLPNUM_TYPENAME_ILLfactor_ftran_multi (or, if btran is nonzero,
+ * EGLPNUM_TYPENAME_ILLfactor_btran_multi) would solve together right now,
+ * 1 when they would go one at a time. */
+int EGLPNUM_TYPENAME_ILLfactor_multi_width (
+	EGLPNUM_TYPENAME_factor_work * f,
+	int k,
+	int btran)
+{
+	if (k < 1)
+		return k;
+	if ((btran ? f->btran_dens : f->ftran_dens) < SPARSE_FACTOR)
+		return 1;
+	return multi_block (f, k);
+}
+
+/* EGLPNUM_TYPENAME_ILLfactor_ftran_multi solves Bx[j]=a[j] for the k right
+ * hand sides a[0..k-1]. The vectors are interleaved in a dense row-major
+ * block, so that L, the eta file and U are streamed once per block instead
+ * of once per vector; the block holds at most SPIKE_BLOCK_ENTRIES numbers.
+ * When recent results have been sparse the vectors go one at a time through
+ * EGLPNUM_TYPENAME_ILLfactor_ftran, whose sparse paths are cheaper then.
+ * Each x[j] must have room for f->dim entries. */
+void EGLPNUM_TYPENAME_ILLfactor_ftran_multi (
+	EGLPNUM_TYPENAME_factor_work * f,
+	int k,
+	EGLPNUM_TYPENAME_svector * a,
 	EGLPNUM_TYPENAME_svector * x)
 {
+	int *lcindx = f->lcindx;
+	EGLPNUM_TYPENAME_lc_info *lc_inf = f->lc_inf;
+	EGLPNUM_TYPE *lccoef = f->lccoef;
+	int *erindx = f->erindx;
+	EGLPNUM_TYPE *ercoef = f->ercoef;
+	EGLPNUM_TYPENAME_er_info *er_inf = f->er_inf;
+	int *ucindx = f->ucindx;
+	EGLPNUM_TYPE *uccoef = f->uccoef;
 	EGLPNUM_TYPENAME_uc_info *uc_inf = f->uc_inf;
-	EGLPNUM_TYPE *work = f->work_coef;
-	int nzcnt;
-	int *indx;
-	EGLPNUM_TYPE *coef;
-	int i;
-	int last;
-	EGLPNUM_TYPE v;
-
-	EGLPNUM_TYPENAME_EGlpNumInitVar (v);
+	int etacnt = f->etacnt;
+	int dim = f->dim;
+	int kb = multi_block (f, k);
+	int b, nb, i, j, l, r, c, beg, nzcnt;
+	EGLPNUM_TYPE *blk = 0;
+	EGLPNUM_TYPE *v = 0;
 
-	do
+	for (b = 0; b < k; b += nb)
 	{
-		EGLPNUM_TYPENAME_EGlpNumCopy (v, work[c]);
-		EGLPNUM_TYPENAME_EGlpNumZero (work[c]);
-		c = f->cperm[f->rrank[c]];
-		nzcnt = uc_inf[c].nzcnt;
-		indx = f->ucindx + uc_inf[c].cbeg;
-		coef = f->uccoef + uc_inf[c].cbeg;
-		EGLPNUM_TYPENAME_EGlpNumDivTo (v, coef[0]);
-		if (EGLPNUM_TYPENAME_EGlpNumIsNeqZero (v, f->szero_tol))
-			/*if (v > szero_tol || v < -szero_tol) */
+		if (kb == 1 || f->ftran_dens < SPARSE_FACTOR)
 		{
-			x->indx[x->nzcnt] = c;
-			EGLPNUM_TYPENAME_EGlpNumCopy (x->coef[x->nzcnt], v);
-			x->nzcnt++;
+			EGLPNUM_TYPENAME_ILLfactor_ftran (f, a + b, x + b);
+			nb = 1;
+			continue;
 		}
-		last = -1;
-		for (i = 1; i < nzcnt; i++)
+		nb = (k - b < kb) ? k - b : kb;
+		if (!blk)
 		{
-			c = indx[i];
-			EGLPNUM_TYPENAME_EGlpNumSubInnProdTo (work[c], v, coef[i]);
-			if (--uc_inf[c].delay == 0)
+			blk = EGLPNUM_TYPENAME_EGlpNumAllocArray (kb * dim);
+			v = EGLPNUM_TYPENAME_EGlpNumAllocArray (kb);
+			for (i = 0; i < kb * dim; i++)
+				EGLPNUM_TYPENAME_EGlpNumZero (blk[i]);
+		}
+		for (j = 0; j < nb; j++)
+		{
+			for (l = 0; l < a[b + j].nzcnt; l++)
 			{
-				if (last >= 0)
+				EGLPNUM_TYPENAME_EGlpNumCopy (blk[a[b + j].indx[l] * nb + j],
+																			a[b + j].coef[l]);
+			}
+		}
+
+		/* L^{-1}, as in ILLfactor_ftranl */
+		for (i = 0; i < dim; i++)
+		{
+			nzcnt = lc_inf[i].nzcnt;
+			if (nzcnt == 0)
+				continue;
+			beg = lc_inf[i].cbeg;
+			r = lc_inf[i].c * nb;
+			if (!multi_live (blk + r, nb))
+				continue;
+			for (l = 0; l < nzcnt; l++)
+			{
+				c = lcindx[beg + l] * nb;
+				for (j = 0; j < nb; j++)
 				{
-					ftranu3_process2 (f, last, x);
+					if (EGLPNUM_TYPENAME_EGlpNumIsNeqqZero (blk[r + j]))
+						EGLPNUM_TYPENAME_EGlpNumSubInnProdTo (blk[c + j], blk[r + j],
+																									lccoef[beg + l]);
 				}
-				last = c;
 			}
 		}
-		c = last;
-	} while (c >= 0);
-	EGLPNUM_TYPENAME_EGlpNumClearVar (v);
-}
-
-static void ILLfactor_ftranu3 (
-	EGLPNUM_TYPENAME_factor_work * f,
-	EGLPNUM_TYPENAME_svector * a,
-	EGLPNUM_TYPENAME_svector * x)
-{
-	EGLPNUM_TYPE *work = f->work_coef;
-	int anzcnt = a->nzcnt;
-	int *aindx = a->indx;
-	EGLPNUM_TYPE *acoef = a->coef;
-	EGLPNUM_TYPENAME_uc_info *uc_inf = f->uc_inf;
-	int i;
 
-	for (i = 0; i < anzcnt; i++)
-	{
-		if (uc_inf[aindx[i]].delay++ == 0)
+		/* row etas, as in ILLfactor_ftrane */
+		for (i = 0; i < etacnt; i++)
 		{
-			ftranu3_delay2 (f, aindx[i]);
+			nzcnt = er_inf[i].nzcnt;
+			beg = er_inf[i].rbeg;
+			r = er_inf[i].r * nb;
+			for (j = 0; j < nb; j++)
+				EGLPNUM_TYPENAME_EGlpNumCopy (v[j], blk[r + j]);
+			for (l = 0; l < nzcnt; l++)
+			{
+				c = erindx[beg + l] * nb;
+				for (j = 0; j < nb; j++)
+					EGLPNUM_TYPENAME_EGlpNumSubInnProdTo (v[j], ercoef[beg + l], blk[c + j]);
+			}
+			for (j = 0; j < nb; j++)
+				EGLPNUM_TYPENAME_EGlpNumCopy (blk[r + j], v[j]);
 		}
-		EGLPNUM_TYPENAME_EGlpNumCopy (work[aindx[i]], acoef[i]);
-	}
-	x->nzcnt = 0;
-	for (i = 0; i < anzcnt; i++)
-	{
-		if (--uc_inf[aindx[i]].delay == 0)
+
+		/* U^{-1}, as in ILLfactor_ftranu, which also clears the block */
+		for (j = 0; j < nb; j++)
+			x[b + j].nzcnt = 0;
+		for (i = dim - 1; i >= 0; i--)
 		{
-			ftranu3_process2 (f, aindx[i], x);
+			r = f->rperm[i] * nb;
+			c = f->cperm[i];
+			beg = uc_inf[c].cbeg;
+			nzcnt = uc_inf[c].nzcnt;
+			for (j = 0; j < nb; j++)
+			{
+				EGLPNUM_TYPENAME_EGlpNumCopy (v[j], blk[r + j]);
+				if (!EGLPNUM_TYPENAME_EGlpNumIsNeqqZero (v[j]))
+					continue;
+				EGLPNUM_TYPENAME_EGlpNumZero (blk[r + j]);
+				EGLPNUM_TYPENAME_EGlpNumDivTo (v[j], uccoef[beg]);
+				if (EGLPNUM_TYPENAME_EGlpNumIsNeqZero (v[j], f->szero_tol))
+				{
+					x[b + j].indx[x[b + j].nzcnt] = c;
+					EGLPNUM_TYPENAME_EGlpNumCopy (x[b + j].coef[x[b + j].nzcnt], v[j]);
+					x[b + j].nzcnt++;
+				}
+			}
+			if (!multi_live (v, nb))
+				continue;
+			for (l = 1; l < nzcnt; l++)
+			{
+				r = ucindx[beg + l] * nb;
+				for (j = 0; j < nb; j++)
+				{
+					if (EGLPNUM_TYPENAME_EGlpNumIsNeqqZero (v[j]))
+						EGLPNUM_TYPENAME_EGlpNumSubInnProdTo (blk[r + j], v[j], uccoef[beg + l]);
+				}
+			}
 		}
+		for (j = 0; j < nb; j++)
+			f->ftran_dens = hyper_density (f, f->ftran_dens, x[b + j].nzcnt);
 	}
-#ifdef SOLVE_DEBUG
-	QSlog("EGLPNUM_TYPENAME_ILLfactor_ftran x after u3:");
-	for (i = 0; i < x->nzcnt; i++)
-	{
-		QSlog(" %.3f*%d", EGLPNUM_TYPENAME_EGlpNumToLf (x->coef[i]), x->indx[i]);
-	}
-#endif /* SOLVE_DEBUG */
+	EGLPNUM_TYPENAME_EGlpNumFreeArray (blk);
+	EGLPNUM_TYPENAME_EGlpNumFreeArray (v);
 }
 
-/* EGLPNUM_TYPENAME_ILLfactor_ftran solves Bx=a for x */
-void EGLPNUM_TYPENAME_ILLfactor_ftran (
+/* EGLPNUM_TYPENAME_ILLfactor_btran_multi solves x[j]^tB=a[j]^t for the k
+ * right hand sides a[0..k-1], interleaved as in
+ * EGLPNUM_TYPENAME_ILLfactor_ftran_multi. Each x[j] must have room for
+ * f->dim entries. */
+void EGLPNUM_TYPENAME_ILLfactor_btran_multi (
 	EGLPNUM_TYPENAME_factor_work * f,
+	int k,
 	EGLPNUM_TYPENAME_svector * a,
 	EGLPNUM_TYPENAME_svector * x)
 {
-	int i;
-	int nzcnt;
-	int sparse;
-	int *aindx;
-	EGLPNUM_TYPE *acoef;
-	EGLPNUM_TYPE *work_coef = f->work_coef;
+	int *lrindx = f->lrindx;
+	EGLPNUM_TYPE *lrcoef = f->lrcoef;
+	EGLPNUM_TYPENAME_lr_info *lr_inf = f->lr_inf;
+	int *erindx = f->erindx;
+	EGLPNUM_TYPE *ercoef = f->ercoef;
+	EGLPNUM_TYPENAME_er_info *er_inf = f->er_inf;
+	int *urindx = f->urindx;
+	EGLPNUM_TYPE *urcoef = f->urcoef;
+	EGLPNUM_TYPENAME_ur_info *ur_inf = f->ur_inf;
+	int etacnt = f->etacnt;
+	int dim = f->dim;
+	int kb = multi_block (f, k);
+	int b, nb, i, j, l, r, c, beg, nzcnt;
+	EGLPNUM_TYPE *blk = 0;
+	EGLPNUM_TYPE *v = 0;
 
-#ifdef RECORD
+	for (b = 0; b < k; b += nb)
 	{
-		EGioPrintf (fsave, "f %d", a->nzcnt);
-		for (i = 0; i < a->nzcnt; i++)
+		if (kb == 1 || f->btran_dens < SPARSE_FACTOR)
 		{
-			EGioPrintf (fsave, " %d %.16e", a->indx[i], EGLPNUM_TYPENAME_EGlpNumToLf (a->coef[i]));
+			EGLPNUM_TYPENAME_ILLfactor_btran (f, a + b, x + b);
+			nb = 1;
+			continue;
 		}
-		EGioPrintf (fsave, "\n");
-		EGioFlush (fsave);
-	}
-#endif /* RECORD */
-#ifdef DEBUG_FACTOR
-	{
-		QSlog("EGLPNUM_TYPENAME_ILLfactor_ftran a:");
-		for (i = 0; i < a->nzcnt; i++)
+		nb = (k - b < kb) ? k - b : kb;
+		if (!blk)
 		{
-			QSlog(" %d %la", a->indx[i], EGLPNUM_TYPENAME_EGlpNumToLf (a->coef[i]));
+			blk = EGLPNUM_TYPENAME_EGlpNumAllocArray (kb * dim);
+			v = EGLPNUM_TYPENAME_EGlpNumAllocArray (kb);
+			for (i = 0; i < kb * dim; i++)
+				EGLPNUM_TYPENAME_EGlpNumZero (blk[i]);
+		}
+		for (j = 0; j < nb; j++)
+		{
+			for (l = 0; l < a[b + j].nzcnt; l++)
+			{
+				EGLPNUM_TYPENAME_EGlpNumCopy (blk[a[b + j].indx[l] * nb + j],
+																			a[b + j].coef[l]);
+			}
 		}
-	}
-#endif /* DEBUG_FACTOR */
 
-	if (a->nzcnt >= SPARSE_FACTOR * f->dim)
-	{
-		nzcnt = a->nzcnt;
-		aindx = a->indx;
-		acoef = a->coef;
-		for (i = 0; i < nzcnt; i++)
+		/* U^{-T}, as in ILLfactor_btranu; the results go through x, since they
+		 * are indexed by row, and the block is left clear */
+		for (j = 0; j < nb; j++)
+			x[b + j].nzcnt = 0;
+		for (i = 0; i < dim; i++)
+		{
+			c = f->cperm[i] * nb;
+			r = f->rperm[i];
+			beg = ur_inf[r].rbeg;
+			nzcnt = ur_inf[r].nzcnt;
+			for (j = 0; j < nb; j++)
+			{
+				EGLPNUM_TYPENAME_EGlpNumCopy (v[j], blk[c + j]);
+				if (!EGLPNUM_TYPENAME_EGlpNumIsNeqqZero (v[j]))
+					continue;
+				EGLPNUM_TYPENAME_EGlpNumZero (blk[c + j]);
+				EGLPNUM_TYPENAME_EGlpNumDivTo (v[j], urcoef[beg]);
+				if (EGLPNUM_TYPENAME_EGlpNumIsNeqZero (v[j], f->szero_tol))
+				{
+					x[b + j].indx[x[b + j].nzcnt] = r;
+					EGLPNUM_TYPENAME_EGlpNumCopy (x[b + j].coef[x[b + j].nzcnt], v[j]);
+					x[b + j].nzcnt++;
+				}
+			}
+			if (!multi_live (v, nb))
+				continue;
+			for (l = 1; l < nzcnt; l++)
+			{
+				c = urindx[beg + l] * nb;
+				for (j = 0; j < nb; j++)
+				{
+					if (EGLPNUM_TYPENAME_EGlpNumIsNeqqZero (v[j]))
+						EGLPNUM_TYPENAME_EGlpNumSubInnProdTo (blk[c + j], v[j], urcoef[beg + l]);
+				}
+			}
+		}
+		for (j = 0; j < nb; j++)
 		{
-			EGLPNUM_TYPENAME_EGlpNumCopy (work_coef[aindx[i]], acoef[i]);
+			for (l = 0; l < x[b + j].nzcnt; l++)
+			{
+				EGLPNUM_TYPENAME_EGlpNumCopy (blk[x[b + j].indx[l] * nb + j],
+																			x[b + j].coef[l]);
+			}
 		}
-		sparse = 0;
-	}
-	else
-	{
-		sparse = 1;
-	}
 
-	if (sparse)
-	{
-		ILLfactor_ftranl3 (f, a, &f->xtmp);
-		if (f->xtmp.nzcnt >= SPARSE_FACTOR * f->dim)
+		/* row etas, as in ILLfactor_btrane */
+		for (i = etacnt - 1; i >= 0; i--)
 		{
-			nzcnt = f->xtmp.nzcnt;
-			aindx = f->xtmp.indx;
-			acoef = f->xtmp.coef;
-
-			for (i = 0; i < nzcnt; i++)
+			nzcnt = er_inf[i].nzcnt;
+			beg = er_inf[i].rbeg;
+			r = er_inf[i].r * nb;
+			if (!multi_live (blk + r, nb))
+				continue;
+			for (l = 0; l < nzcnt; l++)
 			{
-				EGLPNUM_TYPENAME_EGlpNumCopy (work_coef[aindx[i]], acoef[i]);
+				c = erindx[beg + l] * nb;
+				for (j = 0; j < nb; j++)
+				{
+					if (EGLPNUM_TYPENAME_EGlpNumIsNeqqZero (blk[r + j]))
+						EGLPNUM_TYPENAME_EGlpNumSubInnProdTo (blk[c + j], blk[r + j],
+																									ercoef[beg + l]);
+				}
 			}
-			sparse = 0;
 		}
-	}
-	else
-	{
-		ILLfactor_ftranl (f, work_coef);
-	}
 
-	if (sparse)
-	{
-		ILLfactor_ftrane2 (f, &f->xtmp);
-		if (f->xtmp.nzcnt >= SPARSE_FACTOR * f->dim)
+		/* L^{-T}, as in ILLfactor_btranl2 */
+		for (i = dim - 1; i >= 0; i--)
 		{
-			nzcnt = f->xtmp.nzcnt;
-			aindx = f->xtmp.indx;
-			acoef = f->xtmp.coef;
-
-			for (i = 0; i < nzcnt; i++)
+			nzcnt = lr_inf[i].nzcnt;
+			if (nzcnt == 0)
+				continue;
+			beg = lr_inf[i].rbeg;
+			r = lr_inf[i].r * nb;
+			if (!multi_live (blk + r, nb))
+				continue;
+			for (l = 0; l < nzcnt; l++)
 			{
-				EGLPNUM_TYPENAME_EGlpNumCopy (work_coef[aindx[i]], acoef[i]);
+				c = lrindx[beg + l] * nb;
+				for (j = 0; j < nb; j++)
+				{
+					if (EGLPNUM_TYPENAME_EGlpNumIsNeqqZero (blk[r + j]))
+						EGLPNUM_TYPENAME_EGlpNumSubInnProdTo (blk[c + j], blk[r + j],
+																									lrcoef[beg + l]);
+				}
 			}
-			sparse = 0;
 		}
-	}
-	else
-	{
-		ILLfactor_ftrane (f, work_coef);
-	}
-
-	if (sparse)
-	{
-		ILLfactor_ftranu3 (f, &f->xtmp, x);
-	}
-	else
-	{
-		ILLfactor_ftranu (f, work_coef, x);
-	}
-
-#ifdef SORT_RESULTS
-	sort_vector (x);
-#endif
 
-#ifdef DEBUG_FACTOR
-	{
-		QSlog("EGLPNUM_TYPENAME_ILLfactor_ftran x:");
-		for (i = 0; i < x->nzcnt; i++)
+		/* gather the results and clear the block */
+		for (j = 0; j < nb; j++)
+			x[b + j].nzcnt = 0;
+		for (i = 0; i < dim; i++)
 		{
-			QSlog(" %d %la", x->indx[i], EGLPNUM_TYPENAME_EGlpNumToLf (x->coef[i]));
+			r = i * nb;
+			for (j = 0; j < nb; j++)
+			{
+				if (!EGLPNUM_TYPENAME_EGlpNumIsNeqqZero (blk[r + j]))
+					continue;
+				if (EGLPNUM_TYPENAME_EGlpNumIsNeqZero (blk[r + j], f->szero_tol))
+				{
+					x[b + j].indx[x[b + j].nzcnt] = i;
+					EGLPNUM_TYPENAME_EGlpNumCopy (x[b + j].coef[x[b + j].nzcnt], blk[r + j]);
+					x[b + j].nzcnt++;
+				}
+				EGLPNUM_TYPENAME_EGlpNumZero (blk[r + j]);
+			}
 		}
+		for (j = 0; j < nb; j++)
+			f->btran_dens = hyper_density (f, f->btran_dens, x[b + j].nzcnt);
 	}
-#endif /* DEBUG_FACTOR */
-	return;
-}
-
-int EGLPNUM_TYPENAME_compute_spike (
-    EGLPNUM_TYPENAME_factor_work * f,
-    EGLPNUM_TYPENAME_svector * a,
-    EGLPNUM_TYPENAME_svector * spike)
-{
-    int i;
-    int nzcnt;
-    int sparse;
-    int *aindx;
-    EGLPNUM_TYPE *acoef;
-    EGLPNUM_TYPE *work_coef = f->work_coef;
-
-    // Determine if we should use sparse or dense methods
-    if (a->nzcnt >= SPARSE_FACTOR * f->dim)
-    {
-        // Dense case: copy input to work array
-        aindx = a->indx;
-        acoef = a->coef;
-        nzcnt = a->nzcnt;
-        for (i = 0; i < nzcnt; i++)
-        {
-            EGLPNUM_TYPENAME_EGlpNumCopy(work_coef[aindx[i]], acoef[i]);
-        }
-        sparse = 0;
-    }
-    else
-    {
-        sparse = 1;
-    }
-
-    // Apply L^{-1}
-    if (sparse)
-    {
-        ILLfactor_ftranl3(f, a, spike);  // Note: spike, not &spike
-        // Check if result became dense
-        if (spike->nzcnt >= SPARSE_FACTOR * f->dim)
-        {
-            nzcnt = spike->nzcnt;
-            aindx = spike->indx;
-            acoef = spike->coef;
-            for (i = 0; i < nzcnt; i++)
-            {
-                EGLPNUM_TYPENAME_EGlpNumCopy(work_coef[aindx[i]], acoef[i]);
-            }
-            sparse = 0;
-        }
-    }
-    else
-    {
-        ILLfactor_ftranl(f, work_coef);
-    }
-
-    // Apply E^{-1} (eta factors)
-    if (sparse)
-    {
-        ILLfactor_ftrane2(f, spike);
-    }
-    else
-    {
-        ILLfactor_ftrane(f, work_coef);
-        // Convert dense result back to sparse
-        nzcnt = 0;
-        aindx = spike->indx;
-        acoef = spike->coef;
-        for (i = 0; i < f->dim; i++)
-        {
-            if (EGLPNUM_TYPENAME_EGlpNumIsNeqZero(work_coef[i], f->szero_tol))
-            {
-                aindx[nzcnt] = i;
-                EGLPNUM_TYPENAME_EGlpNumCopy(acoef[nzcnt], work_coef[i]);
-                nzcnt++;
-            }
-            EGLPNUM_TYPENAME_EGlpNumZero(work_coef[i]); // Clean up
-        }
-        spike->nzcnt = nzcnt;
-    }
-	return 0;
+	EGLPNUM_TYPENAME_EGlpNumFreeArray (blk);
+	EGLPNUM_TYPENAME_EGlpNumFreeArray (v);
 }
 
 /* EGLPNUM_TYPENAME_ILLfactor_ftran_update solves Bx=a for x, and also returns upd, where Ux=upd */
@@ -3946,6 +5948,8 @@ void EGLPNUM_TYPENAME_ILLfactor_ftran_update (
 		ILLfactor_ftranu (f, work_coef, x);
 	}
 
+	f->ftran_dens = hyper_density (f, f->ftran_dens, x->nzcnt);
+
 #ifdef SORT_RESULTS
 	sort_vector (upd);
 	sort_vector (x);
@@ -3977,6 +5981,14 @@ static void ILLfactor_btranl2 (
 	int j;
 	EGLPNUM_TYPE v;
 
+#if SOLVE_SNAP
+	if (f->snap_l)
+	{
+		snap_solve_l (&f->lr_snap, x);
+		return;
+	}
+#endif
+
 	EGLPNUM_TYPENAME_EGlpNumInitVar (v);
 
 	for (i = dim - 1; i >= 0; i--)
@@ -4161,6 +6173,57 @@ static void btranl3_process2 (
 	EGLPNUM_TYPENAME_EGlpNumClearVar (v);
 }
 
+/* hypersparse version of ILLfactor_btranl3 */
+static void ILLfactor_btranl_hyper (
+	EGLPNUM_TYPENAME_factor_work * f,
+	EGLPNUM_TYPENAME_svector * a,
+	EGLPNUM_TYPENAME_svector * x)
+{
+	EGLPNUM_TYPE *work = f->work_coef;
+	EGLPNUM_TYPENAME_lr_info *lr_inf = f->lr_inf;
+	int *list = f->reach_list;
+	int dim = f->dim;
+	int nzcnt;
+	int *indx;
+	EGLPNUM_TYPE *coef;
+	int i;
+	int j;
+	int r;
+	EGLPNUM_TYPE v;
+
+	EGLPNUM_TYPENAME_EGlpNumInitVar (v);
+
+	for (i = 0; i < a->nzcnt; i++)
+	{
+		EGLPNUM_TYPENAME_EGlpNumCopy (work[a->indx[i]], a->coef[i]);
+	}
+	x->nzcnt = 0;
+	for (i = hyper_reach (f, REACH_BTRANL, a); i < dim; i++)
+	{
+		r = list[i];
+		lr_inf[r].delay = 0;
+		EGLPNUM_TYPENAME_EGlpNumCopy (v, work[r]);
+		EGLPNUM_TYPENAME_EGlpNumZero (work[r]);
+		if (!EGLPNUM_TYPENAME_EGlpNumIsNeqqZero (v))
+			continue;
+		if (EGLPNUM_TYPENAME_EGlpNumIsNeqZero (v, f->szero_tol))
+		{
+			x->indx[x->nzcnt] = r;
+			EGLPNUM_TYPENAME_EGlpNumCopy (x->coef[x->nzcnt], v);
+			x->nzcnt++;
+		}
+		r = lr_inf[r].rrank;
+		nzcnt = lr_inf[r].nzcnt;
+		indx = f->lrindx + lr_inf[r].rbeg;
+		coef = f->lrcoef + lr_inf[r].rbeg;
+		for (j = 0; j < nzcnt; j++)
+		{
+			EGLPNUM_TYPENAME_EGlpNumSubInnProdTo (work[indx[j]], v, coef[j]);
+		}
+	}
+	EGLPNUM_TYPENAME_EGlpNumClearVar (v);
+}
+
 static void ILLfactor_btranl3 (
 	EGLPNUM_TYPENAME_factor_work * f,
 	EGLPNUM_TYPENAME_svector * a,
@@ -4173,6 +6236,11 @@ static void ILLfactor_btranl3 (
 	EGLPNUM_TYPENAME_lr_info *lr_inf = f->lr_inf;
 	int i;
 
+	if (hyper_solve (f, anzcnt, f->btran_dens))
+	{
+		ILLfactor_btranl_hyper (f, a, x);
+		return;
+	}
 	for (i = 0; i < anzcnt; i++)
 	{
 		if (lr_inf[aindx[i]].delay++ == 0)
@@ -4352,6 +6420,14 @@ static void ILLfactor_btranu (
 	int j;
 	EGLPNUM_TYPE v;
 
+#if SOLVE_SNAP
+	if (f->snap_u)
+	{
+		snap_solve_u (f, &f->ur_snap, a, x);
+		return;
+	}
+#endif
+
 	EGLPNUM_TYPENAME_EGlpNumInitVar (v);
 
 	for (i = 0; i < dim; i++)
@@ -4537,6 +6613,55 @@ static void btranu3_process2 (
 	EGLPNUM_TYPENAME_EGlpNumClearVar (v);
 }
 
+/* hypersparse version of ILLfactor_btranu3 */
+static void ILLfactor_btranu_hyper (
+	EGLPNUM_TYPENAME_factor_work * f,
+	EGLPNUM_TYPENAME_svector * a,
+	EGLPNUM_TYPENAME_svector * x)
+{
+	EGLPNUM_TYPE *work = f->work_coef;
+	EGLPNUM_TYPENAME_ur_info *ur_inf = f->ur_inf;
+	int *list = f->reach_list;
+	int dim = f->dim;
+	int nzcnt;
+	int *indx;
+	EGLPNUM_TYPE *coef;
+	int i;
+	int j;
+	int r;
+	EGLPNUM_TYPE v;
+
+	EGLPNUM_TYPENAME_EGlpNumInitVar (v);
+
+	for (i = 0; i < a->nzcnt; i++)
+	{
+		EGLPNUM_TYPENAME_EGlpNumCopy (work[a->indx[i]], a->coef[i]);
+	}
+	x->nzcnt = 0;
+	for (i = hyper_reach (f, REACH_BTRANU, a); i < dim; i++)
+	{
+		r = list[i];
+		ur_inf[r].delay = 0;
+		EGLPNUM_TYPENAME_EGlpNumCopy (v, work[r]);
+		EGLPNUM_TYPENAME_EGlpNumZero (work[r]);
+		if (!EGLPNUM_TYPENAME_EGlpNumIsNeqqZero (v))
+			continue;
+		r = f->rperm[f->crank[r]];
+		nzcnt = ur_inf[r].nzcnt;
+		indx = f->urindx + ur_inf[r].rbeg;
+		coef = f->urcoef + ur_inf[r].rbeg;
+		EGLPNUM_TYPENAME_EGlpNumDivTo (v, coef[0]);
+		x->indx[x->nzcnt] = r;
+		EGLPNUM_TYPENAME_EGlpNumCopy (x->coef[x->nzcnt], v);
+		x->nzcnt++;
+		for (j = 1; j < nzcnt; j++)
+		{
+			EGLPNUM_TYPENAME_EGlpNumSubInnProdTo (work[indx[j]], v, coef[j]);
+		}
+	}
+	EGLPNUM_TYPENAME_EGlpNumClearVar (v);
+}
+
 static void ILLfactor_btranu3 (
 	EGLPNUM_TYPENAME_factor_work * f,
 	EGLPNUM_TYPENAME_svector * a,
@@ -4549,6 +6674,11 @@ static void ILLfactor_btranu3 (
 	EGLPNUM_TYPENAME_ur_info *ur_inf = f->ur_inf;
 	int i;
 
+	if (hyper_solve (f, anzcnt, f->btran_dens))
+	{
+		ILLfactor_btranu_hyper (f, a, x);
+		return;
+	}
 	for (i = 0; i < anzcnt; i++)
 	{
 		if (ur_inf[aindx[i]].delay++ == 0)
@@ -4701,6 +6831,8 @@ void EGLPNUM_TYPENAME_ILLfactor_btran (
 		x->nzcnt = nzcnt;
 	}
 
+	f->btran_dens = hyper_density (f, f->btran_dens, x->nzcnt);
+
 #ifdef SORT_RESULTS
 	sort_vector (x);
 #endif
@@ -5550,6 +7682,7 @@ int EGLPNUM_TYPENAME_ILLfactor_update (
 		*p_refact = 1;
 		return 0;
 	}
+	f->snap_u = 0;
 
 #ifdef UPDATE_STUDY
 	nupdate++;
@@ -5715,12 +7848,16 @@ CLEANUP:
     dest->er_space_mul = src->er_space_mul;
     dest->grow_mul = src->grow_mul;
     dest->p = src->p;
-    dest->etamax = 500; //TODO: make this dynamic
+    /* room for more updates than a fresh factorization, never less than src */
+    dest->etamax = src->etamax > 500 ? src->etamax : 500; //TODO: make this dynamic
     dest->minmult = src->minmult;
     dest->maxmult = src->maxmult;
     dest->updmaxmult = src->updmaxmult;
     dest->dense_fract = src->dense_fract;
     dest->dense_min = src->dense_min;
+    dest->nthreads = src->nthreads;
+    dest->ftran_dens = src->ftran_dens;
+    dest->btran_dens = src->btran_dens;
     EGLPNUM_TYPENAME_EGlpNumCopy(dest->maxelem_orig, src->maxelem_orig);
     dest->nzcnt_orig = src->nzcnt_orig;
     EGLPNUM_TYPENAME_EGlpNumCopy(dest->maxelem_factor, src->maxelem_factor);
@@ -5788,7 +7925,7 @@ CLEANUP:
         memcpy(dest->lr_inf, src->lr_inf, src->dim * sizeof(EGLPNUM_TYPENAME_lr_info));
     }
     if (src->er_inf) {
-        ILL_SAFE_MALLOC(dest->er_inf, src->etamax, EGLPNUM_TYPENAME_er_info);
+        ILL_SAFE_MALLOC(dest->er_inf, dest->etamax, EGLPNUM_TYPENAME_er_info);
         memcpy(dest->er_inf, src->er_inf, src->etamax * sizeof(EGLPNUM_TYPENAME_er_info));
     }
 	
@@ -5892,6 +8029,11 @@ CLEANUP:
         ILL_SAFE_MALLOC(dest->crank, src->dim, int);
         memcpy(dest->crank, src->crank, src->dim * sizeof(int));
     }
+    if (src->reach_list) {
+        ILL_SAFE_MALLOC(dest->reach_list, src->dim, int);
+        ILL_SAFE_MALLOC(dest->reach_stack, src->dim, int);
+        ILL_SAFE_MALLOC(dest->reach_pos, src->dim, int);
+    }
     
     // Dense Matrix
     if (src->dmat) {
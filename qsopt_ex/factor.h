@@ -79,6 +79,22 @@ typedef struct EGLPNUM_TYPENAME_er_info
 }
 EGLPNUM_TYPENAME_er_info;
 
+/* one triangular factor packed in the order the dense solves visit it, step
+ * k eliminates entry piv[k] of the work vector with the entries
+ * beg[k] .. beg[k+1]-1 of indx/coef. Only built for doubles, in the other
+ * types the snapshots stay empty and snap_l, snap_u zero */
+typedef struct EGLPNUM_TYPENAME_solve_snap
+{
+	int nsteps;
+	int space;
+	int *beg;
+	int *piv;
+	int *out;											/* result index of each step, U only */
+	int *indx;
+	EGLPNUM_TYPE *coef;
+}
+EGLPNUM_TYPENAME_solve_snap;
+
 typedef struct EGLPNUM_TYPENAME_factor_work
 {
 	int max_k;
@@ -98,6 +114,8 @@ typedef struct EGLPNUM_TYPENAME_factor_work
 	double updmaxmult;
 	double dense_fract;
 	int dense_min;
+	int nthreads;									/* threads for the sparse elimination */
+	int par_rounds;								/* its rounds run on more than one thread */
 
 	EGLPNUM_TYPE maxelem_orig;
 	int nzcnt_orig;
@@ -135,6 +153,17 @@ typedef struct EGLPNUM_TYPENAME_factor_work
 	int *rrank;
 	int *cperm;
 	int *crank;
+	int *reach_list;							/* nodes reached by a hypersparse solve */
+	int *reach_stack;							/* depth first search stack */
+	int *reach_pos;								/* next edge of each node on the stack */
+	double ftran_dens;						/* running average density of ftran results */
+	double btran_dens;						/* running average density of btran results */
+	EGLPNUM_TYPENAME_solve_snap lc_snap;	/* L by columns, in ftran order */
+	EGLPNUM_TYPENAME_solve_snap lr_snap;	/* L by rows, in btran order */
+	EGLPNUM_TYPENAME_solve_snap uc_snap;	/* U by columns, in ftran order */
+	EGLPNUM_TYPENAME_solve_snap ur_snap;	/* U by rows, in btran order */
+	int snap_l;										/* lc_snap and lr_snap match L */
+	int snap_u;										/* uc_snap and ur_snap match U */
 	EGLPNUM_TYPENAME_svector xtmp;
 	int ur_freebeg;
 	int ur_space;
@@ -208,6 +237,30 @@ int EGLPNUM_TYPENAME_ILLfactor_create_factor_work (
 	EGLPNUM_TYPENAME_compute_spike (
 		EGLPNUM_TYPENAME_factor_work * f,
 		EGLPNUM_TYPENAME_svector * a,
+		EGLPNUM_TYPENAME_svector * spike),
+	EGLPNUM_TYPENAME_ILLfactor_spike_block (
+		EGLPNUM_TYPENAME_factor_work * f,
+		int k,
+		EGLPNUM_TYPENAME_svector * a,
 		EGLPNUM_TYPENAME_svector * spike);
 
+void EGLPNUM_TYPENAME_ILLfactor_spike_refresh (
+	EGLPNUM_TYPENAME_factor_work * f,
+	int start,
+	EGLPNUM_TYPENAME_svector * spike);
+int EGLPNUM_TYPENAME_ILLfactor_multi_width (
+	EGLPNUM_TYPENAME_factor_work * f,
+	int k,
+	int btran);
+void EGLPNUM_TYPENAME_ILLfactor_ftran_multi (
+	EGLPNUM_TYPENAME_factor_work * f,
+	int k,
+	EGLPNUM_TYPENAME_svector * a,
+	EGLPNUM_TYPENAME_svector * x),
+  EGLPNUM_TYPENAME_ILLfactor_btran_multi (
+	EGLPNUM_TYPENAME_factor_work * f,
+	int k,
+	EGLPNUM_TYPENAME_svector * a,
+	EGLPNUM_TYPENAME_svector * x);
+
 #endif /* EGLPNUM_TYPENAME___QS_FACTOR_H_ */
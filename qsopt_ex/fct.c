@@ -237,14 +237,18 @@ void EGLPNUM_TYPENAME_ILLfct_compute_xbz (
 	int col, mcnt, mbeg;
 	EGLPNUM_TYPENAME_svector *srhs = &(lp->srhs);
 	EGLPNUM_TYPENAME_svector *ssoln = &(lp->ssoln);
+	EGLPNUM_TYPENAME_EGlpNumDot_t *bzn =
+		EGLPNUM_TYPENAME_EGlpNumDotAllocArray (lp->nrows);
 	EGLPNUM_TYPE xval;
 
 	EGLPNUM_TYPENAME_EGlpNumInitVar (xval);
 
+	/* accumulate bz - N xN one row at a time, so that in exact arithmetic
+	 * every row is canonicalized once */
 	for (i = 0; i < lp->nrows; i++)
 	{
 		EGLPNUM_TYPENAME_EGlpNumZero (lp->xbz[i]);
-		EGLPNUM_TYPENAME_EGlpNumCopy (srhs->coef[i], lp->bz[i]);
+		EGLPNUM_TYPENAME_EGlpNumDotAdd (bzn[i], lp->bz[i]);
 	}
 	for (j = 0; j < lp->nnbasic; j++)
 	{
@@ -260,10 +264,12 @@ void EGLPNUM_TYPENAME_ILLfct_compute_xbz (
 			mcnt = lp->matcnt[col];
 			mbeg = lp->matbeg[col];
 			for (i = 0; i < mcnt; i++)
-				EGLPNUM_TYPENAME_EGlpNumSubInnProdTo (srhs->coef[lp->matind[mbeg + i]], xval,
-														 lp->matval[mbeg + i]);
+				EGLPNUM_TYPENAME_EGlpNumDotSubProd (bzn[lp->matind[mbeg + i]], xval,
+																						lp->matval[mbeg + i]);
 		}
 	}
+	for (i = 0; i < lp->nrows; i++)
+		EGLPNUM_TYPENAME_EGlpNumDotGet (srhs->coef[i], bzn[i]);
 	for (i = 0, r = 0; i < lp->nrows; i++)
 		if (EGLPNUM_TYPENAME_EGlpNumIsNeqqZero (srhs->coef[i]))
 		{
@@ -277,6 +283,7 @@ void EGLPNUM_TYPENAME_ILLfct_compute_xbz (
 	for (i = 0; i < ssoln->nzcnt; i++)
 		EGLPNUM_TYPENAME_EGlpNumCopy (lp->xbz[ssoln->indx[i]], ssoln->coef[i]);
 	EGLPNUM_TYPENAME_EGlpNumClearVar (xval);
+	EGLPNUM_TYPENAME_EGlpNumDotFreeArray (bzn);
 }
 
 void EGLPNUM_TYPENAME_ILLfct_compute_piz (
@@ -309,22 +316,26 @@ void EGLPNUM_TYPENAME_ILLfct_compute_dz (
 	int i, j;
 	int col;
 	int mcnt, mbeg;
+	EGLPNUM_TYPENAME_EGlpNumDot_t acc;
 	EGLPNUM_TYPE sum;
 
+	EGLPNUM_TYPENAME_EGlpNumDotInit (acc);
 	EGLPNUM_TYPENAME_EGlpNumInitVar (sum);
 
 	for (j = 0; j < lp->nnbasic; j++)
 	{
-		EGLPNUM_TYPENAME_EGlpNumZero (sum);
+		EGLPNUM_TYPENAME_EGlpNumDotZero (acc);
 		col = lp->nbaz[j];
 		mcnt = lp->matcnt[col];
 		mbeg = lp->matbeg[col];
 		for (i = 0; i < mcnt; i++)
-			EGLPNUM_TYPENAME_EGlpNumAddInnProdTo (sum, lp->piz[lp->matind[mbeg + i]],
-													 lp->matval[mbeg + i]);
+			EGLPNUM_TYPENAME_EGlpNumDotAddProd (acc, lp->piz[lp->matind[mbeg + i]],
+																					lp->matval[mbeg + i]);
+		EGLPNUM_TYPENAME_EGlpNumDotGet (sum, acc);
 		EGLPNUM_TYPENAME_EGlpNumCopyDiff (lp->dz[j], lp->cz[col], sum);
 	}
 	EGLPNUM_TYPENAME_EGlpNumClearVar (sum);
+	EGLPNUM_TYPENAME_EGlpNumDotClear (acc);
 }
 
 void EGLPNUM_TYPENAME_ILLfct_compute_phaseI_xbz (
@@ -450,6 +461,67 @@ void EGLPNUM_TYPENAME_ILLfct_compute_zz (
 	EGLPNUM_TYPENAME_ILLfct_compute_binvrow (lp, zz, row, EGLPNUM_TYPENAME_PIVZ_TOLER);
 }
 
+/* ILLfct_compute_yz for the k columns ecol[0..k-1], without update vectors,
+ * solved together */
+int EGLPNUM_TYPENAME_ILLfct_compute_yz_multi (
+	EGLPNUM_TYPENAME_lpinfo * lp,
+	int k,
+	EGLPNUM_TYPENAME_svector * yz,
+	const int *ecol)
+{
+	int rval = 0;
+	int j;
+	EGLPNUM_TYPENAME_svector *a = 0;
+
+	ILL_SAFE_MALLOC (a, k, EGLPNUM_TYPENAME_svector);
+	for (j = 0; j < k; j++)
+	{
+		a[j].nzcnt = lp->matcnt[ecol[j]];
+		a[j].indx = &(lp->matind[lp->matbeg[ecol[j]]]);
+		a[j].coef = &(lp->matval[lp->matbeg[ecol[j]]]);
+	}
+
+	EGLPNUM_TYPENAME_ILLfactor_set_factor_dparam (lp->f, QS_FACTOR_SZERO_TOL, EGLPNUM_TYPENAME_PIVZ_TOLER);
+	EGLPNUM_TYPENAME_ILLbasis_column_solve_multi (lp, k, a, yz);
+	EGLPNUM_TYPENAME_ILLfactor_set_factor_dparam (lp->f, QS_FACTOR_SZERO_TOL, EGLPNUM_TYPENAME_SZERO_TOLER);
+
+CLEANUP:
+	ILL_IFFREE(a);
+	EG_RETURN (rval);
+}
+
+/* ILLfct_compute_zz for the k rows lindex[0..k-1], solved together */
+int EGLPNUM_TYPENAME_ILLfct_compute_zz_multi (
+	EGLPNUM_TYPENAME_lpinfo * lp,
+	int k,
+	EGLPNUM_TYPENAME_svector * zz,
+	const int *lindex)
+{
+	int rval = 0;
+	int j;
+	EGLPNUM_TYPENAME_svector *a = 0;
+	EGLPNUM_TYPE e;
+
+	EGLPNUM_TYPENAME_EGlpNumInitVar (e);
+	EGLPNUM_TYPENAME_EGlpNumOne (e);
+	ILL_SAFE_MALLOC (a, k, EGLPNUM_TYPENAME_svector);
+	for (j = 0; j < k; j++)
+	{
+		a[j].nzcnt = 1;
+		a[j].indx = (int *) (lindex + j);
+		a[j].coef = &e;
+	}
+
+	EGLPNUM_TYPENAME_ILLfactor_set_factor_dparam (lp->f, QS_FACTOR_SZERO_TOL, EGLPNUM_TYPENAME_PIVZ_TOLER);
+	EGLPNUM_TYPENAME_ILLbasis_row_solve_multi (lp, k, a, zz);
+	EGLPNUM_TYPENAME_ILLfactor_set_factor_dparam (lp->f, QS_FACTOR_SZERO_TOL, EGLPNUM_TYPENAME_SZERO_TOLER);
+
+CLEANUP:
+	ILL_IFFREE(a);
+	EGLPNUM_TYPENAME_EGlpNumClearVar (e);
+	EG_RETURN (rval);
+}
+
 void EGLPNUM_TYPENAME_ILLfct_compute_binvrow (
 	EGLPNUM_TYPENAME_lpinfo * lp,
 	EGLPNUM_TYPENAME_svector * zz,
@@ -58,7 +58,17 @@ int EGLPNUM_TYPENAME_ILLfct_compute_zA (
 	EGLPNUM_TYPENAME_lpinfo * lp,
 	int indx,
 	int indxtype,
-	EGLPNUM_TYPE piv_val);
+	EGLPNUM_TYPE piv_val),
+  EGLPNUM_TYPENAME_ILLfct_compute_yz_multi (
+	EGLPNUM_TYPENAME_lpinfo * lp,
+	int k,
+	EGLPNUM_TYPENAME_svector * yz,
+	const int *ecol),
+  EGLPNUM_TYPENAME_ILLfct_compute_zz_multi (
+	EGLPNUM_TYPENAME_lpinfo * lp,
+	int k,
+	EGLPNUM_TYPENAME_svector * zz,
+	const int *lindex);
 
 void EGLPNUM_TYPENAME_ILLfct_load_workvector (
 	EGLPNUM_TYPENAME_lpinfo * lp,
@@ -531,6 +531,29 @@ CLEANUP:
 	EG_RETURN (rval);
 }
 
+int EGLPNUM_TYPENAME_ILLlib_basis_condition (
+	EGLPNUM_TYPENAME_lpinfo * lp,
+	double *cond,
+	double *growth)
+{
+	int rval = 0;
+	double orig, fact;
+
+	rval = EGLPNUM_TYPENAME_ILLbasis_condition (lp, cond);
+	CHECKRVALG (rval, CLEANUP);
+
+	if (growth)
+	{
+		orig = EGLPNUM_TYPENAME_EGlpNumToLf (lp->f->maxelem_orig);
+		fact = EGLPNUM_TYPENAME_EGlpNumToLf (lp->f->maxelem_factor);
+		*growth = (orig > 0 && fact > orig) ? fact / orig : 1.0;
+	}
+
+CLEANUP:
+
+	EG_RETURN (rval);
+}
+
 int EGLPNUM_TYPENAME_ILLlib_chgbnd (
 	EGLPNUM_TYPENAME_lpinfo * lp,
 	int indx,
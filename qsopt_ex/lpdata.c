@@ -84,30 +84,30 @@
 
 //static int TRACE = 0;
 
-EGLPNUM_TYPE EGLPNUM_TYPENAME_PARAM_IBASIS_RPIVOT;
-EGLPNUM_TYPE EGLPNUM_TYPENAME_PARAM_IBASIS_RTRIANG;
-EGLPNUM_TYPE EGLPNUM_TYPENAME_PARAM_MIN_DNORM;
-EGLPNUM_TYPE EGLPNUM_TYPENAME_PFEAS_TOLER;
-EGLPNUM_TYPE EGLPNUM_TYPENAME_BD_TOLER;
-EGLPNUM_TYPE EGLPNUM_TYPENAME_DFEAS_TOLER;
-EGLPNUM_TYPE EGLPNUM_TYPENAME_PIVOT_TOLER;
-EGLPNUM_TYPE EGLPNUM_TYPENAME_SZERO_TOLER;
-EGLPNUM_TYPE EGLPNUM_TYPENAME_PIVZ_TOLER;
-EGLPNUM_TYPE EGLPNUM_TYPENAME_OBJBND_TOLER;
-EGLPNUM_TYPE EGLPNUM_TYPENAME_DBNDPIV_TOLER;
-EGLPNUM_TYPE EGLPNUM_TYPENAME_DBNDPIV_RATIO;
-EGLPNUM_TYPE EGLPNUM_TYPENAME_ALTPIV_TOLER;
+EGLPNUM_TYPENAME_EGlpNumTLS EGLPNUM_TYPE EGLPNUM_TYPENAME_PARAM_IBASIS_RPIVOT;
+EGLPNUM_TYPENAME_EGlpNumTLS EGLPNUM_TYPE EGLPNUM_TYPENAME_PARAM_IBASIS_RTRIANG;
+EGLPNUM_TYPENAME_EGlpNumTLS EGLPNUM_TYPE EGLPNUM_TYPENAME_PARAM_MIN_DNORM;
+EGLPNUM_TYPENAME_EGlpNumTLS EGLPNUM_TYPE EGLPNUM_TYPENAME_PFEAS_TOLER;
+EGLPNUM_TYPENAME_EGlpNumTLS EGLPNUM_TYPE EGLPNUM_TYPENAME_BD_TOLER;
+EGLPNUM_TYPENAME_EGlpNumTLS EGLPNUM_TYPE EGLPNUM_TYPENAME_DFEAS_TOLER;
+EGLPNUM_TYPENAME_EGlpNumTLS EGLPNUM_TYPE EGLPNUM_TYPENAME_PIVOT_TOLER;
+EGLPNUM_TYPENAME_EGlpNumTLS EGLPNUM_TYPE EGLPNUM_TYPENAME_SZERO_TOLER;
+EGLPNUM_TYPENAME_EGlpNumTLS EGLPNUM_TYPE EGLPNUM_TYPENAME_PIVZ_TOLER;
+EGLPNUM_TYPENAME_EGlpNumTLS EGLPNUM_TYPE EGLPNUM_TYPENAME_OBJBND_TOLER;
+EGLPNUM_TYPENAME_EGlpNumTLS EGLPNUM_TYPE EGLPNUM_TYPENAME_DBNDPIV_TOLER;
+EGLPNUM_TYPENAME_EGlpNumTLS EGLPNUM_TYPE EGLPNUM_TYPENAME_DBNDPIV_RATIO;
+EGLPNUM_TYPENAME_EGlpNumTLS EGLPNUM_TYPE EGLPNUM_TYPENAME_ALTPIV_TOLER;
 //EGLPNUM_TYPE DJZERO_TOLER;
-EGLPNUM_TYPE EGLPNUM_TYPENAME_PROGRESS_ZERO;				/*   1e-7 */
-EGLPNUM_TYPE EGLPNUM_TYPENAME_PROGRESS_THRESH;			/*   1e-5 */
-EGLPNUM_TYPE EGLPNUM_TYPENAME_CB_EPS;
-EGLPNUM_TYPE EGLPNUM_TYPENAME_CB_INF_RATIO;
-EGLPNUM_TYPE EGLPNUM_TYPENAME_CB_PRI_RLIMIT;
-EGLPNUM_TYPE EGLPNUM_TYPENAME_ILL_MAXDOUBLE;
-EGLPNUM_TYPE EGLPNUM_TYPENAME_ILL_MINDOUBLE;
+EGLPNUM_TYPENAME_EGlpNumTLS EGLPNUM_TYPE EGLPNUM_TYPENAME_PROGRESS_ZERO;				/*   1e-7 */
+EGLPNUM_TYPENAME_EGlpNumTLS EGLPNUM_TYPE EGLPNUM_TYPENAME_PROGRESS_THRESH;			/*   1e-5 */
+EGLPNUM_TYPENAME_EGlpNumTLS EGLPNUM_TYPE EGLPNUM_TYPENAME_CB_EPS;
+EGLPNUM_TYPENAME_EGlpNumTLS EGLPNUM_TYPE EGLPNUM_TYPENAME_CB_INF_RATIO;
+EGLPNUM_TYPENAME_EGlpNumTLS EGLPNUM_TYPE EGLPNUM_TYPENAME_CB_PRI_RLIMIT;
+EGLPNUM_TYPENAME_EGlpNumTLS EGLPNUM_TYPE EGLPNUM_TYPENAME_ILL_MAXDOUBLE;
+EGLPNUM_TYPENAME_EGlpNumTLS EGLPNUM_TYPE EGLPNUM_TYPENAME_ILL_MINDOUBLE;
 
 /* ========================================================================= */
-int EGLPNUM_TYPENAME___QSEX_SETUP = 0;
+EGLPNUM_TYPENAME_EGlpNumTLS int EGLPNUM_TYPENAME___QSEX_SETUP = 0;
 /* ========================================================================= */
 void EGLPNUM_TYPENAME_ILLstart ( void)
 {
@@ -187,6 +187,12 @@ void EGLPNUM_TYPENAME_ILLstart ( void)
 /* ========================================================================= */
 void EGLPNUM_TYPENAME_ILLchange_precision (void)
 {
+	/* first use in this thread, nothing to change */
+	if (!EGLPNUM_TYPENAME___QSEX_SETUP)
+	{
+		EGLPNUM_TYPENAME_ILLstart ();
+		return;
+	}
 	EGLPNUM_TYPENAME_EGlpNumClearVar (EGLPNUM_TYPENAME_PFEAS_TOLER);
 	EGLPNUM_TYPENAME_EGlpNumClearVar (EGLPNUM_TYPENAME_BD_TOLER);
 	EGLPNUM_TYPENAME_EGlpNumClearVar (EGLPNUM_TYPENAME_DFEAS_TOLER);
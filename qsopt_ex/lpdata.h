@@ -33,8 +33,8 @@
 #include "format_EGLPNUM_TYPENAME.h"
 #include "dstruct_EGLPNUM_TYPENAME.h"
 
-extern EGLPNUM_TYPE EGLPNUM_TYPENAME_ILL_MAXDOUBLE;	/*  1e150 */
-extern EGLPNUM_TYPE EGLPNUM_TYPENAME_ILL_MINDOUBLE;	/* -1e150 */
+extern EGLPNUM_TYPENAME_EGlpNumTLS EGLPNUM_TYPE EGLPNUM_TYPENAME_ILL_MAXDOUBLE;	/*  1e150 */
+extern EGLPNUM_TYPENAME_EGlpNumTLS EGLPNUM_TYPE EGLPNUM_TYPENAME_ILL_MINDOUBLE;	/* -1e150 */
 
 #define EGLPNUM_TYPENAME_ILL_MAXINT    (2147483647)	/* this is equal to 2^31-1 */
 #define EGLPNUM_TYPENAME_ILL_MIN       (1)				/* Must be same as QS_MIN */
@@ -298,6 +298,6 @@ int EGLPNUM_TYPENAME_ILLlp_add_logicals (
 /* if non-zero, then internal data has been initialized, and there is some
  * memory allocated, if zero, no internal memory has been allocated
  * (or it has been freed) */
-extern int EGLPNUM_TYPENAME___QSEX_SETUP;
+extern EGLPNUM_TYPENAME_EGlpNumTLS int EGLPNUM_TYPENAME___QSEX_SETUP;
 
 #endif /* __ILL_LPDATA_H */
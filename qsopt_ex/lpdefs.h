@@ -37,25 +37,25 @@
 #include "basicdefs.h"
 /* tolerances, these are initialized in EGLPNUM_TYPENAME_ILLstart, file lpdata.c */
 /* these three constants are defined in lpdata.c */
-extern EGLPNUM_TYPE EGLPNUM_TYPENAME_PARAM_IBASIS_RPIVOT;	/*       0.98 */
-extern EGLPNUM_TYPE EGLPNUM_TYPENAME_PARAM_IBASIS_RTRIANG;/*       0.01 */
-extern EGLPNUM_TYPE EGLPNUM_TYPENAME_PARAM_MIN_DNORM;			/*      1e-24 */
-extern EGLPNUM_TYPE EGLPNUM_TYPENAME_PFEAS_TOLER;					/*       1e-6 */
-extern EGLPNUM_TYPE EGLPNUM_TYPENAME_BD_TOLER;						/*       1e-7 */
-extern EGLPNUM_TYPE EGLPNUM_TYPENAME_DFEAS_TOLER;					/*       1e-6 */
-extern EGLPNUM_TYPE EGLPNUM_TYPENAME_PIVOT_TOLER;					/*      1e-10 */
-extern EGLPNUM_TYPE EGLPNUM_TYPENAME_SZERO_TOLER;					/*      1e-15 */
-extern EGLPNUM_TYPE EGLPNUM_TYPENAME_PIVZ_TOLER;					/*      1e-12 */
-extern EGLPNUM_TYPE EGLPNUM_TYPENAME_OBJBND_TOLER;				/*       1e-2 */
-extern EGLPNUM_TYPE EGLPNUM_TYPENAME_DBNDPIV_TOLER;				/*       1e-3 */
-extern EGLPNUM_TYPE EGLPNUM_TYPENAME_DBNDPIV_RATIO;				/*       1e-2 */
-extern EGLPNUM_TYPE EGLPNUM_TYPENAME_ALTPIV_TOLER;				/*       1e-8 */
+extern EGLPNUM_TYPENAME_EGlpNumTLS EGLPNUM_TYPE EGLPNUM_TYPENAME_PARAM_IBASIS_RPIVOT;	/*       0.98 */
+extern EGLPNUM_TYPENAME_EGlpNumTLS EGLPNUM_TYPE EGLPNUM_TYPENAME_PARAM_IBASIS_RTRIANG;/*       0.01 */
+extern EGLPNUM_TYPENAME_EGlpNumTLS EGLPNUM_TYPE EGLPNUM_TYPENAME_PARAM_MIN_DNORM;			/*      1e-24 */
+extern EGLPNUM_TYPENAME_EGlpNumTLS EGLPNUM_TYPE EGLPNUM_TYPENAME_PFEAS_TOLER;					/*       1e-6 */
+extern EGLPNUM_TYPENAME_EGlpNumTLS EGLPNUM_TYPE EGLPNUM_TYPENAME_BD_TOLER;						/*       1e-7 */
+extern EGLPNUM_TYPENAME_EGlpNumTLS EGLPNUM_TYPE EGLPNUM_TYPENAME_DFEAS_TOLER;					/*       1e-6 */
+extern EGLPNUM_TYPENAME_EGlpNumTLS EGLPNUM_TYPE EGLPNUM_TYPENAME_PIVOT_TOLER;					/*      1e-10 */
+extern EGLPNUM_TYPENAME_EGlpNumTLS EGLPNUM_TYPE EGLPNUM_TYPENAME_SZERO_TOLER;					/*      1e-15 */
+extern EGLPNUM_TYPENAME_EGlpNumTLS EGLPNUM_TYPE EGLPNUM_TYPENAME_PIVZ_TOLER;					/*      1e-12 */
+extern EGLPNUM_TYPENAME_EGlpNumTLS EGLPNUM_TYPE EGLPNUM_TYPENAME_OBJBND_TOLER;				/*       1e-2 */
+extern EGLPNUM_TYPENAME_EGlpNumTLS EGLPNUM_TYPE EGLPNUM_TYPENAME_DBNDPIV_TOLER;				/*       1e-3 */
+extern EGLPNUM_TYPENAME_EGlpNumTLS EGLPNUM_TYPE EGLPNUM_TYPENAME_DBNDPIV_RATIO;				/*       1e-2 */
+extern EGLPNUM_TYPENAME_EGlpNumTLS EGLPNUM_TYPE EGLPNUM_TYPENAME_ALTPIV_TOLER;				/*       1e-8 */
 //extern EGLPNUM_TYPE DJZERO_TOLER;/*             1e-8 */
-extern EGLPNUM_TYPE EGLPNUM_TYPENAME_PROGRESS_ZERO;				/*       1e-7 */
-extern EGLPNUM_TYPE EGLPNUM_TYPENAME_PROGRESS_THRESH;			/*       1e-5 */
-extern EGLPNUM_TYPE EGLPNUM_TYPENAME_CB_EPS;							/*      0.001 */
-extern EGLPNUM_TYPE EGLPNUM_TYPENAME_CB_INF_RATIO;				/*       10.0 */
-extern EGLPNUM_TYPE EGLPNUM_TYPENAME_CB_PRI_RLIMIT;				/*       0.25 */
+extern EGLPNUM_TYPENAME_EGlpNumTLS EGLPNUM_TYPE EGLPNUM_TYPENAME_PROGRESS_ZERO;				/*       1e-7 */
+extern EGLPNUM_TYPENAME_EGlpNumTLS EGLPNUM_TYPE EGLPNUM_TYPENAME_PROGRESS_THRESH;			/*       1e-5 */
+extern EGLPNUM_TYPENAME_EGlpNumTLS EGLPNUM_TYPE EGLPNUM_TYPENAME_CB_EPS;							/*      0.001 */
+extern EGLPNUM_TYPENAME_EGlpNumTLS EGLPNUM_TYPE EGLPNUM_TYPENAME_CB_INF_RATIO;				/*       10.0 */
+extern EGLPNUM_TYPENAME_EGlpNumTLS EGLPNUM_TYPE EGLPNUM_TYPENAME_CB_PRI_RLIMIT;				/*       0.25 */
 
 /* structure for statistics */
 typedef struct
@@ -250,6 +250,7 @@ typedef struct EGLPNUM_TYPENAME_lpinfo
 
 	int maxiter;
 	int iterskip;
+	int factor_threads;						/* threads used to factor the basis */
 	double maxtime;
 	double starttime;
 	struct EGLPNUM_TYPENAME_ILLlpdata *O;
@@ -46,6 +46,7 @@
 #include "dstruct_EGLPNUM_TYPENAME.h"
 
 #define  MULTIP 1
+#define  NORM_BLOCK 32					/* norms computed by one multiple solve */
 #define  PRICE_DEBUG 0
 
 
@@ -753,30 +754,63 @@ int EGLPNUM_TYPENAME_ILLprice_update_pdevex_norms (
 	return 0;
 }
 
+/* set *nb to how many of the left norms still to compute the multiple solve
+ * takes together (btran selects the row solve), and allocate the vectors
+ * z[*nalloc..*nb-1] that the block still lacks */
+static int norm_block (
+	EGLPNUM_TYPENAME_lpinfo * const lp,
+	EGLPNUM_TYPENAME_svector * const z,
+	int *const nalloc,
+	int const left,
+	int const btran,
+	int *const nb)
+{
+	int rval = 0;
+
+	*nb = EGLPNUM_TYPENAME_ILLfactor_multi_width (lp->f,
+															left < NORM_BLOCK ? left : NORM_BLOCK, btran);
+	while (*nalloc < *nb)
+	{
+		rval = EGLPNUM_TYPENAME_ILLsvector_alloc (z + *nalloc, lp->nrows);
+		CHECKRVALG(rval,CLEANUP);
+		(*nalloc)++;
+	}
+
+CLEANUP:
+	EG_RETURN(rval);
+}
+
 int EGLPNUM_TYPENAME_ILLprice_build_psteep_norms (
 	EGLPNUM_TYPENAME_lpinfo * const lp,
 	EGLPNUM_TYPENAME_p_steep_info * const psinfo)
 {
-	int j;
+	int j, b, nb;
+	int nalloc = 0;
 	int rval = 0;
-	EGLPNUM_TYPENAME_svector yz;
+	EGLPNUM_TYPENAME_svector yz[NORM_BLOCK];
 
-	EGLPNUM_TYPENAME_ILLsvector_init (&yz);
-	rval = EGLPNUM_TYPENAME_ILLsvector_alloc (&yz, lp->nrows);
-	CHECKRVALG(rval,CLEANUP);
+	for (j = 0; j < NORM_BLOCK; j++)
+		EGLPNUM_TYPENAME_ILLsvector_init (yz + j);
 	psinfo->norms = EGLPNUM_TYPENAME_EGlpNumAllocArray (lp->nnbasic);
 
-	for (j = 0; j < lp->nnbasic; j++)
+	for (b = 0; b < lp->nnbasic; b += nb)
 	{
 		rval = ILLstring_report (NULL, &lp->O->reporter);
 		CHECKRVALG(rval,CLEANUP);
-		EGLPNUM_TYPENAME_ILLfct_compute_yz (lp, &yz, 0, lp->nbaz[j]);
-		EGLPNUM_TYPENAME_EGlpNumInnProd (psinfo->norms[j], yz.coef, yz.coef, (size_t) yz.nzcnt);
-		EGLPNUM_TYPENAME_EGlpNumAddTo (psinfo->norms[j], EGLPNUM_TYPENAME_oneLpNum);
+		rval = norm_block (lp, yz, &nalloc, lp->nnbasic - b, 0, &nb);
+		CHECKRVALG(rval,CLEANUP);
+		rval = EGLPNUM_TYPENAME_ILLfct_compute_yz_multi (lp, nb, yz, lp->nbaz + b);
+		CHECKRVALG(rval,CLEANUP);
+		for (j = 0; j < nb; j++)
+		{
+			EGLPNUM_TYPENAME_EGlpNumInnProd (psinfo->norms[b + j], yz[j].coef, yz[j].coef, (size_t) yz[j].nzcnt);
+			EGLPNUM_TYPENAME_EGlpNumAddTo (psinfo->norms[b + j], EGLPNUM_TYPENAME_oneLpNum);
+		}
 	}
 
 CLEANUP:
-	EGLPNUM_TYPENAME_ILLsvector_free (&yz);
+	for (j = 0; j < NORM_BLOCK; j++)
+		EGLPNUM_TYPENAME_ILLsvector_free (yz + j);
 	if (rval)
 		EGLPNUM_TYPENAME_EGlpNumFreeArray (psinfo->norms);
 
@@ -948,29 +982,39 @@ int EGLPNUM_TYPENAME_ILLprice_build_dsteep_norms (
 	EGLPNUM_TYPENAME_lpinfo * const lp,
 	EGLPNUM_TYPENAME_d_steep_info * const dsinfo)
 {
-	int i;
+	int i, j, nb;
+	int nalloc = 0;
 	int rval = 0;
-	EGLPNUM_TYPENAME_svector z;
+	int rows[NORM_BLOCK];
+	EGLPNUM_TYPENAME_svector z[NORM_BLOCK];
 
-	EGLPNUM_TYPENAME_ILLsvector_init (&z);
-	rval = EGLPNUM_TYPENAME_ILLsvector_alloc (&z, lp->nrows);
-	CHECKRVALG(rval,CLEANUP);
+	for (j = 0; j < NORM_BLOCK; j++)
+		EGLPNUM_TYPENAME_ILLsvector_init (z + j);
 	dsinfo->norms = EGLPNUM_TYPENAME_EGlpNumAllocArray (lp->nrows);
 
-	for (i = 0; i < lp->nrows; i++)
+	for (i = 0; i < lp->nrows; i += nb)
 	{
 		rval = ILLstring_report (NULL, &lp->O->reporter);
 		CHECKRVALG(rval,CLEANUP);
+		rval = norm_block (lp, z, &nalloc, lp->nrows - i, 1, &nb);
+		CHECKRVALG(rval,CLEANUP);
+		for (j = 0; j < nb; j++)
+			rows[j] = i + j;
 
-		EGLPNUM_TYPENAME_ILLfct_compute_zz (lp, &z, i);
+		rval = EGLPNUM_TYPENAME_ILLfct_compute_zz_multi (lp, nb, z, rows);
+		CHECKRVALG(rval,CLEANUP);
 
-		EGLPNUM_TYPENAME_EGlpNumInnProd (dsinfo->norms[i], z.coef, z.coef, (size_t) z.nzcnt);
-		if (EGLPNUM_TYPENAME_EGlpNumIsLess (dsinfo->norms[i], EGLPNUM_TYPENAME_PARAM_MIN_DNORM))
-			EGLPNUM_TYPENAME_EGlpNumCopy (dsinfo->norms[i], EGLPNUM_TYPENAME_PARAM_MIN_DNORM);
+		for (j = 0; j < nb; j++)
+		{
+			EGLPNUM_TYPENAME_EGlpNumInnProd (dsinfo->norms[i + j], z[j].coef, z[j].coef, (size_t) z[j].nzcnt);
+			if (EGLPNUM_TYPENAME_EGlpNumIsLess (dsinfo->norms[i + j], EGLPNUM_TYPENAME_PARAM_MIN_DNORM))
+				EGLPNUM_TYPENAME_EGlpNumCopy (dsinfo->norms[i + j], EGLPNUM_TYPENAME_PARAM_MIN_DNORM);
+		}
 	}
 
 CLEANUP:
-	EGLPNUM_TYPENAME_ILLsvector_free (&z);
+	for (j = 0; j < NORM_BLOCK; j++)
+		EGLPNUM_TYPENAME_ILLsvector_free (z + j);
 	if (rval)
 		EGLPNUM_TYPENAME_EGlpNumFreeArray (dsinfo->norms);
 
@@ -983,22 +1027,26 @@ int EGLPNUM_TYPENAME_ILLprice_get_dsteep_norms (
 	int *const rowind,
 	EGLPNUM_TYPE * const norms)
 {
-	int i;
+	int i, j, nb;
+	int nalloc = 0;
 	int rval = 0;
-	EGLPNUM_TYPENAME_svector z;
+	EGLPNUM_TYPENAME_svector z[NORM_BLOCK];
 
-	EGLPNUM_TYPENAME_ILLsvector_init (&z);
-	rval = EGLPNUM_TYPENAME_ILLsvector_alloc (&z, lp->nrows);
-	CHECKRVALG(rval,CLEANUP);
-
-	for (i = 0; i < count; i++)
+	for (j = 0; j < NORM_BLOCK; j++)
+		EGLPNUM_TYPENAME_ILLsvector_init (z + j);
+	for (i = 0; i < count; i += nb)
 	{
-		EGLPNUM_TYPENAME_ILLfct_compute_zz (lp, &z, rowind[i]);
-		EGLPNUM_TYPENAME_EGlpNumInnProd (norms[i], z.coef, z.coef, (size_t) z.nzcnt);
+		rval = norm_block (lp, z, &nalloc, count - i, 1, &nb);
+		CHECKRVALG(rval,CLEANUP);
+		rval = EGLPNUM_TYPENAME_ILLfct_compute_zz_multi (lp, nb, z, rowind + i);
+		CHECKRVALG(rval,CLEANUP);
+		for (j = 0; j < nb; j++)
+			EGLPNUM_TYPENAME_EGlpNumInnProd (norms[i + j], z[j].coef, z[j].coef, (size_t) z[j].nzcnt);
 	}
 
 CLEANUP:
-	EGLPNUM_TYPENAME_ILLsvector_free (&z);
+	for (j = 0; j < NORM_BLOCK; j++)
+		EGLPNUM_TYPENAME_ILLsvector_free (z + j);
 	EG_RETURN(rval);
 }
 
@@ -89,6 +89,8 @@ static int TRACE = 0;
 /*    int EGLPNUM_TYPENAME_QSget_binv_row (EGLPNUM_TYPENAME_QSdata *p, int indx, double *binvrow)             */
 /*    int EGLPNUM_TYPENAME_QSget_tableau_row (EGLPNUM_TYPENAME_QSdata *p, int indx, double *tableaurow)       */
 /*    int EGLPNUM_TYPENAME_QSget_basis_order (EGLPNUM_TYPENAME_QSdata *p, int *basorder)                      */
+/*    int EGLPNUM_TYPENAME_QSget_basis_condition (EGLPNUM_TYPENAME_QSdata *p, double *cond,                   */
+/*        double *growth)                                                   */
 /*    int EGLPNUM_TYPENAME_QSget_status (EGLPNUM_TYPENAME_QSdata *p, int *status)                             */
 /*    int EGLPNUM_TYPENAME_QSget_solution (EGLPNUM_TYPENAME_QSdata *p, double *value, double *x,              */
 /*        double *pi, double *slack, double *rc),                           */
@@ -189,6 +191,15 @@ void EGLPNUM_TYPENAME_QSset_precision (const unsigned prec) {
 	/* change the numbers */
 }
 
+/* switch the calling thread to the precision p was built with, so that the
+ * tolerances match the numbers in p whatever other problems the thread (or
+ * other threads) solved before */
+static void use_precision (EGLPNUM_TYPENAME_QSdata * p)
+{
+	if (EGLPNUM_TYPENAME_EGlpNumHasPrecision && p->precision != EGLPNUM_PRECISION)
+		EGLPNUM_TYPENAME_QSset_precision (p->precision);
+}
+
 static void init_basis (QSbasis * B), free_cache (EGLPNUM_TYPENAME_QSdata * p);
 
 static int opt_work ( EGLPNUM_TYPENAME_QSdata * p, int *status, int primal_or_dual),
@@ -265,6 +276,7 @@ static int opt_work (EGLPNUM_TYPENAME_QSdata * p, int *status, int primal_or_dua
 	int rstatus = QS_LP_UNSOLVED;
 	EGLPNUM_TYPENAME_QSdata *p2 = 0;
 
+	use_precision (p);
 	if (p->basis)
 	{
 		if (p->basis->nstruct != p->qslp->nstruct ||
@@ -523,6 +535,24 @@ EGLPNUM_TYPENAME_QSLIB_INTERFACE EGLPNUM_TYPENAME_QSdata *EGLPNUM_TYPENAME_QScre
 
 	p->cached_lu = 0;
 	p->cached_baz = 0;
+	p->cached_lu_mpf = 0;
+	p->free_cached_lu_mpf = 0;
+	memset (&(p->exact_lu_stats), 0, sizeof (QSexact_lu_stats));
+	p->exact_info.race_winner = -1;
+	p->exact_info.rung = -1;
+	p->exact_info.resumed = -1;
+	p->exact_info.nsaved = 0;
+	p->exact_basis_solver = QS_EXACT_BASIS_SOLVER_LU;
+	p->exact_lu_update = QS_EXACT_LU_UPDATE_ETA;
+	p->exact_race = QS_EXACT_RACE_OFF;
+	p->exact_reconstruct = QS_EXACT_RECONSTRUCT_DEFAULT;
+	p->exact_schedule = QS_EXACT_SCHEDULE_FIXED;
+	p->exact_nrungs = 0;
+	p->exact_rungs = 0;
+	p->exact_rung_time = 0;
+	p->exact_checkpoint = 0;
+	p->exact_resume = 0;
+	p->precision = EGLPNUM_PRECISION;
 
 	p->itcnt.pI_iter = 0;
 	p->itcnt.pII_iter = 0;
@@ -2257,6 +2287,40 @@ CLEANUP:
 	EG_RETURN (rval);
 }
 
+/* ========================================================================= */
+/** @brief estimate the 1-norm condition number of the final basis of p and
+ * the element growth of its LU factorization.
+ * @param cond where we return a (lower bound) estimate of
+ * \f$\|B\|_1\|B^{-1}\|_1\f$, see #EGLPNUM_TYPENAME_ILLbasis_condition.
+ * @param growth if not NULL, where we return the ratio between the largest
+ * element of the factors and the largest element of B.
+ * @note both are measured on the (possibly scaled) problem the simplex works
+ * on, and cost a few FTRAN/BTRAN calls. */
+EGLPNUM_TYPENAME_QSLIB_INTERFACE int EGLPNUM_TYPENAME_QSget_basis_condition (
+	EGLPNUM_TYPENAME_QSdata * p,
+	double *cond,
+	double *growth)
+{
+	int rval = 0;
+
+	rval = check_qsdata_pointer (p);
+	CHECKRVALG (rval, CLEANUP);
+
+	if (p->lp == 0 || p->lp->basisid == -1)
+	{
+		QSlog("LP has no basis in EGLPNUM_TYPENAME_QSget_basis_condition");
+		rval = 1;
+		goto CLEANUP;
+	}
+
+	rval = EGLPNUM_TYPENAME_ILLlib_basis_condition (p->lp, cond, growth);
+	CHECKRVALG (rval, CLEANUP);
+
+CLEANUP:
+
+	EG_RETURN (rval);
+}
+
 EGLPNUM_TYPENAME_QSLIB_INTERFACE int EGLPNUM_TYPENAME_QScompute_row_norms (
 	EGLPNUM_TYPENAME_QSdata * p)
 {
@@ -2327,7 +2391,25 @@ EGLPNUM_TYPENAME_QSLIB_INTERFACE void EGLPNUM_TYPENAME_QSfree_prob (
 			EGLPNUM_TYPENAME_ILLprice_free_pricing_info (p->pricing);
 			ILL_IFFREE(p->pricing);
 		}
+		if (p->cached_lu)
+		{
+			EGLPNUM_TYPENAME_ILLfactor_free_factor_work (p->cached_lu);
+			EGLPNUM_TYPENAME_EGlpNumClearVar (p->cached_lu->fzero_tol);
+			EGLPNUM_TYPENAME_EGlpNumClearVar (p->cached_lu->szero_tol);
+			EGLPNUM_TYPENAME_EGlpNumClearVar (p->cached_lu->partial_tol);
+			EGLPNUM_TYPENAME_EGlpNumClearVar (p->cached_lu->maxelem_orig);
+			EGLPNUM_TYPENAME_EGlpNumClearVar (p->cached_lu->maxelem_factor);
+			EGLPNUM_TYPENAME_EGlpNumClearVar (p->cached_lu->maxelem_cur);
+			EGLPNUM_TYPENAME_EGlpNumClearVar (p->cached_lu->partial_cur);
+			ILL_IFFREE(p->cached_lu);
+		}
+		ILL_IFFREE(p->cached_baz);
+		if (p->cached_lu_mpf && p->free_cached_lu_mpf)
+			p->free_cached_lu_mpf (p->cached_lu_mpf);
 		ILL_IFFREE(p->name);
+		ILL_IFFREE(p->exact_rungs);
+		ILL_IFFREE(p->exact_rung_time);
+		ILL_IFFREE(p->exact_checkpoint);
 
 		ILL_IFFREE(p);
 	}
@@ -3418,6 +3500,85 @@ EGLPNUM_TYPENAME_QSLIB_INTERFACE int EGLPNUM_TYPENAME_QSset_param (
 			goto CLEANUP;
 		}
 		break;
+	case QS_PARAM_EXACT_BASIS_SOLVER:
+		if (newvalue == QS_EXACT_BASIS_SOLVER_LU ||
+				newvalue == QS_EXACT_BASIS_SOLVER_BAREISS ||
+				newvalue == QS_EXACT_BASIS_SOLVER_MODULAR ||
+				newvalue == QS_EXACT_BASIS_SOLVER_DIXON)
+		{
+			p->exact_basis_solver = newvalue;
+		}
+		else
+		{
+			QSlog("illegal value for QS_PARAM_EXACT_BASIS_SOLVER");
+			rval = 1;
+			goto CLEANUP;
+		}
+		break;
+	case QS_PARAM_EXACT_LU_UPDATE:
+		if (newvalue == QS_EXACT_LU_UPDATE_ETA ||
+				newvalue == QS_EXACT_LU_UPDATE_SCHUR)
+		{
+			p->exact_lu_update = newvalue;
+		}
+		else
+		{
+			QSlog("illegal value for QS_PARAM_EXACT_LU_UPDATE");
+			rval = 1;
+			goto CLEANUP;
+		}
+		break;
+	case QS_PARAM_EXACT_RACE:
+		if (newvalue == QS_EXACT_RACE_OFF ||
+				newvalue == QS_EXACT_RACE_MPF128 ||
+				newvalue == QS_EXACT_RACE_MPF192)
+		{
+			p->exact_race = newvalue;
+		}
+		else
+		{
+			QSlog("illegal value for QS_PARAM_EXACT_RACE");
+			rval = 1;
+			goto CLEANUP;
+		}
+		break;
+	case QS_PARAM_EXACT_RECONSTRUCT:
+		if (newvalue >= 0)
+		{
+			p->exact_reconstruct = newvalue;
+		}
+		else
+		{
+			QSlog("illegal value for QS_PARAM_EXACT_RECONSTRUCT");
+			rval = 1;
+			goto CLEANUP;
+		}
+		break;
+	case QS_PARAM_EXACT_PRECISION_SCHEDULE:
+		if (newvalue == QS_EXACT_SCHEDULE_FIXED ||
+				newvalue == QS_EXACT_SCHEDULE_SKIP)
+		{
+			p->exact_schedule = newvalue;
+		}
+		else
+		{
+			QSlog("illegal value for QS_PARAM_EXACT_PRECISION_SCHEDULE");
+			rval = 1;
+			goto CLEANUP;
+		}
+		break;
+	case QS_PARAM_FACTOR_THREADS:
+		if (newvalue > 0)
+		{
+			p->lp->factor_threads = newvalue;
+		}
+		else
+		{
+			QSlog("illegal value for QS_PARAM_FACTOR_THREADS");
+			rval = 1;
+			goto CLEANUP;
+		}
+		break;
 	default:
 		QSlog("unknown parameter: %d", whichparam);
 		rval = 1;
@@ -3515,6 +3676,24 @@ EGLPNUM_TYPENAME_QSLIB_INTERFACE int EGLPNUM_TYPENAME_QSget_param (
 	case QS_PARAM_SIMPLEX_SCALING:
 		*value = p->simplex_scaling;
 		break;
+	case QS_PARAM_EXACT_BASIS_SOLVER:
+		*value = p->exact_basis_solver;
+		break;
+	case QS_PARAM_EXACT_LU_UPDATE:
+		*value = p->exact_lu_update;
+		break;
+	case QS_PARAM_EXACT_RACE:
+		*value = p->exact_race;
+		break;
+	case QS_PARAM_EXACT_RECONSTRUCT:
+		*value = p->exact_reconstruct;
+		break;
+	case QS_PARAM_EXACT_PRECISION_SCHEDULE:
+		*value = p->exact_schedule;
+		break;
+	case QS_PARAM_FACTOR_THREADS:
+		*value = p->lp->factor_threads;
+		break;
 	default:
 		QSlog("unknown parameter: %d", whichparam);
 		rval = 1;
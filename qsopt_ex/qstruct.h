@@ -46,6 +46,37 @@ typedef struct EGLPNUM_TYPENAME_qsdata
 
 	struct EGLPNUM_TYPENAME_factor_work *cached_lu;
 	int *cached_baz;
+	struct mpf_factor_work *cached_lu_mpf;	/* 128-bit copy of cached_lu the
+																				 * exact solver updates with it */
+	void (*free_cached_lu_mpf) (struct mpf_factor_work *);	/* releases
+																													 * cached_lu_mpf */
+	QSexact_lu_stats exact_lu_stats;	/* how the exact solver kept cached_lu in
+																 * sync, only used by the exact solver */
+	QSexact_solve_info exact_info;	/* path taken by the last exact solve */
+	int exact_basis_solver;				/* QS_EXACT_BASIS_SOLVER_xxx, only used by
+																 * the exact solver */
+	int exact_lu_update;					/* QS_EXACT_LU_UPDATE_xxx, how the exact
+																 * solver keeps cached_lu in sync */
+	int exact_race;								/* QS_EXACT_RACE_xxx, which precisions the
+																 * exact solver runs concurrently */
+	int exact_reconstruct;				/* largest denominator the exact solver
+																 * snaps approximate solutions to, zero to
+																 * test them as computed */
+	int exact_schedule;						/* QS_EXACT_SCHEDULE_xxx, how the exact
+																 * solver walks its precision schedule */
+	int exact_nrungs;							/* number of entries in exact_rungs, zero
+																 * for the default schedule */
+	unsigned *exact_rungs;				/* bits of each mpf rung of the exact
+																 * solver */
+	double *exact_rung_time;			/* seconds allowed to each rung, zero or
+																 * less for no limit */
+	char *exact_checkpoint;				/* file the exact solver saves its state
+																 * to after every rung, or null */
+	int exact_resume;							/* if set, the next exact solve resumes
+																 * from exact_checkpoint */
+	unsigned precision;						/* bits of the numbers in the problem, the
+																 * calling thread switches to it before
+																 * solving (mpf only) */
 }
 EGLPNUM_TYPENAME_QSdata;
 
@@ -135,6 +135,7 @@ void EGLPNUM_TYPENAME_ILLsimplex_load_lpinfo (
 	lp->maxtime = 300000;
 	//lp->iterskip = 10;
 	lp->iterskip = 100;
+	lp->factor_threads = 1;
 	EGLPNUM_TYPENAME_EGlpNumCopy (lp->objbound, EGLPNUM_TYPENAME_INFTY);
 	lp->O = qslp;
 }
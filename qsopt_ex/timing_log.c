@@ -10,7 +10,8 @@ void log_timing(const char *label, double seconds) {
     FILE *fp = fopen(LOG_FILE, "a");
     if (fp) {
         time_t now = time(NULL);
-        char *timestamp = ctime(&now);
+        char buf[32];  // ctime_r, the log is written from several threads
+        char *timestamp = ctime_r(&now, buf);
         timestamp[strcspn(timestamp, "\n")] = 0;  // strips the newline created by previous live
         fprintf(fp, "[%s] %s%.10f seconds\n", timestamp, label, seconds);
         fclose(fp);
@@ -35,7 +36,8 @@ void log_session_header(const char *label) {
     FILE *fp = fopen(LOG_FILE, "a");
     if (fp) {
         time_t now = time(NULL);
-        char *timestamp = ctime(&now);
+        char buf[32];
+        char *timestamp = ctime_r(&now, buf);
         timestamp[strcspn(timestamp, "\n")] = 0;
 
         fprintf(fp, "============================================================\n");
@@ -51,7 +53,8 @@ void log_session_footer(const char *label) {
     FILE *fp = fopen(LOG_FILE, "a");
     if (fp) {
         time_t now = time(NULL);
-        char *timestamp = ctime(&now);
+        char buf[32];
+        char *timestamp = ctime_r(&now, buf);
         timestamp[strcspn(timestamp, "\n")] = 0;
 
         fprintf(fp, "Solved Problem: %s\n", label);
@@ -56,7 +56,7 @@
 /*    want to time, then compute ILLutil_zeit () - t.                       */
 /*                                                                          */
 /*  double ILLutil_real_zeit (void)                                         */
-/*    - To measure wall clock time.                                         */
+/*    - To measure wall clock time (with gettimeofday resolution).          */
 /*                                                                          */
 /*    To use this, set double t = ILLutil_real_zeit (), run the function    */
 /*    you want to time, then compute ILLutil_real_zeit () - t.              */
@@ -93,6 +93,7 @@
 #include <stdio.h>
 #include <string.h>
 #include <time.h>
+#include <sys/time.h>
 
 #include "logging-private.h"
 
@@ -199,7 +200,10 @@ double ILLutil_zeit (void)
 double ILLutil_real_zeit (
 	void)
 {
-	return time (0);
+	struct timeval now;
+
+	gettimeofday (&now, 0);
+	return ((double) now.tv_sec) + ((double) now.tv_usec) / 1000000.0;
 }
 
 void ILLutil_init_timer (ILLutil_timer * t, const char *name)
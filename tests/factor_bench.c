@@ -0,0 +1,156 @@
+/*
+ * This file is part of QSopt_ex.
+ *
+ * (c) Copyright 2006 by David Applegate, William Cook, Sanjeeb Dash,
+ * and Daniel Espinoza
+ *
+ * Sanjeeb Dash ownership of copyright in QSopt_ex is derived from his
+ * copyright in QSopt.
+ *
+ * This code may be used under the terms of the GNU General Public License
+ * (Version 2.1 or later) as published by the Free Software Foundation.
+ *
+ * Alternatively, use is granted for research purposes only.
+ *
+ * It is your choice of which of these two licenses you are operating
+ * under.
+ *
+ * We make no guarantees about the correctness or usefulness of this code.
+ */
+
+/* Time the dense double ftran and btran with a dense right hand side through
+ * the solve snapshots and through the factor structs, on a random banded
+ * basis:
+ *
+ *     factor_bench dim entries band reps
+ *
+ * Every third column is a unit column, the others have up to `entries'
+ * entries besides the diagonal, within `band' rows of it. */
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "QSopt_ex.h"
+
+int main(int ac, char **av)
+{
+    int n, d, w, reps;
+    int *basis = NULL, *cbeg = NULL, *clen = NULL, *cind = NULL;
+    double *cval = NULL;
+    double t[2][2] = { { 0, 0 }, { 0, 0 } }, t0;
+    int i, j, k, l, r, cnt = 0, nsing = 0, *singr = NULL, *singc = NULL;
+    int lnz = 0, unz = 0, same;
+    int rval = EXIT_FAILURE;
+    dbl_factor_work f;
+    dbl_svector a, x[2];
+
+    if (ac != 5) {
+        fprintf(stderr, "Usage: %s dim entries band reps\n", av[0]);
+        return EXIT_FAILURE;
+    }
+    n = atoi(av[1]);
+    d = atoi(av[2]);
+    w = atoi(av[3]);
+    reps = atoi(av[4]);
+    if (n < 1 || d < 0 || w < 0 || reps < 1) {
+        fprintf(stderr, "Bad arguments\n");
+        return EXIT_FAILURE;
+    }
+
+    QSexactStart();
+    memset(&f, 0, sizeof(f));
+    dbl_ILLfactor_init_factor_work(&f);
+    dbl_ILLsvector_init(&a);
+    dbl_ILLsvector_init(x);
+    dbl_ILLsvector_init(x + 1);
+
+    basis = malloc(n * sizeof(int));
+    cbeg = malloc(n * sizeof(int));
+    clen = malloc(n * sizeof(int));
+    cind = malloc((size_t) n * (d + 1) * sizeof(int));
+    cval = malloc((size_t) n * (d + 1) * sizeof(double));
+    if (!basis || !cbeg || !clen || !cind || !cval) {
+        fprintf(stderr, "Out of memory\n");
+        goto CLEANUP;
+    }
+    srand(11);
+    for (j = 0; j < n; j++) {
+        basis[j] = j;
+        cbeg[j] = cnt;
+        cind[cnt] = j;
+        cval[cnt++] = (rand() % 2 ? 1 : -1) * (0.5 + (rand() % 1000) / 1000.0);
+        for (k = 0; j % 3 && k < d; k++) {
+            r = (j + n + rand() % (2 * w + 1) - w) % n;
+            for (i = cbeg[j]; i < cnt && cind[i] != r; i++) ;
+            if (i < cnt) continue;
+            cind[cnt] = r;
+            cval[cnt++] = (rand() % 2001 - 1000) / 1000.0;
+        }
+        clen[j] = cnt - cbeg[j];
+    }
+
+    if (dbl_ILLfactor_create_factor_work(&f, n) ||
+        dbl_ILLfactor(&f, basis, cbeg, clen, cind, cval, &nsing, &singr,
+                      &singc) || nsing) {
+        fprintf(stderr, "Unable to factor the basis\n");
+        goto CLEANUP;
+    }
+    if (!f.snap_l || !f.snap_u) {
+        fprintf(stderr, "No solve snapshots were built\n");
+        goto CLEANUP;
+    }
+    if (dbl_ILLsvector_alloc(&a, n) || dbl_ILLsvector_alloc(x, n) ||
+        dbl_ILLsvector_alloc(x + 1, n)) {
+        fprintf(stderr, "Out of memory\n");
+        goto CLEANUP;
+    }
+    for (i = 0; i < n; i++) {
+        a.indx[i] = i;
+        a.coef[i] = (rand() % 2001 - 1000) / 1000.0 + 1e-3;
+    }
+    a.nzcnt = n;
+
+    /* k = 0 with the snapshots, k = 1 through the structs */
+    for (l = 0; l < reps; l++) {
+        for (k = 0; k < 2; k++) {
+            f.snap_l = f.snap_u = !k;
+            t0 = ILLutil_real_zeit();
+            dbl_ILLfactor_ftran(&f, &a, x + k);
+            t[k][0] += ILLutil_real_zeit() - t0;
+            t0 = ILLutil_real_zeit();
+            dbl_ILLfactor_btran(&f, &a, x + k);
+            t[k][1] += ILLutil_real_zeit() - t0;
+        }
+    }
+    same = x[0].nzcnt == x[1].nzcnt &&
+        !memcmp(x[0].coef, x[1].coef, x[0].nzcnt * sizeof(double));
+    for (i = 0; i < n; i++) {
+        lnz += f.lc_inf[i].nzcnt;
+        unz += f.ur_inf[i].nzcnt;
+    }
+    printf("dim %d L %d U %d\n", n, lnz, unz);
+    printf("ftran  structs %.4fs  snapshots %.4fs\n", t[1][0], t[0][0]);
+    printf("btran  structs %.4fs  snapshots %.4fs\n", t[1][1], t[0][1]);
+    printf("results %s\n", same ? "identical" : "DIFFER");
+    rval = same ? EXIT_SUCCESS : EXIT_FAILURE;
+
+CLEANUP:
+    dbl_ILLsvector_free(&a);
+    dbl_ILLsvector_free(x);
+    dbl_ILLsvector_free(x + 1);
+    dbl_ILLfactor_free_factor_work(&f);
+    free(singr);
+    free(singc);
+    free(basis);
+    free(cbeg);
+    free(clen);
+    free(cind);
+    free(cval);
+    QSexactClear();
+    return rval;
+}
@@ -25,9 +25,15 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <math.h>
 #include <gmp.h>
 
+#include "qs_config.h"
 #include "QSopt_ex.h"
+#include "fct_mpq.h"
+#include "exact_basis.h"
 
 typedef void test_func(int test_id);
 
@@ -105,6 +111,85 @@ CLEANUP:
     return rval;
 }
 
+/* Entries of the n x n Hilbert matrix, whose condition grows like e^(3.5 n) */
+static void hilbert_entry(mpq_t v, int n, int i, int j)
+{
+    (void) n;
+    mpq_set_ui(v, 1, i + j + 1);
+}
+
+/* Entries of Wilkinson's matrix: one on the diagonal and in the last column,
+ * minus one below the diagonal. Eliminating it in order doubles the last
+ * column at every step. */
+static void wilkinson_entry(mpq_t v, int n, int i, int j)
+{
+    mpq_set_si(v, i == j || j == n - 1 ? 1 : j < i ? -1 : 0, 1);
+}
+
+/* Load min sum(x) s.t. A x = A 1 with x free, so that A is the optimal basis
+ * and the objective value is n */
+static int load_square_problem(mpq_QSprob *p, int n,
+                               void (*entry)(mpq_t, int, int, int))
+{
+    int i, j, nz = 0, rval = 0;
+    int *cmatcnt = malloc(n * sizeof(int));
+    int *cmatbeg = malloc(n * sizeof(int));
+    int *cmatind = malloc(n * n * sizeof(int));
+    char *sense = malloc(n);
+    mpq_t *cmatval = malloc(n * n * sizeof(mpq_t));
+    mpq_t *obj = malloc(n * sizeof(mpq_t));
+    mpq_t *rhs = malloc(n * sizeof(mpq_t));
+    mpq_t *lower = malloc(n * sizeof(mpq_t));
+    mpq_t *upper = malloc(n * sizeof(mpq_t));
+
+    *p = NULL;
+    if (!cmatcnt || !cmatbeg || !cmatind || !sense || !cmatval || !obj ||
+        !rhs || !lower || !upper) {
+        free(cmatcnt); free(cmatbeg); free(cmatind); free(sense);
+        free(cmatval); free(obj); free(rhs); free(lower); free(upper);
+        return 1;
+    }
+    for (i = 0; i < n * n; i++) mpq_init(cmatval[i]);
+    for (i = 0; i < n; i++) {
+        mpq_init(obj[i]);
+        mpq_init(rhs[i]);
+        mpq_init(lower[i]);
+        mpq_init(upper[i]);
+        mpq_set_ui(obj[i], 1, 1);
+        mpq_set(lower[i], mpq_ILL_MINDOUBLE);
+        mpq_set(upper[i], mpq_ILL_MAXDOUBLE);
+        sense[i] = 'E';
+    }
+    for (j = 0; j < n; j++) {
+        cmatbeg[j] = nz;
+        for (i = 0; i < n; i++) {
+            entry(cmatval[nz], n, i, j);
+            if (mpq_sgn(cmatval[nz]) == 0) continue;
+            mpq_add(rhs[i], rhs[i], cmatval[nz]);
+            cmatind[nz++] = i;
+        }
+        cmatcnt[j] = nz - cmatbeg[j];
+    }
+
+    *p = mpq_QSload_prob("square", n, n, cmatcnt, cmatbeg, cmatind, cmatval,
+                         QS_MIN, obj, rhs, sense, lower, upper, NULL, NULL);
+    if (*p == NULL) {
+        fprintf(stderr, "Unable to load the LP problem\n");
+        rval = 1;
+    }
+
+    for (i = 0; i < n * n; i++) mpq_clear(cmatval[i]);
+    for (i = 0; i < n; i++) {
+        mpq_clear(obj[i]);
+        mpq_clear(rhs[i]);
+        mpq_clear(lower[i]);
+        mpq_clear(upper[i]);
+    }
+    free(cmatcnt); free(cmatbeg); free(cmatind); free(sense);
+    free(cmatval); free(obj); free(rhs); free(lower); free(upper);
+    return rval;
+}
+
 /* Load and solve test problem. */
 static int solve_test_problem(mpq_QSprob *p, int *status)
 {
@@ -508,6 +593,484 @@ CLEANUP:
     mpq_clear(value);
 }
 
+/*                                                      */
+/*  A problem whose optimal basis is a dense rational   */
+/*  4x4 matrix, to exercise the exact basis solvers:    */
+/*       Minimize  x1 - x2 + 2x3 + 1/3x4 + 3x5 - 2x6     */
+/*       Subject to                                     */
+/*            2x1 +  x2 -    x3 + 1/2x4 + x5      = 3   */
+/*             x1 + 3x2 + 1/3x3 -    x4      + x6 = 1   */
+/*            -x1 + 2x2 +   4x3 +    x4 + x5 + x6 = 2/3 */
+/*         1/2x1 -  x2 +    x3 +   5x4 - x5 + 2x6 = 7   */
+/*            x1, ..., x4 free                          */
+/*            0 <= x5, x6 <= 1                          */
+/*                                                      */
+static int load_dense_basis_problem(mpq_QSprob *p)
+{
+    static const char *a[4][6] = {
+        { "2", "1", "-1", "1/2", "1", "0" },
+        { "1", "3", "1/3", "-1", "0", "1" },
+        { "-1", "2", "4", "1", "1", "1" },
+        { "1/2", "-1", "1", "5", "-1", "2" } };
+    static const char *c[6] = { "1", "-1", "2", "1/3", "3", "-2" };
+    static const char *b[4] = { "3", "1", "2/3", "7" };
+    int cmatcnt[6], cmatbeg[6], cmatind[24];
+    char sense[4] = { 'E', 'E', 'E', 'E' };
+    mpq_t cmatval[24], obj[6], rhs[4], lower[6], upper[6];
+    int i, j, cnt = 0, rval = 0;
+
+    for (i = 0; i < 24; i++) mpq_init(cmatval[i]);
+    for (j = 0; j < 6; j++) {
+        cmatbeg[j] = cnt;
+        for (i = 0; i < 4; i++) {
+            if (strcmp(a[i][j], "0") == 0) continue;
+            cmatind[cnt] = i;
+            mpq_set_str(cmatval[cnt], a[i][j], 10);
+            cnt++;
+        }
+        cmatcnt[j] = cnt - cmatbeg[j];
+        mpq_init(obj[j]);
+        mpq_set_str(obj[j], c[j], 10);
+        mpq_init(lower[j]);
+        mpq_init(upper[j]);
+        if (j < 4) {
+            mpq_set(lower[j], mpq_ILL_MINDOUBLE);
+            mpq_set(upper[j], mpq_ILL_MAXDOUBLE);
+        } else {
+            mpq_set_ui(upper[j], 1UL, 1UL);
+        }
+    }
+    for (i = 0; i < 4; i++) {
+        mpq_init(rhs[i]);
+        mpq_set_str(rhs[i], b[i], 10);
+    }
+
+    *p = mpq_QSload_prob("dense", 6, 4, cmatcnt, cmatbeg, cmatind, cmatval,
+                         QS_MIN, obj, rhs, sense, lower, upper, NULL, NULL);
+    if (*p == NULL) {
+        fprintf(stderr, "Unable to load the LP problem\n");
+        rval = 1;
+    }
+
+    for (i = 0; i < 24; i++) mpq_clear(cmatval[i]);
+    for (j = 0; j < 6; j++) {
+        mpq_clear(obj[j]);
+        mpq_clear(lower[j]);
+        mpq_clear(upper[j]);
+    }
+    for (i = 0; i < 4; i++) mpq_clear(rhs[i]);
+    return rval;
+}
+
+/* Compare lp->xbz and lp->piz with the LU values saved in x and pi, and
+ * scramble them for the next solver */
+static int basis_values_match(mpq_lpinfo *lp, mpq_t *x, mpq_t *pi)
+{
+    int i, ok = 1;
+
+    for (i = 0; i < lp->nrows; i++) {
+        ok = ok && mpq_equal(lp->xbz[i], x[i]) && mpq_equal(lp->piz[i], pi[i]);
+        mpq_set_si(lp->xbz[i], -12345, 7);
+        mpq_set_si(lp->piz[i], 54321, 11);
+    }
+    return ok;
+}
+
+/* Compute x_B and pi of the optimal basis of the dense problem with the
+ * rational LU, then with one of the other exact basis solvers, and ask for
+ * the same numbers. QS_EXACT_BASIS_SOLVER_LU stands for the Schur complement
+ * of a factorization of the basis with two of its columns replaced by
+ * logicals. */
+static void test_basis_solver(int test_id, int method, const char *name)
+{
+    mpq_QSprob p = NULL;
+    mpq_lpinfo *lp;
+    mpq_factor_work f;
+    mpq_t x[4], pi[4];
+    int basis0[4];
+    int i, r0, r1, nstruct = 0, status = 0, singular = 1, nsing = 1;
+    int *singr = NULL, *singc = NULL;
+    int rval;
+
+    memset(&f, 0, sizeof(f));
+    for (i = 0; i < 4; i++) {
+        mpq_init(x[i]);
+        mpq_init(pi[i]);
+    }
+
+    rval = load_dense_basis_problem(&p);
+    if (!rval) rval = mpq_QSopt_dual(p, &status);
+    if (rval || status != QS_LP_OPTIMAL) {
+        printf("not ok %i - Unable to solve the dense LP\n", test_id);
+        goto CLEANUP;
+    }
+    lp = p->lp;
+    for (i = 0; i < 4; i++)
+        nstruct += lp->vstat[lp->O->structmap[i]] == STAT_BASIC;
+    if (lp->nrows != 4 || nstruct < 4) {
+        printf("not ok %i - The optimal basis is not the dense one\n",
+               test_id);
+        goto CLEANUP;
+    }
+
+    /* reference values from the rational LU of the basis */
+    if (mpq_ILLbasis_factor(lp, &singular) || singular) {
+        printf("not ok %i - Unable to factor the basis\n", test_id);
+        goto CLEANUP;
+    }
+    mpq_ILLfct_compute_xbz(lp);
+    mpq_ILLfct_compute_piz(lp);
+    for (i = 0; i < 4; i++) {
+        mpq_set(x[i], lp->xbz[i]);
+        mpq_set(pi[i], lp->piz[i]);
+    }
+    basis_values_match(lp, x, pi);
+
+    if (method != QS_EXACT_BASIS_SOLVER_LU) {
+        rval = QSexact_basis_solve(lp, method, QS_EXACT_BASIS_PRIMAL |
+                                   QS_EXACT_BASIS_DUAL, &singular);
+    } else {
+        /* factor a neighbour of the basis, two columns off */
+        mpq_EGlpNumInitVar(f.fzero_tol);
+        mpq_EGlpNumInitVar(f.szero_tol);
+        mpq_EGlpNumInitVar(f.partial_tol);
+        mpq_EGlpNumInitVar(f.maxelem_orig);
+        mpq_EGlpNumInitVar(f.maxelem_factor);
+        mpq_EGlpNumInitVar(f.maxelem_cur);
+        mpq_EGlpNumInitVar(f.partial_cur);
+        mpq_ILLfactor_init_factor_work(&f);
+        rval = mpq_ILLfactor_create_factor_work(&f, 4);
+        for (r0 = 0; !rval && nsing && r0 < 4; r0++) {
+            for (r1 = r0 + 1; !rval && nsing && r1 < 4; r1++) {
+                memcpy(basis0, lp->baz, sizeof(basis0));
+                basis0[1] = lp->O->rowmap[r0];
+                basis0[2] = lp->O->rowmap[r1];
+                free(singr);
+                free(singc);
+                singr = singc = NULL;
+                rval = mpq_ILLfactor(&f, basis0, lp->matbeg, lp->matcnt,
+                                     lp->matind, lp->matval, &nsing, &singr,
+                                     &singc);
+            }
+        }
+        if (!rval && nsing) rval = 1;
+        if (!rval)
+            rval = QSexact_schur_solve(lp, &f, basis0, QS_EXACT_BASIS_PRIMAL |
+                                       QS_EXACT_BASIS_DUAL, &singular);
+    }
+    if (rval || singular) {
+        printf("not ok %i - The %s basis solver failed\n", test_id, name);
+        goto CLEANUP;
+    }
+    if (!basis_values_match(lp, x, pi)) {
+        printf("not ok %i - The %s basis solver disagrees with the LU\n",
+               test_id, name);
+        goto CLEANUP;
+    }
+    printf("ok %i - The %s basis solver matches the LU exactly\n",
+           test_id, name);
+
+CLEANUP:
+    free(singr);
+    free(singc);
+    if (method == QS_EXACT_BASIS_SOLVER_LU) {
+        mpq_ILLfactor_free_factor_work(&f);
+        mpq_EGlpNumClearVar(f.fzero_tol);
+        mpq_EGlpNumClearVar(f.szero_tol);
+        mpq_EGlpNumClearVar(f.partial_tol);
+        mpq_EGlpNumClearVar(f.maxelem_orig);
+        mpq_EGlpNumClearVar(f.maxelem_factor);
+        mpq_EGlpNumClearVar(f.maxelem_cur);
+        mpq_EGlpNumClearVar(f.partial_cur);
+    }
+    if (p) mpq_QSfree_prob(p);
+    for (i = 0; i < 4; i++) {
+        mpq_clear(x[i]);
+        mpq_clear(pi[i]);
+    }
+}
+
+static void test_basis_solver_bareiss(int test_id)
+{
+    test_basis_solver(test_id, QS_EXACT_BASIS_SOLVER_BAREISS, "Bareiss");
+}
+
+static void test_basis_solver_modular(int test_id)
+{
+    test_basis_solver(test_id, QS_EXACT_BASIS_SOLVER_MODULAR, "modular");
+}
+
+static void test_basis_solver_dixon(int test_id)
+{
+    test_basis_solver(test_id, QS_EXACT_BASIS_SOLVER_DIXON, "Dixon");
+}
+
+static void test_basis_solver_schur(int test_id)
+{
+    test_basis_solver(test_id, QS_EXACT_BASIS_SOLVER_LU, "Schur");
+}
+
+/* How an exact solve of the small problem is set up, and the path it must
+ * take to its answer; a checkpoint, when given, must be resumed from and
+ * written again */
+typedef struct {
+    const char *name;
+    int race;                   /* QS_PARAM_EXACT_RACE */
+    int schedule;               /* QS_PARAM_EXACT_PRECISION_SCHEDULE */
+    int nrungs;                 /* explicit precision schedule, if nrungs > 0 */
+    unsigned bits[2];
+    int ck_rung;                /* checkpoint to resume from, if ck_rung >= 0 */
+    unsigned ck_precision;
+    int ck_lost;
+    int race_winner;            /* -1 if the race must not settle the problem,
+                                 * else the most bits the winner may have */
+    int rung;                   /* last rung run after the double solve */
+    int hilbert;                /* solve a Hilbert basis of this dimension
+                                 * instead of the small problem, if > 0 */
+} exact_path_case;
+
+/* Write a checkpoint for the small problem as left by a solve killed at
+ * c->ck_rung, with the optimal basis, and read it back */
+static int write_test_checkpoint(const char *name, const exact_path_case *c)
+{
+    QSexact_checkpoint ck = { 0, 0, 0, 0, 0, 0, 0, NULL };
+    QSexact_checkpoint back = { 0, 0, 0, 0, 0, 0, 0, NULL };
+    mpq_QSprob p = NULL;
+    int status = 0;
+    int rval;
+
+    rval = solve_test_problem(&p, &status);
+    if (!rval && status != QS_LP_OPTIMAL) rval = 1;
+    if (!rval) {
+        ck.ncols = 3;
+        ck.nrows = 2;
+        ck.rung = c->ck_rung;
+        ck.precision = c->ck_precision;
+        ck.lost = c->ck_lost;
+        ck.status = QS_LP_UNSOLVED;
+        ck.iter = 11;
+        ck.basis = mpq_QSget_basis(p);
+        rval = ck.basis == NULL || QSexact_write_checkpoint(name, &ck);
+    }
+    if (!rval) rval = QSexact_read_checkpoint(name, &back);
+    if (!rval)
+        rval = back.ncols != 3 || back.nrows != 2 || back.rung != ck.rung ||
+            back.precision != ck.precision || back.lost != ck.lost ||
+            back.iter != 11 || back.basis == NULL ||
+            memcmp(back.basis->cstat, ck.basis->cstat, 3) ||
+            memcmp(back.basis->rstat, ck.basis->rstat, 2);
+    QSexact_free_checkpoint(&ck);
+    QSexact_free_checkpoint(&back);
+    if (p) mpq_QSfree_prob(p);
+    return rval;
+}
+
+static void test_exact_path(int test_id, const exact_path_case *c)
+{
+    static const unsigned bad[] = { 16 };
+    static const double seconds[] = { 10.0, 0.0 };
+    char name[] = "/tmp/qsckptXXXXXX";
+    mpq_QSprob p = NULL;
+    QSexact_solve_info info;
+    int status = 0;
+    int policy = -1;
+    int fd = -1;
+    int rval = 0;
+
+    mpq_t value;
+    mpq_init(value);
+
+    if (c->ck_rung >= 0) {
+        fd = mkstemp(name);
+        if (fd < 0) {
+            printf("not ok %i - Unable to create a temporary file\n", test_id);
+            goto CLEANUP;
+        }
+        close(fd);
+        if (write_test_checkpoint(name, c)) {
+            printf("not ok %i - Checkpoint did not survive a round trip\n",
+                   test_id);
+            goto CLEANUP;
+        }
+    }
+
+    if (c->hilbert > 0)
+        rval = load_square_problem(&p, c->hilbert, hilbert_entry);
+    else
+        rval = load_test_problem(&p);
+    if (rval) {
+        printf("not ok %i - Unable to load the LP\n", test_id);
+        goto CLEANUP;
+    }
+
+    rval = mpq_QSset_param(p, QS_PARAM_EXACT_RACE, c->race);
+    if (!rval) rval = mpq_QSset_param(p, QS_PARAM_EXACT_PRECISION_SCHEDULE,
+                                      c->schedule);
+    if (!rval) rval = mpq_QSget_param(p, QS_PARAM_EXACT_PRECISION_SCHEDULE,
+                                      &policy);
+    if (!rval && c->nrungs > 0) {
+        rval = QSexact_set_precision_schedule(p, c->nrungs, c->bits, seconds);
+        if (!rval) rval = !QSexact_set_precision_schedule(p, 1, bad, NULL);
+    }
+    if (!rval && c->ck_rung >= 0) rval = QSexact_set_checkpoint(p, name, 1);
+    if (rval || policy != c->schedule) {
+        printf("not ok %i - Could not set up the solve with %s\n", test_id,
+               c->name);
+        goto CLEANUP;
+    }
+
+    rval = QSexact_solver(p, NULL, NULL, NULL, DUAL_SIMPLEX, &status);
+    if (rval || status != QS_LP_OPTIMAL) {
+        printf("not ok %i - Did not find an optimal solution.\n", test_id);
+        goto CLEANUP;
+    }
+
+    rval = mpq_QSget_objval(p, &value);
+    if (rval || mpq_cmp_ui(value, c->hilbert > 0 ? c->hilbert : 42, 1) != 0) {
+        printf("not ok %i - Unexpected obj value: %.6f\n", test_id,
+               mpq_get_d(value));
+        goto CLEANUP;
+    }
+
+    QSexact_get_solve_info(p, &info);
+    if ((info.race_winner < 0) != (c->race_winner < 0) ||
+        info.race_winner > c->race_winner) {
+        printf("not ok %i - Race winner %d with %s\n", test_id,
+               info.race_winner, c->name);
+        goto CLEANUP;
+    }
+    if (info.rung != c->rung) {
+        printf("not ok %i - Reached rung %d instead of %d with %s\n", test_id,
+               info.rung, c->rung, c->name);
+        goto CLEANUP;
+    }
+    if (info.resumed != c->ck_rung || (info.nsaved > 0) != (c->ck_rung >= 0)) {
+        printf("not ok %i - Resumed at rung %d and wrote %d checkpoints with "
+               "%s\n", test_id, info.resumed, info.nsaved, c->name);
+        goto CLEANUP;
+    }
+    printf("ok %i - The correct objective value was obtained with %s\n",
+           test_id, c->name);
+
+CLEANUP:
+    if (c->ck_rung >= 0) remove(name);
+    if (p) mpq_QSfree_prob(p);
+    mpq_clear(value);
+}
+
+static void test_solution_objective_race(int test_id)
+{
+    static const exact_path_case c = {
+        "precision racing", QS_EXACT_RACE_MPF192, QS_EXACT_SCHEDULE_FIXED,
+        0, { 0, 0 }, -1, 0, 0, 192, -1, 0 };
+    test_exact_path(test_id, &c);
+}
+
+/* The double solve of an 8 x 8 Hilbert basis fails, and the estimated
+ * condition of about 2^28 asks for more than the 64 bits of the first rung:
+ * a fixed schedule runs that rung anyway, a skipping one goes straight to
+ * the second */
+static void test_solution_objective_schedule(int test_id)
+{
+    static const exact_path_case c = {
+        "an explicit precision schedule", QS_EXACT_RACE_OFF,
+        QS_EXACT_SCHEDULE_FIXED, 2, { 64, 256 }, -1, 0, 0, -1, 0, 8 };
+    test_exact_path(test_id, &c);
+}
+
+static void test_solution_objective_schedule_skip(int test_id)
+{
+    static const exact_path_case c = {
+        "a skipping precision schedule", QS_EXACT_RACE_OFF,
+        QS_EXACT_SCHEDULE_SKIP, 2, { 64, 256 }, -1, 0, 0, -1, 1, 8 };
+    test_exact_path(test_id, &c);
+}
+
+/* A solve killed after its first mpf rung, resumed on a fresh copy */
+static void test_solution_objective_checkpoint(int test_id)
+{
+    static const exact_path_case c = {
+        "a checkpoint to resume from", QS_EXACT_RACE_OFF,
+        QS_EXACT_SCHEDULE_FIXED, 0, { 0, 0 }, 1, 128, 7, -1, 1, 0 };
+    test_exact_path(test_id, &c);
+}
+
+static void test_basis_condition(int test_id)
+{
+    mpq_QSprob p = NULL;
+    dbl_QSprob p_dbl = NULL;
+    int status = 0;
+    double cond = 0, growth = 0;
+
+    int rval = load_test_problem(&p);
+    if (rval) {
+        printf("not ok %i - Unable to load the LP\n", test_id);
+        goto CLEANUP;
+    }
+
+    p_dbl = QScopy_prob_mpq_dbl(p, "dbl_test");
+    if (p_dbl == NULL || dbl_QSopt_dual(p_dbl, &status) ||
+        status != QS_LP_OPTIMAL) {
+        printf("not ok %i - Unable to solve the LP in double\n", test_id);
+        goto CLEANUP;
+    }
+
+    rval = dbl_QSget_basis_condition(p_dbl, &cond, &growth);
+    if (rval) {
+        printf("not ok %i - Unable to estimate the basis condition\n", test_id);
+        goto CLEANUP;
+    }
+
+    /* Any basis has condition and growth at least one */
+    if (!(cond >= 1.0) || !(growth >= 1.0) || cond > 1e6) {
+        printf("not ok %i - Bad estimate, cond %g growth %g\n",
+               test_id, cond, growth);
+        goto CLEANUP;
+    }
+
+    printf("ok %i - Basis condition estimated\n", test_id);
+
+CLEANUP:
+    if (p_dbl) dbl_QSfree_prob(p_dbl);
+    if (p) mpq_QSfree_prob(p);
+}
+
+/* The growth reported for a 30 x 30 Wilkinson basis, which the factor can
+ * only eliminate by doubling its last column */
+static void test_basis_growth(int test_id)
+{
+    mpq_QSprob p = NULL;
+    dbl_QSprob p_dbl = NULL;
+    int status = 0;
+    double cond = 0, growth = 0;
+
+    int rval = load_square_problem(&p, 30, wilkinson_entry);
+    if (rval) {
+        printf("not ok %i - Unable to load the LP\n", test_id);
+        goto CLEANUP;
+    }
+
+    p_dbl = QScopy_prob_mpq_dbl(p, "dbl_test");
+    if (p_dbl == NULL || dbl_QSopt_dual(p_dbl, &status) ||
+        status != QS_LP_OPTIMAL) {
+        printf("not ok %i - Unable to solve the LP in double\n", test_id);
+        goto CLEANUP;
+    }
+
+    rval = dbl_QSget_basis_condition(p_dbl, &cond, &growth);
+    if (rval || !(growth > 1024.0)) {
+        printf("not ok %i - Growth %g reported for a growing basis\n",
+               test_id, growth);
+        goto CLEANUP;
+    }
+
+    printf("ok %i - Element growth of the basis reported\n", test_id);
+
+CLEANUP:
+    if (p_dbl) dbl_QSfree_prob(p_dbl);
+    if (p) mpq_QSfree_prob(p);
+}
+
 static void test_solution_get_variables(int test_id)
 {
     mpq_QSprob p = NULL;
@@ -592,6 +1155,746 @@ CLEANUP:
     if (p) mpq_QSfree_prob(p);
 }
 
+static void test_solution_certificate(int test_id)
+{
+    mpq_QSprob p = NULL;
+    mpq_t *x = NULL;
+    QSexact_cert cert = { 0 };
+    EGioFile_t *f = NULL;
+    FILE *fp = NULL;
+    int status = 0;
+    int rval = 0;
+    int i;
+    int ncols = 3;
+
+    rval = solve_test_problem(&p, &status);
+    if (rval) {
+        printf("not ok %i - Unable to solve the LP\n", test_id);
+        goto CLEANUP;
+    }
+
+    /* Write the certificate and read it back */
+    fp = tmpfile();
+    if (fp == NULL || (f = EGioOpenFILE(fp)) == NULL) {
+        printf("not ok %i - Could not open a temporary file\n", test_id);
+        goto CLEANUP;
+    }
+    rval = QSexact_write_cert(p, status, NULL, f);
+    if (rval) {
+        printf("not ok %i - Could not write the certificate, error code %d\n",
+               test_id, rval);
+        goto CLEANUP;
+    }
+    fflush(fp);
+    rewind(fp);
+    rval = QSexact_read_cert(f, &cert);
+    if (rval) {
+        printf("not ok %i - Could not read the certificate, error code %d\n",
+               test_id, rval);
+        goto CLEANUP;
+    }
+
+    x = malloc(ncols * sizeof(mpq_t));
+    for (i = 0; i < ncols; i++) mpq_init(x[i]);
+    mpq_QSget_x_array(p, x);
+    rval = cert.status != QS_LP_OPTIMAL || cert.ncols != ncols ||
+           cert.x == NULL || cert.y == NULL || cert.basis == NULL;
+    for (i = 0; !rval && i < ncols; i++) rval = !mpq_equal(x[i], cert.x[i]);
+    if (rval) {
+        printf("not ok %i - Certificate does not match the solution\n",
+               test_id);
+        goto CLEANUP;
+    }
+
+    /* Check it, then check that a perturbed x is rejected */
+    if (!QSexact_check_cert(p, &cert, 2)) {
+        printf("not ok %i - Valid certificate rejected\n", test_id);
+        goto CLEANUP;
+    }
+    mpq_set_ui(x[0], 1UL, 3UL);
+    mpq_add(cert.x[0], cert.x[0], x[0]);
+    if (QSexact_check_cert(p, &cert, 2)) {
+        printf("not ok %i - Perturbed certificate accepted\n", test_id);
+    } else {
+        printf("ok %i - Binary certificate read back and checked\n", test_id);
+    }
+
+CLEANUP:
+    QSexact_free_cert(&cert);
+    if (f) EGioClose(f);
+    else if (fp) fclose(fp);
+    if (x) {
+        for (i = 0; i < ncols; i++) mpq_clear(x[i]);
+        free(x);
+    }
+    if (p) mpq_QSfree_prob(p);
+}
+
+/* Write a certificate header for one column with an x section, followed by
+ * an integer of cnt limbs of which only the first is present */
+static void write_bad_certificate(FILE *fp, int ncols, int nrows, int flags,
+                                  unsigned long long cnt)
+{
+    unsigned char b[8];
+    int v[4];
+    int i, j;
+
+    v[0] = QS_LP_OPTIMAL; v[1] = ncols; v[2] = nrows; v[3] = flags;
+    fwrite("QSXCERT1", 1, 8, fp);
+    for (j = 0; j < 4; j++) {
+        for (i = 0; i < 4; i++) b[i] = (unsigned char) ((unsigned) v[j] >> (8 * i));
+        fwrite(b, 1, 4, fp);
+    }
+    for (i = 0; i < 8; i++) b[i] = (unsigned char) (cnt >> (8 * i));
+    fwrite(b, 1, 8, fp);
+    memset(b, 0xff, 8);
+    fwrite(b, 1, 8, fp);
+    fflush(fp);
+    rewind(fp);
+}
+
+static void test_malformed_certificate(int test_id)
+{
+    /* limb counts that overflow, or that exceed what is left of the file,
+     * basis sections longer than the file and unknown sections */
+    static const struct {
+        int ncols, nrows, flags;
+        unsigned long long cnt;
+    } bad[] = {
+        { 1, 0, QS_CERT_X, (1ULL << 61) + 1 },
+        { 1, 0, QS_CERT_X, 1ULL << 63 },
+        { 1, 0, QS_CERT_X, (unsigned long long) -(1LL << 40) },
+        { 1, 0, QS_CERT_X, 2 },
+        { 0x7fffffff, 0, QS_CERT_BASIS, 0 },
+        { 0x7ffffffe, 0x7ffffffe, QS_CERT_BASIS, 0 },
+        { 0x7ffffff0, 0, QS_CERT_X, 0 },
+        { 0, 0, 16, 0 }
+    };
+    QSexact_cert cert = { 0 };
+    EGioFile_t *f = NULL;
+    FILE *fp = NULL;
+    int i;
+
+    for (i = 0; i < (int) (sizeof(bad) / sizeof(bad[0])); i++) {
+        fp = tmpfile();
+        if (fp == NULL || (f = EGioOpenFILE(fp)) == NULL) {
+            printf("not ok %i - Could not open a temporary file\n", test_id);
+            if (fp) fclose(fp);
+            return;
+        }
+        write_bad_certificate(fp, bad[i].ncols, bad[i].nrows, bad[i].flags,
+                              bad[i].cnt);
+        if (!QSexact_read_cert(f, &cert)) {
+            printf("not ok %i - Malformed certificate %d accepted\n",
+                   test_id, i);
+            QSexact_free_cert(&cert);
+            EGioClose(f);
+            return;
+        }
+        EGioClose(f);
+    }
+    printf("ok %i - Malformed certificates rejected\n", test_id);
+}
+
+static void test_factor_multi_solve(int test_id)
+{
+    /* B is 8x8 with a full diagonal and a few entries off it, columnwise */
+    enum { n = 8, k = 5 };
+    int basis[n], cbeg[n], clen[n], cind[3 * n];
+    int i, j, l, cnt = 0, nsing = 0, *singr = 0, *singc = 0;
+    int ok = 1;
+    mpq_t cval[3 * n];
+    mpq_t dense[n];
+    mpq_factor_work f;
+    mpq_svector a[k], x[k], y;
+
+    memset(&f, 0, sizeof(f));
+    mpq_EGlpNumInitVar(f.fzero_tol);
+    mpq_EGlpNumInitVar(f.szero_tol);
+    mpq_EGlpNumInitVar(f.partial_tol);
+    mpq_EGlpNumInitVar(f.maxelem_orig);
+    mpq_EGlpNumInitVar(f.maxelem_factor);
+    mpq_EGlpNumInitVar(f.maxelem_cur);
+    mpq_EGlpNumInitVar(f.partial_cur);
+    mpq_ILLfactor_init_factor_work(&f);
+    for (i = 0; i < 3 * n; i++) mpq_init(cval[i]);
+    for (i = 0; i < n; i++) mpq_init(dense[i]);
+    for (j = 0; j < n; j++) {
+        basis[j] = j;
+        cbeg[j] = cnt;
+        cind[cnt] = j;
+        mpq_set_si(cval[cnt++], 2 + j % 3, 1);
+        cind[cnt] = (j * 5 + 3) % n;
+        if (cind[cnt] != j) mpq_set_si(cval[cnt++], -1, 1 + j % 2);
+        cind[cnt] = (j * 3 + 1) % n;
+        if (cind[cnt] != j && cind[cnt] != cind[cnt - 1])
+            mpq_set_si(cval[cnt++], 1, 3);
+        clen[j] = cnt - cbeg[j];
+    }
+    mpq_ILLsvector_init(&y);
+    for (j = 0; j < k; j++) {
+        mpq_ILLsvector_init(a + j);
+        mpq_ILLsvector_init(x + j);
+    }
+    if (mpq_ILLfactor_create_factor_work(&f, n) ||
+        mpq_ILLfactor(&f, basis, cbeg, clen, cind, cval, &nsing, &singr,
+                      &singc) || nsing ||
+        mpq_ILLsvector_alloc(&y, n)) {
+        ok = 0;
+        goto CLEANUP;
+    }
+    for (j = 0; j < k; j++) {
+        if (mpq_ILLsvector_alloc(a + j, 2) || mpq_ILLsvector_alloc(x + j, n)) {
+            ok = 0;
+            goto CLEANUP;
+        }
+        a[j].nzcnt = 2;
+        a[j].indx[0] = j;
+        a[j].indx[1] = (j + 3) % n;
+        mpq_set_si(a[j].coef[0], 1, 1);
+        mpq_set_si(a[j].coef[1], -j - 1, 2);
+    }
+
+    /* the multiple solves give exactly what the solves one at a time give */
+    for (l = 0; l < 2; l++) {
+        if (l == 0) mpq_ILLfactor_ftran_multi(&f, k, a, x);
+        else mpq_ILLfactor_btran_multi(&f, k, a, x);
+        for (j = 0; j < k; j++) {
+            if (l == 0) mpq_ILLfactor_ftran(&f, a + j, &y);
+            else mpq_ILLfactor_btran(&f, a + j, &y);
+            for (i = 0; i < y.nzcnt; i++)
+                mpq_set(dense[y.indx[i]], y.coef[i]);
+            for (i = 0; i < x[j].nzcnt; i++)
+                mpq_sub(dense[x[j].indx[i]], dense[x[j].indx[i]], x[j].coef[i]);
+            for (i = 0; i < n; i++) {
+                ok = ok && mpq_sgn(dense[i]) == 0;
+                mpq_set_ui(dense[i], 0UL, 1UL);
+            }
+            ok = ok && x[j].nzcnt == y.nzcnt && y.nzcnt > 0;
+        }
+    }
+
+CLEANUP:
+    if (ok) {
+        printf("ok %i - Multiple right hand side solves match single solves\n",
+               test_id);
+    } else {
+        printf("not ok %i - Multiple right hand side solves differ\n",
+               test_id);
+    }
+    for (j = 0; j < k; j++) {
+        mpq_ILLsvector_free(a + j);
+        mpq_ILLsvector_free(x + j);
+    }
+    mpq_ILLsvector_free(&y);
+    mpq_ILLfactor_free_factor_work(&f);
+    mpq_EGlpNumClearVar(f.fzero_tol);
+    mpq_EGlpNumClearVar(f.szero_tol);
+    mpq_EGlpNumClearVar(f.partial_tol);
+    mpq_EGlpNumClearVar(f.maxelem_orig);
+    mpq_EGlpNumClearVar(f.maxelem_factor);
+    mpq_EGlpNumClearVar(f.maxelem_cur);
+    mpq_EGlpNumClearVar(f.partial_cur);
+    for (i = 0; i < 3 * n; i++) mpq_clear(cval[i]);
+    for (i = 0; i < n; i++) mpq_clear(dense[i]);
+}
+
+/* A 128-bit copy of a rational LU that takes the same updates as the LU
+ * solves like a copy made afresh from the updated LU */
+static void test_factor_shadow_update(int test_id)
+{
+    enum { n = 8, nupd = 4 };
+    const unsigned precision = EGLPNUM_PRECISION;
+    int basis[n], cbeg[n], clen[n], cind[3 * n], used[n];
+    int i, j, r, t, cnt = 0, nsing = 0, *singr = 0, *singc = 0;
+    int refactor = 0, ok = 1;
+    mpq_t cval[3 * n];
+    mpq_factor_work f;
+    mpf_factor_work *shadow = 0, *fresh = 0;
+    mpq_svector a, upd, x;
+    mpf_svector e, y[2];
+    mpf_t diff, tol;
+
+    memset(&f, 0, sizeof(f));
+    mpq_EGlpNumInitVar(f.fzero_tol);
+    mpq_EGlpNumInitVar(f.szero_tol);
+    mpq_EGlpNumInitVar(f.partial_tol);
+    mpq_EGlpNumInitVar(f.maxelem_orig);
+    mpq_EGlpNumInitVar(f.maxelem_factor);
+    mpq_EGlpNumInitVar(f.maxelem_cur);
+    mpq_EGlpNumInitVar(f.partial_cur);
+    mpq_ILLfactor_init_factor_work(&f);
+    QSexact_set_precision(128);
+    mpf_init(diff);
+    mpf_init(tol);
+    for (i = 0; i < 3 * n; i++) mpq_init(cval[i]);
+    for (j = 0; j < n; j++) {
+        basis[j] = j;
+        used[j] = 0;
+        cbeg[j] = cnt;
+        cind[cnt] = j;
+        mpq_set_si(cval[cnt++], 2 + j % 3, 1);
+        cind[cnt] = (j * 5 + 3) % n;
+        if (cind[cnt] != j) mpq_set_si(cval[cnt++], -1, 1 + j % 2);
+        cind[cnt] = (j * 3 + 1) % n;
+        if (cind[cnt] != j && cind[cnt] != cind[cnt - 1])
+            mpq_set_si(cval[cnt++], 1, 3);
+        clen[j] = cnt - cbeg[j];
+    }
+    mpq_ILLsvector_init(&a);
+    mpq_ILLsvector_init(&upd);
+    mpq_ILLsvector_init(&x);
+    mpf_ILLsvector_init(&e);
+    mpf_ILLsvector_init(y);
+    mpf_ILLsvector_init(y + 1);
+    shadow = calloc(1, sizeof(*shadow));
+    fresh = calloc(1, sizeof(*fresh));
+    if (!shadow || !fresh || mpq_ILLfactor_create_factor_work(&f, n) ||
+        mpq_ILLfactor(&f, basis, cbeg, clen, cind, cval, &nsing, &singr,
+                      &singc) || nsing ||
+        mpq_factor_work_to_mpf_factor_work(shadow, &f) ||
+        mpq_ILLsvector_alloc(&a, 2) || mpq_ILLsvector_alloc(&upd, n) ||
+        mpq_ILLsvector_alloc(&x, n) || mpf_ILLsvector_alloc(&e, 1) ||
+        mpf_ILLsvector_alloc(y, n) || mpf_ILLsvector_alloc(y + 1, n)) {
+        ok = 0;
+        goto CLEANUP;
+    }
+
+    /* replace a few columns, each at a position it has a nonzero in */
+    for (t = 0; t < nupd && ok; t++) {
+        a.nzcnt = 2;
+        a.indx[0] = t;
+        a.indx[1] = (t + 2) % n;
+        mpq_set_si(a.coef[0], 3, 1);
+        mpq_set_si(a.coef[1], 1, 2 + t);
+        mpq_ILLfactor_ftran_update(&f, &a, &upd, &x);
+        for (r = -1, i = 0; i < x.nzcnt && r < 0; i++)
+            if (!used[x.indx[i]]) r = x.indx[i];
+        if (r < 0 || QSexact_lu_update(&f, &shadow, &upd, r, &refactor) ||
+            refactor || !shadow) {
+            ok = 0;
+            break;
+        }
+        used[r] = 1;
+    }
+    if (ok && mpq_factor_work_to_mpf_factor_work(fresh, &f)) ok = 0;
+
+    /* both copies solve B x = e_i alike, up to the 128-bit rounding */
+    mpf_set_d(tol, 1e-30);
+    for (i = 0; i < n && ok; i++) {
+        e.nzcnt = 1;
+        e.indx[0] = i;
+        mpf_set_ui(e.coef[0], 1);
+        mpf_ILLfactor_ftran(shadow, &e, y);
+        mpf_ILLfactor_ftran(fresh, &e, y + 1);
+        ok = y[0].nzcnt > 0;
+        for (j = 0; j < y[0].nzcnt && ok; j++) {
+            for (r = 0; r < y[1].nzcnt && y[1].indx[r] != y[0].indx[j]; r++) ;
+            if (r < y[1].nzcnt) mpf_sub(diff, y[0].coef[j], y[1].coef[r]);
+            else mpf_set(diff, y[0].coef[j]);
+            mpf_abs(diff, diff);
+            ok = mpf_cmp(diff, tol) <= 0;
+        }
+        for (j = 0; j < y[1].nzcnt && ok; j++) {
+            for (r = 0; r < y[0].nzcnt && y[0].indx[r] != y[1].indx[j]; r++) ;
+            if (r == y[0].nzcnt) {
+                mpf_abs(diff, y[1].coef[j]);
+                ok = mpf_cmp(diff, tol) <= 0;
+            }
+        }
+    }
+
+CLEANUP:
+    if (ok) {
+        printf("ok %i - The 128-bit LU copy follows the rational updates\n",
+               test_id);
+    } else {
+        printf("not ok %i - The 128-bit LU copy drifted from the rational "
+               "LU\n", test_id);
+    }
+    if (shadow && shadow->dim) QSexact_free_lu_shadow(shadow);
+    else free(shadow);
+    if (fresh && fresh->dim) QSexact_free_lu_shadow(fresh);
+    else free(fresh);
+    mpq_ILLsvector_free(&a);
+    mpq_ILLsvector_free(&upd);
+    mpq_ILLsvector_free(&x);
+    mpf_ILLsvector_free(&e);
+    mpf_ILLsvector_free(y);
+    mpf_ILLsvector_free(y + 1);
+    free(singr);
+    free(singc);
+    mpq_ILLfactor_free_factor_work(&f);
+    mpq_EGlpNumClearVar(f.fzero_tol);
+    mpq_EGlpNumClearVar(f.szero_tol);
+    mpq_EGlpNumClearVar(f.partial_tol);
+    mpq_EGlpNumClearVar(f.maxelem_orig);
+    mpq_EGlpNumClearVar(f.maxelem_factor);
+    mpq_EGlpNumClearVar(f.maxelem_cur);
+    mpq_EGlpNumClearVar(f.partial_cur);
+    for (i = 0; i < 3 * n; i++) mpq_clear(cval[i]);
+    mpf_clear(diff);
+    mpf_clear(tol);
+    QSexact_set_precision(precision);
+}
+
+static void test_factor_solve_snapshot(int test_id)
+{
+    /* B is a banded 200x200 double matrix, every third column a unit one */
+    enum { n = 200, w = 5 };
+    int basis[n], cbeg[n], clen[n], cind[4 * n];
+    double cval[4 * n];
+    int i, j, l, r, cnt = 0, nsing = 0, *singr = 0, *singc = 0;
+    unsigned seed = 7;
+    int ok = 1;
+    dbl_factor_work f;
+    dbl_svector a, x[2];
+
+    memset(&f, 0, sizeof(f));
+    dbl_ILLfactor_init_factor_work(&f);
+    for (j = 0; j < n; j++) {
+        basis[j] = j;
+        cbeg[j] = cnt;
+        cind[cnt] = j;
+        cval[cnt++] = 4.0 + j % 5;
+        for (l = 0; j % 3 && l < 3; l++) {
+            seed = seed * 1103515245u + 12345u;
+            r = (j + n + (int) ((seed >> 16) % (2 * w + 1)) - w) % n;
+            for (i = cbeg[j]; i < cnt && cind[i] != r; i++) ;
+            if (i < cnt) continue;
+            cind[cnt] = r;
+            cval[cnt++] = ((int) ((seed >> 8) % 19) - 9) / 8.0;
+        }
+        clen[j] = cnt - cbeg[j];
+    }
+    dbl_ILLsvector_init(&a);
+    dbl_ILLsvector_init(x);
+    dbl_ILLsvector_init(x + 1);
+    if (dbl_ILLfactor_create_factor_work(&f, n) ||
+        dbl_ILLfactor(&f, basis, cbeg, clen, cind, cval, &nsing, &singr,
+                      &singc) || nsing || !f.snap_l || !f.snap_u ||
+        dbl_ILLsvector_alloc(&a, n) || dbl_ILLsvector_alloc(x, n) ||
+        dbl_ILLsvector_alloc(x + 1, n)) {
+        ok = 0;
+        goto CLEANUP;
+    }
+    for (i = 0; i < n; i++) {
+        a.indx[i] = i;
+        a.coef[i] = 1.0 + (i % 7) / 4.0;
+    }
+    a.nzcnt = n;
+
+    /* a dense right hand side goes through the dense solves, which must give
+     * bit for bit the same result from the snapshots and from the structs */
+    for (l = 0; l < 2; l++) {
+        for (r = 0; r < 2; r++) {
+            f.snap_l = f.snap_u = !r;
+            if (l == 0) dbl_ILLfactor_ftran(&f, &a, x + r);
+            else dbl_ILLfactor_btran(&f, &a, x + r);
+        }
+        ok = ok && x[0].nzcnt == x[1].nzcnt && x[0].nzcnt > n / 2 &&
+            !memcmp(x[0].indx, x[1].indx, x[0].nzcnt * sizeof(int)) &&
+            !memcmp(x[0].coef, x[1].coef, x[0].nzcnt * sizeof(double));
+    }
+
+CLEANUP:
+    if (ok) {
+        printf("ok %i - Snapshot solves match the factor structs\n", test_id);
+    } else {
+        printf("not ok %i - Snapshot solves differ from the factor structs\n",
+               test_id);
+    }
+    dbl_ILLsvector_free(&a);
+    dbl_ILLsvector_free(x);
+    dbl_ILLsvector_free(x + 1);
+    dbl_ILLfactor_free_factor_work(&f);
+}
+
+static void test_factor_threads(int test_id)
+{
+    /* B is a banded 1200x1200 double matrix without singletons, big enough
+     * for the parallel elimination */
+    enum { n = 1200, w = 40, d = 6 };
+    static int cbeg[n], clen[n], cind[(d + 1) * n];
+    static double cval[(d + 1) * n], sol[2][2][n], res[n];
+    int basis[n];
+    int i, j, l, r, t, cnt = 0, nsing = 0, *singr = 0, *singc = 0;
+    unsigned seed = 5;
+    double err = 0, diff = 0, norm = 0;
+    int ok = 1, rounds = 0;
+    dbl_factor_work f;
+    dbl_svector a, x;
+
+    for (j = 0; j < n; j++) {
+        cbeg[j] = cnt;
+        cind[cnt] = j;
+        cval[cnt++] = 10.0 + (j % 4) / 2.0;
+        for (l = 0; l < d; l++) {
+            seed = seed * 1103515245u + 12345u;
+            r = (j + n + (int) ((seed >> 16) % (2 * w + 1)) - w) % n;
+            for (i = cbeg[j]; i < cnt && cind[i] != r; i++) ;
+            if (i < cnt) continue;
+            cind[cnt] = r;
+            cval[cnt++] = ((int) ((seed >> 8) % 17) - 8) / 4.0;
+        }
+        clen[j] = cnt - cbeg[j];
+    }
+    dbl_ILLsvector_init(&a);
+    dbl_ILLsvector_init(&x);
+    if (dbl_ILLsvector_alloc(&a, n) || dbl_ILLsvector_alloc(&x, n)) {
+        ok = 0;
+        goto CLEANUP;
+    }
+    for (i = 0; i < n; i++) {
+        a.indx[i] = i;
+        a.coef[i] = 1.0 + (i % 5) / 3.0;
+    }
+    a.nzcnt = n;
+
+    for (t = 0; t < 2 && ok; t++) {
+        memset(&f, 0, sizeof(f));
+        dbl_ILLfactor_init_factor_work(&f);
+        for (j = 0; j < n; j++) basis[j] = j;
+        /* pivot close to the column maximum, so that the residuals are down
+         * to rounding */
+        if (dbl_ILLfactor_set_factor_dparam(&f, QS_FACTOR_PARTIAL_TOL, 0.5) ||
+            dbl_ILLfactor_set_factor_iparam(&f, QS_FACTOR_NTHREADS,
+                                            t ? 4 : 1) ||
+            dbl_ILLfactor_create_factor_work(&f, n) ||
+            dbl_ILLfactor(&f, basis, cbeg, clen, cind, cval, &nsing, &singr,
+                          &singc) || nsing) {
+            ok = 0;
+        }
+        for (l = 0; l < 2 && ok; l++) {
+            if (l == 0) dbl_ILLfactor_ftran(&f, &a, &x);
+            else dbl_ILLfactor_btran(&f, &a, &x);
+            for (i = 0; i < x.nzcnt; i++) sol[t][l][x.indx[i]] = x.coef[i];
+        }
+        if (t) rounds = f.par_rounds;
+        dbl_ILLfactor_free_factor_work(&f);
+    }
+    if (!ok) goto CLEANUP;
+
+    /* B x = a and B^T y = a, with either thread count */
+    for (t = 0; t < 2; t++) {
+        memset(res, 0, sizeof(res));
+        for (j = 0; j < n; j++) {
+            double dot = 0;
+            for (i = cbeg[j]; i < cbeg[j] + clen[j]; i++) {
+                res[cind[i]] += cval[i] * sol[t][0][j];
+                dot += cval[i] * sol[t][1][cind[i]];
+            }
+            dot -= a.coef[j];
+            if (fabs(dot) > err) err = fabs(dot);
+        }
+        for (i = 0; i < n; i++) {
+            if (fabs(res[i] - a.coef[i]) > err) err = fabs(res[i] - a.coef[i]);
+            for (l = 0; l < 2; l++) {
+                if (fabs(sol[t][l][i]) > norm) norm = fabs(sol[t][l][i]);
+                if (fabs(sol[0][l][i] - sol[t][l][i]) > diff)
+                    diff = fabs(sol[0][l][i] - sol[t][l][i]);
+            }
+        }
+    }
+    ok = norm > 0 && err < 1e-12 && diff <= 1e-12 * norm &&
+        (rounds > 0 || !HAVE_EG_THREAD);
+
+CLEANUP:
+    if (ok) {
+        printf("ok %i - Factors with one and four threads solve alike\n",
+               test_id);
+    } else {
+        printf("not ok %i - Threaded factor off, residual %g difference %g, "
+               "%d parallel rounds\n", test_id, err, diff, rounds);
+    }
+    dbl_ILLsvector_free(&a);
+    dbl_ILLsvector_free(&x);
+}
+
+static void test_factor_hypersparse(int test_id)
+{
+    /* B is the identity plus a few long chains, so that the solves with a
+     * unit vector touch only a handful of rows */
+    enum { n = 500, k = 6 };
+    static const int unit[k] = { 0, 7, 123, 250, 377, 499 };
+    int basis[n], cbeg[n], clen[n], cind[2 * n];
+    int i, j, l, r, cnt = 0, nsing = 0, *singr = 0, *singc = 0;
+    int ok = 1;
+    mpq_t cval[2 * n];
+    mpq_t dense[3][n];
+    mpq_factor_work f;
+    mpq_svector a, x;
+
+    memset(&f, 0, sizeof(f));
+    mpq_EGlpNumInitVar(f.fzero_tol);
+    mpq_EGlpNumInitVar(f.szero_tol);
+    mpq_EGlpNumInitVar(f.partial_tol);
+    mpq_EGlpNumInitVar(f.maxelem_orig);
+    mpq_EGlpNumInitVar(f.maxelem_factor);
+    mpq_EGlpNumInitVar(f.maxelem_cur);
+    mpq_EGlpNumInitVar(f.partial_cur);
+    mpq_ILLfactor_init_factor_work(&f);
+    for (i = 0; i < 2 * n; i++) mpq_init(cval[i]);
+    for (l = 0; l < 3; l++)
+        for (i = 0; i < n; i++) mpq_init(dense[l][i]);
+    for (j = 0; j < n; j++) {
+        basis[j] = j;
+        cbeg[j] = cnt;
+        cind[cnt] = j;
+        mpq_set_si(cval[cnt++], 2 + j % 3, 1);
+        if (j % 5) {
+            cind[cnt] = (j * 37 + 11) % n;
+            if (cind[cnt] != j) mpq_set_si(cval[cnt++], -1, 1 + j % 4);
+        }
+        clen[j] = cnt - cbeg[j];
+    }
+    mpq_ILLsvector_init(&a);
+    mpq_ILLsvector_init(&x);
+    if (mpq_ILLfactor_create_factor_work(&f, n) ||
+        mpq_ILLfactor(&f, basis, cbeg, clen, cind, cval, &nsing, &singr,
+                      &singc) || nsing ||
+        mpq_ILLsvector_alloc(&a, n) || mpq_ILLsvector_alloc(&x, n)) {
+        ok = 0;
+        goto CLEANUP;
+    }
+
+    /* e_i through the reach (recent results sparse), through the delay
+     * counters (recent results dense), and padded with explicit zeros to
+     * go through the dense solves; all three must agree exactly */
+    for (l = 0; l < 2 * k && ok; l++) {
+        for (r = 0; r < 3; r++) {
+            a.nzcnt = r < 2 ? 1 : n;
+            for (i = 0; i < a.nzcnt; i++) {
+                a.indx[i] = r < 2 ? unit[l % k] : i;
+                mpq_set_ui(a.coef[i], a.indx[i] == unit[l % k], 1UL);
+            }
+            f.ftran_dens = f.btran_dens = r ? 1.0 : 0.0;
+            if (l < k) mpq_ILLfactor_ftran(&f, &a, &x);
+            else mpq_ILLfactor_btran(&f, &a, &x);
+            ok = ok && x.nzcnt > 0 && x.nzcnt < HYPER_FACTOR * n * 4;
+            for (i = 0; i < n; i++) mpq_set_ui(dense[r][i], 0UL, 1UL);
+            for (i = 0; i < x.nzcnt; i++)
+                mpq_set(dense[r][x.indx[i]], x.coef[i]);
+        }
+        for (i = 0; i < n; i++)
+            ok = ok && mpq_equal(dense[0][i], dense[1][i]) &&
+                mpq_equal(dense[0][i], dense[2][i]);
+    }
+
+CLEANUP:
+    if (ok) {
+        printf("ok %i - Hypersparse solves match the dense solves\n",
+               test_id);
+    } else {
+        printf("not ok %i - Hypersparse solves differ from the dense solves\n",
+               test_id);
+    }
+    mpq_ILLsvector_free(&a);
+    mpq_ILLsvector_free(&x);
+    mpq_ILLfactor_free_factor_work(&f);
+    mpq_EGlpNumClearVar(f.fzero_tol);
+    mpq_EGlpNumClearVar(f.szero_tol);
+    mpq_EGlpNumClearVar(f.partial_tol);
+    mpq_EGlpNumClearVar(f.maxelem_orig);
+    mpq_EGlpNumClearVar(f.maxelem_factor);
+    mpq_EGlpNumClearVar(f.maxelem_cur);
+    mpq_EGlpNumClearVar(f.partial_cur);
+    for (i = 0; i < 2 * n; i++) mpq_clear(cval[i]);
+    for (l = 0; l < 3; l++)
+        for (i = 0; i < n; i++) mpq_clear(dense[l][i]);
+}
+
+static void test_dot_accumulator(int test_id)
+{
+    /* Mix power of two and general denominators, and cancel to zero */
+    static const char *a[] = { "3/4", "-5/8", "7/3", "1", "-11/6", "9/1024" };
+    static const char *b[] = { "2/3", "8/5", "3/14", "-4", "6/11", "1024/9" };
+    mpq_EGlpNumDot_t acc;
+    mpq_t x, y, sum, res;
+    int ok = 1;
+    int i;
+
+    mpq_EGlpNumDotInit(acc);
+    mpq_init(x); mpq_init(y); mpq_init(sum); mpq_init(res);
+    for (i = 0; i < 6; i++) {
+        mpq_set_str(x, a[i], 10);
+        mpq_set_str(y, b[i], 10);
+        mpq_canonicalize(x);
+        mpq_canonicalize(y);
+        mpq_EGlpNumDotAddProd(acc, x, y);
+        mpq_mul(x, x, y);
+        mpq_add(sum, sum, x);
+        mpq_EGlpNumDotGet(res, acc);
+        ok = ok && mpq_equal(res, sum);
+    }
+    mpq_EGlpNumDotAdd(acc, sum);
+    mpq_EGlpNumDotGet(res, acc);
+    mpq_add(sum, sum, sum);
+    ok = ok && mpq_equal(res, sum);
+    mpq_set_ui(x, 2UL, 1UL);
+    mpq_EGlpNumDotSubProd(acc, sum, x);
+    mpq_EGlpNumDotGet(res, acc);
+    mpq_neg(sum, sum);
+    ok = ok && mpq_equal(res, sum);
+
+    /* Dyadic values convert to double with a shift, same as mpq_get_d */
+    for (i = 0; i < 6; i++) {
+        mpq_set_d(x, (i - 2.5) / (3 << (4 * i)));
+        ok = ok && mpq_EGlpNumGetD(x) == mpq_get_d(x);
+        mpq_EGlpNumDotAdd(acc, x);
+    }
+    mpq_EGlpNumDotSubDot(acc, acc);
+    mpq_EGlpNumDotGet(res, acc);
+    ok = ok && mpq_sgn(res) == 0;
+
+    if (ok) {
+        printf("ok %i - Exact dot products match mpq arithmetic\n", test_id);
+    } else {
+        printf("not ok %i - Exact dot products differ from mpq arithmetic\n",
+               test_id);
+    }
+    mpq_clear(x); mpq_clear(y); mpq_clear(sum); mpq_clear(res);
+    mpq_EGlpNumDotClear(acc);
+}
+
+static void test_rational_reconstruction(int test_id)
+{
+    /* Binary images of doubles snap back to the fractions they round, values
+     * with no close small-denominator fraction are kept */
+    static const double d[] = { 1.0 / 3, -22.0 / 7, 0.1, 3.141592653589793, 5 };
+    static const char *e[] = { "1/3", "-22/7", "1/10", 0, "5" };
+    mpq_t *v;
+    mpq_t want;
+    int ok = 1;
+    int i;
+
+    v = malloc(5 * sizeof(mpq_t));
+    mpq_init(want);
+    for (i = 0; i < 5; i++) {
+        mpq_init(v[i]);
+        mpq_set_d(v[i], d[i]);
+    }
+    ok = QSexact_reconstruct(v, 5, 1000UL, 53) == 3;
+    for (i = 0; i < 5; i++) {
+        if (e[i])
+            mpq_set_str(want, e[i], 10);
+        else
+            mpq_set_d(want, d[i]);
+        ok = ok && mpq_equal(v[i], want);
+        mpq_clear(v[i]);
+    }
+    free(v);
+    mpq_clear(want);
+
+    if (ok) {
+        printf("ok %i - Rational reconstruction recovers small fractions\n",
+               test_id);
+    } else {
+        printf("not ok %i - Rational reconstruction returned wrong values\n",
+               test_id);
+    }
+}
+
 static void test_write_problem_to_file(int test_id, const char *filetype)
 {
     mpq_QSprob p = NULL;
@@ -615,6 +1918,55 @@ CLEANUP:
     if (p) mpq_QSfree_prob(p);
 }
 
+static void test_lift_solution(int test_id)
+{
+    mpq_QSprob p = NULL;
+    mpq_QSbas basis = NULL;
+    mpq_t x[3], y[2], lx[3], ly[2];
+    int status = 0;
+    int rval = 0;
+    int i;
+    int ncols = 3, nrows = 2;
+
+    for (i = 0; i < ncols; i++) { mpq_init(x[i]); mpq_init(lx[i]); }
+    for (i = 0; i < nrows; i++) { mpq_init(y[i]); mpq_init(ly[i]); }
+
+    rval = solve_test_problem(&p, &status);
+    if (rval || status != QS_LP_OPTIMAL) {
+        printf("not ok %i - Unable to solve the LP\n", test_id);
+        goto CLEANUP;
+    }
+
+    basis = mpq_QSget_basis(p);
+    rval = basis == NULL || mpq_QSget_x_array(p, x) ||
+           mpq_QSget_pi_array(p, y);
+    if (rval) {
+        printf("not ok %i - Could not get the optimal solution\n", test_id);
+        goto CLEANUP;
+    }
+
+    rval = QSexact_lift_solution(p, basis, lx, ly);
+    if (rval) {
+        printf("not ok %i - Lifting failed, error code %d\n", test_id, rval);
+        goto CLEANUP;
+    }
+
+    for (i = 0; i < ncols; i++) rval |= !mpq_equal(x[i], lx[i]);
+    for (i = 0; i < nrows; i++) rval |= !mpq_equal(y[i], ly[i]);
+    if (rval) {
+        printf("not ok %i - Lifted solution differs from the optimal one\n",
+               test_id);
+    } else {
+        printf("ok %i - Lifted the exact basic solution\n", test_id);
+    }
+
+CLEANUP:
+    for (i = 0; i < ncols; i++) { mpq_clear(x[i]); mpq_clear(lx[i]); }
+    for (i = 0; i < nrows; i++) { mpq_clear(y[i]); mpq_clear(ly[i]); }
+    if (basis) mpq_QSfree_basis(basis);
+    if (p) mpq_QSfree_prob(p);
+}
+
 static void test_write_problem_to_lp_file(int test_id)
 {
     test_write_problem_to_file(test_id, "LP");
@@ -707,8 +2059,28 @@ int main(int ac, char **av)
         test_solve_no_constraints,
         test_solution_is_optimal,
         test_solution_objective,
+        test_basis_solver_bareiss,
+        test_basis_solver_modular,
+        test_basis_solver_dixon,
+        test_basis_solver_schur,
+        test_solution_objective_race,
+        test_solution_objective_schedule,
+        test_solution_objective_schedule_skip,
+        test_solution_objective_checkpoint,
+        test_basis_condition,
+        test_basis_growth,
+        test_factor_multi_solve,
+        test_factor_shadow_update,
+        test_factor_solve_snapshot,
+        test_factor_threads,
+        test_factor_hypersparse,
         test_solution_get_variables,
         test_solution_get_dual_values,
+        test_solution_certificate,
+        test_malformed_certificate,
+        test_dot_accumulator,
+        test_rational_reconstruction,
+        test_lift_solution,
         test_write_problem_to_lp_file,
         test_write_problem_to_mps_file,
         test_write_lp_problem_no_constraints,